@@ -15,6 +15,12 @@ export function randomPrime(
   add?: ArrayBufferView,
   rem?: ArrayBufferView
 ): ArrayBuffer;
+export function randomPrimeAsync(
+  size: number,
+  safe: boolean,
+  add?: ArrayBufferView,
+  rem?: ArrayBufferView
+): Promise<ArrayBuffer>;
 
 export function statelessDH(
   privateKey: CryptoKey,
@@ -220,6 +226,13 @@ export function getPbkdf(
   keylen: number,
   digest: string
 ): ArrayBuffer;
+export function getPbkdfAsync(
+  password: ArrayLike,
+  salt: ArrayLike,
+  iterations: number,
+  keylen: number,
+  digest: string
+): Promise<ArrayBuffer>;
 
 // scrypt
 export function getScrypt(
@@ -231,6 +244,15 @@ export function getScrypt(
   maxmem: number,
   keylen: number
 ): ArrayBuffer;
+export function getScryptAsync(
+  password: ArrayLike,
+  salt: ArrayLike,
+  N: number,
+  r: number,
+  p: number,
+  maxmem: number,
+  keylen: number
+): Promise<ArrayBuffer>;
 
 // Keys
 export function exportKey(
@@ -277,10 +299,16 @@ export interface DhKeyPairOptions {
 }
 
 export function generateRsaKeyPair(options: RsaKeyPairOptions): CryptoKeyPair;
+export function generateRsaKeyPairAsync(
+  options: RsaKeyPairOptions
+): Promise<CryptoKeyPair>;
 export function generateDsaKeyPair(options: DsaKeyPairOptions): CryptoKeyPair;
 export function generateEcKeyPair(options: EcKeyPairOptions): CryptoKeyPair;
 export function generateEdKeyPair(options: EdKeyPairOptions): CryptoKeyPair;
 export function generateDhKeyPair(options: DhKeyPairOptions): CryptoKeyPair;
+export function generateDhKeyPairAsync(
+  options: DhKeyPairOptions
+): Promise<CryptoKeyPair>;
 
 // Spkac
 export function verifySpkac(input: ArrayBufferView | ArrayBuffer): boolean;
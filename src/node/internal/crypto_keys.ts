@@ -37,6 +37,7 @@ import {
   type AsymmetricKeyDetails,
   type AsymmetricKeyType,
   type CreateAsymmetricKeyOptions,
+  type DhKeyPairOptions,
   type GenerateKeyOptions,
   type GenerateKeyPairOptions,
   type InnerExportOptions,
@@ -603,28 +604,27 @@ export function generateKeyPair(
   callback: GenerateKeyPairCallback
 ): void {
   validateFunction(callback, 'callback');
-  try {
-    // Unlike Node.js, which implements async crypto functions using the
-    // libuv thread pool, we don't actually perform async crypto operations.
-    // Here we just defer to the sync version of the function and then "fake"
-    // async by using queueMicrotask to call the callback.
-    const { publicKey, privateKey } = generateKeyPairSync(_type, _options);
-    queueMicrotask(() => {
+  // Like Node.js, RSA and DH keys are generated on a background thread where
+  // possible. The other key types are cheap enough that we generate them
+  // synchronously and "fake" async by calling the callback from a microtask.
+  new Promise<KeyObjectPair>((res) => {
+    res(generateKeyPairImpl(_type, _options, true));
+  }).then(
+    ({ publicKey, privateKey }: KeyObjectPair): void => {
       try {
         callback(null, publicKey, privateKey);
       } catch (err) {
         reportError(err);
       }
-    });
-  } catch (err) {
-    queueMicrotask(() => {
+    },
+    (err: unknown): void => {
       try {
         callback(err);
       } catch (otherErr) {
         reportError(otherErr);
       }
-    });
-  }
+    }
+  );
 }
 
 Object.defineProperty(generateKeyPair, kCustomPromisifyArgsSymbol, {
@@ -666,6 +666,14 @@ export function generateKeyPairSync(
   type: AsymmetricKeyType,
   options: GenerateKeyPairOptions = {}
 ): KeyObjectPair {
+  return generateKeyPairImpl(type, options, false) as KeyObjectPair;
+}
+
+function generateKeyPairImpl(
+  type: AsymmetricKeyType,
+  options: GenerateKeyPairOptions,
+  async: boolean
+): KeyObjectPair | Promise<KeyObjectPair> {
   validateOneOf(type, 'type', [
     'rsa',
     'ec',
@@ -750,12 +758,18 @@ export function generateKeyPairSync(
     case 'rsa': {
       validateUint32(modulusLength, 'options.modulusLength');
       validateUint32(publicExponent, 'options.publicExponent');
+      const rsaOptions = {
+        type,
+        modulusLength: modulusLength,
+        publicExponent: publicExponent,
+      };
+      if (async) {
+        return cryptoImpl
+          .generateRsaKeyPairAsync(rsaOptions)
+          .then(handleKeyEncoding) as Promise<KeyObjectPair>;
+      }
       return handleKeyEncoding(
-        cryptoImpl.generateRsaKeyPair({
-          type,
-          modulusLength: modulusLength,
-          publicExponent: publicExponent,
-        })
+        cryptoImpl.generateRsaKeyPair(rsaOptions)
       ) as KeyObjectPair;
     }
     // TODO(later): BoringSSL does not support RSA-PSS key generation in the
@@ -839,6 +853,7 @@ export function generateKeyPairSync(
         validateInt32(generator, 'options.generator', 0);
       }
 
+      let dhOptions: DhKeyPairOptions;
       if (group != null || groupName != null) {
         if (prime != null) {
           throw new ERR_INCOMPATIBLE_OPTION_PAIR('group', 'prime');
@@ -854,48 +869,43 @@ export function generateKeyPairSync(
 
         validateString(g, 'options.group');
 
-        return handleKeyEncoding(
-          cryptoImpl.generateDhKeyPair({
-            primeOrGroup: g,
-            generator,
-          })
-        ) as KeyObjectPair;
-      }
-
-      if (prime != null) {
-        if (primeLength != null) {
-          throw new ERR_INCOMPATIBLE_OPTION_PAIR('prime', 'primeLength');
-        }
-
-        if (!isArrayBufferView(prime) && !isAnyArrayBuffer(prime)) {
-          throw new ERR_INVALID_ARG_TYPE(
-            'options.prime',
-            ['Buffer', 'TypedArray', 'ArrayBuffer'],
-            prime
+        dhOptions = { primeOrGroup: g, generator };
+      } else {
+        if (prime != null) {
+          if (primeLength != null) {
+            throw new ERR_INCOMPATIBLE_OPTION_PAIR('prime', 'primeLength');
+          }
+
+          if (!isArrayBufferView(prime) && !isAnyArrayBuffer(prime)) {
+            throw new ERR_INVALID_ARG_TYPE(
+              'options.prime',
+              ['Buffer', 'TypedArray', 'ArrayBuffer'],
+              prime
+            );
+          }
+        } else if (primeLength != null) {
+          validateInt32(primeLength, 'options.primeLength', 0);
+        } else {
+          throw new ERR_MISSING_OPTION(
+            'At least one of the group, prime, or primeLength options'
           );
         }
-      } else if (primeLength != null) {
-        validateInt32(primeLength, 'options.primeLength', 0);
-      } else {
-        throw new ERR_MISSING_OPTION(
-          'At least one of the group, prime, or primeLength options'
-        );
-      }
 
-      if (prime) {
-        return handleKeyEncoding(
-          cryptoImpl.generateDhKeyPair({
-            primeOrGroup: prime as BufferSource,
-            generator: generator as number,
-          })
-        ) as KeyObjectPair;
+        dhOptions = {
+          primeOrGroup: prime
+            ? (prime as BufferSource)
+            : (primeLength as number),
+          generator: generator as number,
+        };
       }
 
+      if (async) {
+        return cryptoImpl
+          .generateDhKeyPairAsync(dhOptions)
+          .then(handleKeyEncoding) as Promise<KeyObjectPair>;
+      }
       return handleKeyEncoding(
-        cryptoImpl.generateDhKeyPair({
-          primeOrGroup: primeLength as number,
-          generator: generator as number,
-        })
+        cryptoImpl.generateDhKeyPair(dhOptions)
       ) as KeyObjectPair;
     }
   }
@@ -86,7 +86,9 @@ export function pbkdf2(
 
   new Promise<ArrayBuffer>((res, rej) => {
     try {
-      res(cryptoImpl.getPbkdf(password, salt, iterations, keylen, digest));
+      res(
+        cryptoImpl.getPbkdfAsync(password, salt, iterations, keylen, digest)
+      );
     } catch (err) {
       rej(err as Error);
     }
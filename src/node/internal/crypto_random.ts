@@ -387,15 +387,15 @@ export function generatePrime(
 
   const { safe, bigint, add, rem } = processGeneratePrimeOptions(options);
 
-  new Promise<bigint | ArrayBuffer>((res, rej) => {
+  new Promise<ArrayBuffer>((res, rej) => {
     try {
-      const primeBuf = cryptoImpl.randomPrime(size, safe, add, rem);
-      res(bigint ? arrayBufferToUnsignedBigInt(primeBuf) : primeBuf);
+      res(cryptoImpl.randomPrimeAsync(size, safe, add, rem));
     } catch (err) {
       rej(err as Error);
     }
   }).then(
-    (val: bigint | ArrayBuffer): void => {
+    (primeBuf: ArrayBuffer): void => {
+      const val = bigint ? arrayBufferToUnsignedBigInt(primeBuf) : primeBuf;
       callback(null, val);
     },
     (err: unknown): void => {
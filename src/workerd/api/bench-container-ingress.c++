@@ -315,8 +315,12 @@ void runWorkerInterfaceBench(benchmark::State& state,
   state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(REQUESTS_PER_ITER));
 }
 
-void runManagedBench(
-    benchmark::State& state, TestFixture::SetupParams params, TunnelReuse tunnelReuse) {
+// Requests are spread round-robin over `portCount` ports, with a tunnel pool sized per `options`.
+void runManagedBench(benchmark::State& state,
+    TestFixture::SetupParams params,
+    TunnelReuse tunnelReuse,
+    size_t portCount = 1,
+    Container::TcpPortPoolOptions options = {}) {
   TestFixture fixture(kj::mv(params));
   AutogateScope autogateScope(tunnelReuse);
 
@@ -334,15 +338,22 @@ void runManagedBench(
     container = env.js.alloc<Container>(
         rpc::Container::Client(kj::heap<MockContainerServer>(
             sharedFakeTimer(), env.context.getHeaderTable(), *backend, serverByteStreamFactory)),
-        true);
+        true, options);
   });
 
   auto& headerTable = ioContext->getHeaderTable();
+  size_t nextPort = 0;
   runWorkerInterfaceBench(
       state, fixture, *request, headerTable, [&](const TestFixture::Environment& env) {
-    auto fetcher = container->getTcpPort(env.js, 8080);
+    auto port = 8080 + static_cast<int>(nextPort++ % portCount);
+    auto fetcher = container->getTcpPort(env.js, port);
     return fetcher->getClient(env.context, kj::none, "container"_kjc);
   });
+
+  auto& metrics = container->getTcpPortPoolMetrics();
+  state.counters["pool_hits"] = static_cast<double>(metrics.hits);
+  state.counters["pool_misses"] = static_cast<double>(metrics.misses);
+  state.counters["pool_evictions"] = static_cast<double>(metrics.evictions);
 }
 
 void Managed(benchmark::State& state) {
@@ -352,6 +363,16 @@ void ManagedReuse(benchmark::State& state) {
   runManagedBench(state, setupParams(), TunnelReuse::ENABLED);
 }
 
+// Many ports, all of which fit in the tunnel pool.
+void ManagedReuseManyPorts(benchmark::State& state) {
+  runManagedBench(state, setupParams(), TunnelReuse::ENABLED, 32, {.maxPorts = 32});
+}
+
+// Many ports cycled through a pool too small to hold them, so every lookup evicts.
+void ManagedReuseManyPortsThrash(benchmark::State& state) {
+  runManagedBench(state, setupParams(), TunnelReuse::ENABLED, 32, {.maxPorts = 4});
+}
+
 void FetchDirect(benchmark::State& state) {
   TestFixture fixture(setupParams());
 
@@ -403,6 +424,8 @@ void Direct(benchmark::State& state) {
 
 WD_BENCHMARK(Managed);
 WD_BENCHMARK(ManagedReuse);
+WD_BENCHMARK(ManagedReuseManyPorts);
+WD_BENCHMARK(ManagedReuseManyPortsThrash);
 WD_BENCHMARK(FetchDirect);
 WD_BENCHMARK(Direct);
 
@@ -1391,6 +1391,61 @@ KJ_TEST("Container does not reuse tunnels when the autogate is disabled") {
   runTunnelTest(ResponseMode::KEEP_ALIVE, 2, TunnelReuseGate::DISABLED);
 }
 
+KJ_TEST("Container evicts the least recently used pooled tunnel") {
+  auto fixture = makeFixture();
+  AutogateScope autogateScope;
+  capnp::ByteStreamFactory byteStreamFactory;
+  size_t connectCount = 0;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto container = env.js.alloc<Container>(
+        rpc::Container::Client(kj::heap<TestContainerServer>(
+            byteStreamFactory, ResponseMode::KEEP_ALIVE, connectCount)),
+        true, Container::TcpPortPoolOptions{.maxPorts = 2});
+    auto& metrics = container->getTcpPortPoolMetrics();
+
+    container->getTcpPort(env.js, 8080);
+    container->getTcpPort(env.js, 8081);
+    KJ_EXPECT(metrics.misses == 2);
+    KJ_EXPECT(metrics.evictions == 0);
+
+    // Touch 8080 so that 8081 is the least recently used.
+    container->getTcpPort(env.js, 8080);
+    KJ_EXPECT(metrics.hits == 1);
+
+    container->getTcpPort(env.js, 8082);
+    KJ_EXPECT(metrics.misses == 3);
+    KJ_EXPECT(metrics.evictions == 1);
+
+    container->getTcpPort(env.js, 8080);
+    KJ_EXPECT(metrics.hits == 2);
+    container->getTcpPort(env.js, 8081);
+    KJ_EXPECT(metrics.misses == 4);
+    KJ_EXPECT(metrics.evictions == 2);
+  });
+}
+
+KJ_TEST("Container does not reuse idle pooled tunnels") {
+  auto fixture = makeFixture();
+  AutogateScope autogateScope;
+  capnp::ByteStreamFactory byteStreamFactory;
+  size_t connectCount = 0;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto container = env.js.alloc<Container>(
+        rpc::Container::Client(kj::heap<TestContainerServer>(
+            byteStreamFactory, ResponseMode::KEEP_ALIVE, connectCount)),
+        true, Container::TcpPortPoolOptions{.idleTimeout = 0 * kj::SECONDS});
+    auto& metrics = container->getTcpPortPoolMetrics();
+
+    container->getTcpPort(env.js, 8080);
+    container->getTcpPort(env.js, 8080);
+    KJ_EXPECT(metrics.hits == 0);
+    KJ_EXPECT(metrics.misses == 2);
+    KJ_EXPECT(metrics.evictions == 1);
+  });
+}
+
 KJ_TEST("Container start invalidates pooled tunnels") {
   auto fixture = makeFixture();
   AutogateScope autogateScope;
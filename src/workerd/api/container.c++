@@ -14,6 +14,7 @@
 
 #include <capnp/compat/byte-stream.h>
 #include <kj/filesystem.h>
+#include <kj/list.h>
 #include <kj/refcount.h>
 
 #include <cmath>
@@ -22,14 +23,6 @@ namespace workerd::api {
 
 namespace {
 
-// Upper bound on the number of distinct container ports whose tunnels we pool per Container. This
-// is a hard admission cap: once this many ports are pooled, any further distinct port falls back
-// to the non-pooled connect path (a fresh tunnel per request) for the Container's lifetime.
-// TODO(perf): This has no eviction policy or observability. Consider LRU eviction of cold entries
-//   and/or a debug log or metric when the cap is hit, so ports beyond the cap are not silently and
-//   permanently relegated to the slower path.
-constexpr size_t MAX_CACHED_TCP_PORTS = 4;
-
 constexpr size_t MAX_IMAGE_REFERENCE_SIZE = 4096;
 constexpr kj::StringPtr VALID_CONTAINER_INSTANCE_TYPES[] = {
   "lite"_kj, "standard-1"_kj, "standard-2"_kj, "standard-3"_kj, "standard-4"_kj};
@@ -305,7 +298,12 @@ void ExecProcess::resize(jsg::Lock& js, int cols, int rows) {
 // Basic lifecycle methods
 
 Container::Container(rpc::Container::Client rpcClient, bool running)
-    : rpcClient(IoContext::current().addObject(kj::heap(kj::mv(rpcClient)))) {
+    : Container(kj::mv(rpcClient), running, TcpPortPoolOptions()) {}
+
+Container::Container(
+    rpc::Container::Client rpcClient, bool running, TcpPortPoolOptions tcpPortPoolOptions)
+    : rpcClient(IoContext::current().addObject(kj::heap(kj::mv(rpcClient)))),
+      tcpPortPoolOptions(tcpPortPoolOptions) {
   if (running) startMonitor();
 }
 
@@ -1325,13 +1323,114 @@ class Container::TcpPortState {
   kj::Maybe<PooledPort> pooled;
 };
 
+// The pooled TcpPortStates of a Container, keyed by port and ordered by last use. Entries are
+// only dropped from the pool; a TcpPortState that is still held by a Fetcher keeps working.
+class Container::TcpPortPool {
+ public:
+  ~TcpPortPool() noexcept(false) {
+    while (!lru.empty()) {
+      lru.remove(lru.front());
+    }
+  }
+
+  // Returns the pooled state for `port` and marks it most recently used. A state whose port has
+  // failed is dropped instead, so that the caller builds a fresh tunnel.
+  kj::Maybe<kj::Rc<TcpPortState>> find(int port, kj::Date now) {
+    KJ_IF_SOME(entry, entries.find(port)) {
+      if (entry->state->hasPortFailed()) {
+        remove(*entry);
+        return kj::none;
+      }
+      entry->lastUsed = now;
+      lru.remove(*entry);
+      lru.add(*entry);
+      return entry->state.addRef();
+    }
+    return kj::none;
+  }
+
+  // Drops every state that has not been used within `idleTimeout`. Returns how many were dropped.
+  uint expireIdle(kj::Date now, kj::Duration idleTimeout) {
+    uint count = 0;
+    while (!lru.empty() && now - lru.front().lastUsed >= idleTimeout) {
+      remove(lru.front());
+      ++count;
+    }
+    return count;
+  }
+
+  // Adds a state for a port that is not in the pool, first evicting the least recently used
+  // state if the pool already holds `maxPorts`. Returns true if a state was evicted.
+  bool insert(int port, kj::Rc<TcpPortState> state, kj::Date now, size_t maxPorts) {
+    bool evicted = false;
+    if (entries.size() >= maxPorts) {
+      remove(lru.front());
+      evicted = true;
+    }
+    auto& entry = entries.insert(port, kj::heap<Entry>(port, kj::mv(state), now)).value;
+    lru.add(*entry);
+    return evicted;
+  }
+
+  void invalidateAll() {
+    for (auto& entry: lru) {
+      entry.state->invalidate();
+    }
+  }
+
+ private:
+  struct Entry {
+    Entry(int port, kj::Rc<TcpPortState> state, kj::Date lastUsed)
+        : port(port),
+          state(kj::mv(state)),
+          lastUsed(lastUsed) {}
+
+    int port;
+    kj::Rc<TcpPortState> state;
+    kj::Date lastUsed;
+    kj::ListLink<Entry> link;
+  };
+
+  kj::HashMap<int, kj::Own<Entry>> entries;
+  // Least recently used first.
+  kj::List<Entry, &Entry::link> lru;
+
+  void remove(Entry& entry) {
+    int port = entry.port;
+    lru.remove(entry);
+    entries.erase(port);
+  }
+};
+
 void Container::invalidateTcpPortStates() {
-  KJ_IF_SOME(states, tcpPortStates) {
-    for (auto& entry: *states) {
-      entry.value->invalidate();
+  KJ_IF_SOME(pool, tcpPortPool) {
+    pool->invalidateAll();
+  }
+  tcpPortPool = kj::none;
+}
+
+void Container::recordTcpPortPoolHit() {
+  ++tcpPortPoolMetrics.hits;
+  KJ_IF_SOME(actor, IoContext::current().getActor()) {
+    actor.getMetrics().containerTunnelPoolHit();
+  }
+}
+
+void Container::recordTcpPortPoolMiss() {
+  ++tcpPortPoolMetrics.misses;
+  KJ_IF_SOME(actor, IoContext::current().getActor()) {
+    actor.getMetrics().containerTunnelPoolMiss();
+  }
+}
+
+void Container::recordTcpPortPoolEvictions(uint count) {
+  if (count == 0) return;
+  tcpPortPoolMetrics.evictions += count;
+  KJ_IF_SOME(actor, IoContext::current().getActor()) {
+    for (auto i KJ_UNUSED: kj::zeroTo(count)) {
+      actor.getMetrics().containerTunnelPoolEviction();
     }
   }
-  tcpPortStates = kj::none;
 }
 
 // `getTcpPort()` returns a `Fetcher`, on which `fetch()` and `connect()` can be called. `Fetcher`
@@ -1485,26 +1584,34 @@ jsg::Ref<Fetcher> Container::getTcpPort(jsg::Lock& js, int port) {
   };
 
   auto portState = [&]() -> kj::Rc<TcpPortState> {
-    if (util::Autogate::isEnabled(util::AutogateKey::CONTAINER_TUNNEL_REUSE)) {
-      if (tcpPortStates == kj::none) {
-        tcpPortStates = ioctx.addObject(kj::heap<kj::HashMap<int, kj::Rc<TcpPortState>>>());
+    if (util::Autogate::isEnabled(util::AutogateKey::CONTAINER_TUNNEL_REUSE) &&
+        tcpPortPoolOptions.maxPorts > 0) {
+      if (tcpPortPool == kj::none) {
+        tcpPortPool = ioctx.addObject(kj::heap<TcpPortPool>());
       }
-      auto& states = *KJ_ASSERT_NONNULL(tcpPortStates);
+      auto& pool = *KJ_ASSERT_NONNULL(tcpPortPool);
+      auto now = ioctx.now();
+
+      // A tunnel that sat idle for a long time is likely to have been dropped by the container,
+      // so don't hand it out.
+      recordTcpPortPoolEvictions(pool.expireIdle(now, tcpPortPoolOptions.idleTimeout));
 
-      KJ_IF_SOME(entry, states.findEntry(port)) {
-        if (!entry.value->hasPortFailed()) return entry.value.addRef();
-        states.erase(entry);
+      KJ_IF_SOME(state, pool.find(port, now)) {
+        recordTcpPortPoolHit();
+        return kj::mv(state);
       }
-      if (states.size() < MAX_CACHED_TCP_PORTS) {
-        auto req = makePortRequest();
-        auto response = req.send();
-        auto state = kj::rc<TcpPortState>(ioctx.getUnsafeTimer(), ioctx.getByteStreamFactory(),
-            ioctx.getEntropySource(), ioctx.getHeaderTable(), response.getPort());
-        ioctx.addTask(response.ignoreResult().catch_(
-            [state = state.addRef()](kj::Exception&&) mutable { state->markPortFailed(); }));
-        states.insert(port, state.addRef());
-        return state;
+      recordTcpPortPoolMiss();
+
+      auto req = makePortRequest();
+      auto response = req.send();
+      auto state = kj::rc<TcpPortState>(ioctx.getUnsafeTimer(), ioctx.getByteStreamFactory(),
+          ioctx.getEntropySource(), ioctx.getHeaderTable(), response.getPort());
+      ioctx.addTask(response.ignoreResult().catch_(
+          [state = state.addRef()](kj::Exception&&) mutable { state->markPortFailed(); }));
+      if (pool.insert(port, state.addRef(), now, tcpPortPoolOptions.maxPorts)) {
+        recordTcpPortPoolEvictions(1);
       }
+      return state;
     }
 
     auto req = makePortRequest();
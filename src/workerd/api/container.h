@@ -196,7 +196,34 @@ class ExecProcess: public jsg::Object {
 // etc.
 class Container: public jsg::Object {
  public:
+  // Limits on the tunnels that getTcpPort() keeps open for reuse when the container-tunnel-reuse
+  // autogate is enabled.
+  struct TcpPortPoolOptions {
+    // Maximum number of ports with a pooled tunnel. When a tunnel for another port is needed, the
+    // least recently used port's tunnel is evicted to make room.
+    size_t maxPorts = 16;
+
+    // A pooled tunnel that has not been used for this long is discarded rather than reused.
+    kj::Duration idleTimeout = 60 * kj::SECONDS;
+  };
+
+  // Reported to the ActorObserver as they happen; also kept here for tests and benchmarks.
+  struct TcpPortPoolMetrics {
+    // getTcpPort() calls that reused a pooled tunnel.
+    uint64_t hits = 0;
+    // getTcpPort() calls that had to build a new tunnel.
+    uint64_t misses = 0;
+    // Pooled tunnels dropped because the pool was full or they sat idle too long.
+    uint64_t evictions = 0;
+  };
+
   Container(rpc::Container::Client rpcClient, bool running);
+  Container(
+      rpc::Container::Client rpcClient, bool running, TcpPortPoolOptions tcpPortPoolOptions);
+
+  const TcpPortPoolMetrics& getTcpPortPoolMetrics() const {
+    return tcpPortPoolMetrics;
+  }
 
   struct DirectorySnapshot {
     kj::String id;
@@ -427,9 +454,15 @@ class Container: public jsg::Object {
   // the container-tunnel-reuse autogate is enabled. Held via IoOwn because it holds KJ I/O objects
   // (Cap'n Proto capabilities, kj streams) that must remain tied to the Durable Object's IoContext.
   class TcpPortState;
-  kj::Maybe<IoOwn<kj::HashMap<int, kj::Rc<TcpPortState>>>> tcpPortStates;
+  class TcpPortPool;
+  kj::Maybe<IoOwn<TcpPortPool>> tcpPortPool;
+  TcpPortPoolOptions tcpPortPoolOptions;
+  TcpPortPoolMetrics tcpPortPoolMetrics;
 
   void invalidateTcpPortStates();
+  void recordTcpPortPoolHit();
+  void recordTcpPortPoolMiss();
+  void recordTcpPortPoolEvictions(uint count);
   void startMonitor();
   bool isCurrentMonitor(uint64_t generation);
 
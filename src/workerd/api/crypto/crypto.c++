@@ -99,16 +99,16 @@ namespace {
 // Note that SubtleCrypto.digest() is special. It is not a key-based operation and we only support
 // one hash family, SHA, so its implementation is non-virtual.
 //
-// NOTE(perf): The SubtleCrypto interface is asynchronous, but all of our implementations perform
-//   the crypto synchronously before returning. In theory, we could be performing bulk crypto in a
-//   separate thread, maybe improving performance. However, it's unclear what real use case would
-//   benefit from this. It's also unclear that we would want a single request to be able to use
-//   multiple cores -- certainly it would greatly complicate our implementation of request CPU
-//   limits. So, we probably shouldn't implement true asynchronous crypto.
-//
-//   Additionally, performing the crypto synchronously actually has a performance benefit: we can
-//   safely avoid copying input BufferSources -- most of our functions can take
+// NOTE(perf): The SubtleCrypto interface is asynchronous, but most of our implementations perform
+//   the crypto synchronously before returning. Bulk crypto is fast enough that moving it to
+//   another thread wouldn't pay for itself, and performing it synchronously has a performance
+//   benefit: we can safely avoid copying input BufferSources -- most of our functions can take
 //   kj::ArrayPtr<const kj::byte>s, rather than kj::Array<kj::byte>s.
+//
+//   The exceptions are operations that can take long enough to stall the isolate's event loop
+//   for everyone else: PBKDF2 derivation (deriveBitsAsync()) and RSA key generation
+//   (generateAsyncFunc). Those copy their inputs and run through offloadCrypto(), which charges
+//   the CPU time they take back to the request and caps how many one isolate can run at once.
 
 // =======================================================================================
 // Registered algorithms
@@ -122,9 +122,12 @@ static kj::Maybe<const CryptoAlgorithm&> lookupAlgorithm(kj::StringPtr name) {
     {"HMAC"_kj, &CryptoKey::Impl::importHmac, &CryptoKey::Impl::generateHmac},
     {"PBKDF2"_kj, &CryptoKey::Impl::importPbkdf2},
     {"HKDF"_kj, &CryptoKey::Impl::importHkdf},
-    {"RSASSA-PKCS1-v1_5"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa},
-    {"RSA-PSS"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa},
-    {"RSA-OAEP"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa},
+    {"RSASSA-PKCS1-v1_5"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa,
+      &CryptoKey::Impl::generateRsaAsync},
+    {"RSA-PSS"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa,
+      &CryptoKey::Impl::generateRsaAsync},
+    {"RSA-OAEP"_kj, &CryptoKey::Impl::importRsa, &CryptoKey::Impl::generateRsa,
+      &CryptoKey::Impl::generateRsaAsync},
     {"ECDSA"_kj, &CryptoKey::Impl::importEcdsa, &CryptoKey::Impl::generateEcdsa},
     {"ECDH"_kj, &CryptoKey::Impl::importEcdh, &CryptoKey::Impl::generateEcdh},
     {"NODE-ED25519"_kj, &CryptoKey::Impl::importEddsa, &CryptoKey::Impl::generateEddsa},
@@ -419,6 +422,25 @@ jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> SubtleCrypto::digest(
   });
 }
 
+namespace {
+void checkGeneratedKeyUsages(
+    const kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair>& cryptoKeyOrPair, bool noUsages) {
+  KJ_SWITCH_ONEOF(cryptoKeyOrPair) {
+    KJ_CASE_ONEOF(cryptoKey, jsg::Ref<CryptoKey>) {
+      if (noUsages) {
+        auto type = cryptoKey->getType();
+        JSG_REQUIRE(type != "secret" && type != "private", DOMSyntaxError,
+            "Secret/private CryptoKeys must have at least one usage.");
+      }
+    }
+    KJ_CASE_ONEOF(keyPair, CryptoKeyPair) {
+      JSG_REQUIRE(keyPair.privateKey->getUsageSet().size() != 0, DOMSyntaxError,
+          "Attempt to generate asymmetric keys with no valid private key usages.");
+    }
+  }
+}
+}  // namespace
+
 jsg::Promise<kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair>> SubtleCrypto::generateKey(jsg::Lock& js,
     kj::OneOf<kj::String, GenerateKeyAlgorithm> algorithmParam,
     bool extractable,
@@ -433,22 +455,20 @@ jsg::Promise<kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair>> SubtleCrypto::genera
     JSG_REQUIRE(algoImpl.generateFunc != nullptr, DOMNotSupportedError,
         "Unrecognized key generation algorithm \"", algorithm.name, "\" requested.");
 
+    if (algoImpl.generateAsyncFunc != nullptr) {
+      bool noUsages = keyUsages.size() == 0;
+      return algoImpl
+          .generateAsyncFunc(js, algoImpl.name, kj::mv(algorithm), extractable, keyUsages)
+          .then(js, [noUsages](jsg::Lock&, kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> result) {
+        checkGeneratedKeyUsages(result, noUsages);
+        return kj::mv(result);
+      });
+    }
+
     auto cryptoKeyOrPair =
         algoImpl.generateFunc(js, algoImpl.name, kj::mv(algorithm), extractable, keyUsages);
-    KJ_SWITCH_ONEOF(cryptoKeyOrPair) {
-      KJ_CASE_ONEOF(cryptoKey, jsg::Ref<CryptoKey>) {
-        if (keyUsages.size() == 0) {
-          auto type = cryptoKey->getType();
-          JSG_REQUIRE(type != "secret" && type != "private", DOMSyntaxError,
-              "Secret/private CryptoKeys must have at least one usage.");
-        }
-      }
-      KJ_CASE_ONEOF(keyPair, CryptoKeyPair) {
-        JSG_REQUIRE(keyPair.privateKey->getUsageSet().size() != 0, DOMSyntaxError,
-            "Attempt to generate asymmetric keys with no valid private key usages.");
-      }
-    }
-    return cryptoKeyOrPair;
+    checkGeneratedKeyUsages(cryptoKeyOrPair, keyUsages.size() == 0);
+    return js.resolvedPromise(kj::mv(cryptoKeyOrPair));
   });
 }
 
@@ -468,13 +488,19 @@ jsg::Promise<jsg::Ref<CryptoKey>> SubtleCrypto::deriveKey(jsg::Lock& js,
 
     auto length = getKeyLength(derivedKeyAlgorithm);
 
-    auto secret = jsg::JsBufferSource(baseKey.impl->deriveBits(js, kj::mv(algorithm), length));
-
-    // TODO(perf): For conformance, importKey() makes a copy of `secret`. In this case we really
-    //   don't need to, but rather we ought to call the appropriate CryptoKey::Impl::import*()
-    //   function directly.
-    return importKeySync(
-        js, "raw", secret.addRef(js), kj::mv(derivedKeyAlgorithm), extractable, kj::mv(keyUsages));
+    return baseKey.impl->deriveBitsAsync(js, kj::mv(algorithm), length)
+        .then(js,
+            [derivedKeyAlgorithm = kj::mv(derivedKeyAlgorithm), extractable,
+                keyUsages = kj::mv(keyUsages)](
+                jsg::Lock& js, jsg::JsRef<jsg::JsArrayBuffer> bits) mutable {
+      auto secret = jsg::JsBufferSource(bits.getHandle(js));
+
+      // TODO(perf): For conformance, importKey() makes a copy of `secret`. In this case we really
+      //   don't need to, but rather we ought to call the appropriate CryptoKey::Impl::import*()
+      //   function directly.
+      return importKeySync(js, "raw", secret.addRef(js), kj::mv(derivedKeyAlgorithm), extractable,
+          kj::mv(keyUsages));
+    });
   });
 }
 
@@ -496,7 +522,7 @@ jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> SubtleCrypto::deriveBits(jsg::Lock&
 
   return js.evalNow([&] {
     validateOperation(baseKey, algorithm.name, CryptoKeyUsageSet::deriveBits());
-    return baseKey.impl->deriveBits(js, kj::mv(algorithm), length).addRef(js);
+    return baseKey.impl->deriveBitsAsync(js, kj::mv(algorithm), length);
   });
 }
 
@@ -136,6 +136,17 @@ class CryptoKey::Impl {
   static GenerateFunc generateEcdh;
   static GenerateFunc generateEddsa;
 
+  // Like GenerateFunc, but may generate the key on a background thread. Only algorithms whose key
+  // generation is expensive provide one.
+  using GenerateAsyncFunc = jsg::Promise<kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair>>(
+      jsg::Lock& js,
+      kj::StringPtr normalizedName,
+      SubtleCrypto::GenerateKeyAlgorithm&& algorithm,
+      bool extractable,
+      kj::ArrayPtr<const kj::String> keyUsages);
+
+  static GenerateAsyncFunc generateRsaAsync;
+
   Impl(bool extractable, CryptoKeyUsageSet usages): extractable(extractable), usages(usages) {}
 
   static kj::Own<CryptoKey::Impl> from(jsg::Lock& js, kj::Own<EVP_PKEY> key);
@@ -182,6 +193,14 @@ class CryptoKey::Impl {
         "\".");
   }
 
+  // Like deriveBits(), but may do the derivation on a background thread. Algorithms whose
+  // derivation is expensive override this; by default it just calls deriveBits().
+  virtual jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> deriveBitsAsync(jsg::Lock& js,
+      SubtleCrypto::DeriveKeyAlgorithm&& algorithm,
+      kj::Maybe<uint32_t> length) const {
+    return js.resolvedPromise(deriveBits(js, kj::mv(algorithm), length).addRef(js));
+  }
+
   virtual jsg::JsArrayBuffer wrapKey(jsg::Lock& js,
       SubtleCrypto::EncryptAlgorithm&& algorithm,
       kj::ArrayPtr<const kj::byte> unwrappedKey) const {
@@ -279,6 +298,9 @@ struct CryptoAlgorithm {
   //   template metaprogramming cannot recognize it as const). Maybe we can fix this in KJ, by
   //   making `RemoveConstOrDisable` recognize function references are inherently const.
 
+  // Preferred over generateFunc when not nullptr.
+  CryptoKey::Impl::GenerateAsyncFunc* generateAsyncFunc = nullptr;
+
   // Allow comparison by name, case-insensitive. This is a convenience for placing in an std::set.
   inline bool operator==(const CryptoAlgorithm& other) const {
     return strcasecmp(name.cStr(), other.name.cStr()) == 0;
@@ -30,6 +30,13 @@ kj::Maybe<jsg::JsArrayBuffer> pbkdf2(jsg::Lock& js,
     kj::ArrayPtr<const kj::byte> password,
     kj::ArrayPtr<const kj::byte> salt);
 
+// Like the above, but doesn't need the isolate, so that it can run off-thread.
+kj::Maybe<kj::Array<kj::byte>> pbkdf2(size_t length,
+    size_t iterations,
+    const EVP_MD* digest,
+    kj::ArrayPtr<const kj::byte> password,
+    kj::ArrayPtr<const kj::byte> salt);
+
 // Perform Scrypt key derivation.
 kj::Maybe<jsg::JsArrayBuffer> scrypt(jsg::Lock& js,
     size_t length,
@@ -40,4 +47,13 @@ kj::Maybe<jsg::JsArrayBuffer> scrypt(jsg::Lock& js,
     kj::ArrayPtr<const kj::byte> pass,
     kj::ArrayPtr<const kj::byte> salt);
 
+// Like the above, but doesn't need the isolate, so that it can run off-thread.
+kj::Maybe<kj::Array<kj::byte>> scrypt(size_t length,
+    uint32_t N,
+    uint32_t r,
+    uint32_t p,
+    uint32_t maxmem,
+    kj::ArrayPtr<const kj::byte> pass,
+    kj::ArrayPtr<const kj::byte> salt);
+
 }  // namespace workerd::api
@@ -0,0 +1,56 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "offload.h"
+
+#include <kj/map.h>
+
+namespace workerd::api {
+
+namespace {
+
+// Offloaded operations in flight per isolate. An isolate may move between threads, and several
+// isolates may share one, so this can't be thread-local.
+kj::MutexGuarded<kj::HashMap<const void*, uint>>& getInFlightCounts() {
+  static kj::MutexGuarded<kj::HashMap<const void*, uint>> counts;
+  return counts;
+}
+
+class Reservation final {
+ public:
+  explicit Reservation(const void* isolate): isolate(isolate) {}
+  ~Reservation() noexcept(false) {
+    auto lock = getInFlightCounts().lockExclusive();
+    auto& count = KJ_ASSERT_NONNULL(lock->find(isolate));
+    if (--count == 0) {
+      lock->erase(isolate);
+    }
+  }
+  KJ_DISALLOW_COPY_AND_MOVE(Reservation);
+
+ private:
+  const void* isolate;
+};
+
+}  // namespace
+
+ThreadPool& getCryptoThreadPool() {
+  static ThreadPool pool({.threadCount = 4, .maxQueued = 256});
+  return pool;
+}
+
+kj::Maybe<kj::Own<void>> tryReserveCryptoOffload(jsg::Lock& js) {
+  const void* isolate = js.v8Isolate;
+  {
+    auto lock = getInFlightCounts().lockExclusive();
+    auto& count = lock->findOrCreate(isolate, [&]() -> kj::HashMap<const void*, uint>::Entry {
+      return {isolate, 0};
+    });
+    if (count >= MAX_CRYPTO_OFFLOADS_PER_ISOLATE) return kj::none;
+    ++count;
+  }
+  return kj::Own<void>(kj::heap<Reservation>(isolate));
+}
+
+}  // namespace workerd::api
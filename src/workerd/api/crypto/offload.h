@@ -0,0 +1,63 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/io-context.h>
+#include <workerd/jsg/jsg.h>
+#include <workerd/util/thread-pool.h>
+
+namespace workerd::api {
+
+// How many offloaded crypto operations one isolate may have running or queued at once. Beyond
+// this, offloadCrypto() runs them inline, so that one isolate can't occupy the whole pool.
+constexpr uint MAX_CRYPTO_OFFLOADS_PER_ISOLATE = 2;
+
+// The process-wide pool that offloadCrypto() runs work on.
+ThreadPool& getCryptoThreadPool();
+
+// Reserves one of the current isolate's MAX_CRYPTO_OFFLOADS_PER_ISOLATE slots until the returned
+// object is dropped, or returns none if they are all taken. The object may be dropped on any
+// thread.
+kj::Maybe<kj::Own<void>> tryReserveCryptoOffload(jsg::Lock& js);
+
+// Runs a crypto operation expensive enough to hold up the isolate's event loop -- key derivation
+// with a high work factor, RSA key or prime generation -- on the crypto thread pool, and calls
+// `then(js, result)` back on the isolate thread, in the current IoContext, to turn its result
+// into a JavaScript value.
+//
+// `work` must own copies of everything it reads and must not touch JavaScript. It may throw JSG
+// errors, which reject the returned promise as usual. The CPU time it took is charged to the
+// current request through LimitEnforcer::chargeBackgroundCpuTime().
+//
+// `work` runs inline instead, as if the operation were synchronous, when there is no current
+// IoContext, when the isolate has MAX_CRYPTO_OFFLOADS_PER_ISOLATE operations in flight already,
+// or when the pool's queue is full.
+template <typename T, typename Func>
+jsg::PromiseForResult<Func, T, true> offloadCrypto(
+    jsg::Lock& js, kj::Function<T()> work, Func&& then) {
+  KJ_IF_SOME(context, IoContext::tryCurrent()) {
+    auto maybeReservation = tryReserveCryptoOffload(js);
+    KJ_IF_SOME(reservation, maybeReservation) {
+      // The reservation goes with the work, so that it is released on the pool thread once the
+      // work has run (or been skipped), rather than when the request stops waiting for it.
+      work = [work = kj::mv(work), reservation = kj::mv(reservation)]() mutable {
+        return work();
+      };
+      auto maybePromise = getCryptoThreadPool().tryRun(kj::mv(work));
+      KJ_IF_SOME(promise, maybePromise) {
+        return context.awaitIo(js, kj::mv(promise),
+            [then = kj::fwd<Func>(then)](
+                jsg::Lock& js, ThreadPool::Result<T> result) mutable {
+          IoContext::current().getLimitEnforcer().chargeBackgroundCpuTime(result.cpuTime);
+          return then(js, kj::mv(result.value));
+        });
+      }
+    }
+  }
+
+  return js.evalNow([&] { return then(js, work()); });
+}
+
+}  // namespace workerd::api
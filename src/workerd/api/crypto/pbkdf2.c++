@@ -4,6 +4,7 @@
 
 #include "impl.h"
 #include "kdf.h"
+#include "offload.h"
 
 #include <ncrypto.h>
 
@@ -34,9 +35,16 @@ class Pbkdf2Key final: public CryptoKey::Impl {
   }
 
  private:
-  jsg::JsArrayBuffer deriveBits(jsg::Lock& js,
-      SubtleCrypto::DeriveKeyAlgorithm&& algorithm,
-      kj::Maybe<uint32_t> maybeLength) const override {
+  struct DeriveParams {
+    const EVP_MD* hashType;
+    kj::ArrayPtr<kj::byte> salt;
+    uint32_t iterations;
+    uint32_t lengthBytes;
+  };
+
+  DeriveParams validateDeriveParams(jsg::Lock& js,
+      SubtleCrypto::DeriveKeyAlgorithm& algorithm,
+      kj::Maybe<uint32_t> maybeLength) const {
     kj::StringPtr hashName = api::getAlgorithmName(
         JSG_REQUIRE_NONNULL(algorithm.hash, TypeError, "Missing field \"hash\" in \"algorithm\"."));
     auto hashType = lookupDigestAlgorithm(hashName).second;
@@ -68,10 +76,38 @@ class Pbkdf2Key final: public CryptoKey::Impl {
     JSG_REQUIRE(ncrypto::checkHkdfLength(hashType, derivedLengthBytes), DOMOperationError,
         "Pbkdf2 failed: derived key length exceeds maximum for this hash");
 
-    return JSG_REQUIRE_NONNULL(pbkdf2(js, derivedLengthBytes, iterations, hashType, keyData, salt),
+    return {
+      .hashType = hashType,
+      .salt = salt,
+      .iterations = static_cast<uint32_t>(iterations),
+      .lengthBytes = derivedLengthBytes,
+    };
+  }
+
+  jsg::JsArrayBuffer deriveBits(jsg::Lock& js,
+      SubtleCrypto::DeriveKeyAlgorithm&& algorithm,
+      kj::Maybe<uint32_t> maybeLength) const override {
+    auto params = validateDeriveParams(js, algorithm, maybeLength);
+    return JSG_REQUIRE_NONNULL(pbkdf2(js, params.lengthBytes, params.iterations, params.hashType,
+                                   keyData, params.salt),
         Error, "PBKDF2 deriveBits failed.");
   }
 
+  jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> deriveBitsAsync(jsg::Lock& js,
+      SubtleCrypto::DeriveKeyAlgorithm&& algorithm,
+      kj::Maybe<uint32_t> maybeLength) const override {
+    auto params = validateDeriveParams(js, algorithm, maybeLength);
+    return offloadCrypto<kj::Array<kj::byte>>(js,
+        [hashType = params.hashType, iterations = params.iterations,
+            lengthBytes = params.lengthBytes, salt = kj::heapArray(params.salt.asConst()),
+            keyData = kj::heap<ZeroOnFree>(kj::heapArray(keyData.asPtr()))]() {
+      return JSG_REQUIRE_NONNULL(pbkdf2(lengthBytes, iterations, hashType, *keyData, salt),
+          Error, "PBKDF2 deriveBits failed.");
+    }, [](jsg::Lock& js, kj::Array<kj::byte> bits) {
+      return jsg::JsArrayBuffer::create(js, bits.asPtr()).addRef(js);
+    });
+  }
+
   // TODO(bug): Possibly by mistake, PBKDF2 was historically not on the allow list of
   //   algorithms in exportKey(). Later, the allow list was removed, instead assuming that any
   //   algorithm which implemented this method must be allowed. To maintain exactly the
@@ -121,6 +157,21 @@ kj::Maybe<jsg::JsArrayBuffer> pbkdf2(jsg::Lock& js,
   return kj::none;
 }
 
+kj::Maybe<kj::Array<kj::byte>> pbkdf2(size_t length,
+    size_t iterations,
+    const EVP_MD* digest,
+    kj::ArrayPtr<const kj::byte> password,
+    kj::ArrayPtr<const kj::byte> salt) {
+  ncrypto::ClearErrorOnReturn clearErrorOnReturn;
+  auto buf = kj::heapArray<kj::byte>(length);
+  auto ncBuf = ToNcryptoBuffer(buf.asPtr());
+  if (ncrypto::pbkdf2Into(digest, ToNcryptoBuffer(password.asChars()), ToNcryptoBuffer(salt),
+          iterations, length, &ncBuf)) {
+    return kj::mv(buf);
+  }
+  return kj::none;
+}
+
 kj::Own<CryptoKey::Impl> CryptoKey::Impl::importPbkdf2(jsg::Lock& js,
     kj::StringPtr normalizedName,
     kj::StringPtr format,
@@ -26,6 +26,14 @@ jsg::JsArrayBuffer randomPrime(jsg::Lock& js,
     bool safe,
     kj::Maybe<kj::ArrayPtr<kj::byte>> add_buf,
     kj::Maybe<kj::ArrayPtr<kj::byte>> rem_buf) {
+  auto prime = prepareRandomPrime(size, safe, add_buf, rem_buf)();
+  return jsg::JsArrayBuffer::create(js, prime.asPtr());
+}
+
+kj::Function<kj::Array<kj::byte>()> prepareRandomPrime(uint32_t size,
+    bool safe,
+    kj::Maybe<kj::ArrayPtr<kj::byte>> add_buf,
+    kj::Maybe<kj::ArrayPtr<kj::byte>> rem_buf) {
   ncrypto::ClearErrorOnReturn clearErrorOnReturn;
 
   JSG_REQUIRE(size <= kMaxPrimeBits, RangeError, "generatePrime size exceeds maximum (",
@@ -84,25 +92,30 @@ jsg::JsArrayBuffer randomPrime(jsg::Lock& js,
         "options.add must not be bigger than size of the requested prime");
   }
 
-  // Generating random primes uses the PRNG internally.
-  // Make sure the CSPRNG is properly seeded.
-  JSG_REQUIRE(
-      workerd::api::CSPRNG(nullptr), Error, "Error while generating prime (bad random state)");
-
-  if (auto prime = ncrypto::BignumPointer::NewPrime(
-          {
-            .bits = bits,
-            .safe = safe,
-            .add = kj::mv(add),
-            .rem = kj::mv(rem),
-          },
-          checkLimitEnforcer)) {
-    auto buf = JSG_REQUIRE_NONNULL(
-        bignumToArrayPadded(js, *prime.get()), Error, "Error while generating prime");
-    return jsg::JsArrayBuffer::create(js, buf.asArrayPtr());
-  }
-
-  JSG_FAIL_REQUIRE(Error, "Error while generating prime");
+  return [bits, safe, add = kj::mv(add), rem = kj::mv(rem)]() mutable -> kj::Array<kj::byte> {
+    ncrypto::ClearErrorOnReturn clearErrorOnReturn;
+
+    // Generating random primes uses the PRNG internally.
+    // Make sure the CSPRNG is properly seeded.
+    JSG_REQUIRE(
+        workerd::api::CSPRNG(nullptr), Error, "Error while generating prime (bad random state)");
+
+    // Off the isolate's thread there is no IoContext, so checkLimitEnforcer() can't cut the
+    // search short; size is capped at kMaxPrimeBits above to bound it.
+    if (auto prime = ncrypto::BignumPointer::NewPrime(
+            {
+              .bits = bits,
+              .safe = safe,
+              .add = kj::mv(add),
+              .rem = kj::mv(rem),
+            },
+            checkLimitEnforcer)) {
+      return JSG_REQUIRE_NONNULL(
+          bignumToArrayPadded(*prime.get()), Error, "Error while generating prime");
+    }
+
+    JSG_FAIL_REQUIRE(Error, "Error while generating prime");
+  };
 }
 
 bool checkPrime(kj::ArrayPtr<kj::byte> bufferView, uint32_t num_checks) {
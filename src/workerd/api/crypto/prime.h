@@ -1,6 +1,7 @@
 #pragma once
 
 #include <kj/common.h>
+#include <kj/function.h>
 
 #include <cstdint>
 
@@ -18,6 +19,14 @@ jsg::JsArrayBuffer randomPrime(jsg::Lock& js,
     kj::Maybe<kj::ArrayPtr<kj::byte>> add_buf,
     kj::Maybe<kj::ArrayPtr<kj::byte>> rem_buf);
 
+// Validates the arguments of randomPrime() and returns a function that generates the prime as a
+// big-endian byte array. The function owns everything it needs and doesn't need the isolate, so
+// it may run on another thread.
+kj::Function<kj::Array<kj::byte>()> prepareRandomPrime(uint32_t size,
+    bool safe,
+    kj::Maybe<kj::ArrayPtr<kj::byte>> add_buf,
+    kj::Maybe<kj::ArrayPtr<kj::byte>> rem_buf);
+
 // Checks if the given buffer represents a prime.
 bool checkPrime(kj::ArrayPtr<kj::byte> buffer, uint32_t num_checks);
 
@@ -2,6 +2,7 @@
 
 #include "impl.h"
 #include "keys.h"
+#include "offload.h"
 #include "util.h"
 
 #include <openssl/bn.h>
@@ -820,9 +821,19 @@ kj::Own<EVP_PKEY> rsaJwkReader(SubtleCrypto::JsonWebKey&& keyDataJwk) {
   OSSLCALL(EVP_PKEY_set1_RSA(evpPkey.get(), rsaKey.get()));
   return evpPkey;
 }
-}  // namespace
+struct GeneratedRsaKeys {
+  kj::Own<EVP_PKEY> privateEvpPKey;
+  kj::Own<EVP_PKEY> publicEvpPKey;
+};
 
-kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> CryptoKey::Impl::generateRsa(jsg::Lock& js,
+// generateKey() for RSA, split so that the expensive part can run off-thread. `generate` owns
+// everything it needs and doesn't need the isolate; `finish` wraps its result in CryptoKeys.
+struct RsaKeygen {
+  kj::Function<GeneratedRsaKeys()> generate;
+  kj::Function<CryptoKeyPair(jsg::Lock&, GeneratedRsaKeys)> finish;
+};
+
+RsaKeygen prepareRsaKeygen(jsg::Lock& js,
     kj::StringPtr normalizedName,
     SubtleCrypto::GenerateKeyAlgorithm&& algorithm,
     bool extractable,
@@ -843,7 +854,7 @@ kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> CryptoKey::Impl::generateRsa(jsg::
       "modulusLength must be greater than zero "
       "(requested ",
       modulusLength, ").");
-  auto [normalizedHashName, hashEvpMd] = lookupDigestAlgorithm(hash);
+  auto normalizedHashName = lookupDigestAlgorithm(hash).first;
 
   CryptoKeyUsageSet validUsages = (normalizedName == "RSA-OAEP")
       ? (CryptoKeyUsageSet::encrypt() | CryptoKeyUsageSet::decrypt() |
@@ -865,24 +876,56 @@ kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> CryptoKey::Impl::generateRsa(jsg::
   auto bnExponent = JSG_REQUIRE_NONNULL(toBignum(publicExponent.asArrayPtr()),
       InternalDOMOperationError, "Error setting up RSA keygen.");
 
-  auto rsaPrivateKey = OSSL_NEW(RSA);
-  OSSLCALL(RSA_generate_key_ex(rsaPrivateKey, modulusLength, bnExponent.get(), nullptr));
-  auto privateEvpPKey = OSSL_NEW(EVP_PKEY);
-  OSSLCALL(EVP_PKEY_set1_RSA(privateEvpPKey.get(), rsaPrivateKey.get()));
-  kj::Own<RSA> rsaPublicKey = OSSLCALL_OWN(RSA, RSAPublicKey_dup(rsaPrivateKey.get()),
-      InternalDOMOperationError, "Error finalizing RSA keygen", internalDescribeOpensslErrors());
-  auto publicEvpPKey = OSSL_NEW(EVP_PKEY);
-  OSSLCALL(EVP_PKEY_set1_RSA(publicEvpPKey.get(), rsaPublicKey));
-
-  // Create a JsUint8Array copy of the public exponent for the key algorithm struct.
-  auto expCopy = jsg::JsUint8Array::create(js, publicExponent.asArrayPtr());
-  auto keyAlgorithm = CryptoKey::RsaKeyAlgorithm{.name = normalizedName,
-    .modulusLength = static_cast<uint16_t>(modulusLength),
-    .publicExponent = jsg::JsBufferSource(expCopy).addRef(js),
-    .hash = KeyAlgorithm{normalizedHashName}};
+  return {
+    .generate = [modulusLength, bnExponent = kj::mv(bnExponent)]() -> GeneratedRsaKeys {
+      auto rsaPrivateKey = OSSL_NEW(RSA);
+      OSSLCALL(RSA_generate_key_ex(rsaPrivateKey, modulusLength, bnExponent.get(), nullptr));
+      auto privateEvpPKey = OSSL_NEW(EVP_PKEY);
+      OSSLCALL(EVP_PKEY_set1_RSA(privateEvpPKey.get(), rsaPrivateKey.get()));
+      kj::Own<RSA> rsaPublicKey = OSSLCALL_OWN(RSA, RSAPublicKey_dup(rsaPrivateKey.get()),
+          InternalDOMOperationError, "Error finalizing RSA keygen",
+          internalDescribeOpensslErrors());
+      auto publicEvpPKey = OSSL_NEW(EVP_PKEY);
+      OSSLCALL(EVP_PKEY_set1_RSA(publicEvpPKey.get(), rsaPublicKey));
+      return {.privateEvpPKey = kj::mv(privateEvpPKey), .publicEvpPKey = kj::mv(publicEvpPKey)};
+    },
+    .finish = [normalizedName, normalizedHashName, modulusLength, extractable, usages,
+                  exponent = kj::heapArray(publicExponent.asArrayPtr().asConst())](
+                  jsg::Lock& js, GeneratedRsaKeys keys) {
+      // Create a JsUint8Array copy of the public exponent for the key algorithm struct.
+      auto expCopy = jsg::JsUint8Array::create(js, exponent);
+      auto keyAlgorithm = CryptoKey::RsaKeyAlgorithm{.name = normalizedName,
+        .modulusLength = static_cast<uint16_t>(modulusLength),
+        .publicExponent = jsg::JsBufferSource(expCopy).addRef(js),
+        .hash = KeyAlgorithm{normalizedHashName}};
+
+      return generateRsaPair(js, normalizedName, kj::mv(keys.privateEvpPKey),
+          kj::mv(keys.publicEvpPKey), kj::mv(keyAlgorithm), extractable, usages);
+    },
+  };
+}
+
+}  // namespace
+
+kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> CryptoKey::Impl::generateRsa(jsg::Lock& js,
+    kj::StringPtr normalizedName,
+    SubtleCrypto::GenerateKeyAlgorithm&& algorithm,
+    bool extractable,
+    kj::ArrayPtr<const kj::String> keyUsages) {
+  auto keygen = prepareRsaKeygen(js, normalizedName, kj::mv(algorithm), extractable, keyUsages);
+  return keygen.finish(js, keygen.generate());
+}
 
-  return generateRsaPair(js, normalizedName, kj::mv(privateEvpPKey), kj::mv(publicEvpPKey),
-      kj::mv(keyAlgorithm), extractable, usages);
+jsg::Promise<kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair>> CryptoKey::Impl::generateRsaAsync(
+    jsg::Lock& js,
+    kj::StringPtr normalizedName,
+    SubtleCrypto::GenerateKeyAlgorithm&& algorithm,
+    bool extractable,
+    kj::ArrayPtr<const kj::String> keyUsages) {
+  auto keygen = prepareRsaKeygen(js, normalizedName, kj::mv(algorithm), extractable, keyUsages);
+  return offloadCrypto<GeneratedRsaKeys>(js, kj::mv(keygen.generate),
+      [finish = kj::mv(keygen.finish)](jsg::Lock& js, GeneratedRsaKeys keys) mutable
+      -> kj::OneOf<jsg::Ref<CryptoKey>, CryptoKeyPair> { return finish(js, kj::mv(keys)); });
 }
 
 kj::Own<CryptoKey::Impl> CryptoKey::Impl::importRsa(jsg::Lock& js,
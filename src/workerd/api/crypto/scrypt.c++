@@ -27,4 +27,21 @@ kj::Maybe<jsg::JsArrayBuffer> scrypt(jsg::Lock& js,
   return kj::none;
 }
 
+kj::Maybe<kj::Array<kj::byte>> scrypt(size_t length,
+    uint32_t N,
+    uint32_t r,
+    uint32_t p,
+    uint32_t maxmem,
+    kj::ArrayPtr<const kj::byte> pass,
+    kj::ArrayPtr<const kj::byte> salt) {
+  ncrypto::ClearErrorOnReturn clearErrorOnReturn;
+  auto buf = kj::heapArray<kj::byte>(length);
+  auto ncBuf = ToNcryptoBuffer(buf.asPtr());
+  if (ncrypto::scryptInto(ToNcryptoBuffer(pass.asChars()), ToNcryptoBuffer(salt), N, r, p, maxmem,
+          length, &ncBuf)) {
+    return kj::mv(buf);
+  }
+  return kj::none;
+}
+
 }  // namespace workerd::api
@@ -139,7 +139,7 @@ struct NormalizedFilePath {
 
 Stat::Stat(const workerd::Stat& stat)
     : type(nameForFsType(stat.type)),
-      size(stat.size),
+      size(static_cast<double>(stat.size)),
       lastModified((stat.lastModified - kj::UNIX_EPOCH) / kj::NANOSECONDS),
       created((stat.created - kj::UNIX_EPOCH) / kj::NANOSECONDS),
       writable(stat.writable),
@@ -500,7 +500,10 @@ uint32_t FileSystemModule::write(
         // If the file descriptor is opened in append mode, we ignore the position
         // option and always append to the end of the file.
         auto stat = file->stat(js);
-        return stat.size;
+        if (stat.size > kMax) {
+          node::THROW_ERR_UV_EINVAL(js, "write"_kj, "position out of range"_kj);
+        }
+        return static_cast<uint32_t>(stat.size);
       }
       auto pos = options.position.orDefault(opened->position);
       if (pos > kMax) {
@@ -556,10 +559,9 @@ uint32_t FileSystemModule::read(
 
     KJ_SWITCH_ONEOF(opened->node) {
       KJ_CASE_ONEOF(file, kj::Rc<workerd::File>) {
-        auto pos = options.position.orDefault(opened->position);
-        if (pos > kMax) {
-          node::THROW_ERR_UV_EINVAL(js, "read"_kj, "position out of range"_kj);
-        }
+        // Unlike writes, reads are not limited to 32-bit positions since files
+        // in host directory mounts may be larger than 4GB.
+        uint64_t pos = options.position.orDefault(opened->position);
         uint32_t total = 0;
         for (auto& buffer: data) {
           auto handle = buffer.getHandle(js);
@@ -687,7 +689,11 @@ uint32_t FileSystemModule::writeAll(jsg::Lock& js,
             // If the append option is set, we will write to the end of the file
             // instead of overwriting it.
             if (options.append) {
-              KJ_SWITCH_ONEOF(file->write(js, stat.size, data.asArrayPtr())) {
+              if (stat.size > kMax) {
+                node::THROW_ERR_UV_EINVAL(js, "writeAll"_kj, "position out of range"_kj);
+              }
+              KJ_SWITCH_ONEOF(
+                  file->write(js, static_cast<uint32_t>(stat.size), data.asArrayPtr())) {
                 KJ_CASE_ONEOF(written, uint32_t) {
                   return written;
                 }
@@ -18,7 +18,9 @@ class URL;
 // Metadata about a file, directory, or link.
 struct Stat {
   kj::StringPtr type;  // One of either "file", "directory", or "symlink"
-  uint32_t size;
+  // A double rather than uint32_t since files in host directory mounts may be
+  // larger than 4GB. Sizes up to 2^53 are represented exactly.
+  double size;
   uint64_t lastModified;
   uint64_t created;
   bool writable;
@@ -15,7 +15,7 @@
 #include <kj/vector.h>
 
 #include <algorithm>
-#include <regex>
+#include <functional>
 
 #if !_MSC_VER
 #include <strings.h>
@@ -24,14 +24,38 @@
 namespace workerd::api {
 
 namespace {
-// Like split() in kj/compat/url.c++, but splits at a substring rather than a character.
-kj::ArrayPtr<const char> splitAtSubString(kj::ArrayPtr<const char>& text, kj::StringPtr subString) {
-  // TODO(perf): Use a Boyer-Moore search?
-  auto iter = std::search(text.begin(), text.end(), subString.begin(), subString.end());
-  auto result = kj::arrayPtr(text.begin(), iter - text.begin());
-  text =
-      text.slice(kj::min(text.size(), result.end() - text.begin() + subString.size()), text.size());
-  return result;
+// Finds every occurrence of a fixed delimiter with a Boyer-Moore-Horspool search, which skips
+// ahead by up to the delimiter's length per comparison rather than trying every offset.
+class DelimiterSearcher {
+ public:
+  explicit DelimiterSearcher(kj::ArrayPtr<const char> delimiter)
+      : delimiter(delimiter),
+        searcher(delimiter.begin(), delimiter.end()) {}
+
+  // Like split() in kj/compat/url.c++, but splits at the delimiter rather than a character.
+  kj::ArrayPtr<const char> split(kj::ArrayPtr<const char>& text) const {
+    auto iter = std::search(text.begin(), text.end(), searcher);
+    auto result = kj::arrayPtr(text.begin(), iter - text.begin());
+    text = text.slice(
+        kj::min(text.size(), result.end() - text.begin() + delimiter.size()), text.size());
+    return result;
+  }
+
+ private:
+  kj::ArrayPtr<const char> delimiter;
+  std::boyer_moore_horspool_searcher<const char*> searcher;
+};
+
+// Returns the length of the header block at the start of `text`, including the blank line that
+// terminates it, i.e. up to and including the first "\n\n" or "\n\r\n".
+kj::Maybe<size_t> findHeaderEnd(kj::ArrayPtr<const char> text) {
+  auto pos = text.begin();
+  while (auto newline = static_cast<const char*>(memchr(pos, '\n', text.end() - pos))) {
+    pos = newline + 1;
+    if (pos < text.end() && *pos == '\r') ++pos;
+    if (pos < text.end() && *pos == '\n') return pos + 1 - text.begin();
+  }
+  return kj::none;
 }
 
 struct FormDataHeaderTable {
@@ -133,6 +157,28 @@ void addEscapingQuotes(kj::Vector<char>& builder, kj::StringPtr value) {
   }
 }
 
+// A file part of a buffered body becomes a view of the body, rather than a copy, once it makes up
+// a meaningful share of it. A large upload then doesn't need a second copy, while a small file
+// can't keep a much larger body alive.
+bool shouldShareBody(size_t partSize, size_t bodySize) {
+  constexpr size_t MIN_SHARED_PART_SIZE = 64 * 1024;
+  constexpr size_t MAX_BODY_TO_PART_RATIO = 16;
+  return partSize >= MIN_SHARED_PART_SIZE && partSize * MAX_BODY_TO_PART_RATIO >= bodySize;
+}
+
+// The number of chars addEscapingQuotes() adds for `value`.
+size_t escapedSize(kj::StringPtr value) {
+  size_t size = value.size();
+  for (char c: value) {
+    if (c == '\"' || c == '\n') {
+      size += 2;
+    } else if (c == '\\') {
+      size += 1;
+    }
+  }
+  return size;
+}
+
 void assertUtf8(const auto& params) {
   KJ_IF_SOME(charset, params.find("charset"_kj)) {
     JSG_REQUIRE(strcasecmp(charset.cStr(), "utf-8") == 0 ||
@@ -152,11 +198,12 @@ void FormData::parseFormDataImpl(
   // multipart/form-data messages are delimited by <CRLF>--<boundary>. We want to be able to handle
   // omitted carriage returns, though, so our delimiter only matches against a preceding line feed.
   const auto delimiter = kj::str("\n--", boundary);
+  const DelimiterSearcher searcher(delimiter);
 
   // We want to slice off the delimiter's preceding newline for the initial search, because the very
   // first instance does not require one. In every subsequent multipart message, the preceding
   // newline is required.
-  auto message = splitAtSubString(rawText, delimiter.slice(1));
+  auto message = DelimiterSearcher(delimiter.slice(1)).split(rawText);
 
   JSG_REQUIRE(rawText.size() > 0, TypeError,
       "No initial boundary string (or you have a truncated message).");
@@ -177,22 +224,15 @@ void FormData::parseFormDataImpl(
     return false;
   };
 
-  constexpr auto staticRegexFlags =
-      std::regex_constants::ECMAScript | std::regex_constants::optimize;
-
-  static const auto headerTerminationRegex = std::regex("\r?\n\r?\n", staticRegexFlags);
-
-  std::cmatch match;
-
   auto& formDataHeaderTable = getFormDataHeaderTable();
 
   while (!done(rawText)) {
-    JSG_REQUIRE(std::regex_search(rawText.begin(), rawText.end(), match, headerTerminationRegex),
-        TypeError, "No multipart message header termination found.");
+    auto headersSize = JSG_REQUIRE_NONNULL(
+        findHeaderEnd(rawText), TypeError, "No multipart message header termination found.");
 
     // TODO(cleanup): Use kj-http to parse multipart headers. Right now that API isn't public, so
-    //   I'm just using a regex. For reference, multipart/form-data supports the following three
-    //   headers (https://tools.ietf.org/html/rfc7578#section-4.8):
+    //   I'm just scanning for the blank line. For reference, multipart/form-data supports the
+    //   following three headers (https://tools.ietf.org/html/rfc7578#section-4.8):
     //
     //   Content-Disposition        (required)
     //   Content-Type               (optional, recommended for files)
@@ -200,8 +240,8 @@ void FormData::parseFormDataImpl(
     //
     // TODO(soon): Read the Content-Type to support files.
 
-    auto headersText = kj::str(rawText.first(match[0].second - rawText.begin()));
-    rawText = rawText.slice(match[0].second - rawText.begin(), rawText.size());
+    auto headersText = kj::str(rawText.first(headersSize));
+    rawText = rawText.slice(headersSize, rawText.size());
 
     kj::HttpHeaders headers(*formDataHeaderTable.table);
     JSG_REQUIRE(headers.tryParse(headersText), TypeError, "FormData part had invalid headers.");
@@ -235,7 +275,7 @@ void FormData::parseFormDataImpl(
 
     kj::Maybe<kj::StringPtr> type = headers.get(kj::HttpHeaderId::CONTENT_TYPE);
 
-    message = splitAtSubString(rawText, delimiter);
+    message = searcher.split(rawText);
     JSG_REQUIRE(
         rawText.size() > 0, TypeError, "No subsequent boundary string after multipart message.");
 
@@ -252,6 +292,19 @@ void FormData::parse(jsg::Lock& js,
     kj::ArrayPtr<const char> rawText,
     kj::StringPtr contentType,
     bool convertFilesToStrings) {
+  parseImpl(js, rawText, contentType, convertFilesToStrings, kj::none);
+}
+
+void FormData::parse(
+    jsg::Lock& js, jsg::Ref<Blob> body, kj::StringPtr contentType, bool convertFilesToStrings) {
+  parseImpl(js, body->getData().asChars(), contentType, convertFilesToStrings, body);
+}
+
+void FormData::parseImpl(jsg::Lock& js,
+    kj::ArrayPtr<const char> rawText,
+    kj::StringPtr contentType,
+    bool convertFilesToStrings,
+    kj::Maybe<jsg::Ref<Blob>&> body) {
   KJ_IF_SOME(parsed, MimeType::tryParse(contentType)) {
     auto& params = parsed.params();
     if (MimeType::FORM_DATA == parsed) {
@@ -271,10 +324,19 @@ void FormData::parse(jsg::Lock& js,
               .value = kj::str(kj::mv(messageData)),
             });
           } else {
+            auto type = kj::str(maybeType.orDefault(nullptr));
+            KJ_IF_SOME(b, body) {
+              if (shouldShareBody(message.size(), b->getData().size())) {
+                data.add(FormData::Entry{.name = kj::str(name),
+                  .value = js.alloc<File>(
+                      b.addRef(), message, kj::str(filename), kj::mv(type), dateNow())});
+                return;
+              }
+            }
             auto bytes = jsg::JsArrayBuffer::create(js, message);
             data.add(FormData::Entry{.name = kj::str(name),
-              .value = js.alloc<File>(js, jsg::JsBufferSource(bytes), kj::str(filename),
-                  kj::str(maybeType.orDefault(nullptr)), dateNow())});
+              .value = js.alloc<File>(
+                  js, jsg::JsBufferSource(bytes), kj::str(filename), kj::mv(type), dateNow())});
           }
         } else {
           auto messageData = kj::heapArray<char>(message.asChars());
@@ -314,9 +376,33 @@ kj::Array<kj::byte> FormData::serialize(kj::ArrayPtr<const char> boundary) {
   JSG_REQUIRE(boundary.size() > 0 && boundary.size() <= 70, TypeError,
       "Length of multipart/form-data boundary string must be in the range [1, 70].");
 
-  // TODO(perf): We should be able to trivially calculate the length of the serialized form data
-  //   beforehand. I tried, but apparently my math REALLY sucks and I hate memory overruns, so ...
-  auto builder = kj::Vector<char>{};
+  auto octetStream = MimeType::OCTET_STREAM.toString();
+  auto fileType = [&](File& file) -> kj::StringPtr {
+    auto type = file.getType();
+    return type == nullptr ? octetStream : type;
+  };
+
+  // Compute the exact serialized size up front so the output is allocated once. This must mirror
+  // the builder calls below exactly; the assert at the end checks that it does.
+  size_t size = 0;
+  for (auto& kv: data) {
+    size += "--"_kj.size() + boundary.size() + "\r\n"_kj.size() +
+        "Content-Disposition: form-data; name=\""_kj.size() + escapedSize(kv.name);
+    KJ_SWITCH_ONEOF(kv.value) {
+      KJ_CASE_ONEOF(text, kj::String) {
+        size += "\"\r\n\r\n"_kj.size() + text.size();
+      }
+      KJ_CASE_ONEOF(file, jsg::Ref<File>) {
+        size += "\"; filename=\""_kj.size() + escapedSize(file->getName()) +
+            "\"\r\nContent-Type: "_kj.size() + fileType(*file).size() + "\r\n\r\n"_kj.size() +
+            file->getData().size();
+      }
+    }
+    size += "\r\n"_kj.size();
+  }
+  size += "--"_kj.size() + boundary.size() + "--"_kj.size();
+
+  auto builder = kj::Vector<char>(size);
 
   for (auto& kv: data) {
     builder.addAll("--"_kj);
@@ -333,12 +419,7 @@ kj::Array<kj::byte> FormData::serialize(kj::ArrayPtr<const char> boundary) {
         builder.addAll("\"; filename=\""_kj);
         addEscapingQuotes(builder, file->getName());
         builder.addAll("\"\r\nContent-Type: "_kj);
-        auto type = file->getType();
-        if (type == nullptr) {
-          builder.addAll(MimeType::OCTET_STREAM.toString());
-        } else {
-          builder.addAll(type);
-        }
+        builder.addAll(fileType(*file));
         builder.addAll("\r\n\r\n"_kj);
         builder.addAll(file->getData().asChars());
       }
@@ -349,6 +430,7 @@ kj::Array<kj::byte> FormData::serialize(kj::ArrayPtr<const char> boundary) {
   builder.addAll(boundary);
   builder.addAll("--"_kj);
 
+  KJ_ASSERT(builder.size() == size);
   return builder.releaseAsArray().releaseAsBytes();
 }
 
@@ -65,6 +65,13 @@ public:
              kj::StringPtr contentType,
              bool convertFilesToStrings);
 
+  // Like parse() above, but parses the contents of `body`. Large file parts are created as views of
+  // `body` rather than copied out of it.
+  void parse(jsg::Lock& js,
+             jsg::Ref<Blob> body,
+             kj::StringPtr contentType,
+             bool convertFilesToStrings);
+
   // Given a delimiter string `boundary`, serialize all fields in this form data to an array of
   // bytes suitable for use as an HTTP message body.
   kj::Array<kj::byte> serialize(kj::ArrayPtr<const char> boundary);
@@ -193,6 +200,12 @@ private:
   // of this FormData object.
   kj::Maybe<jsg::ExternalMemoryAdjustment> externalMemoryAdjustment;
 
+  void parseImpl(jsg::Lock& js,
+                 kj::ArrayPtr<const char> rawText,
+                 kj::StringPtr contentType,
+                 bool convertFilesToStrings,
+                 kj::Maybe<jsg::Ref<Blob>&> body);
+
   static EntryType clone(jsg::Lock& js, EntryType& value);
 
   template <typename Type>
@@ -7,6 +7,8 @@
 #include <workerd/util/header-validation.h>
 #include <workerd/util/strings.h>
 
+#include <atomic>
+
 namespace workerd::api {
 
 namespace {
@@ -273,6 +275,84 @@ static_assert(HEADER_HASH_TABLE.find("accept-charset"_kj) == 1);
 static_assert(HEADER_HASH_TABLE.find("AcCePt-ChArSeT"_kj) == 1);
 static_assert(std::size(COMMON_HEADER_NAMES) == (Headers::MAX_COMMON_HEADER_ID + 1));
 
+// Header names registered with Headers::internHeaderNames(), probed like HEADER_HASH_TABLE but
+// built at runtime, with linear probing since the names aren't known in advance. Interned IDs
+// are local to this process: they are never serialized.
+class InternedHeaderTable final {
+ public:
+  explicit InternedHeaderTable(kj::ArrayPtr<const kj::StringPtr> requested) {
+    KJ_REQUIRE(requested.size() <= Headers::MAX_INTERNED_HEADERS, "too many interned headers");
+    for (auto name: requested) {
+      KJ_REQUIRE(name.size() > 0, "invalid header name");
+      for (char c: name) {
+        KJ_REQUIRE(util::isHttpTokenChar(c), "invalid header name", name);
+      }
+      auto hash = caseInsensitiveHash(name);
+      if (HEADER_HASH_TABLE.find(name) != 0 || find(name, hash) != 0) continue;
+
+      names.add(toLower(name));
+      size_t slot = hash % HEADER_MAP_SIZE;
+      while (slots[slot].id != 0) {
+        slot = (slot + 1) % HEADER_MAP_SIZE;
+      }
+      slots[slot] = {hash, static_cast<uint>(names.size())};
+    }
+  }
+
+  // Returns the ID of `name`, in any case, or 0 if it isn't interned.
+  uint find(kj::StringPtr name) const {
+    return find(name, caseInsensitiveHash(name));
+  }
+
+  // The lower-case name for an ID returned by find().
+  kj::StringPtr getName(uint id) const {
+    return names[id - 1];
+  }
+
+  // IDs run from 1 to size().
+  size_t size() const {
+    return names.size();
+  }
+
+ private:
+  struct Slot {
+    uint hash = 0;
+    uint id = 0;
+  };
+
+  kj::Vector<kj::String> names;
+
+  // At most half full, given MAX_INTERNED_HEADERS, so probing always reaches an empty slot.
+  Slot slots[HEADER_MAP_SIZE] = {};
+  static_assert(Headers::MAX_INTERNED_HEADERS * 2 <= HEADER_MAP_SIZE);
+
+  uint find(kj::StringPtr name, uint hash) const {
+    for (size_t slot = hash % HEADER_MAP_SIZE;; slot = (slot + 1) % HEADER_MAP_SIZE) {
+      auto& entry = slots[slot];
+      if (entry.id == 0) return 0;
+      if (entry.hash == hash && strcaseeq(names[entry.id - 1], name)) return entry.id;
+    }
+  }
+};
+
+// Published once by Headers::internHeaderNames() and never modified or freed after, so readers on
+// any thread need only load the pointer.
+std::atomic<const InternedHeaderTable*> internedHeaderTable = nullptr;
+kj::Own<const InternedHeaderTable> ownInternedHeaderTable;
+
+const InternedHeaderTable& getInternedHeaderTable() {
+  auto table = internedHeaderTable.load(std::memory_order_acquire);
+  KJ_ASSERT(table != nullptr, "no header names are interned");
+  return *table;
+}
+
+bool hasUpperCase(kj::StringPtr name) {
+  for (char c: name) {
+    if (isAlphaUpper(c)) return true;
+  }
+  return false;
+}
+
 void maybeWarnIfBadHeaderString(kj::StringPtr name, kj::StringPtr str) {
   KJ_IF_SOME(context, IoContext::tryCurrent()) {
     if (context.hasWarningHandler()) {
@@ -327,21 +407,64 @@ kj::String normalizeHeaderValue(kj::StringPtr name, kj::String value) {
   return kj::str(trimmed.attach(value.releaseArray()));
 }
 
-Headers::HeaderKey getHeaderKeyFor(kj::StringPtr name) {
+// Returns the ID of a common or interned header. Otherwise, validates `name` as an uncommon
+// header name and returns none.
+kj::Maybe<Headers::HeaderKey> getHeaderIdFor(kj::StringPtr name) {
   if (uint commonId = HEADER_HASH_TABLE.find(name)) {
     KJ_DASSERT(commonId > 0 && commonId <= Headers::MAX_COMMON_HEADER_ID);
-    return commonId;
+    return Headers::HeaderKey(commonId);
+  }
+
+  if (auto table = internedHeaderTable.load(std::memory_order_acquire); table != nullptr) {
+    if (uint internedId = table->find(name)) {
+      return Headers::HeaderKey(Headers::InternedId{internedId});
+    }
   }
 
   for (char c: name) {
     JSG_REQUIRE(util::isHttpTokenChar(c), TypeError, "Invalid header name.");
   }
+  return kj::none;
+}
+
+Headers::HeaderKey getHeaderKeyFor(kj::StringPtr name) {
+  KJ_IF_SOME(key, getHeaderIdFor(name)) {
+    return kj::mv(key);
+  }
 
   // Not a common header, so allocate lowercase copy for uncommon header
   return toLower(name);
 }
+
+// Like getHeaderKeyFor(), but an uncommon name is lower-cased in place and moved into the key,
+// leaving `name` empty, instead of being copied. For callers that don't need the name as given.
+Headers::HeaderKey takeHeaderKeyFor(kj::String& name) {
+  KJ_IF_SOME(key, getHeaderIdFor(name)) {
+    return kj::mv(key);
+  }
+  return toLower(kj::mv(name));
+}
 }  // namespace
 
+bool Headers::internHeaderNames(kj::ArrayPtr<const kj::StringPtr> names) {
+  kj::Own<const InternedHeaderTable> table = kj::heap<InternedHeaderTable>(names);
+  const InternedHeaderTable* expected = nullptr;
+  if (!internedHeaderTable.compare_exchange_strong(
+          expected, table.get(), std::memory_order_acq_rel)) {
+    return false;
+  }
+  ownInternedHeaderTable = kj::mv(table);
+  return true;
+}
+
+kj::Maybe<kj::Own<Headers::Header>>& Headers::getInternedSlot(uint id) {
+  if (internedHeaders == nullptr) {
+    internedHeaders =
+        kj::heapArray<kj::Maybe<kj::Own<Header>>>(getInternedHeaderTable().size() + 1);
+  }
+  return internedHeaders[id];
+}
+
 Headers::Headers(jsg::Lock& js, jsg::Dict<kj::String, kj::String> dict): guard(Guard::NONE) {
   // Because the headers might end up in either of our two tables,
   // we can't really reserve space for them up front.
@@ -355,6 +478,11 @@ Headers::Headers(jsg::Lock& js, const Headers& other): guard(Guard::NONE) {
     commonHeaders[i] =
         other.commonHeaders[i].map([](const kj::Own<Header>& h) { return h->clone(); });
   }
+  if (other.internedHeaders != nullptr) {
+    internedHeaders = KJ_MAP(header, other.internedHeaders) {
+      return header.map([](const kj::Own<Header>& h) { return h->clone(); });
+    };
+  }
   uncommonHeaders.reserve(other.uncommonHeaders.size());
   for (auto& [key, header]: other.uncommonHeaders) {
     // It should not be possible to have duplicate keys here.
@@ -379,6 +507,11 @@ kj::Maybe<Headers::Header&> Headers::tryGetHeader(const HeaderKey& key) {
     KJ_CASE_ONEOF(idx, kj::uint) {
       return commonHeaders[idx].map([](kj::Own<Header>& header) -> Header& { return *header; });
     }
+    KJ_CASE_ONEOF(interned, InternedId) {
+      if (interned.id >= internedHeaders.size()) return kj::none;
+      return internedHeaders[interned.id].map(
+          [](kj::Own<Header>& header) -> Header& { return *header; });
+    }
     KJ_CASE_ONEOF(name, kj::String) {
       return uncommonHeaders.find(name).map(
           [](kj::Own<Header>& header) -> Header& { return *header; });
@@ -420,6 +553,17 @@ void Headers::shallowCopyTo(kj::HttpHeaders& out) {
     kj::StringPtr value;
   };
   kj::Vector<Entry> entries(uncommonHeaders.size());
+  for (kj::uint i = 1; i < internedHeaders.size(); i++) {
+    KJ_IF_SOME(header, internedHeaders[i]) {
+      kj::StringPtr name = getInternedHeaderTable().getName(i);
+      KJ_IF_SOME(n, header->name) {
+        name = n;
+      }
+      for (auto& value: header->values) {
+        entries.add(Entry{.name = name, .value = value});
+      }
+    }
+  }
   for (auto& header: uncommonHeaders) {
     KJ_IF_SOME(name, header.value->name) {
       for (auto& value: header.value->values) {
@@ -453,6 +597,9 @@ kj::Array<Headers::DisplayedHeader> Headers::getDisplayedHeaders(jsg::Lock& js)
       }
     }
   }
+  for (auto& header: internedHeaders) {
+    if (header != kj::none) reserved += 1;
+  }
   for (auto& header: uncommonHeaders) {
     reserved += header.value->values.size();
   }
@@ -477,6 +624,15 @@ kj::Array<Headers::DisplayedHeader> Headers::getDisplayedHeaders(jsg::Lock& js)
     }
   }
 
+  for (kj::uint i = 1; i < internedHeaders.size(); i++) {
+    KJ_IF_SOME(header, internedHeaders[i]) {
+      vec.add(Headers::DisplayedHeader{
+        .key = kj::str(getInternedHeaderTable().getName(i)),
+        .value = kj::strArray(header->values, ", "),
+      });
+    }
+  }
+
   for (auto& header: uncommonHeaders) {
     vec.add(Headers::DisplayedHeader{
       .key = kj::str(header.key),
@@ -535,7 +691,9 @@ jsg::Ref<Headers> Headers::constructor(jsg::Lock& js, jsg::Optional<Initializer>
 }
 
 kj::Maybe<kj::String> Headers::get(jsg::Lock& js, kj::String name) {
-  return getPtr(js, name);
+  return tryGetHeader(takeHeaderKeyFor(name)).map([](Header& header) {
+    return kj::strArray(header.values, ", ");
+  });
 }
 
 kj::Maybe<kj::String> Headers::getPtr(jsg::Lock& js, kj::StringPtr name) {
@@ -570,7 +728,7 @@ kj::Array<kj::StringPtr> Headers::getAll(kj::String name) {
 }
 
 bool Headers::has(kj::String name) {
-  return tryGetHeader(getHeaderKeyFor(name)) != kj::none;
+  return tryGetHeader(takeHeaderKeyFor(name)) != kj::none;
 }
 
 bool Headers::hasCommon(capnp::CommonHeaderName idx) {
@@ -586,7 +744,10 @@ void Headers::set(jsg::Lock& js, kj::String name, kj::String value) {
 }
 
 void Headers::setUnguarded(jsg::Lock& js, kj::String name, kj::String value) {
-  KJ_SWITCH_ONEOF(getHeaderKeyFor(name)) {
+  // The name as given only needs keeping, for display, if it isn't lower-case. Otherwise it can
+  // become the key itself.
+  bool keepName = hasUpperCase(name);
+  KJ_SWITCH_ONEOF(keepName ? getHeaderKeyFor(name) : takeHeaderKeyFor(name)) {
     KJ_CASE_ONEOF(id, kj::uint) {
       KJ_IF_SOME(existing, commonHeaders[id]) {
         existing->values.resize(1);
@@ -601,11 +762,26 @@ void Headers::setUnguarded(jsg::Lock& js, kj::String name, kj::String value) {
       }
       return;
     }
+    KJ_CASE_ONEOF(interned, InternedId) {
+      auto& slot = getInternedSlot(interned.id);
+      KJ_IF_SOME(existing, slot) {
+        existing->values.resize(1);
+        existing->values[0] = kj::mv(value);
+      } else {
+        kj::Maybe<kj::String> maybeName;
+        if (keepName) {
+          maybeName = kj::mv(name);
+        }
+        auto& created = slot.emplace(kj::heap(Header(kj::mv(maybeName))));
+        created->values.add(kj::mv(value));
+      }
+      return;
+    }
     KJ_CASE_ONEOF(n, kj::String) {
       using Ret = decltype(uncommonHeaders)::Entry;
       auto& header = uncommonHeaders.findOrCreate(n, [&] -> Ret {
         kj::Maybe<kj::String> maybeName;
-        if (name != n) {
+        if (keepName) {
           maybeName = kj::mv(name);
         }
         return Ret{
@@ -641,7 +817,8 @@ void Headers::append(jsg::Lock& js, kj::String name, kj::String value) {
 }
 
 void Headers::appendUnguarded(jsg::Lock& js, kj::String name, kj::String value) {
-  KJ_SWITCH_ONEOF(getHeaderKeyFor(name)) {
+  bool keepName = hasUpperCase(name);
+  KJ_SWITCH_ONEOF(keepName ? getHeaderKeyFor(name) : takeHeaderKeyFor(name)) {
     KJ_CASE_ONEOF(id, kj::uint) {
       KJ_IF_SOME(existing, commonHeaders[id]) {
         existing->values.add(kj::mv(value));
@@ -655,6 +832,20 @@ void Headers::appendUnguarded(jsg::Lock& js, kj::String name, kj::String value)
       }
       return;
     }
+    KJ_CASE_ONEOF(interned, InternedId) {
+      auto& slot = getInternedSlot(interned.id);
+      KJ_IF_SOME(existing, slot) {
+        existing->values.add(kj::mv(value));
+      } else {
+        kj::Maybe<kj::String> maybeName;
+        if (keepName) {
+          maybeName = kj::mv(name);
+        }
+        auto& created = slot.emplace(kj::heap(Header(kj::mv(maybeName))));
+        created->values.add(kj::mv(value));
+      }
+      return;
+    }
     KJ_CASE_ONEOF(n, kj::String) {
       KJ_IF_SOME(existing, uncommonHeaders.find(n)) {
         existing->values.add(kj::mv(value));
@@ -662,7 +853,7 @@ void Headers::appendUnguarded(jsg::Lock& js, kj::String name, kj::String value)
         using Ret = decltype(uncommonHeaders)::Entry;
         auto& header = uncommonHeaders.findOrCreate(n, [&] -> Ret {
           kj::Maybe<kj::String> maybeName;
-          if (name != n) {
+          if (keepName) {
             maybeName = kj::mv(name);
           }
           return Ret{
@@ -680,11 +871,17 @@ void Headers::appendUnguarded(jsg::Lock& js, kj::String name, kj::String value)
 
 void Headers::delete_(kj::String name) {
   checkGuard();
-  KJ_SWITCH_ONEOF(getHeaderKeyFor(name)) {
+  KJ_SWITCH_ONEOF(takeHeaderKeyFor(name)) {
     KJ_CASE_ONEOF(id, kj::uint) {
       commonHeaders[id] = kj::none;
       return;
     }
+    KJ_CASE_ONEOF(interned, InternedId) {
+      if (interned.id < internedHeaders.size()) {
+        internedHeaders[interned.id] = kj::none;
+      }
+      return;
+    }
     KJ_CASE_ONEOF(n, kj::String) {
       uncommonHeaders.erase(n);
       return;
@@ -774,6 +971,9 @@ void Headers::visitForMemoryInfo(jsg::MemoryTracker& tracker) const {
   for (const auto& header: commonHeaders) {
     tracker.trackField("header", header);
   }
+  for (const auto& header: internedHeaders) {
+    tracker.trackField("header", header);
+  }
   for (const auto& header: uncommonHeaders) {
     tracker.trackField(nullptr, header.value);
   }
@@ -807,6 +1007,11 @@ void Headers::serialize(jsg::Lock& js, jsg::Serializer& serializer) {
       count += h->values.size();
     }
   }
+  for (auto& header: internedHeaders) {
+    KJ_IF_SOME(h, header) {
+      count += h->values.size();
+    }
+  }
   for (auto& header: uncommonHeaders) {
     count += header.value->values.size();
   }
@@ -821,6 +1026,20 @@ void Headers::serialize(jsg::Lock& js, jsg::Serializer& serializer) {
       }
     }
   }
+  // Interned IDs mean nothing to another process, so interned headers are written by name.
+  for (kj::uint i = 1; i < internedHeaders.size(); i++) {
+    KJ_IF_SOME(header, internedHeaders[i]) {
+      kj::StringPtr name = getInternedHeaderTable().getName(i);
+      KJ_IF_SOME(n, header->name) {
+        name = n;
+      }
+      for (auto& value: header->values) {
+        serializer.writeRawUint32(0);
+        serializer.writeLengthDelimited(name);
+        serializer.writeLengthDelimited(value);
+      }
+    }
+  }
   for (auto& header: uncommonHeaders) {
     auto name = ([&] -> kj::StringPtr {
       KJ_IF_SOME(name, header.value->name) {
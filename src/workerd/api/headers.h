@@ -161,13 +161,25 @@ public:
 
   void visitForMemoryInfo(jsg::MemoryTracker& tracker) const;
 
-  // A header is identified by either a common header ID or an uncommon header name.
-  // The header key name is always identifed in lower-case form, while the original
+  // Registers additional header names that Headers objects identify by ID, like the common
+  // headers, rather than by a lower-cased copy of the name. Meant for the custom headers an
+  // application reads or writes on every request (e.g. `x-request-id`). Names that are already
+  // common headers are ignored. Must be called before any Headers object is created, and only
+  // takes effect once per process: returns false, changing nothing, if names were already
+  // registered.
+  static bool internHeaderNames(kj::ArrayPtr<const kj::StringPtr> names);
+
+  // The most names internHeaderNames() accepts.
+  static constexpr size_t MAX_INTERNED_HEADERS = 256;
+
+  struct InternedId {
+    uint id;
+  };
+
+  // A header is identified by either a common header ID, an interned header ID, or an uncommon
+  // header name. The header key name is always identifed in lower-case form, while the original
   // casing is preserved in the actual Header struct to support case-preserving display.
-  // TODO(perf): We can likely optimize this further by interning uncommon header names
-  // so that we avoid repeated allocations of the same uncommon header name. Unless
-  // it proves to be a performance problem, however, we can leave that for future work.
-  using HeaderKey = kj::OneOf<uint, kj::String>;
+  using HeaderKey = kj::OneOf<uint, InternedId, kj::String>;
 
 private:
   struct Header final {
@@ -197,12 +209,17 @@ private:
   // This wastes one slot, but it is a fixed array for fast access.
   kj::FixedArray<kj::Maybe<kj::Own<Header>>, MAX_COMMON_HEADER_ID + 1> commonHeaders;
 
+  // Indexed by interned header ID. Allocated on first use, since most Headers objects never hold
+  // an interned header.
+  kj::Array<kj::Maybe<kj::Own<Header>>> internedHeaders;
+
   // The key is always lower-case.
   kj::HashMap<kj::String, kj::Own<Header>> uncommonHeaders;
 
   Guard guard;
 
   kj::Maybe<Header&> tryGetHeader(const HeaderKey& key);
+  kj::Maybe<kj::Own<Header>>& getInternedSlot(uint id);
 
   void checkGuard() {
     JSG_REQUIRE(guard == Guard::NONE, TypeError, "Can't modify immutable headers.");
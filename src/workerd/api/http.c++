@@ -33,6 +33,8 @@
 #include <kj/memory.h>
 #include <kj/parse/char.h>
 
+#include <simdutf.h>
+
 namespace workerd::api {
 
 namespace {
@@ -57,6 +59,21 @@ jsg::Optional<kj::StringPtr> getCacheModeName(Request::CacheMode mode) {
   KJ_UNREACHABLE;
 }
 
+// Bodies at least this large are handed to V8 without copying when they are ASCII.
+constexpr size_t MIN_EXTERNAL_BODY_TEXT_SIZE = 64 * 1024;
+
+// Converts a body read by text() or json() to a JS string. A large ASCII body, which most JSON
+// is, becomes an external string over the buffer that was read, rather than being copied onto the
+// V8 heap. Anything else is transcoded from UTF-8 once, as usual.
+jsg::JsString bodyTextToJs(jsg::Lock& js, kj::String text) {
+  if (text.size() >= MIN_EXTERNAL_BODY_TEXT_SIZE &&
+      simdutf::validate_ascii(text.begin(), text.size())) {
+    auto content = text.asArray();
+    return jsg::JsString(jsg::newExternalOneByteString(js, content.attach(kj::mv(text))));
+  }
+  return js.str(text);
+}
+
 }  // namespace
 
 // -----------------------------------------------------------------------------
@@ -209,7 +226,7 @@ jsg::Promise<jsg::JsRef<jsg::JsUint8Array>> Body::bytes(jsg::Lock& js) {
   return js.evalNow([&] { return bodyStream.bytes(js, bufferingLimit()); });
 }
 
-jsg::Promise<kj::String> Body::text(jsg::Lock& js) {
+jsg::Promise<kj::String> Body::readText(jsg::Lock& js) {
   // A null body yields an empty string without consulting the IoContext.
   // See https://fetch.spec.whatwg.org/#concept-body-consume-body
   if (bodyStream.isNull()) {
@@ -251,11 +268,14 @@ jsg::Promise<jsg::Ref<FormData>> Body::formData(jsg::Lock& js) {
 
     if (!bodyStream.isNull()) {
       KJ_ASSERT(!bodyStream.isDisturbed(js));
-      return bodyStream.text(js, bufferingLimit())
+      // Read the body into an ArrayBuffer rather than a string so that file parts can be views of
+      // it instead of copies.
+      return bodyStream.arrayBuffer(js, bufferingLimit())
           .then(js,
               [contentType = kj::mv(contentType), formData = kj::mv(formData)](
-                  auto& js, kj::String rawText) mutable {
-        formData->parse(js, kj::mv(rawText), contentType,
+                  jsg::Lock& js, jsg::JsRef<jsg::JsArrayBuffer> buffer) mutable {
+        auto body = js.alloc<Blob>(js, jsg::JsBufferSource(buffer.getHandle(js)), kj::String());
+        formData->parse(js, kj::mv(body), contentType,
             !FeatureFlags::get(js).getFormDataParserSupportsFiles());
         return kj::mv(formData);
       });
@@ -270,8 +290,15 @@ jsg::Promise<jsg::Ref<FormData>> Body::formData(jsg::Lock& js) {
   });
 }
 
+jsg::Promise<jsg::JsRef<jsg::JsString>> Body::text(jsg::Lock& js) {
+  return readText(js).then(js,
+      [](jsg::Lock& js, kj::String text) { return bodyTextToJs(js, kj::mv(text)).addRef(js); });
+}
+
 jsg::Promise<jsg::Value> Body::json(jsg::Lock& js) {
-  return text(js).then(js, [](jsg::Lock& js, kj::String text) { return js.parseJson(text); });
+  return readText(js).then(js, [](jsg::Lock& js, kj::String text) {
+    return js.parseJson(v8::Local<v8::String>(bodyTextToJs(js, kj::mv(text))));
+  });
 }
 
 jsg::Promise<jsg::Ref<Blob>> Body::blob(jsg::Lock& js) {
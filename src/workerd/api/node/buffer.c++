@@ -12,55 +12,60 @@
 #include <workerd/jsg/jsg.h>
 
 #include <kj/array.h>
-#include <kj/encoding.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace workerd::api::node {
 
 namespace {
 
-kj::Maybe<uint> tryFromHexDigit(char c) {
-  if ('0' <= c && c <= '9') {
-    return c - '0';
-  } else if ('a' <= c && c <= 'f') {
-    return c - ('a' - 10);
-  } else if ('A' <= c && c <= 'F') {
-    return c - ('A' - 10);
+// Value of each byte as a hex digit, or 0xff if it isn't one.
+constexpr auto HEX_DIGIT_VALUES = []() {
+  std::array<kj::byte, 256> table{};
+  table.fill(0xff);
+  for (int c = '0'; c <= '9'; ++c) table[c] = c - '0';
+  for (int c = 'a'; c <= 'f'; ++c) table[c] = c - ('a' - 10);
+  for (int c = 'A'; c <= 'F'; ++c) table[c] = c - ('A' - 10);
+  return table;
+}();
+
+// The two lowercase hex digits of each byte.
+constexpr auto HEX_DIGIT_PAIRS = []() {
+  constexpr char digits[] = "0123456789abcdef";
+  std::array<std::array<char, 2>, 256> table{};
+  for (int b = 0; b < 256; ++b) table[b] = {digits[b >> 4], digits[b & 0x0f]};
+  return table;
+}();
+
+// Decodes pairs of hex digits from `text` into `out` until either runs out, returning the number
+// of bytes written. We do not use kj::decodeHex because we need to match Node.js' behavior of
+// truncating the result at the first invalid pair, as opposed to just marking that an error
+// happened and trying to continue with the decode.
+size_t decodeHexInto(kj::ArrayPtr<const kj::byte> text, kj::ArrayPtr<kj::byte> out, bool strict) {
+  size_t count = kj::min(text.size() / 2, out.size());
+  for (size_t i = 0; i < count; ++i) {
+    kj::byte high = HEX_DIGIT_VALUES[text[2 * i]];
+    kj::byte low = HEX_DIGIT_VALUES[text[2 * i + 1]];
+    // Digit values fit in four bits, so this catches either one being invalid.
+    if (KJ_UNLIKELY((high | low) > 0x0f)) {
+      JSG_REQUIRE(!strict, TypeError, "The text is not valid hex");
+      return i;
+    }
+    out[i] = (high << 4) | low;
   }
-  return kj::none;
+  return count;
 }
 
 jsg::JsUint8Array decodeHexTruncated(
     jsg::Lock& js, kj::ArrayPtr<kj::byte> text, bool strict = false) {
-  // We do not use kj::decodeHex because we need to match Node.js'
-  // behavior of truncating the response at the first invalid hex
-  // pair as opposed to just marking that an error happened and
-  // trying to continue with the decode.
   if (text.size() % 2 != 0) {
     JSG_REQUIRE(!strict, TypeError, "The text is not valid hex");
     text = text.first(text.size() - 1);
   }
   auto vec = jsg::JsUint8Array::create(js, text.size() / 2);
-  auto ptr = vec.asArrayPtr();
-  size_t len = 0;
-
-  for (size_t i = 0; i < text.size(); i += 2) {
-    kj::byte b = 0;
-    KJ_IF_SOME(d1, tryFromHexDigit(text[i])) {
-      b = d1 << 4;
-    } else {
-      JSG_REQUIRE(!strict, TypeError, "The text is not valid hex");
-      break;
-    }
-    KJ_IF_SOME(d2, tryFromHexDigit(text[i + 1])) {
-      b |= d2;
-    } else {
-      JSG_REQUIRE(!strict, TypeError, "The text is not valid hex");
-      break;
-    }
-    ptr[len++] = b;
-  }
+  auto len = decodeHexInto(text, vec.asArrayPtr(), strict);
 
   if (len == vec.size()) {
     return vec;
@@ -69,6 +74,22 @@ jsg::JsUint8Array decodeHexTruncated(
   return vec.slice(js, len);
 }
 
+// Fills `dest` with repeated copies of `pattern`, which must not overlap it. Rather than copying
+// the pattern once per repetition, each step copies everything filled so far.
+void fillRepeating(kj::ArrayPtr<kj::byte> dest, kj::ArrayPtr<const kj::byte> pattern) {
+  if (pattern.size() == 1) {
+    memset(dest.begin(), pattern[0], dest.size());
+    return;
+  }
+  size_t filled = kj::min(pattern.size(), dest.size());
+  memcpy(dest.begin(), pattern.begin(), filled);
+  while (filled < dest.size()) {
+    size_t n = kj::min(filled, dest.size() - filled);
+    memcpy(dest.begin() + filled, dest.begin(), n);
+    filled += n;
+  }
+}
+
 uint32_t writeInto(jsg::Lock& js,
     kj::ArrayPtr<kj::byte> buffer,
     jsg::JsString string,
@@ -118,13 +139,10 @@ uint32_t writeInto(jsg::Lock& js,
       return nbytes::Base64Decode(dest.asChars().begin(), dest.size(), str.begin(), str.size());
     }
     case Encoding::HEX: {
-      KJ_STACK_ARRAY(kj::byte, buf, string.length(js), 1024, 536870888);
+      // Only as much of the string as fits in `dest` is needed.
+      KJ_STACK_ARRAY(kj::byte, buf, kj::min(string.length(js), dest.size() * 2), 1024, 536870888);
       string.writeInto(js, buf, flags);
-      auto backing = decodeHexTruncated(js, buf, false);
-      auto bytes = backing.asArrayPtr();
-      auto amountToCopy = kj::min(bytes.size(), dest.size());
-      dest.write(bytes.first(amountToCopy));
-      return amountToCopy;
+      return decodeHexInto(buf, dest, false);
     }
     default:
       KJ_UNREACHABLE;
@@ -283,14 +301,21 @@ void BufferUtil::fillImpl(jsg::Lock& js,
         ptr.fill(0);
         return;
       }
-      ptr.fill(decoded.asArrayPtr());
+      fillRepeating(ptr, decoded.asArrayPtr());
     }
     KJ_CASE_ONEOF(source, jsg::JsUint8Array) {
       if (source.size() == 0) {
         ptr.fill(0);
         return;
       }
-      ptr.fill(source.asArrayPtr());
+      auto pattern = source.asArrayPtr();
+      if (pattern.end() > ptr.begin() && pattern.begin() < ptr.end()) {
+        // The source overlaps the range being filled, e.g. `buf.fill(buf.subarray(...))`.
+        auto copy = kj::heapArray<kj::byte>(pattern);
+        fillRepeating(ptr, copy);
+        return;
+      }
+      fillRepeating(ptr, pattern);
     }
   }
 }
@@ -434,11 +459,16 @@ jsg::JsString toStringImpl(
   if (slice.size() == 0) return js.str();
   switch (encoding) {
     case Encoding::ASCII: {
-      // TODO(perf): We can look at making this more performant later.
-      // Essentially we have to modify the buffer such that every byte
-      // has the highest bit turned off. Whee! Node.js has a faster
-      // algorithm that it implements so we can likely adopt that.
-      kj::Array<kj::byte> copy = KJ_MAP(b, slice) -> kj::byte { return b & 0x7f; };
+      // Input is usually ASCII already, and then it can be used as is.
+      if (simdutf::validate_ascii(slice.asChars().begin(), slice.size())) {
+        return js.str(slice);
+      }
+      // Otherwise every byte has its highest bit turned off. (This loop is simple enough for the
+      // compiler to vectorize.)
+      KJ_STACK_ARRAY(kj::byte, copy, slice.size(), 1024, 4096);
+      for (auto i: kj::indices(slice)) {
+        copy[i] = slice[i] & 0x7f;
+      }
       return js.str(copy);
     }
     case Encoding::LATIN1: {
@@ -448,14 +478,14 @@ jsg::JsString toStringImpl(
       return js.str(slice.asChars());
     }
     case Encoding::UTF16LE: {
-      // Why are we copying here? Good question! There's really not much of a
-      // good reason why we should be copying here except that V8 doesn't seem
-      // to like it! We end up with an asan buffer over-read error if we pass
-      // in the slice directly... looks to have something to do with alignment
-      // issues. Copying here sidesteps the problem and avoids the asan issue.
       kj::ArrayPtr<uint16_t> view(reinterpret_cast<uint16_t*>(slice.begin()), slice.size() / 2);
+      if (reinterpret_cast<uintptr_t>(slice.begin()) % alignof(uint16_t) == 0) {
+        return js.str(view);
+      }
+      // V8 doesn't like being passed unaligned two-byte data (we end up with an asan buffer
+      // over-read error), so copy that to aligned memory first.
       KJ_STACK_ARRAY(uint16_t, data, view.size(), 1024, 4096);
-      data.copyFrom(view);
+      memcpy(data.begin(), slice.begin(), view.size() * sizeof(uint16_t));
       return js.str(data);
     }
     case Encoding::BASE64: {
@@ -474,7 +504,11 @@ jsg::JsString toStringImpl(
       return js.str(out);
     }
     case Encoding::HEX: {
-      return js.str(kj::encodeHex(slice));
+      KJ_STACK_ARRAY(kj::byte, out, slice.size() * 2, 1024, 4096);
+      for (auto i: kj::indices(slice)) {
+        memcpy(out.begin() + 2 * i, HEX_DIGIT_PAIRS[slice[i]].data(), 2);
+      }
+      return js.str(out);
     }
     default:
       KJ_UNREACHABLE;
@@ -7,6 +7,7 @@
 #include <workerd/api/crypto/impl.h>
 #include <workerd/api/crypto/jwk.h>
 #include <workerd/api/crypto/keys.h>
+#include <workerd/api/crypto/offload.h>
 
 #include <ncrypto.h>
 #include <openssl/crypto.h>
@@ -594,7 +595,11 @@ jsg::Ref<CryptoKey> CryptoImpl::createPublicKey(jsg::Lock& js, CreateAsymmetricK
   KJ_UNREACHABLE;
 }
 
-CryptoKeyPair CryptoImpl::generateRsaKeyPair(jsg::Lock& js, RsaKeyPairOptions options) {
+namespace {
+// Validates `options` and returns a function that generates the key. The function owns its
+// keygen context and doesn't need the isolate, so that it can run off-thread.
+kj::Function<ncrypto::EVPKeyPointer()> prepareRsaKeygen(
+    const CryptoImpl::RsaKeyPairOptions& options) {
   ncrypto::ClearErrorOnReturn clearErrorOnReturn;
 
   // Matches the WebCrypto validateRsaParams bound. Consider lowering both to 8192.
@@ -647,12 +652,16 @@ CryptoKeyPair CryptoImpl::generateRsaKeyPair(jsg::Lock& js, RsaKeyPairOptions op
   //   }
   // }
 
-  // Generate the key
-  EVP_PKEY* pkey = nullptr;
-  JSG_REQUIRE(EVP_PKEY_keygen(ctx.get(), &pkey), Error, "Failed to generate key");
-
-  auto generated = ncrypto::EVPKeyPointer(pkey);
+  return [ctx = kj::mv(ctx)]() mutable {
+    ncrypto::ClearErrorOnReturn clearErrorOnReturn;
+    EVP_PKEY* pkey = nullptr;
+    JSG_REQUIRE(EVP_PKEY_keygen(ctx.get(), &pkey), Error, "Failed to generate key");
+    return ncrypto::EVPKeyPointer(pkey);
+  };
+}
 
+// Wraps a key pair generated by one of the prepare*Keygen() functions.
+CryptoKeyPair generatedKeyPair(jsg::Lock& js, ncrypto::EVPKeyPointer generated) {
   auto publicKey = AsymmetricKey::NewPublic(generated.clone());
   JSG_REQUIRE(publicKey, Error, "Failed to create public key");
   auto privateKey = AsymmetricKey::NewPrivate(kj::mv(generated));
@@ -663,6 +672,17 @@ CryptoKeyPair CryptoImpl::generateRsaKeyPair(jsg::Lock& js, RsaKeyPairOptions op
     .privateKey = js.alloc<CryptoKey>(kj::mv(privateKey)),
   };
 }
+}  // namespace
+
+CryptoKeyPair CryptoImpl::generateRsaKeyPair(jsg::Lock& js, RsaKeyPairOptions options) {
+  return generatedKeyPair(js, prepareRsaKeygen(options)());
+}
+
+jsg::Promise<CryptoKeyPair> CryptoImpl::generateRsaKeyPairAsync(
+    jsg::Lock& js, RsaKeyPairOptions options) {
+  return offloadCrypto<ncrypto::EVPKeyPointer>(js, prepareRsaKeygen(options),
+      [](jsg::Lock& js, ncrypto::EVPKeyPointer key) { return generatedKeyPair(js, kj::mv(key)); });
+}
 
 CryptoKeyPair CryptoImpl::generateDsaKeyPair(jsg::Lock& js, DsaKeyPairOptions options) {
   // TODO(later): BoringSSL does not implement DSA key generation using
@@ -776,8 +796,10 @@ CryptoKeyPair CryptoImpl::generateEdKeyPair(jsg::Lock& js, EdKeyPairOptions opti
   };
 }
 
-CryptoKeyPair CryptoImpl::generateDhKeyPair(jsg::Lock& js, DhKeyPairOptions options) {
-
+namespace {
+// Like prepareRsaKeygen(), for DH. The prime or group is resolved here, on the isolate thread.
+kj::Function<ncrypto::EVPKeyPointer()> prepareDhKeygen(
+    jsg::Lock& js, const CryptoImpl::DhKeyPairOptions& options) {
   // TODO(soon): Older versions of boringssl+fips do not support EVP with
   // DH key pairs that are required to make the following work. A compile
   // flag is used to disable the mechanism in ncrypto, causing the calls
@@ -835,21 +857,23 @@ CryptoKeyPair CryptoImpl::generateDhKeyPair(jsg::Lock& js, DhKeyPairOptions opti
   JSG_REQUIRE(ctx, Error, "Failed to create keygen context");
   JSG_REQUIRE(ctx.initForKeygen(), Error, "Failed to initialize keygen context");
 
-  // Generate the key
-  EVP_PKEY* pkey = nullptr;
-  JSG_REQUIRE(EVP_PKEY_keygen(ctx.get(), &pkey), Error, "Failed to generate key");
-
-  auto generated = ncrypto::EVPKeyPointer(pkey);
+  return [ctx = kj::mv(ctx)]() mutable {
+    ncrypto::ClearErrorOnReturn clearErrorOnReturn;
+    EVP_PKEY* pkey = nullptr;
+    JSG_REQUIRE(EVP_PKEY_keygen(ctx.get(), &pkey), Error, "Failed to generate key");
+    return ncrypto::EVPKeyPointer(pkey);
+  };
+}
+}  // namespace
 
-  auto publicKey = AsymmetricKey::NewPublic(generated.clone());
-  JSG_REQUIRE(publicKey, Error, "Failed to create public key");
-  auto privateKey = AsymmetricKey::NewPrivate(kj::mv(generated));
-  JSG_REQUIRE(privateKey, Error, "Failed to create private key");
+CryptoKeyPair CryptoImpl::generateDhKeyPair(jsg::Lock& js, DhKeyPairOptions options) {
+  return generatedKeyPair(js, prepareDhKeygen(js, options)());
+}
 
-  return CryptoKeyPair{
-    .publicKey = js.alloc<CryptoKey>(kj::mv(publicKey)),
-    .privateKey = js.alloc<CryptoKey>(kj::mv(privateKey)),
-  };
+jsg::Promise<CryptoKeyPair> CryptoImpl::generateDhKeyPairAsync(
+    jsg::Lock& js, DhKeyPairOptions options) {
+  return offloadCrypto<ncrypto::EVPKeyPointer>(js, prepareDhKeygen(js, options),
+      [](jsg::Lock& js, ncrypto::EVPKeyPointer key) { return generatedKeyPair(js, kj::mv(key)); });
 }
 
 jsg::JsUint8Array CryptoImpl::statelessDH(
@@ -6,6 +6,7 @@
 #include <workerd/api/crypto/digest.h>
 #include <workerd/api/crypto/impl.h>
 #include <workerd/api/crypto/kdf.h>
+#include <workerd/api/crypto/offload.h>
 #include <workerd/api/crypto/prime.h>
 #include <workerd/api/crypto/spkac.h>
 #include <workerd/jsg/jsg.h>
@@ -30,6 +31,9 @@ kj::ArrayPtr<kj::byte> nonNullBytes(kj::ArrayPtr<kj::byte> ptr) {
 // ======================================================================================
 #pragma region KDF
 
+// Unlike PBKDF2 and scrypt, HKDF has no work factor: its output is capped at 255 digests, so it
+// is a few hundred HMAC calls at most and stays synchronous rather than going through
+// offloadCrypto().
 jsg::JsArrayBuffer CryptoImpl::getHkdf(jsg::Lock& js,
     kj::String hash,
     jsg::JsBufferSource key,
@@ -58,12 +62,13 @@ jsg::JsArrayBuffer CryptoImpl::getHkdf(jsg::Lock& js,
       Error, "Hkdf failed");
 }
 
-jsg::JsArrayBuffer CryptoImpl::getPbkdf(jsg::Lock& js,
-    jsg::JsBufferSource password,
-    jsg::JsBufferSource salt,
+namespace {
+const EVP_MD* validatePbkdf(jsg::Lock& js,
+    jsg::JsBufferSource& password,
+    jsg::JsBufferSource& salt,
     uint32_t num_iterations,
     uint32_t keylen,
-    kj::String name) {
+    kj::StringPtr name) {
   // The Node.js version of the PBKDF2 is a bit different from the Web Crypto API.
   // For one, the Node.js implementation allows for a broader range of possible
   // digest algorithms whereas the Web Crypto API only allows for a few specific ones.
@@ -80,13 +85,51 @@ jsg::JsArrayBuffer CryptoImpl::getPbkdf(jsg::Lock& js,
   checkPbkdfLimits(js, num_iterations);
   JSG_REQUIRE(ncrypto::checkHkdfLength(digest, keylen), RangeError,
       "Pbkdf2 failed: derived key length exceeds maximum for this hash");
+  return digest;
+}
 
+void validateScrypt(jsg::Lock& js,
+    jsg::JsBufferSource& password,
+    jsg::JsBufferSource& salt,
+    uint32_t N,
+    uint32_t r,
+    uint32_t p) {
+  JSG_REQUIRE(password.size() <= INT32_MAX, RangeError, "Scrypt failed: password is too large");
+  JSG_REQUIRE(salt.size() <= INT32_MAX, RangeError, "Scrypt failed: salt is too large");
+  checkScryptLimits(js, N, r, p);
+}
+}  // namespace
+
+jsg::JsArrayBuffer CryptoImpl::getPbkdf(jsg::Lock& js,
+    jsg::JsBufferSource password,
+    jsg::JsBufferSource salt,
+    uint32_t num_iterations,
+    uint32_t keylen,
+    kj::String name) {
+  auto digest = validatePbkdf(js, password, salt, num_iterations, keylen, name);
   return JSG_REQUIRE_NONNULL(
       api::pbkdf2(js, keylen, num_iterations, digest, nonNullBytes(password.asArrayPtr()),
           nonNullBytes(salt.asArrayPtr())),
       Error, "Pbkdf2 failed");
 }
 
+jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> CryptoImpl::getPbkdfAsync(jsg::Lock& js,
+    jsg::JsBufferSource password,
+    jsg::JsBufferSource salt,
+    uint32_t num_iterations,
+    uint32_t keylen,
+    kj::String name) {
+  auto digest = validatePbkdf(js, password, salt, num_iterations, keylen, name);
+  return offloadCrypto<kj::Array<kj::byte>>(js,
+      [keylen, num_iterations, digest, password = password.copy(), salt = salt.copy()]() mutable {
+    return JSG_REQUIRE_NONNULL(api::pbkdf2(keylen, num_iterations, digest,
+                                   nonNullBytes(password.asPtr()), nonNullBytes(salt.asPtr())),
+        Error, "Pbkdf2 failed");
+  }, [](jsg::Lock& js, kj::Array<kj::byte> result) {
+    return jsg::JsArrayBuffer::create(js, result.asPtr()).addRef(js);
+  });
+}
+
 jsg::JsArrayBuffer CryptoImpl::getScrypt(jsg::Lock& js,
     jsg::JsBufferSource password,
     jsg::JsBufferSource salt,
@@ -95,15 +138,31 @@ jsg::JsArrayBuffer CryptoImpl::getScrypt(jsg::Lock& js,
     uint32_t p,
     uint32_t maxmem,
     uint32_t keylen) {
-  JSG_REQUIRE(password.size() <= INT32_MAX, RangeError, "Scrypt failed: password is too large");
-  JSG_REQUIRE(salt.size() <= INT32_MAX, RangeError, "Scrypt failed: salt is too large");
-  checkScryptLimits(js, N, r, p);
-
+  validateScrypt(js, password, salt, N, r, p);
   return JSG_REQUIRE_NONNULL(
       api::scrypt(js, keylen, N, r, p, maxmem, nonNullBytes(password.asArrayPtr()),
           nonNullBytes(salt.asArrayPtr())),
       Error, "Scrypt failed");
 }
+
+jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> CryptoImpl::getScryptAsync(jsg::Lock& js,
+    jsg::JsBufferSource password,
+    jsg::JsBufferSource salt,
+    uint32_t N,
+    uint32_t r,
+    uint32_t p,
+    uint32_t maxmem,
+    uint32_t keylen) {
+  validateScrypt(js, password, salt, N, r, p);
+  return offloadCrypto<kj::Array<kj::byte>>(js,
+      [keylen, N, r, p, maxmem, password = password.copy(), salt = salt.copy()]() mutable {
+    return JSG_REQUIRE_NONNULL(api::scrypt(keylen, N, r, p, maxmem,
+                                   nonNullBytes(password.asPtr()), nonNullBytes(salt.asPtr())),
+        Error, "Scrypt failed");
+  }, [](jsg::Lock& js, kj::Array<kj::byte> result) {
+    return jsg::JsArrayBuffer::create(js, result.asPtr()).addRef(js);
+  });
+}
 #pragma endregion  // KDF
 
 // ======================================================================================
@@ -136,6 +195,22 @@ jsg::JsArrayBuffer CryptoImpl::randomPrime(jsg::Lock& js,
           [&](jsg::JsBufferSource& buf) mutable { return nonNullBytes(buf.asArrayPtr()); }));
 }
 
+jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> CryptoImpl::randomPrimeAsync(jsg::Lock& js,
+    uint32_t size,
+    bool safe,
+    jsg::Optional<jsg::JsBufferSource> add_buf,
+    jsg::Optional<jsg::JsBufferSource> rem_buf) {
+  return offloadCrypto<kj::Array<kj::byte>>(js,
+      workerd::api::prepareRandomPrime(size, safe,
+          add_buf.map(
+              [&](jsg::JsBufferSource& buf) mutable { return nonNullBytes(buf.asArrayPtr()); }),
+          rem_buf.map(
+              [&](jsg::JsBufferSource& buf) mutable { return nonNullBytes(buf.asArrayPtr()); })),
+      [](jsg::Lock& js, kj::Array<kj::byte> result) {
+    return jsg::JsArrayBuffer::create(js, result.asPtr()).addRef(js);
+  });
+}
+
 bool CryptoImpl::checkPrimeSync(
     jsg::Lock& js, jsg::JsBufferSource bufferView, uint32_t num_checks) {
   return workerd::api::checkPrime(nonNullBytes(bufferView.asArrayPtr()), num_checks);
@@ -63,6 +63,12 @@ class CryptoImpl final: public jsg::Object {
       bool safe,
       jsg::Optional<jsg::JsBufferSource> add,
       jsg::Optional<jsg::JsBufferSource> rem);
+  // Like randomPrime(), but generates the prime on a background thread where possible.
+  jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> randomPrimeAsync(jsg::Lock& js,
+      uint32_t size,
+      bool safe,
+      jsg::Optional<jsg::JsBufferSource> add,
+      jsg::Optional<jsg::JsBufferSource> rem);
   bool checkPrimeSync(jsg::Lock& js, jsg::JsBufferSource bufferView, uint32_t num_checks);
 
   // Hash
@@ -136,6 +142,13 @@ class CryptoImpl final: public jsg::Object {
       uint32_t num_iterations,
       uint32_t keylen,
       kj::String name);
+  // Like getPbkdf(), but derives the key on a background thread where possible.
+  jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> getPbkdfAsync(jsg::Lock& js,
+      jsg::JsBufferSource password,
+      jsg::JsBufferSource salt,
+      uint32_t num_iterations,
+      uint32_t keylen,
+      kj::String name);
 
   // Scrypt
   jsg::JsArrayBuffer getScrypt(jsg::Lock& js,
@@ -146,6 +159,15 @@ class CryptoImpl final: public jsg::Object {
       uint32_t p,
       uint32_t maxmem,
       uint32_t keylen);
+  // Like getScrypt(), but derives the key on a background thread where possible.
+  jsg::Promise<jsg::JsRef<jsg::JsArrayBuffer>> getScryptAsync(jsg::Lock& js,
+      jsg::JsBufferSource password,
+      jsg::JsBufferSource salt,
+      uint32_t N,
+      uint32_t r,
+      uint32_t p,
+      uint32_t maxmem,
+      uint32_t keylen);
 
   // Keys
   struct KeyExportOptions {
@@ -250,10 +272,14 @@ class CryptoImpl final: public jsg::Object {
   };
 
   CryptoKeyPair generateRsaKeyPair(jsg::Lock& js, RsaKeyPairOptions options);
+  // Like generateRsaKeyPair(), but generates the key on a background thread where possible.
+  jsg::Promise<CryptoKeyPair> generateRsaKeyPairAsync(jsg::Lock& js, RsaKeyPairOptions options);
   CryptoKeyPair generateDsaKeyPair(jsg::Lock& js, DsaKeyPairOptions options);
   CryptoKeyPair generateEcKeyPair(jsg::Lock& js, EcKeyPairOptions options);
   CryptoKeyPair generateEdKeyPair(jsg::Lock& js, EdKeyPairOptions options);
   CryptoKeyPair generateDhKeyPair(jsg::Lock& js, DhKeyPairOptions options);
+  // Like generateDhKeyPair(), but generates the key on a background thread where possible.
+  jsg::Promise<CryptoKeyPair> generateDhKeyPairAsync(jsg::Lock& js, DhKeyPairOptions options);
 
   // Sign/Verify
   class SignHandle final: public jsg::Object {
@@ -548,6 +574,7 @@ class CryptoImpl final: public jsg::Object {
     JSG_NESTED_TYPE(ECDHHandle);
     // Primes
     JSG_METHOD(randomPrime);
+    JSG_METHOD(randomPrimeAsync);
     JSG_METHOD(checkPrimeSync);
     // Hash and Hmac
     JSG_NESTED_TYPE(HashHandle);
@@ -556,8 +583,10 @@ class CryptoImpl final: public jsg::Object {
     JSG_METHOD(getHkdf);
     // Pbkdf2
     JSG_METHOD(getPbkdf);
+    JSG_METHOD(getPbkdfAsync);
     // Scrypt
     JSG_METHOD(getScrypt);
+    JSG_METHOD(getScryptAsync);
     // Keys
     JSG_METHOD(exportKey);
     JSG_METHOD(equals);
@@ -574,10 +603,12 @@ class CryptoImpl final: public jsg::Object {
     JSG_NESTED_TYPE(X509Certificate);
     // Key generation
     JSG_METHOD(generateRsaKeyPair);
+    JSG_METHOD(generateRsaKeyPairAsync);
     JSG_METHOD(generateDsaKeyPair);
     JSG_METHOD(generateEcKeyPair);
     JSG_METHOD(generateEdKeyPair);
     JSG_METHOD(generateDhKeyPair);
+    JSG_METHOD(generateDhKeyPairAsync);
     // Sign/Verify
     JSG_NESTED_TYPE(SignHandle);
     JSG_NESTED_TYPE(VerifyHandle);
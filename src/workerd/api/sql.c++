@@ -8,6 +8,8 @@
 
 #include <workerd/io/io-context.h>
 
+#include <kj/map.h>
+
 #if _WIN32
 #define strncasecmp _strnicmp
 #else
@@ -23,6 +25,49 @@ namespace workerd::api {
 // queries containing dynamic content or excessively large one-off queries.
 static constexpr uint SQL_STATEMENT_CACHE_MAX_SIZE = 1024 * 1024;
 
+// Maximum number of columns for which row objects are created from a DictionaryTemplate. Rows
+// with more columns than this have their properties set one at a time.
+static constexpr uint MAX_ROW_TEMPLATE_COLUMNS = 64;
+
+namespace {
+
+// Returns true if a row with these column names can be created from a DictionaryTemplate, i.e.
+// each name becomes its own ordinary data property. Names that collide (e.g. `SELECT *` across a
+// join), that look like array indices, or that would set the prototype keep the historical
+// per-property behavior instead. Non-ASCII names are also excluded to avoid any question of how
+// V8 interprets the bytes we hand it.
+bool canUseRowTemplate(kj::ArrayPtr<const kj::String> names) {
+  if (names.size() > MAX_ROW_TEMPLATE_COLUMNS) {
+    return false;
+  }
+
+  kj::HashSet<kj::StringPtr> seen;
+  for (auto& name: names) {
+    if (name == "__proto__") {
+      return false;
+    }
+
+    bool allDigits = name.size() > 0;
+    for (char c: name) {
+      if (static_cast<kj::byte>(c) >= 0x80) {
+        return false;
+      }
+      allDigits = allDigits && '0' <= c && c <= '9';
+    }
+    if (allDigits) {
+      return false;
+    }
+
+    if (seen.contains(name)) {
+      return false;
+    }
+    seen.insert(name);
+  }
+  return true;
+}
+
+}  // namespace
+
 SqlStorage::SqlStorage(jsg::Ref<DurableObjectStorage> storage)
     : storage(kj::mv(storage)),
       statementCache(IoContext::current().addObject(kj::heap<StatementCache>())) {}
@@ -138,6 +183,28 @@ double SqlStorage::getDatabaseSize(jsg::Lock& js) {
   return dbSize;
 }
 
+kj::Array<SqlStorage::StatementStats> SqlStorage::getStatementStats(jsg::Lock& js) {
+  KJ_IF_SOME(stats, getDb(js).getStatementStats()) {
+    kj::Vector<StatementStats> result;
+    for (auto& entry: stats.getEntries()) {
+      auto& counters = entry.counters;
+      if (counters.internal) continue;
+      result.add(StatementStats{
+        .sql = kj::mv(entry.sql),
+        .calls = static_cast<double>(counters.calls),
+        .totalTimeMs = counters.totalTime / kj::NANOSECONDS / 1e6,
+        .maxTimeMs = counters.maxTime / kj::NANOSECONDS / 1e6,
+        .rowsRead = static_cast<double>(counters.rowsRead),
+        .rowsWritten = static_cast<double>(counters.rowsWritten),
+        .cacheHits = static_cast<double>(counters.cacheHits),
+      });
+    }
+    return result.releaseAsArray();
+  } else {
+    return nullptr;
+  }
+}
+
 bool SqlStorageRegulator::isAllowedName(kj::StringPtr name) const {
   return name.size() < 4 || strncasecmp(name.begin(), "_cf_", 4) != 0;
 }
@@ -216,6 +283,9 @@ SqlStorage::Cursor::~Cursor() noexcept(false) {
 void SqlStorage::Cursor::initColumnNames(jsg::Lock& js, State& stateRef) {
   KJ_IF_SOME(cached, stateRef.cachedStatement) {
     reusedCachedQuery = cached->useCount++ > 0;
+    if (reusedCachedQuery) {
+      stateRef.query.setStatementCacheHit();
+    }
   }
 
   js.withinHandleScope([&]() {
@@ -225,9 +295,53 @@ void SqlStorage::Cursor::initColumnNames(jsg::Lock& js, State& stateRef) {
     }
     auto array = jsg::JsArray(v8::Array::New(js.v8Isolate, vec.data(), vec.size()));
     columnNames = jsg::JsRef<jsg::JsArray>(js, array);
+    rowTemplate = getRowTemplate(js, stateRef);
   });
 }
 
+kj::Maybe<jsg::V8Ref<v8::DictionaryTemplate>> SqlStorage::Cursor::getRowTemplate(
+    jsg::Lock& js, State& stateRef) {
+  auto& query = stateRef.query;
+  auto n = query.columnCount();
+
+  KJ_IF_SOME(cached, stateRef.cachedStatement) {
+    KJ_IF_SOME(existing, cached->rowTemplate) {
+      bool matches = existing.columnNames.size() == n;
+      for (uint i = 0; matches && i < n; i++) {
+        matches = existing.columnNames[i] == query.getColumnName(i);
+      }
+      if (matches) {
+        return existing.tmpl.map(
+            [&](jsg::V8Ref<v8::DictionaryTemplate>& tmpl) { return tmpl.addRef(js); });
+      }
+    }
+  }
+
+  auto names = kj::heapArrayBuilder<kj::String>(n);
+  for (auto i: kj::zeroTo(n)) {
+    names.add(kj::str(query.getColumnName(i)));
+  }
+  auto columnNames = names.finish();
+
+  kj::Maybe<jsg::V8Ref<v8::DictionaryTemplate>> result;
+  if (canUseRowTemplate(columnNames)) {
+    std::string_view views[MAX_ROW_TEMPLATE_COLUMNS];
+    for (auto i: kj::indices(columnNames)) {
+      views[i] = std::string_view(columnNames[i].begin(), columnNames[i].size());
+    }
+    result = js.v8Ref(v8::DictionaryTemplate::New(
+        js.v8Isolate, v8::MemorySpan<const std::string_view>(views, columnNames.size())));
+  }
+
+  KJ_IF_SOME(cached, stateRef.cachedStatement) {
+    cached->rowTemplate = RowTemplate{
+      .columnNames = kj::mv(columnNames),
+      .tmpl = result.map([&](jsg::V8Ref<v8::DictionaryTemplate>& tmpl) { return tmpl.addRef(js); }),
+    };
+  }
+  return result;
+}
+
 double SqlStorage::Cursor::getRowsRead() {
   KJ_IF_SOME(st, state) {
     return static_cast<double>(st->query.getRowsRead());
@@ -284,6 +398,62 @@ jsg::JsArray SqlStorage::Cursor::toArray(jsg::Lock& js) {
   return jsg::JsArray(v8::Array::New(js.v8Isolate, results.data(), results.size()));
 }
 
+jsg::JsArray SqlStorage::Cursor::toColumns(jsg::Lock& js) {
+  auto self = JSG_THIS;
+  auto& limitEnforcer = Worker::Isolate::from(js).getLimitEnforcer();
+
+  // A column's values are accumulated as plain doubles until the first non-number, at which point
+  // the column switches to holding JS values.
+  struct Column {
+    kj::Vector<double> numbers;
+    kj::Maybe<v8::LocalVector<v8::Value>> values;
+  };
+  auto columns = kj::heapArray<Column>(columnNames.getHandle(js).size());
+
+  auto handleValue = [&](uint i, SqlValue value) {
+    auto& column = columns[i];
+    KJ_IF_SOME(values, column.values) {
+      values.push_back(wrapSqlValue(js, kj::mv(value)));
+      return;
+    }
+    KJ_IF_SOME(v, value) {
+      KJ_IF_SOME(number, v.tryGet<double>()) {
+        column.numbers.add(number);
+        return;
+      }
+    }
+    auto& values = column.values.emplace(js.v8Isolate);
+    values.reserve(column.numbers.size() + 1);
+    for (double number: column.numbers) {
+      values.push_back(js.num(number));
+    }
+    column.numbers.clear();
+    values.push_back(wrapSqlValue(js, kj::mv(value)));
+  };
+
+  while (iteratorImpl(js, self, handleValue)) {
+    // See the comment in `toArray()`.
+    if (limitEnforcer.hasExcessivelyExceededHeapLimit()) {
+      JSG_FAIL_REQUIRE(Error,
+          "SQL query result set is too large to fit in memory. Use a streaming iterator "
+          "(e.g. `for (const row of cursor)` or `cursor.raw()`) or add a LIMIT clause instead "
+          "of calling toColumns() on a very large result set.");
+    }
+  }
+
+  v8::LocalVector<v8::Value> results(js.v8Isolate);
+  results.reserve(columns.size());
+  for (auto& column: columns) {
+    KJ_IF_SOME(values, column.values) {
+      results.push_back(v8::Array::New(js.v8Isolate, values.data(), values.size()));
+    } else {
+      auto buffer = jsg::JsArrayBuffer::create(js, column.numbers.asPtr().asBytes());
+      results.push_back(v8::Float64Array::New(buffer, 0, column.numbers.size()));
+    }
+  }
+  return jsg::JsArray(v8::Array::New(js.v8Isolate, results.data(), results.size()));
+}
+
 jsg::JsValue SqlStorage::Cursor::one(jsg::Lock& js) {
   auto self = JSG_THIS;
   auto result = JSG_REQUIRE_NONNULL(rowIteratorNext(js, self), Error,
@@ -305,17 +475,30 @@ jsg::Ref<SqlStorage::Cursor::RowIterator> SqlStorage::Cursor::rows(jsg::Lock& js
 }
 
 kj::Maybe<jsg::JsObject> SqlStorage::Cursor::rowIteratorNext(jsg::Lock& js, jsg::Ref<Cursor>& obj) {
-  KJ_IF_SOME(values, iteratorImpl(js, obj)) {
-    auto names = obj->columnNames.getHandle(js);
-    jsg::JsObject result = js.obj();
-    KJ_ASSERT(names.size() == values.size());
-    for (auto i: kj::zeroTo(names.size())) {
-      result.set(js, names.get(js, i), jsg::JsValue(values[i]));
+  KJ_IF_SOME(tmpl, obj->rowTemplate) {
+    // `getRowTemplate()` only creates a template for up to MAX_ROW_TEMPLATE_COLUMNS columns.
+    v8::MaybeLocal<v8::Value> values[MAX_ROW_TEMPLATE_COLUMNS];
+    size_t count = 0;
+    bool hasRow = iteratorImpl(js, obj, [&](uint i, SqlValue value) {
+      values[i] = v8::Local<v8::Value>(wrapSqlValue(js, kj::mv(value)));
+      count = i + 1;
+    });
+    if (!hasRow) {
+      return kj::none;
     }
-    return result;
-  } else {
+    return jsg::JsObject(tmpl.getHandle(js)->NewInstance(
+        js.v8Context(), v8::MemorySpan<v8::MaybeLocal<v8::Value>>(values, count)));
+  }
+
+  auto names = obj->columnNames.getHandle(js);
+  jsg::JsObject result = js.obj();
+  bool hasRow = iteratorImpl(js, obj, [&](uint i, SqlValue value) {
+    result.set(js, names.get(js, i), wrapSqlValue(js, kj::mv(value)));
+  });
+  if (!hasRow) {
     return kj::none;
   }
+  return result;
 }
 
 jsg::Ref<SqlStorage::Cursor::RawIterator> SqlStorage::Cursor::raw(jsg::Lock& js) {
@@ -330,15 +513,17 @@ jsg::JsArray SqlStorage::Cursor::getColumnNames(jsg::Lock& js) {
 }
 
 kj::Maybe<jsg::JsArray> SqlStorage::Cursor::rawIteratorNext(jsg::Lock& js, jsg::Ref<Cursor>& obj) {
-  KJ_IF_SOME(values, iteratorImpl(js, obj)) {
-    return jsg::JsArray(v8::Array::New(js.v8Isolate, values.data(), values.size()));
-  } else {
+  v8::LocalVector<v8::Value> values(js.v8Isolate);
+  bool hasRow = iteratorImpl(js, obj,
+      [&](uint, SqlValue value) { values.push_back(wrapSqlValue(js, kj::mv(value))); });
+  if (!hasRow) {
     return kj::none;
   }
+  return jsg::JsArray(v8::Array::New(js.v8Isolate, values.data(), values.size()));
 }
 
-kj::Maybe<v8::LocalVector<v8::Value>> SqlStorage::Cursor::iteratorImpl(
-    jsg::Lock& js, jsg::Ref<Cursor>& obj) {
+template <typename Func>
+bool SqlStorage::Cursor::iteratorImpl(jsg::Lock& js, jsg::Ref<Cursor>& obj, Func&& handleValue) {
   auto& state = *KJ_UNWRAP_OR(obj->state, {
     if (obj->canceled) {
       JSG_FAIL_REQUIRE(Error,
@@ -347,7 +532,7 @@ kj::Maybe<v8::LocalVector<v8::Value>> SqlStorage::Cursor::iteratorImpl(
           "prepared statement objects.");
     } else {
       // Query already done.
-      return kj::none;
+      return false;
     }
   });
 
@@ -355,12 +540,10 @@ kj::Maybe<v8::LocalVector<v8::Value>> SqlStorage::Cursor::iteratorImpl(
 
   if (query.isDone()) {
     obj->endQuery(state);
-    return kj::none;
+    return false;
   }
 
   auto n = query.columnCount();
-  v8::LocalVector<v8::Value> results(js.v8Isolate);
-  results.reserve(n);
   for (auto i: kj::zeroTo(n)) {
     SqlValue value;
     KJ_SWITCH_ONEOF(query.getValue(i)) {
@@ -383,7 +566,7 @@ kj::Maybe<v8::LocalVector<v8::Value>> SqlStorage::Cursor::iteratorImpl(
         // leave value null
       }
     }
-    results.push_back(wrapSqlValue(js, kj::mv(value)));
+    handleValue(i, kj::mv(value));
   }
 
   // Proactively iterate to the next row and, if it turns out the query is done, discard it. This
@@ -403,7 +586,7 @@ kj::Maybe<v8::LocalVector<v8::Value>> SqlStorage::Cursor::iteratorImpl(
     obj->endQuery(state);
   }
 
-  return kj::mv(results);
+  return true;
 }
 
 void SqlStorage::Cursor::endQuery(State& stateRef) {
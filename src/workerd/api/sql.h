@@ -31,6 +31,7 @@ class SqlStorage final: public jsg::Object {
   class Cursor;
   class Statement;
   struct IngestResult;
+  struct StatementStats;
 
   // One value returned from SQL. Note that we intentionally return StringPtr instead of String
   // because we know that the underlying buffer returned by SQLite will be valid long enough to be
@@ -46,6 +47,11 @@ class SqlStorage final: public jsg::Object {
 
   double getDatabaseSize(jsg::Lock& js);
 
+  // Returns aggregate statistics about the statements this object has executed, if statement
+  // stats are enabled for the namespace (`sqlStatementStats` in the config). Statements run by
+  // the system on the application's behalf are not included.
+  kj::Array<StatementStats> getStatementStats(jsg::Lock& js);
+
   JSG_RESOURCE_TYPE(SqlStorage, CompatibilityFlags::Reader flags) {
     JSG_METHOD(exec);
 
@@ -58,6 +64,8 @@ class SqlStorage final: public jsg::Object {
       JSG_METHOD(ingest);
 
       JSG_METHOD(setMaxPageCountForTest);
+
+      JSG_METHOD(getStatementStats);
     }
 
     JSG_READONLY_PROTOTYPE_PROPERTY(databaseSize, getDatabaseSize);
@@ -89,6 +97,14 @@ class SqlStorage final: public jsg::Object {
   kj::Maybe<IoOwn<SqliteDatabase::Statement>> pragmaPageCount;
   kj::Maybe<IoOwn<SqliteDatabase::Statement>> pragmaGetMaxPageCount;
 
+  // A template for creating a statement's row objects with a fixed shape in one step, along with
+  // the column names it was built for. `tmpl` is none if the columns can't all be represented as
+  // distinct plain data properties, in which case row properties are set one at a time.
+  struct RowTemplate {
+    kj::Array<kj::String> columnNames;
+    kj::Maybe<jsg::V8Ref<v8::DictionaryTemplate>> tmpl;
+  };
+
   // A statement in the statement cache.
   struct CachedStatement: public kj::Refcounted {
     jsg::HashableV8Ref<v8::String> query;
@@ -97,6 +113,10 @@ class SqlStorage final: public jsg::Object {
     kj::ListLink<CachedStatement> lruLink;
     uint useCount = 0;
 
+    // Reused by each cursor over this statement whose column names still match. (SQLite
+    // re-prepares the statement when the schema changes, so `SELECT *` may gain columns.)
+    kj::Maybe<RowTemplate> rowTemplate;
+
     CachedStatement(jsg::Lock& js,
         SqlStorage& sqlStorage,
         SqliteDatabase& db,
@@ -204,6 +224,9 @@ class SqlStorage::Cursor final: public jsg::Object {
     JSG_METHOD(next);
     JSG_METHOD(toArray);
     JSG_METHOD(one);
+    if (flags.getWorkerdExperimental()) {
+      JSG_METHOD(toColumns);
+    }
 
     JSG_ITERABLE(rows);
     JSG_METHOD(raw);
@@ -233,6 +256,11 @@ class SqlStorage::Cursor final: public jsg::Object {
   jsg::JsArray toArray(jsg::Lock& js);
   jsg::JsValue one(jsg::Lock& js);
 
+  // Returns the remaining results column by column: an array with one entry per column, which is
+  // a Float64Array if every value in the column is a number, or otherwise an array of values.
+  // Numeric columns are accumulated natively, so no JS value is created per number.
+  jsg::JsArray toColumns(jsg::Lock& js);
+
   void visitForMemoryInfo(jsg::MemoryTracker& tracker) const {
     if (state != kj::none) {
       tracker.trackFieldWithSize("IoOwn<State>", sizeof(IoOwn<State>));
@@ -289,20 +317,31 @@ class SqlStorage::Cursor final: public jsg::Object {
 
   jsg::JsRef<jsg::JsArray> columnNames;
 
+  // Template used to build row objects, shared with the cached statement if there is one. None
+  // if the row properties must be set one at a time.
+  kj::Maybe<jsg::V8Ref<v8::DictionaryTemplate>> rowTemplate;
+
   // Invoke when `query.isDone()`, or when we want to prematurely cancel the query. This records
   // row counters and then sets `state` to `none` to drop the query and return the prepared
   // statement to the statement cache.
   void endQuery(State& stateRef);
 
-  // Initialize `columnNames` from the state object.
+  // Initialize `columnNames` and `rowTemplate` from the state object.
   void initColumnNames(jsg::Lock& js, State& stateRef);
 
+  static kj::Maybe<jsg::V8Ref<v8::DictionaryTemplate>> getRowTemplate(
+      jsg::Lock& js, State& stateRef);
+
   static kj::Array<const SqliteDatabase::Query::ValuePtr> mapBindings(
       kj::ArrayPtr<BindingValue> values);
 
   static kj::Maybe<jsg::JsObject> rowIteratorNext(jsg::Lock& js, jsg::Ref<Cursor>& obj);
   static kj::Maybe<jsg::JsArray> rawIteratorNext(jsg::Lock& js, jsg::Ref<Cursor>& obj);
-  static kj::Maybe<v8::LocalVector<v8::Value>> iteratorImpl(jsg::Lock& js, jsg::Ref<Cursor>& obj);
+
+  // Reads the next row, passing each column's index and value to `handleValue`. Returns false if
+  // there are no more rows.
+  template <typename Func>
+  static bool iteratorImpl(jsg::Lock& js, jsg::Ref<Cursor>& obj, Func&& handleValue);
 
   friend class Statement;
 
@@ -360,11 +399,23 @@ struct SqlStorage::IngestResult {
   JSG_STRUCT(remainder, rowsRead, rowsWritten, statementCount);
 };
 
+struct SqlStorage::StatementStats {
+  kj::String sql;
+  double calls;
+  double totalTimeMs;
+  double maxTimeMs;
+  double rowsRead;
+  double rowsWritten;
+  double cacheHits;
+
+  JSG_STRUCT(sql, calls, totalTimeMs, maxTimeMs, rowsRead, rowsWritten, cacheHits);
+};
+
 #define EW_SQL_ISOLATE_TYPES                                                                       \
   api::SqlStorage, api::SqlStorage::Statement, api::SqlStorage::Cursor,                            \
-      api::SqlStorage::IngestResult, api::SqlStorage::Cursor::RowIterator,                         \
-      api::SqlStorage::Cursor::RowIterator::Next, api::SqlStorage::Cursor::RawIterator,            \
-      api::SqlStorage::Cursor::RawIterator::Next
+      api::SqlStorage::IngestResult, api::SqlStorage::StatementStats,                              \
+      api::SqlStorage::Cursor::RowIterator, api::SqlStorage::Cursor::RowIterator::Next,            \
+      api::SqlStorage::Cursor::RawIterator, api::SqlStorage::Cursor::RawIterator::Next
 // The list of sql.h types that are added to worker.c++'s JSG_DECLARE_ISOLATE_TYPE
 
 }  // namespace workerd::api
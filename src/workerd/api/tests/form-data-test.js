@@ -969,3 +969,40 @@ export const urlencodedReasonableEntryCount = {
     strictEqual(fd.get('key99'), 'val99');
   },
 };
+
+export const largeFilePartsRoundTrip = {
+  async test() {
+    // Large file parts are parsed as views of the buffered body rather than
+    // copies; make sure they still carry exactly their own bytes, next to small
+    // parts and names that need escaping.
+    const big = new Uint8Array(300 * 1024);
+    for (let i = 0; i < big.length; i++) big[i] = (i * 7) & 0xff;
+    const small = new Uint8Array([0x0d, 0x0a, 0x2d, 0x2d]);
+
+    const expected = new FormData();
+    expected.append(
+      'big',
+      new Blob([big], { type: 'application/x-big' }),
+      'big.bin'
+    );
+    expected.append('name with "quotes"\nand\\slash', 'text');
+    expected.append('small', new Blob([small]), 'small.bin');
+    expected.append('big2', new Blob([big.subarray(1)]), 'big2.bin');
+
+    const actual = await new Response(expected).formData();
+
+    const bigFile = actual.get('big');
+    strictEqual(bigFile.name, 'big.bin');
+    strictEqual(bigFile.type, 'application/x-big');
+    deepStrictEqual(new Uint8Array(await bigFile.arrayBuffer()), big);
+    deepStrictEqual(
+      new Uint8Array(await actual.get('big2').arrayBuffer()),
+      big.subarray(1)
+    );
+    deepStrictEqual(
+      new Uint8Array(await actual.get('small').arrayBuffer()),
+      small
+    );
+    strictEqual(actual.get('name with %22quotes%22%0Aand\\slash'), 'text');
+  },
+};
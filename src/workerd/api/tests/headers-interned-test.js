@@ -0,0 +1,64 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+import { deepStrictEqual, strictEqual } from 'node:assert';
+
+// The config interns x-request-id and x-tenant, which must behave exactly like any other
+// uncommon header.
+
+export const getSetDelete = {
+  test() {
+    const headers = new Headers();
+    headers.set('X-Request-ID', 'abc');
+    strictEqual(headers.get('x-request-id'), 'abc');
+    strictEqual(headers.get('X-REQUEST-ID'), 'abc');
+    strictEqual(headers.has('x-Request-Id'), true);
+
+    headers.append('x-request-id', 'def');
+    strictEqual(headers.get('x-request-id'), 'abc, def');
+    headers.set('x-request-id', 'ghi');
+    strictEqual(headers.get('x-request-id'), 'ghi');
+
+    headers.delete('X-Request-Id');
+    strictEqual(headers.has('x-request-id'), false);
+    strictEqual(headers.get('x-request-id'), null);
+  },
+};
+
+export const ordering = {
+  test() {
+    const headers = new Headers([
+      ['x-zebra', '1'],
+      ['X-Tenant', '2'],
+      ['content-type', 'text/plain'],
+      ['x-alpha', '3'],
+      ['x-request-id', '4'],
+    ]);
+    deepStrictEqual(
+      [...headers],
+      [
+        ['content-type', 'text/plain'],
+        ['x-alpha', '3'],
+        ['x-request-id', '4'],
+        ['x-tenant', '2'],
+        ['x-zebra', '1'],
+      ]
+    );
+  },
+};
+
+export const copies = {
+  async test() {
+    const original = new Headers({ 'X-Tenant': 'acme', 'x-other': 'x' });
+    const copy = new Headers(original);
+    original.set('x-tenant', 'changed');
+    strictEqual(copy.get('x-tenant'), 'acme');
+
+    const request = new Request('https://example.com', { headers: copy });
+    strictEqual(request.headers.get('X-TENANT'), 'acme');
+
+    const response = new Response('body', { headers: { 'x-request-id': 'r1' } });
+    strictEqual(response.headers.get('x-request-id'), 'r1');
+    strictEqual(await response.text(), 'body');
+  },
+};
@@ -63,3 +63,30 @@ export const notJsonSerializable = {
     throws(() => Response.json({ a: 1n }));
   },
 };
+
+export const largeBodies = {
+  async test() {
+    // Large ASCII bodies are handed to V8 without copying; everything else is
+    // transcoded. Check that both paths produce the same results as the
+    // small-body path.
+    const items = Array.from({ length: 20000 }, (_, i) => ({
+      id: i,
+      s: `v${i}`,
+    }));
+    const ascii = JSON.stringify(items);
+    ok(ascii.length > 64 * 1024);
+    strictEqual(await new Response(ascii).text(), ascii);
+    deepStrictEqual(await new Response(ascii).json(), items);
+
+    const nonAscii = JSON.stringify(
+      items.map((item) => ({ ...item, s: 'ü€😀' }))
+    );
+    strictEqual(await new Response(nonAscii).text(), nonAscii);
+    deepStrictEqual(await new Response(nonAscii).json(), JSON.parse(nonAscii));
+
+    // The resulting string must stay valid after the response is gone.
+    const text = await new Response(ascii).text();
+    globalThis.gc?.();
+    strictEqual(text.slice(-20), ascii.slice(-20));
+  },
+};
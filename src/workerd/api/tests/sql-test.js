@@ -1092,6 +1092,71 @@ async function test(state) {
       { a: 3, b: 3 },
     ]);
   }
+
+  // Column names that can't be plain data properties of a fixed-shape row object still produce
+  // the same rows as setting each property in turn.
+  {
+    const proto = sql.exec('SELECT 1 AS x, 2 AS __proto__').one();
+    assert.equal(proto.x, 1);
+    assert.equal(Object.getPrototypeOf(proto), Object.prototype);
+    assert.deepEqual(Object.keys(proto), ['x']);
+
+    const numeric = sql.exec('SELECT 1 AS "1", 2 AS "0", 3 AS y').one();
+    assert.deepEqual(Object.keys(numeric), ['0', '1', 'y']);
+    assert.deepEqual(Object.values(numeric), [2, 1, 3]);
+
+    const duplicate = sql.exec('SELECT 1 AS d, 2 AS d').one();
+    assert.deepEqual(duplicate, { d: 2 });
+
+    const unicode = sql.exec('SELECT 1 AS "caf\u00e9"').one();
+    assert.deepEqual(unicode, { 'caf\u00e9': 1 });
+
+    const columns = [];
+    for (let i = 0; i < 100; i++) columns.push(`${i} AS c${i}`);
+    const wide = sql.exec(`SELECT ${columns.join(', ')}`).one();
+    assert.equal(Object.keys(wide).length, 100);
+    assert.equal(wide.c99, 99);
+  }
+
+  // Rows of a cached statement get a template that follows schema changes.
+  {
+    sql.exec('CREATE TABLE rowShapeTest (a INTEGER)');
+    sql.exec('INSERT INTO rowShapeTest VALUES (1)');
+    const select = () => sql.exec('SELECT * FROM rowShapeTest').toArray();
+    assert.deepStrictEqual(select(), [{ a: 1 }]);
+    assert.deepStrictEqual(select(), [{ a: 1 }]);
+    sql.exec('ALTER TABLE rowShapeTest RENAME COLUMN a TO b');
+    assert.deepStrictEqual(select(), [{ b: 1 }]);
+    sql.exec('ALTER TABLE rowShapeTest ADD COLUMN b2 TEXT');
+    assert.deepStrictEqual(select(), [{ b: 1, b2: null }]);
+  }
+
+  // toColumns() returns one entry per column, using a Float64Array for all-numeric columns.
+  {
+    sql.exec('CREATE TABLE toColumnsTest (n INTEGER, r REAL, t TEXT, m)');
+    sql.exec(
+      `INSERT INTO toColumnsTest VALUES (1, 1.5, 'one', 1), (2, 2.5, 'two', NULL),
+          (3, 3.5, 'three', 'x')`
+    );
+    const cursor = sql.exec('SELECT * FROM toColumnsTest ORDER BY n');
+    const [n, r, t, m] = cursor.toColumns();
+    assert.ok(n instanceof Float64Array);
+    assert.deepEqual(Array.from(n), [1, 2, 3]);
+    assert.ok(r instanceof Float64Array);
+    assert.deepEqual(Array.from(r), [1.5, 2.5, 3.5]);
+    assert.deepStrictEqual(t, ['one', 'two', 'three']);
+    assert.deepStrictEqual(m, [1, null, 'x']);
+    assert.deepEqual(cursor.columnNames, ['n', 'r', 't', 'm']);
+
+    const empty = sql.exec('SELECT * FROM toColumnsTest WHERE n > 100').toColumns();
+    assert.equal(empty.length, 4);
+    assert.equal(empty[0].length, 0);
+
+    // Rows already consumed by the iterator are not included.
+    const partial = sql.exec('SELECT n FROM toColumnsTest ORDER BY n');
+    partial.next();
+    assert.deepEqual(Array.from(partial.toColumns()[0]), [2, 3]);
+  }
 }
 
 async function testIoStats(storage) {
@@ -1381,6 +1446,35 @@ export class DurableObjectExample extends DurableObject {
 
   async alarm() {}
 
+  async testStatementStats() {
+    const sql = this.state.storage.sql;
+    sql.exec('CREATE TABLE statsTest (id INTEGER PRIMARY KEY, value TEXT)');
+    for (let i = 0; i < 3; ++i) {
+      // Stats are recorded when the query finishes, so consume each cursor.
+      sql.exec('INSERT INTO statsTest VALUES (?, ?)', i, `value ${i}`).toArray();
+    }
+    sql.exec("SELECT * FROM statsTest WHERE id > 0 AND value != 'x'").toArray();
+    sql.exec("SELECT  * FROM statsTest WHERE id > 1 AND value != 'y'").toArray();
+
+    const stats = sql.getStatementStats();
+    const find = (text) => stats.find((s) => s.sql === text);
+
+    const insert = find('INSERT INTO statsTest VALUES (?, ?)');
+    assert.equal(insert.calls, 3);
+    assert.equal(insert.rowsWritten, 3);
+    // exec() caches the prepared statement, so every call after the first reuses it.
+    assert.equal(insert.cacheHits, 2);
+    assert.ok(insert.totalTimeMs >= insert.maxTimeMs);
+
+    // Literal values and whitespace don't split entries.
+    const select = find('SELECT * FROM statsTest WHERE id > ? AND value != ?');
+    assert.equal(select.calls, 2);
+    assert.ok(select.rowsRead >= 3);
+
+    // Statements the runtime runs on the application's behalf aren't reported.
+    assert.ok(!stats.some((s) => s.sql.includes('_cf_')));
+  }
+
   async testMultiStatement() {
     // Performing this PRAGMA will cause sqlite to invalidate prepared statements and re-compile
     // them the next time they are executed. (Probably, many other pragmas would have the same
@@ -1568,6 +1662,13 @@ export let testRollbackKvInit = {
   },
 };
 
+export let testStatementStats = {
+  async test(ctrl, env, ctx) {
+    let stub = env.ns.get(env.ns.idFromName('statement-stats-test'));
+    await stub.testStatementStats();
+  },
+};
+
 export let testMultiStatement = {
   async test(ctrl, env, ctx) {
     let stub = env.ns.get(env.ns.idFromName('multi-statement-test'));
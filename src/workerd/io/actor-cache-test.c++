@@ -693,6 +693,40 @@ KJ_TEST("ActorCache batching due to maxKeysPerRpc") {
   KJ_EXPECT(deleteProm3.wait(ws) == 2);
 }
 
+KJ_TEST("ActorCache paces flush batches") {
+  ActorCacheTest test({.maxKeysPerRpc = 1});
+  auto& ws = test.ws;
+  auto& mockStorage = test.mockStorage;
+
+  for (auto i: kj::zeroTo(12)) {
+    test.put(kj::str("key", i), "value");
+  }
+
+  auto mockTxn = mockStorage->expectCall("txn", ws).returnMock("transaction");
+
+  // Only the initial window of 8 batches is sent before any of them completes.
+  kj::Vector<MockServer::ExpectedCall> calls;
+  for (auto i: kj::zeroTo(8)) {
+    calls.add(mockTxn->expectCall("put", ws)
+                  .withParams(kj::str("(entries = [(key = \"key", i, "\", value = \"value\")])")));
+  }
+  mockTxn->expectNoActivity(ws);
+
+  // A fast batch frees its slot and also grows the window, so two more go out.
+  kj::mv(calls[0]).thenReturn(CAPNP());
+  calls.add(mockTxn->expectCall("put", ws));
+  calls.add(mockTxn->expectCall("put", ws));
+  mockTxn->expectNoActivity(ws);
+
+  for (auto i: kj::range(1, calls.size())) {
+    kj::mv(calls[i]).thenReturn(CAPNP());
+  }
+  mockTxn->expectCall("put", ws).thenReturn(CAPNP());
+  mockTxn->expectCall("put", ws).thenReturn(CAPNP());
+  mockTxn->expectCall("commit", ws).thenReturn(CAPNP());
+  mockTxn->expectDropped(ws);
+}
+
 KJ_TEST("ActorCache batching due to max storage RPC words") {
   ActorCacheTest test({.hardLimit = 128 * 1024 * 1024});
   auto& ws = test.ws;
@@ -3641,6 +3675,41 @@ KJ_TEST("ActorCache LRU purge ordering") {
   KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("yyy"))) == "bbb");
 }
 
+KJ_TEST("ActorCache LRU purge ordering after many cache hits") {
+  ActorCacheTest test({.softLimit = 4 * ENTRY_SIZE});
+  auto& ws = test.ws;
+  auto& mockStorage = test.mockStorage;
+
+  test.put("foo", "123");
+  test.put("bar", "456");
+  test.put("baz", "789");
+  test.put("qux", "555");
+
+  mockStorage->expectCall("put", ws).thenReturn(CAPNP());
+  test.gate.wait(nullptr).wait(ws);
+
+  // Enough hits to overflow the buffer of touches that get() keeps, so that some of them are
+  // applied immediately and some in batches. The last round leaves the order qux, baz, bar, foo.
+  for (auto i KJ_UNUSED: kj::zeroTo(20)) {
+    KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("qux"))) == "555");
+    KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("baz"))) == "789");
+    KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("bar"))) == "456");
+    KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("foo"))) == "123");
+  }
+
+  test.put("xxx", "aaa");
+  test.put("yyy", "bbb");
+  mockStorage->expectCall("put", ws).thenReturn(CAPNP());
+
+  // The two least recently used entries were evicted.
+  (void)expectUncached(test.get("qux"));
+  (void)expectUncached(test.get("baz"));
+  KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("bar"))) == "456");
+  KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("foo"))) == "123");
+  KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("xxx"))) == "aaa");
+  KJ_ASSERT(KJ_ASSERT_NONNULL(expectCached(test.get("yyy"))) == "bbb");
+}
+
 KJ_TEST("ActorCache LRU purge larger") {
   ActorCacheTest test({.softLimit = 32 * ENTRY_SIZE});
   auto& ws = test.ws;
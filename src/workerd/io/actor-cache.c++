@@ -26,10 +26,66 @@ namespace workerd {
 // hit this limit, so this is just a sanity check.
 static constexpr size_t MAX_ACTOR_STORAGE_RPC_WORDS = (16u << 20) / sizeof(capnp::word);
 
+// Bounds on ActorCache::flushWindow, the number of batch RPCs of a flush transaction that may be
+// in flight at once. See ActorCache::FlushPacer.
+static constexpr uint MIN_FLUSH_WINDOW = 2;
+static constexpr uint MAX_FLUSH_WINDOW = 32;
+
+// A batch RPC that takes longer than this shrinks the flush window; faster ones grow it.
+static constexpr kj::Duration FLUSH_BATCH_TARGET_LATENCY = 100 * kj::MILLISECONDS;
+
+// Regardless of the window, we stop sending more batches of a flush transaction once this many
+// words are in flight, unless nothing is.
+static constexpr size_t MAX_FLUSH_WORDS_IN_FLIGHT = 2 * MAX_ACTOR_STORAGE_RPC_WORDS;
+
 const ActorCache::Hooks ActorCache::Hooks::DEFAULT;
 
 namespace {
 
+// Frees the allocation made by packKeyValue().
+class PackedKeyValueDisposer final: public kj::ArrayDisposer {
+ public:
+  static const PackedKeyValueDisposer instance;
+
+ protected:
+  void disposeImpl(void* firstElement, size_t, size_t, size_t, void (*)(void*)) const override {
+    ::operator delete(firstElement);
+  }
+};
+
+const PackedKeyValueDisposer PackedKeyValueDisposer::instance;
+
+// Copies a key and value received from storage into one allocation, instead of one each for the
+// key and value. The returned key owns the allocation and the value merely points into it, so the
+// value must not outlive the key. That holds within a KeyValuePair or an Entry, both of which
+// declare `value` after `key` and so destroy it first.
+ActorCache::KeyValuePair packKeyValue(
+    kj::ArrayPtr<const char> key, kj::ArrayPtr<const kj::byte> value) {
+  auto block = static_cast<char*>(::operator new(key.size() + 1 + value.size()));
+  if (key.size() > 0) {
+    memcpy(block, key.begin(), key.size());
+  }
+  block[key.size()] = '\0';
+  auto valueBytes = reinterpret_cast<kj::byte*>(block + key.size() + 1);
+  if (value.size() > 0) {
+    memcpy(valueBytes, value.begin(), value.size());
+  }
+
+  return {
+    .key = kj::String(kj::Array<char>(block, key.size() + 1, PackedKeyValueDisposer::instance)),
+    .value = kj::Array<const kj::byte>(valueBytes, value.size(), kj::NullArrayDisposer::instance),
+  };
+}
+
+// Orders a key from a storage response, which isn't NUL-terminated, relative to one of ours.
+// Consistent with the ordering of Key.
+int compareKeys(kj::ArrayPtr<const char> a, kj::ArrayPtr<const char> b) {
+  size_t n = kj::min(a.size(), b.size());
+  int cmp = n == 0 ? 0 : memcmp(a.begin(), b.begin(), n);
+  if (cmp != 0) return cmp;
+  return (a.size() > b.size()) - (a.size() < b.size());
+}
+
 // Utility functions for recording latency metrics via a one-liner in the callers below.
 auto recordStorageRead(ActorCache::Hooks& hooks, const kj::MonotonicClock& clock) {
   auto start = clock.now();
@@ -54,6 +110,8 @@ ActorCache::ActorCache(
 ActorCache::~ActorCache() noexcept(false) {
   // Need to remove all entries from any lists they might be in.
   auto lock = lru.cleanList.lockExclusive();
+  // Buffered touches hold references to our entries, and we might be on `lru.touchedCaches`.
+  lru.drainTouches(lock);
   clear(lock);
 }
 
@@ -148,6 +206,7 @@ kj::Maybe<kj::Promise<void>> ActorCache::evictStale(kj::Date now) {
     int64_t newValue = nowNs + lru.options.staleTimeout / kj::NANOSECONDS;
     if (lru.nextStaleCheckNs.compare_exchange_strong(oldValue, newValue)) {
       auto lock = lru.cleanList.lockExclusive();
+      lru.drainTouches(lock);
       for (auto& entry: *lock) {
         if (entry.isStale) {
           auto& cache = KJ_ASSERT_NONNULL(entry.maybeCache);
@@ -311,6 +370,7 @@ void ActorCache::evictOrOomIfNeeded(Lock& lock) {
 }
 
 bool ActorCache::SharedLru::evictIfNeeded(Lock& lock) const {
+  bool drained = false;
   for (;;) {
     size_t current = size.load(std::memory_order_relaxed);
     if (current <= options.softLimit) {
@@ -318,6 +378,11 @@ bool ActorCache::SharedLru::evictIfNeeded(Lock& lock) const {
       return false;
     }
 
+    if (!drained) {
+      drainTouches(lock);
+      drained = true;
+    }
+
     // We're over the limit, let's evict stuff.
     if (lock->empty()) {
       // Nothing to evict.
@@ -331,8 +396,44 @@ bool ActorCache::SharedLru::evictIfNeeded(Lock& lock) const {
   }
 }
 
+void ActorCache::SharedLru::drainTouches(Lock& lock) const {
+  // No get() can push while we hold the exclusive lock, so a plain load is enough to skip the
+  // exchange in the common case.
+  if (touchedCaches.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+
+  ActorCache* cache = touchedCaches.exchange(nullptr, std::memory_order_acquire);
+  while (cache != nullptr) {
+    ActorCache* next = cache->nextTouchedCache;
+    cache->nextTouchedCache = nullptr;
+    cache->applyPendingTouches(lock);
+    cache = next;
+  }
+}
+
+void ActorCache::applyPendingTouches(Lock& lock) {
+  for (auto& entry: pendingTouches) {
+    // The entry may have been dirtied, overwritten, or evicted since it was touched.
+    if (entry->getSyncStatus() == EntrySyncStatus::CLEAN) {
+      lock->remove(*entry);
+      lock->add(*entry);
+    }
+  }
+  pendingTouches.clear();
+}
+
+void ActorCache::addToCleanList(Lock& listLock, Entry& entryRef) {
+  // Earlier buffered touches have to land before the new entry, or it would look older than them.
+  lru.drainTouches(listLock);
+  entryRef.setClean();
+  listLock->add(entryRef);
+}
+
 void ActorCache::touchEntry(Lock& lock, Entry& entry) {
   if (entry.getSyncStatus() == EntrySyncStatus::CLEAN) {
+    // Drain before unlinking `entry`, which may itself have a buffered touch.
+    lru.drainTouches(lock);
     entry.isStale = false;
     lock->remove(entry);
     addToCleanList(lock, entry);
@@ -436,6 +537,10 @@ kj::OneOf<kj::Maybe<ActorCache::Value>, kj::Promise<kj::Maybe<ActorCache::Value>
   options.noCache = options.noCache || lru.options.noCache;
   requireNotTerminal(nullptr);
 
+  KJ_IF_SOME(value, getCachedShared(key, options)) {
+    return kj::mv(value);
+  }
+
   auto lock = lru.cleanList.lockExclusive();
   auto entry = findInCache(lock, kj::mv(key), options);
   switch (entry->getValueStatus()) {
@@ -463,7 +568,7 @@ auto ActorCache::getImpl(
     value = response.getValue();
   }
   auto lock = lru.cleanList.lockExclusive();
-  auto newEntry = addReadResultToCache(lock, cloneKey(entry->key), value, options);
+  auto newEntry = addReadResultToCache(lock, entry->key, value, options);
   evictOrOomIfNeeded(lock);
   co_return newEntry->getValue();
 }
@@ -490,33 +595,31 @@ class ActorCache::GetMultiStreamImpl final: public rpc::ActorStorage::ListStream
 
     auto lock = cache.lru.cleanList.lockExclusive();
     auto params = context.getParams();
-    kj::String prevKey;
+    kj::ArrayPtr<const char> prevKey;
     for (auto kv: params.getList()) {
       KJ_ASSERT(kv.hasValue());  // values that don't exist aren't listed!
       KJ_ASSERT(nextExpectedKey != keysToFetch.end());
 
-      // TODO(perf): This copy of the key is not really needed, we use the key from `keysToFetch`
-      //   instead. But the capnp representation is a byte array which isn't null-terminated
-      //   which would make the code difficult below.
-      auto key = kj::str(kv.getKey().asChars());
+      // Points into the message; addReadResultToCache() makes its own copy.
+      auto key = kv.getKey().asChars();
 
-      KJ_ASSERT(key >= prevKey, "storage returned keys in non-sorted order?");
+      KJ_ASSERT(compareKeys(key, prevKey) >= 0, "storage returned keys in non-sorted order?");
 
       // Find matching key in keysToFetch, possibly marking missing keys as absent.
       for (;;) {
-        if (nextExpectedKey == keysToFetch.end() || key < *nextExpectedKey) {
+        int cmp = nextExpectedKey == keysToFetch.end() ? -1 : compareKeys(key, *nextExpectedKey);
+        if (cmp < 0) {
           // This may be a duplicate due to a retry. Ignore it.
           break;
-        } else if (key == *nextExpectedKey) {
-          fetchedEntries.add(
-              cache.addReadResultToCache(lock, kj::mv(*nextExpectedKey), kv.getValue(), options));
+        } else if (cmp == 0) {
+          fetchedEntries.add(cache.addReadResultToCache(lock, key, kv.getValue(), options));
           ++nextExpectedKey;
           break;
         }
 
         // It seems the list results have moved past `nextExpectedKey`, meaning it wasn't present
         // on disk. Write a negative cache entry.
-        cache.addReadResultToCache(lock, kj::mv(*nextExpectedKey), kj::none, options);
+        cache.addReadResultToCache(lock, *nextExpectedKey, kj::none, options);
         ++nextExpectedKey;
       }
 
@@ -524,7 +627,7 @@ class ActorCache::GetMultiStreamImpl final: public rpc::ActorStorage::ListStream
         fulfill();
       }
 
-      prevKey = kj::mv(key);
+      prevKey = key;
     }
     cache.evictOrOomIfNeeded(lock);
     return kj::READY_NOW;
@@ -540,7 +643,7 @@ class ActorCache::GetMultiStreamImpl final: public rpc::ActorStorage::ListStream
       // Some trailing keys weren't seen, better mark them as not present.
       auto lock = cache.lru.cleanList.lockExclusive();
       while (nextExpectedKey < keysToFetch.end()) {
-        cache.addReadResultToCache(lock, kj::mv(*nextExpectedKey++), kj::none, options);
+        cache.addReadResultToCache(lock, *nextExpectedKey++, kj::none, options);
       }
       cache.evictOrOomIfNeeded(lock);
     }
@@ -805,10 +908,11 @@ class ActorCache::ForwardListStreamImpl final: public rpc::ActorStorage::ListStr
       bool insertedAny = false;
 
       for (auto kv: list) {
-        Key key = kj::str(kv.getKey().asChars());
+        // Points into the message; addReadResultToCache() makes its own copy.
+        auto key = kv.getKey().asChars();
 
         if (!beginKeyIsKnown) {
-          if (key != beginKey) {
+          if (compareKeys(key, beginKey) != 0) {
             // This is the first set of results we've received, and it does not include the start
             // point of the list. Therefore, we should insert an entry with a null value, to make
             // sure the whole range can be marked as empty. We'll end up marking this entry as
@@ -816,7 +920,7 @@ class ActorCache::ForwardListStreamImpl final: public rpc::ActorStorage::ListStr
             markBeginAsEmpty(lock);
           }
         } else {
-          if (key <= beginKey) {
+          if (compareKeys(key, beginKey) <= 0) {
             // Out-of-order result. This is probably the result of restarting the list operation
             // due to a disconnect. We assume this is actually a duplicate of a result we
             // received earlier. Ignore it.
@@ -825,7 +929,7 @@ class ActorCache::ForwardListStreamImpl final: public rpc::ActorStorage::ListStr
         }
 
         KJ_ASSERT(kv.hasValue());  // values that don't exist aren't listed!
-        auto entry = cache.addReadResultToCache(lock, kj::mv(key), kv.getValue(), options);
+        auto entry = cache.addReadResultToCache(lock, key, kv.getValue(), options);
         fetchedEntries.add(kj::mv(entry));
         insertedAny = true;
       }
@@ -892,7 +996,7 @@ class ActorCache::ForwardListStreamImpl final: public rpc::ActorStorage::ListStr
   //    fine too, as the gap is already marked. Our markGapsEmpty() call will start with the
   //    following entry.
   void markBeginAsEmpty(Lock& lock) {
-    cache.addReadResultToCache(lock, cloneKey(beginKey), kj::none, options);
+    cache.addReadResultToCache(lock, beginKey, kj::none, options);
   }
 
   // Indicates that the operation is being canceled. Proactively drops all entries. This
@@ -1183,9 +1287,11 @@ class ActorCache::ReverseListStreamImpl final: public rpc::ActorStorage::ListStr
       bool insertedAny = false;
 
       for (auto kv: list) {
-        Key key = kj::str(kv.getKey().asChars());
+        // Points into the message; addReadResultToCache() makes its own copy.
+        auto key = kv.getKey().asChars();
 
-        if (key >= endKey) {
+        // A none `endKey` means the end of the key space.
+        if (endKey.map([&](Key& end) { return compareKeys(key, end) >= 0; }).orDefault(false)) {
           // Out-of-order result. This is probably the result of restarting the list operation
           // due to a disconnect. We assume this is actually a duplicate of a result we
           // received earlier. Ignore it.
@@ -1193,7 +1299,7 @@ class ActorCache::ReverseListStreamImpl final: public rpc::ActorStorage::ListStr
         }
 
         KJ_ASSERT(kv.hasValue());  // values that don't exist aren't listed!
-        auto entry = cache.addReadResultToCache(lock, kj::mv(key), kv.getValue(), options);
+        auto entry = cache.addReadResultToCache(lock, key, kv.getValue(), options);
         fetchedEntries.add(kj::mv(entry));
         insertedAny = true;
       }
@@ -1233,7 +1339,7 @@ class ActorCache::ReverseListStreamImpl final: public rpc::ActorStorage::ListStr
         // We may need to insert a negative entry at the beginning of the list range, since we
         // didn't see it, implying it's not present on disk. addResultToCache() will conveniently
         // avoid adding anything if it turns out this is already in a known-empty gap.
-        auto beginEntry = cache.addReadResultToCache(lock, cloneKey(beginKey), kj::none, options);
+        auto beginEntry = cache.addReadResultToCache(lock, beginKey, kj::none, options);
 
         // And we need to mark gaps empty from there to the final entry we actually saw.
         cache.markGapsEmpty(lock, beginEntry->key, endKey, options);
@@ -1480,6 +1586,44 @@ kj::OneOf<ActorCache::GetResultList, kj::Promise<ActorCache::GetResultList>> Act
 // -----------------------------------------------------------------------------
 // Helpers for read operations
 
+kj::Maybe<kj::Maybe<ActorCache::Value>> ActorCache::getCachedShared(
+    KeyPtr key, const ReadOptions& options) {
+  // Other threads only modify our map and entries under an exclusive lock, so a shared lock is
+  // enough for us to read them.
+  auto lock = lru.cleanList.lockShared();
+  auto& map = currentValues.get(lock);
+  auto iter = map.seek(key);
+  if (iter == map.ordered().end() || iter->get()->key != key) {
+    return kj::none;
+  }
+
+  Entry& entry = **iter;
+  if (entry.getValueStatus() == EntryValueStatus::UNKNOWN) {
+    return kj::none;
+  }
+
+  if (!options.noCache) {
+    // Equivalent to touchEntry(), except that moving a clean entry within the clean list is
+    // deferred to drainTouches().
+    if (entry.getSyncStatus() == EntrySyncStatus::CLEAN) {
+      if (pendingTouches.size() >= MAX_PENDING_TOUCHES) {
+        return kj::none;
+      }
+      if (pendingTouches.empty()) {
+        nextTouchedCache = lru.touchedCaches.load(std::memory_order_relaxed);
+        while (!lru.touchedCaches.compare_exchange_weak(
+            nextTouchedCache, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+      }
+      pendingTouches.add(kj::atomicAddRef(entry));
+      entry.isStale = false;
+    }
+    entry.noCache = false;
+  }
+
+  return entry.getValue();
+}
+
 kj::Own<ActorCache::Entry> ActorCache::findInCache(
     Lock& lock, KeyPtr key, const ReadOptions& options) {
   auto& map = currentValues.get(lock);
@@ -1511,14 +1655,17 @@ kj::Own<ActorCache::Entry> ActorCache::findInCache(
   }
 }
 
-kj::Own<ActorCache::Entry> ActorCache::addReadResultToCache(
-    Lock& lock, Key key, kj::Maybe<capnp::Data::Reader> maybeReader, const ReadOptions& options) {
+kj::Own<ActorCache::Entry> ActorCache::addReadResultToCache(Lock& lock,
+    kj::ArrayPtr<const char> keyChars,
+    kj::Maybe<capnp::Data::Reader> maybeReader,
+    const ReadOptions& options) {
   if (options.noCache) {
     // We don't actually want to add this to the cache, just return the entry.
     KJ_IF_SOME(reader, maybeReader) {
-      return kj::atomicRefcounted<Entry>(kj::mv(key), kj::heapArray(reader));
+      auto kv = packKeyValue(keyChars, reader);
+      return kj::atomicRefcounted<Entry>(kj::mv(kv.key), kj::mv(kv.value));
     } else {
-      return kj::atomicRefcounted<Entry>(kj::mv(key), EntryValueStatus::ABSENT);
+      return kj::atomicRefcounted<Entry>(kj::str(keyChars), EntryValueStatus::ABSENT);
     }
   }
 
@@ -1526,8 +1673,11 @@ kj::Own<ActorCache::Entry> ActorCache::addReadResultToCache(
 
   kj::Own<Entry> entry;
   KJ_IF_SOME(reader, maybeReader) {
-    entry = kj::atomicRefcounted<Entry>(*this, kj::mv(key), kj::heapArray(reader));
+    auto kv = packKeyValue(keyChars, reader);
+    entry = kj::atomicRefcounted<Entry>(*this, kj::mv(kv.key), kj::mv(kv.value));
   } else {
+    Key key = kj::str(keyChars);
+
     // Inserting a negative entry. Let's check if the new insertion is redundant due to the
     // previous entry having `gapIsKnownEmpty`.
     auto iter = map.seek(key);
@@ -2394,11 +2544,9 @@ kj::Promise<void> ActorCache::startFlushTransaction() {
   // muted deletes, we go ahead and construct batches of no more than 128 keys. They all end up
   // being part of the same transaction in the end, though.
   //
-  // TODO(perf): Currently we send all the batches at the same time. If the batches are large,
-  //   it could be worth spacing them out a bit so we don't saturate the connection. However, we
-  //   still need to make sure that the whole transaction represents a consistent snapshot in time,
-  //   so getting this right, without making a copy of everything upfront, could get complicated.
-  //   Punting for now.
+  // flushImplUsingTxn() builds every batch's request before sending any of them, and then paces
+  // the sends (see FlushPacer) so a huge transaction doesn't saturate the connection. Since the
+  // requests already hold copies of the data, the transaction is still a consistent snapshot.
 
   PutFlush putFlush;
   MutedDeleteFlush mutedDeleteFlush;
@@ -2866,6 +3014,61 @@ kj::Promise<void> ActorCache::flushImplAlarmOnly(DirtyAlarm dirty) {
   }
 }
 
+// Paces the batch RPCs of one flush transaction. Batches are still sent in order, but only
+// `cache.flushWindow` of them, and at most MAX_FLUSH_WORDS_IN_FLIGHT words, may be outstanding at
+// once, so that a bulk write doesn't monopolize a storage connection shared with other actors.
+// This doesn't affect the transaction's snapshot semantics, since every request has already been
+// built by the time we start sending.
+class ActorCache::FlushPacer {
+ public:
+  explicit FlushPacer(ActorCache& cache): cache(cache) {}
+
+  // Resolves when a batch of `words` words may be sent.
+  kj::Promise<void> waitForRoom(size_t words) {
+    while (inFlight > 0 &&
+        (inFlight >= cache.flushWindow || wordsInFlight + words > MAX_FLUSH_WORDS_IN_FLIGHT)) {
+      auto paf = kj::newPromiseAndFulfiller<void>();
+      roomFreed = kj::mv(paf.fulfiller);
+      co_await paf.promise;
+    }
+  }
+
+  // Counts `promise`, for a batch of `words` words that was just sent, as in flight until it
+  // completes, and adapts the window to its latency.
+  kj::Promise<void> track(kj::Promise<void> promise, size_t words) {
+    ++inFlight;
+    wordsInFlight += words;
+    auto start = cache.clock.now();
+    return promise.then([this, start]() { adaptWindow(cache.clock.now() - start); })
+        .attach(kj::defer([this, words]() { release(words); }))
+        .eagerlyEvaluate(nullptr);
+  }
+
+ private:
+  ActorCache& cache;
+  uint inFlight = 0;
+  size_t wordsInFlight = 0;
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> roomFreed;
+
+  // Additive increase, multiplicative decrease, as in TCP congestion control.
+  void adaptWindow(kj::Duration latency) {
+    if (latency <= FLUSH_BATCH_TARGET_LATENCY) {
+      cache.flushWindow = kj::min(cache.flushWindow + 1, MAX_FLUSH_WINDOW);
+    } else {
+      cache.flushWindow = kj::max(cache.flushWindow / 2, MIN_FLUSH_WINDOW);
+    }
+  }
+
+  void release(size_t words) {
+    --inFlight;
+    wordsInFlight -= words;
+    KJ_IF_SOME(fulfiller, roomFreed) {
+      fulfiller->fulfill();
+      roomFreed = kj::none;
+    }
+  }
+};
+
 kj::Promise<void> ActorCache::flushImplUsingTxn(PutFlush putFlush,
     MutedDeleteFlush mutedDeleteFlush,
     CountedDeleteFlushes countedDeleteFlushes,
@@ -2876,6 +3079,7 @@ kj::Promise<void> ActorCache::flushImplUsingTxn(PutFlush putFlush,
   struct RpcCountedDelete {
     kj::Own<CountedDelete> countedDelete;
     kj::Array<RpcDeleteRequest> rpcDeletes;
+    uint recordsDeleted = 0;
   };
   auto rpcCountedDeletes = kj::heapArrayBuilder<RpcCountedDelete>(countedDeleteFlushes.size());
   auto rpcMutedDeletes = kj::heapArrayBuilder<RpcDeleteRequest>(mutedDeleteFlush.batches.size());
@@ -2954,26 +3158,21 @@ kj::Promise<void> ActorCache::flushImplUsingTxn(PutFlush putFlush,
   // The constant extra 2 promises are those added outside of the rpc batches, currently one
   // to work around a bug in capnp::autoreconnect, and one to actually commit the flush txn
   // A 3rd promise may be added to write the alarm time if necessary.
+  //
+  // The pacer must outlive the promises it tracks.
+  FlushPacer pacer(*this);
   auto promises = kj::heapArrayBuilder<kj::Promise<void>>(rpcPuts.size() + rpcMutedDeletes.size() +
       rpcCountedDeletes.size() + 2 + !maybeAlarmChange.is<CleanAlarm>());
 
-  auto joinCountedDelete = [](RpcCountedDelete& rpcCountedDelete) -> kj::Promise<void> {
-    auto promises = KJ_MAP(request, rpcCountedDelete.rpcDeletes) {
-      return request.send().then(
-          [](capnp::Response<rpc::ActorStorage::Operations::DeleteResults>&& response) mutable
-          -> uint { return response.getNumDeleted(); });
-    };
-
-    size_t recordsDeleted = 0;
-    for (auto& promise: promises) {
-      recordsDeleted += co_await promise;
-    }
+  auto joinCountedDelete = [](RpcCountedDelete& rpcCountedDelete,
+                               kj::Array<kj::Promise<void>> batches) -> kj::Promise<void> {
+    co_await kj::joinPromises(kj::mv(batches));
 
     // This may be a retry following a successful counted delete within a failed transaction.
     // In that case, we don't want to update the count again, since we've already considered it.
     if (!rpcCountedDelete.countedDelete->completedInTransaction) {
       // We only increment our `countDeleted` if *ALL* the delete batches succeeded.
-      rpcCountedDelete.countedDelete->countDeleted += recordsDeleted;
+      rpcCountedDelete.countedDelete->countDeleted += rpcCountedDelete.recordsDeleted;
     }
 
     // This delete succeeded, but we may need to retry it in some cases, ex. if the transaction fails.
@@ -2982,16 +3181,34 @@ kj::Promise<void> ActorCache::flushImplUsingTxn(PutFlush putFlush,
     rpcCountedDelete.countedDelete->completedInTransaction = true;
   };
 
+  // Everything from here until the commit completes counts as the write.
+  auto writeObserver = recordStorageWrite(hooks, clock);
+  util::DurationExceededLogger logger(clock, 1 * kj::SECONDS,
+      "storage operation took longer than expected: commit flush transaction");
+
   for (auto& rpcCountedDelete: rpcCountedDeletes) {
-    promises.add(joinCountedDelete(rpcCountedDelete));
+    auto batches = kj::heapArrayBuilder<kj::Promise<void>>(rpcCountedDelete.rpcDeletes.size());
+    for (auto& request: rpcCountedDelete.rpcDeletes) {
+      auto words = request.totalSize().wordCount;
+      co_await pacer.waitForRoom(words);
+      auto promise = request.send().then(
+          [&rpcCountedDelete](capnp::Response<rpc::ActorStorage::Operations::DeleteResults>&&
+                  response) { rpcCountedDelete.recordsDeleted += response.getNumDeleted(); });
+      batches.add(pacer.track(kj::mv(promise), words));
+    }
+    promises.add(joinCountedDelete(rpcCountedDelete, batches.finish()));
   }
 
   for (auto& request: rpcMutedDeletes) {
-    promises.add(request.sendIgnoringResult());
+    auto words = request.totalSize().wordCount;
+    co_await pacer.waitForRoom(words);
+    promises.add(pacer.track(request.sendIgnoringResult(), words));
   }
 
   for (auto& request: rpcPuts) {
-    promises.add(request.sendIgnoringResult());
+    auto words = request.totalSize().wordCount;
+    co_await pacer.waitForRoom(words);
+    promises.add(pacer.track(request.sendIgnoringResult(), words));
   }
 
   KJ_SWITCH_ONEOF(maybeAlarmChange) {
@@ -3039,18 +3256,13 @@ kj::Promise<void> ActorCache::flushImplUsingTxn(PutFlush putFlush,
   // if the promise is dropped but the pipeline stays alive.
   promises.add(txnProm.ignoreResult());
 
-  {
-    auto writeObserver = recordStorageWrite(hooks, clock);
-    util::DurationExceededLogger logger(clock, 1 * kj::SECONDS,
-        "storage operation took longer than expected: commit flush transaction");
-    promises.add(txn.commitRequest(capnp::MessageSize{4, 0}).sendIgnoringResult());
+  promises.add(txn.commitRequest(capnp::MessageSize{4, 0}).sendIgnoringResult());
 
-    co_await kj::joinPromises(promises.finish());
-    for (auto& rpcCountedDelete: rpcCountedDeletes) {
-      // Now that the transaction has successfully completed, we can mark all our CountedDeletes
-      // as having completed as well.
-      rpcCountedDelete.countedDelete->isFinished = true;
-    }
+  co_await kj::joinPromises(promises.finish());
+  for (auto& rpcCountedDelete: rpcCountedDeletes) {
+    // Now that the transaction has successfully completed, we can mark all our CountedDeletes
+    // as having completed as well.
+    rpcCountedDelete.countedDelete->isFinished = true;
   }
 }
 
@@ -493,7 +493,8 @@ class ActorCache final: public ActorCacheInterface {
     //
     // The mutable content of an `Entry` is protected by the same mutex that protects
     // `lru.cleanList`. `key` and `value` are declared `const` so that they can safely be used
-    // without a lock.
+    // without a lock. The owning cache's thread may also update `isStale` and `noCache` while
+    // holding only a shared lock, since other threads only touch them under an exclusive lock.
 
     Entry(ActorCache& cache, Key key, Value value);
     Entry(ActorCache& cache, Key key, EntryValueStatus status);
@@ -746,6 +747,19 @@ class ActorCache final: public ActorCacheInterface {
   kj::ExternalMutexGuarded<kj::Table<kj::Own<Entry>, kj::TreeIndex<EntryTableCallbacks>>>
       currentValues;
 
+  // Maximum number of touches get() buffers before it falls back to an exclusive lock.
+  static constexpr size_t MAX_PENDING_TOUCHES = 64;
+
+  // Clean entries that get() served under a shared lock, in the order they were hit. A shared
+  // lock can't reorder `lru.cleanList`, so these are moved to its end in a batch by
+  // SharedLru::drainTouches() before anything depends on LRU order. Only this cache's thread
+  // appends, and only while holding a shared lock; draining requires an exclusive lock, so no
+  // other synchronization is needed.
+  kj::Vector<kj::Own<Entry>> pendingTouches;
+
+  // Next cache in `lru.touchedCaches`, if this cache's `pendingTouches` is non-empty.
+  ActorCache* nextTouchedCache = nullptr;
+
   struct UnknownAlarmTime {};
   struct KnownAlarmTime {
     enum class Status { CLEAN, DIRTY, FLUSHING } status;
@@ -813,6 +827,10 @@ class ActorCache final: public ActorCacheInterface {
 
   kj::Maybe<DeleteAllState> requestedDeleteAll;
 
+  // Number of batch RPCs of a flush transaction that may be in flight at once. Adapted to storage
+  // latency by FlushPacer, and kept across flushes.
+  uint flushWindow = 8;
+
   // Promise for the completion of the previous flush. We can only execute one flushImpl() at a time
   // because we can't allow out-of-order writes.
   kj::ForkedPromise<void> lastFlush = kj::Promise<void>(kj::READY_NOW).fork();
@@ -832,10 +850,7 @@ class ActorCache final: public ActorCacheInterface {
 
   // Add this entry to the clean list and set its status to CLEAN.
   // This doesn't do much, but it makes it easier to track what's going on.
-  void addToCleanList(Lock& listLock, Entry& entryRef) {
-    entryRef.setClean();
-    listLock->add(entryRef);
-  }
+  void addToCleanList(Lock& listLock, Entry& entryRef);
 
   // Add this entry to the dirty list and set its status to DIRTY.
   // This doesn't do much, but it makes it easier to track what's going on.
@@ -848,6 +863,14 @@ class ActorCache final: public ActorCacheInterface {
   // the LRU queue.
   void touchEntry(Lock& lock, Entry& entry);
 
+  // Serves get() from cache while holding only a shared lock, so that hits in different actors
+  // don't serialize. Returns kj::none if the regular path is needed: the key isn't cached,
+  // falls in a known-empty gap, or too many touches are already buffered.
+  kj::Maybe<kj::Maybe<Value>> getCachedShared(KeyPtr key, const ReadOptions& options);
+
+  // Moves the entries in `pendingTouches` to the end of the clean list.
+  void applyPendingTouches(Lock& lock);
+
   // TODO(soon) This function mostly belongs on the SharedLru, not the ActorCache. Notably,
   // `removeEntry()` has to do with the shared clean list but `evictEntry()` has to do with
   // the non-shared map. It is like this for now because generalizing the SharedLru into an
@@ -865,8 +888,14 @@ class ActorCache final: public ActorCacheInterface {
   // inserted and will instead immediately have state NOT_IN_CACHE.
   //
   // Either way, a strong reference to the entry is returned.
-  kj::Own<Entry> addReadResultToCache(
-      Lock& lock, Key key, kj::Maybe<capnp::Data::Reader> value, const ReadOptions& readOptions);
+  //
+  // `key` is taken as a plain char array, rather than a Key, so that keys can be passed straight
+  // from a storage response. The key and value of a present entry are copied into a single
+  // allocation.
+  kj::Own<Entry> addReadResultToCache(Lock& lock,
+      kj::ArrayPtr<const char> key,
+      kj::Maybe<capnp::Data::Reader> value,
+      const ReadOptions& readOptions);
 
   // Mark all gaps empty between the begin and end key.
   void markGapsEmpty(Lock& lock, KeyPtr begin, kj::Maybe<KeyPtr> end, const ReadOptions& options);
@@ -952,6 +981,7 @@ class ActorCache final: public ActorCacheInterface {
   // back under the limit.
   kj::Maybe<kj::Promise<void>> getBackpressure();
 
+  class FlushPacer;
   class GetMultiStreamImpl;
   class ForwardListStreamImpl;
   class ReverseListStreamImpl;
@@ -1086,6 +1116,11 @@ class ActorCache::SharedLru {
   // Total byte size of everything that is cached, including dirty values that aren't in `cleanList`.
   mutable std::atomic<size_t> size = 0;
 
+  // Stack of caches with buffered touches, linked through `ActorCache::nextTouchedCache`. Pushed
+  // to concurrently by get() calls holding shared locks on `cleanList`, and emptied only under an
+  // exclusive lock.
+  mutable std::atomic<ActorCache*> touchedCaches = nullptr;
+
   // TimePoint when we should next evict stale entries. Represented as an int64_t of nanoseconds
   // instead of kj::TimePoint to allow for atomic operations.
   mutable std::atomic<int64_t> nextStaleCheckNs = 0;
@@ -1095,6 +1130,9 @@ class ActorCache::SharedLru {
   // appropriate way for the kind of operation being performed.
   bool evictIfNeeded(Lock& lock) const KJ_WARN_UNUSED_RESULT;
 
+  // Applies the touches buffered by every cache, so that `cleanList` is in LRU order.
+  void drainTouches(Lock& lock) const;
+
   friend class ActorCache;
 };
 
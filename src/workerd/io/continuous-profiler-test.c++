@@ -0,0 +1,100 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "continuous-profiler.h"
+
+#include <workerd/jsg/script.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/compat/gzip.h>
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+constexpr kj::StringPtr SPIN_SCRIPT = R"(
+  function spinForAWhile() {
+    let x = 0;
+    for (let i = 0; i < 300000000; i++) x = (x * 31 + i) | 0;
+    return x;
+  }
+  spinForAWhile();
+)"_kj;
+
+kj::String decompress(kj::ArrayPtr<const kj::byte> profile) {
+  kj::ArrayInputStream compressed(profile);
+  kj::GzipInputStream gzip(compressed);
+  auto bytes = gzip.readAllBytes();
+  // The protobuf encoding stores strings verbatim, which is all these tests look for. Replace
+  // NULs so that the result can be searched as a string.
+  for (auto& b: bytes) {
+    if (b == 0) b = ' ';
+  }
+  return kj::heapString(bytes.asChars());
+}
+
+KJ_TEST("encodePprof includes sampled functions and the service label") {
+  TestFixture fixture;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto isolate = env.js.v8Isolate;
+    auto profiler = v8::CpuProfiler::New(isolate);
+    KJ_DEFER(profiler->Dispose());
+
+    v8::HandleScope scope(isolate);
+    auto title = jsg::v8StrIntern(isolate, "test");
+    profiler->StartProfiling(title,
+        v8::CpuProfilingOptions(
+            v8::kLeafNodeLineNumbers, v8::CpuProfilingOptions::kNoSampleLimit, 100));
+    jsg::NonModuleScript::compile(env.js, SPIN_SCRIPT, "spin.js").run(env.js);
+    auto profile = profiler->StopProfiling(title);
+    KJ_ASSERT(profile != nullptr);
+    KJ_DEFER(profile->Delete());
+
+    auto encoded =
+        encodePprof(*profile, "my-service", kj::UNIX_EPOCH, 100 * kj::MICROSECONDS);
+    auto text = decompress(encoded);
+    for (auto expected: {"samples"_kj, "nanoseconds"_kj, "service"_kj, "my-service"_kj,
+           "spinForAWhile"_kj, "spin.js"_kj}) {
+      KJ_EXPECT(text.contains(expected), expected);
+    }
+  });
+}
+
+class RecordingCpuProfiler final: public ContinuousCpuProfiler {
+ public:
+  RecordingCpuProfiler()
+      : ContinuousCpuProfiler({.samplingInterval = 100 * kj::MICROSECONDS,
+          .period = 1 * kj::HOURS}) {}
+
+  struct Written {
+    kj::String isolateId;
+    kj::String text;
+  };
+  mutable kj::Vector<Written> written;
+
+  void write(kj::StringPtr isolateId, kj::Date start, kj::Array<kj::byte> profile) const override {
+    written.add(Written{.isolateId = kj::str(isolateId), .text = decompress(profile)});
+  }
+};
+
+KJ_TEST("ContinuousCpuProfiler writes each isolate's profile when it goes away") {
+  RecordingCpuProfiler profiler;
+
+  {
+    TestFixture fixture({.diagnostics = {.cpuProfiler = profiler}});
+    fixture.runInIoContext([&](const TestFixture::Environment& env) {
+      jsg::NonModuleScript::compile(env.js, SPIN_SCRIPT, "spin.js").run(env.js);
+    });
+
+    // The period hasn't elapsed yet.
+    KJ_EXPECT(profiler.written.size() == 0);
+  }
+
+  KJ_ASSERT(profiler.written.size() == 1);
+  KJ_EXPECT(profiler.written[0].text.contains("spinForAWhile"_kj));
+}
+
+}  // namespace
+}  // namespace workerd
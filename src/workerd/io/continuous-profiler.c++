@@ -0,0 +1,296 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "continuous-profiler.h"
+
+#include <workerd/jsg/jsg.h>
+
+#include <kj/compat/gzip.h>
+#include <kj/debug.h>
+#include <kj/io.h>
+#include <kj/map.h>
+#include <kj/vector.h>
+
+namespace workerd {
+
+namespace {
+
+constexpr kj::StringPtr PROFILE_TITLE = "workerd continuous profile"_kj;
+
+class CpuProfilerDisposer final: public kj::Disposer {
+ public:
+  void disposeImpl(void* pointer) const override {
+    reinterpret_cast<v8::CpuProfiler*>(pointer)->Dispose();
+  }
+
+  static const CpuProfilerDisposer instance;
+};
+
+const CpuProfilerDisposer CpuProfilerDisposer::instance{};
+
+// Just enough of the protobuf wire format to write a pprof Profile message.
+class ProtoWriter {
+ public:
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer.add(static_cast<kj::byte>(value | 0x80));
+      value >>= 7;
+    }
+    buffer.add(static_cast<kj::byte>(value));
+  }
+
+  void writeInt(uint field, uint64_t value) {
+    if (value == 0) return;
+    writeVarint(field << 3);
+    writeVarint(value);
+  }
+
+  void writeBytes(uint field, kj::ArrayPtr<const kj::byte> bytes) {
+    writeVarint(field << 3 | 2);
+    writeVarint(bytes.size());
+    buffer.addAll(bytes);
+  }
+
+  void writeString(uint field, kj::StringPtr text) {
+    writeBytes(field, text.asBytes());
+  }
+
+  void writeMessage(uint field, const ProtoWriter& message) {
+    writeBytes(field, message.buffer);
+  }
+
+  void writePacked(uint field, kj::ArrayPtr<const uint64_t> values) {
+    ProtoWriter packed;
+    for (auto value: values) packed.writeVarint(value);
+    writeMessage(field, packed);
+  }
+
+  kj::ArrayPtr<const kj::byte> asBytes() const {
+    return buffer;
+  }
+
+ private:
+  kj::Vector<kj::byte> buffer;
+};
+
+// Field numbers from pprof's profile.proto.
+namespace pprof {
+constexpr uint PROFILE_SAMPLE_TYPE = 1;
+constexpr uint PROFILE_SAMPLE = 2;
+constexpr uint PROFILE_LOCATION = 4;
+constexpr uint PROFILE_FUNCTION = 5;
+constexpr uint PROFILE_STRING_TABLE = 6;
+constexpr uint PROFILE_TIME_NANOS = 9;
+constexpr uint PROFILE_DURATION_NANOS = 10;
+constexpr uint PROFILE_PERIOD_TYPE = 11;
+constexpr uint PROFILE_PERIOD = 12;
+constexpr uint VALUE_TYPE_TYPE = 1;
+constexpr uint VALUE_TYPE_UNIT = 2;
+constexpr uint SAMPLE_LOCATION_ID = 1;
+constexpr uint SAMPLE_VALUE = 2;
+constexpr uint SAMPLE_LABEL = 3;
+constexpr uint LABEL_KEY = 1;
+constexpr uint LABEL_STR = 2;
+constexpr uint LOCATION_ID = 1;
+constexpr uint LOCATION_LINE = 4;
+constexpr uint LINE_FUNCTION_ID = 1;
+constexpr uint LINE_LINE = 2;
+constexpr uint FUNCTION_ID = 1;
+constexpr uint FUNCTION_NAME = 2;
+constexpr uint FUNCTION_FILENAME = 4;
+constexpr uint FUNCTION_START_LINE = 5;
+}  // namespace pprof
+
+class StringTable {
+ public:
+  StringTable() {
+    strings.add(kj::str());
+    indices.insert(kj::str(), 0);
+  }
+
+  uint64_t operator[](kj::StringPtr text) {
+    return indices.findOrCreate(text, [&]() -> kj::HashMap<kj::String, uint64_t>::Entry {
+      strings.add(kj::str(text));
+      return {kj::str(text), strings.size() - 1};
+    });
+  }
+
+  void writeTo(ProtoWriter& profile) {
+    for (auto& text: strings) profile.writeString(pprof::PROFILE_STRING_TABLE, text);
+  }
+
+ private:
+  kj::Vector<kj::String> strings;
+  kj::HashMap<kj::String, uint64_t> indices;
+};
+
+}  // namespace
+
+kj::Array<kj::byte> encodePprof(const v8::CpuProfile& profile,
+    kj::StringPtr serviceName,
+    kj::Date start,
+    kj::Duration samplingInterval) {
+  ProtoWriter out;
+  StringTable strings;
+
+  auto writeValueType = [&](uint field, kj::StringPtr type, kj::StringPtr unit) {
+    ProtoWriter valueType;
+    valueType.writeInt(pprof::VALUE_TYPE_TYPE, strings[type]);
+    valueType.writeInt(pprof::VALUE_TYPE_UNIT, strings[unit]);
+    out.writeMessage(field, valueType);
+  };
+  writeValueType(pprof::PROFILE_SAMPLE_TYPE, "samples", "count");
+  writeValueType(pprof::PROFILE_SAMPLE_TYPE, "cpu", "nanoseconds");
+
+  // V8's tree has a node per distinct call stack. pprof wants one Function per function, and we
+  // give each Function a single Location, since V8 only tells us which line a function starts
+  // on. Both are keyed by script, position, and name.
+  kj::HashMap<kj::String, uint64_t> functionIds;
+  kj::HashMap<const v8::CpuProfileNode*, uint64_t> nodeLocations;
+  auto getLocation = [&](const v8::CpuProfileNode& node) -> uint64_t {
+    KJ_IF_SOME(id, nodeLocations.find(&node)) {
+      return id;
+    }
+    kj::StringPtr name = node.GetFunctionNameStr();
+    if (name.size() == 0) name = "(anonymous)"_kj;
+    kj::StringPtr script = node.GetScriptResourceNameStr();
+    auto line = node.GetLineNumber();
+    auto key = kj::str(node.GetScriptId(), ':', line, ':', node.GetColumnNumber(), ':', name);
+    auto id = functionIds.findOrCreate(key, [&]() -> kj::HashMap<kj::String, uint64_t>::Entry {
+      uint64_t id = functionIds.size() + 1;
+
+      ProtoWriter function;
+      function.writeInt(pprof::FUNCTION_ID, id);
+      function.writeInt(pprof::FUNCTION_NAME, strings[name]);
+      function.writeInt(pprof::FUNCTION_FILENAME, strings[script]);
+      function.writeInt(pprof::FUNCTION_START_LINE, kj::max(line, 0));
+      out.writeMessage(pprof::PROFILE_FUNCTION, function);
+
+      ProtoWriter lineInfo;
+      lineInfo.writeInt(pprof::LINE_FUNCTION_ID, id);
+      lineInfo.writeInt(pprof::LINE_LINE, kj::max(line, 0));
+      ProtoWriter location;
+      location.writeInt(pprof::LOCATION_ID, id);
+      location.writeMessage(pprof::LOCATION_LINE, lineInfo);
+      out.writeMessage(pprof::PROFILE_LOCATION, location);
+
+      return {kj::str(key), id};
+    });
+    nodeLocations.insert(&node, id);
+    return id;
+  };
+
+  auto intervalNs = samplingInterval / kj::NANOSECONDS;
+  ProtoWriter label;
+  label.writeInt(pprof::LABEL_KEY, strings["service"]);
+  label.writeInt(pprof::LABEL_STR, strings[serviceName]);
+
+  kj::Vector<const v8::CpuProfileNode*> unvisited;
+  unvisited.add(profile.GetTopDownRoot());
+  kj::Vector<uint64_t> stack;
+  while (!unvisited.empty()) {
+    auto node = unvisited.back();
+    unvisited.removeLast();
+    for (int i = 0; i < node->GetChildrenCount(); i++) {
+      unvisited.add(node->GetChild(i));
+    }
+
+    // Idle samples are taken while the isolate waits for work; they aren't CPU time.
+    uint64_t hits = node->GetHitCount();
+    if (hits == 0 || node->GetParent() == nullptr ||
+        kj::StringPtr(node->GetFunctionNameStr()) == "(idle)"_kj) {
+      continue;
+    }
+
+    // Leaf first, stopping short of the synthetic "(root)" node.
+    stack.clear();
+    for (auto frame = node; frame->GetParent() != nullptr; frame = frame->GetParent()) {
+      stack.add(getLocation(*frame));
+    }
+
+    ProtoWriter sample;
+    sample.writePacked(pprof::SAMPLE_LOCATION_ID, stack);
+    const uint64_t values[] = {hits, hits * intervalNs};
+    sample.writePacked(pprof::SAMPLE_VALUE, values);
+    sample.writeMessage(pprof::SAMPLE_LABEL, label);
+    out.writeMessage(pprof::PROFILE_SAMPLE, sample);
+  }
+
+  out.writeInt(pprof::PROFILE_TIME_NANOS, (start - kj::UNIX_EPOCH) / kj::NANOSECONDS);
+  // V8's timestamps are in microseconds.
+  out.writeInt(
+      pprof::PROFILE_DURATION_NANOS, (profile.GetEndTime() - profile.GetStartTime()) * 1000);
+  writeValueType(pprof::PROFILE_PERIOD_TYPE, "cpu", "nanoseconds");
+  out.writeInt(pprof::PROFILE_PERIOD, intervalNs);
+
+  // The string table goes last since everything above adds to it.
+  strings.writeTo(out);
+
+  kj::VectorOutputStream compressed;
+  {
+    kj::GzipOutputStream gzip(compressed);
+    gzip.write(out.asBytes());
+  }
+  return kj::heapArray(compressed.getArray());
+}
+
+ContinuousCpuProfiler::ContinuousCpuProfiler(Options options): options(options) {
+  KJ_REQUIRE(options.samplingInterval >= 1 * kj::MICROSECONDS,
+      "CPU profile sampling interval must be at least a microsecond");
+}
+
+ContinuousCpuProfiler::~ContinuousCpuProfiler() noexcept(false) {}
+
+ContinuousCpuProfiler::Session::Session(
+    const ContinuousCpuProfiler& profiler, v8::Isolate* isolate, kj::StringPtr isolateId)
+    : profiler(profiler),
+      isolate(isolate),
+      isolateId(kj::str(isolateId)),
+      cpuProfiler(v8::CpuProfiler::New(isolate, v8::kDebugNaming, v8::kLazyLogging),
+          CpuProfilerDisposer::instance),
+      startTime(kj::origin<kj::TimePoint>()),
+      startDate(kj::UNIX_EPOCH) {
+  start();
+}
+
+ContinuousCpuProfiler::Session::~Session() noexcept(false) {
+  finish();
+}
+
+void ContinuousCpuProfiler::Session::maybeRotate() {
+  if (kj::systemPreciseMonotonicClock().now() - startTime >= profiler.options.period) {
+    finish();
+    start();
+  }
+}
+
+void ContinuousCpuProfiler::Session::start() {
+  startTime = kj::systemPreciseMonotonicClock().now();
+  startDate = kj::systemPreciseCalendarClock().now();
+
+  v8::HandleScope scope(isolate);
+  v8::CpuProfilingOptions options(v8::kLeafNodeLineNumbers,
+      v8::CpuProfilingOptions::kNoSampleLimit,
+      static_cast<int>(profiler.options.samplingInterval / kj::MICROSECONDS));
+  cpuProfiler->StartProfiling(jsg::v8StrIntern(isolate, PROFILE_TITLE), kj::mv(options));
+}
+
+void ContinuousCpuProfiler::Session::finish() {
+  v8::HandleScope scope(isolate);
+  auto profile = cpuProfiler->StopProfiling(jsg::v8StrIntern(isolate, PROFILE_TITLE));
+  if (profile == nullptr) return;
+  KJ_DEFER(profile->Delete());
+
+  // Don't leave empty files behind for isolates that did nothing.
+  if (profile->GetSamplesCount() == 0) return;
+
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+    auto encoded = encodePprof(*profile, isolateId, startDate, profiler.options.samplingInterval);
+    profiler.write(isolateId, startDate, kj::mv(encoded));
+  })) {
+    KJ_LOG(ERROR, "failed to write CPU profile", isolateId, exception);
+  }
+}
+
+}  // namespace workerd
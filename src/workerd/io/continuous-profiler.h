@@ -0,0 +1,88 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <v8-isolate.h>
+#include <v8-profiler.h>
+
+#include <kj/array.h>
+#include <kj/string.h>
+#include <kj/time.h>
+
+namespace workerd {
+
+// Samples the JavaScript running in every isolate with V8's CpuProfiler, without an inspector
+// session, and hands each isolate's samples to write() as a gzipped pprof profile once per
+// `period`. Samples from all requests to an isolate over a period are aggregated into one
+// profile, so profiles from many processes can be merged directly by pprof tooling.
+//
+// Worker::Isolate starts a Session for itself the first time it's locked, if it was given a
+// ContinuousCpuProfiler through Worker::Isolate::Diagnostics. The profiler must outlive every
+// Session. Sessions only look at the clock when their isolate is locked, so a profile that is due
+// is written on the isolate's next lock, and an isolate that goes idle keeps its last samples
+// until then or until it is destroyed.
+class ContinuousCpuProfiler {
+ public:
+  struct Options {
+    // Time between samples. V8 samples on a dedicated thread per profiled isolate; at the default
+    // of 10ms the overhead is negligible.
+    kj::Duration samplingInterval = 10 * kj::MILLISECONDS;
+
+    // How often each isolate's profile is written out and restarted.
+    kj::Duration period = 60 * kj::SECONDS;
+  };
+
+  explicit ContinuousCpuProfiler(Options options);
+  virtual ~ContinuousCpuProfiler() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(ContinuousCpuProfiler);
+
+  // Called with each finished profile, on the isolate's thread with the isolate locked.
+  // `isolateId` is the Worker::Isolate's ID (the service name, in workerd) and `start` is when the
+  // profile's first sample could have been taken. Exceptions are logged and otherwise ignored.
+  //
+  // Stopping the profiler and encoding the profile already happen under the lock, since they need
+  // V8. Implementations that do I/O should take `profile` elsewhere to do it rather than block the
+  // isolate further.
+  virtual void write(
+      kj::StringPtr isolateId, kj::Date start, kj::Array<kj::byte> profile) const = 0;
+
+  // Profiles one isolate. Must be constructed, used, and destroyed with the isolate locked.
+  // Writes out whatever it has collected when destroyed.
+  class Session {
+   public:
+    Session(const ContinuousCpuProfiler& profiler, v8::Isolate* isolate, kj::StringPtr isolateId);
+    ~Session() noexcept(false);
+    KJ_DISALLOW_COPY_AND_MOVE(Session);
+
+    // Writes out the current profile and starts the next one, if the period has elapsed. Called
+    // each time the isolate is locked.
+    void maybeRotate();
+
+   private:
+    const ContinuousCpuProfiler& profiler;
+    v8::Isolate* isolate;
+    kj::String isolateId;
+    kj::Own<v8::CpuProfiler> cpuProfiler;
+    kj::TimePoint startTime;
+    kj::Date startDate;
+
+    void start();
+    void finish();
+  };
+
+ private:
+  Options options;
+};
+
+// Encodes `profile` as a gzipped pprof profile (see github.com/google/pprof, proto/profile.proto)
+// with `samples/count` and `cpu/nanoseconds` sample types, aggregated by stack. Each sample is
+// labeled with `service` = `serviceName`. `start` becomes the profile's `time_nanos`, since V8's
+// own timestamps aren't based on the epoch.
+kj::Array<kj::byte> encodePprof(const v8::CpuProfile& profile,
+    kj::StringPtr serviceName,
+    kj::Date start,
+    kj::Duration samplingInterval);
+
+}  // namespace workerd
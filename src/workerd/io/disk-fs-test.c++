@@ -0,0 +1,105 @@
+#include <workerd/io/disk-fs.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/filesystem.h>
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+kj::Own<const kj::Directory> makeHostDirectory() {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  dir->openFile(kj::Path({"a", "hello.txt"}), kj::WriteMode::CREATE | kj::WriteMode::CREATE_PARENT)
+      ->writeAll("hello world"_kj);
+  dir->openFile(kj::Path({".secret"}), kj::WriteMode::CREATE)->writeAll("shh"_kj);
+  dir->openFile(kj::Path({"empty"}), kj::WriteMode::CREATE);
+  return kj::mv(dir);
+}
+
+KJ_TEST("Read-only disk directory") {
+  TestFixture fixture;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    kj::Own<const kj::Directory> host = makeHostDirectory();
+    auto dir = newDiskDirectory(kj::Own<const kj::ReadableDirectory>(kj::mv(host)));
+
+    KJ_REQUIRE_NONNULL(dir->tryOpen(env.js, kj::Path({"a"})));
+    KJ_EXPECT(dir->tryOpen(env.js, kj::Path({"zzz"})) == kj::none);
+
+    // Dotfiles are hidden by default.
+    KJ_EXPECT(dir->tryOpen(env.js, kj::Path({".secret"})) == kj::none);
+    KJ_EXPECT(dir->count(env.js) == 2);
+
+    auto maybeFile = dir->tryOpen(env.js, kj::Path({"a", "hello.txt"}));
+    auto& file = KJ_ASSERT_NONNULL(maybeFile).get<kj::Rc<File>>();
+    auto stat = file->stat(env.js);
+    KJ_EXPECT(stat.type == FsType::FILE);
+    KJ_EXPECT(stat.size == 11);
+    KJ_EXPECT(!stat.writable);
+
+    kj::byte buffer[5];
+    KJ_EXPECT(file->read(env.js, 6, buffer) == 5);
+    KJ_EXPECT(kj::arrayPtr(buffer).asChars() == "world"_kj);
+    KJ_EXPECT(file->read(env.js, 11, buffer) == 0);
+
+    auto maybeEmpty = dir->tryOpen(env.js, kj::Path({"empty"}));
+    auto& empty = KJ_ASSERT_NONNULL(maybeEmpty).get<kj::Rc<File>>();
+    KJ_EXPECT(empty->read(env.js, 0, buffer) == 0);
+
+    // Mutations are rejected.
+    KJ_EXPECT(file->write(env.js, 0, "x"_kj).get<FsError>() == FsError::READ_ONLY);
+    auto created = dir->tryOpen(env.js, kj::Path({"new"}), {.createAs = FsType::FILE});
+    KJ_EXPECT(KJ_ASSERT_NONNULL(created).get<FsError>() == FsError::READ_ONLY);
+    KJ_EXPECT(dir->remove(env.js, kj::Path({"empty"})).get<FsError>() == FsError::READ_ONLY);
+  });
+}
+
+KJ_TEST("Disk directory with dotfiles allowed") {
+  TestFixture fixture;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto dir = newDiskDirectory(makeHostDirectory(), {.allowDotfiles = true});
+    KJ_REQUIRE_NONNULL(dir->tryOpen(env.js, kj::Path({".secret"})));
+    KJ_EXPECT(dir->count(env.js) == 3);
+  });
+}
+
+KJ_TEST("Writable disk directory") {
+  TestFixture fixture;
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto host = makeHostDirectory();
+    auto& hostRef = *host;
+    auto dir = newDiskDirectory(kj::mv(host));
+
+    KJ_EXPECT(dir->count(env.js) == 2);
+
+    auto created = dir->tryOpen(env.js, kj::Path({"b", "new.txt"}), {.createAs = FsType::FILE});
+    auto& file = KJ_ASSERT_NONNULL(created).get<kj::Rc<File>>();
+    KJ_EXPECT(file->stat(env.js).writable);
+    KJ_EXPECT(file->write(env.js, 0, "abc"_kj).get<uint32_t>() == 3);
+    KJ_EXPECT(hostRef.openFile(kj::Path({"b", "new.txt"}))->readAllText() == "abc"_kj);
+
+    // The listing is refreshed after a mutation through the VFS.
+    KJ_EXPECT(dir->count(env.js) == 3);
+
+    kj::byte buffer[3];
+    KJ_EXPECT(file->read(env.js, 0, buffer) == 3);
+    KJ_EXPECT(kj::arrayPtr(buffer).asChars() == "abc"_kj);
+
+    KJ_EXPECT(file->resize(env.js, 1) == kj::none);
+    KJ_EXPECT(file->stat(env.js).size == 1);
+
+    KJ_EXPECT(dir->remove(env.js, kj::Path({"b"})).get<FsError>() == FsError::NOT_EMPTY);
+    KJ_EXPECT(dir->remove(env.js, kj::Path({"b"}), {.recursive = true}).get<bool>());
+    KJ_EXPECT(hostRef.tryLstat(kj::Path({"b"})) == kj::none);
+    KJ_EXPECT(dir->count(env.js) == 2);
+
+    // Dotfiles cannot be created even when writable.
+    auto hidden = dir->tryOpen(env.js, kj::Path({".other"}), {.createAs = FsType::FILE});
+    KJ_EXPECT(KJ_ASSERT_NONNULL(hidden).get<FsError>() == FsError::NOT_PERMITTED);
+  });
+}
+
+}  // namespace
+}  // namespace workerd
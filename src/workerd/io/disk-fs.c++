@@ -0,0 +1,523 @@
+#include "disk-fs.h"
+
+#include <workerd/io/io-context.h>
+#include <workerd/io/worker.h>
+#include <workerd/util/uuid.h>
+
+#include <algorithm>
+
+namespace workerd {
+namespace {
+
+// The size of the intermediate buffer used when copying data into a host file
+// from another File, or when filling a host file with a non-zero value.
+static constexpr size_t kCopyChunkSize = 64 * 1024;
+
+// The host directory handle backing a mount. It is shared by every DiskDirectory
+// and DiskFile created from the mount so that nodes address the host file system
+// by their path relative to the mount root rather than each holding an open
+// file descriptor. Like all other VFS nodes, these are only ever accessed while
+// holding the isolate lock so a non-atomic refcount is sufficient.
+class HostDirectory final: public kj::Refcounted {
+ public:
+  HostDirectory(kj::Own<const kj::ReadableDirectory> dir, DiskDirectoryOptions options)
+      : readable(kj::mv(dir)),
+        options(options) {}
+  HostDirectory(kj::Own<const kj::Directory> dir, DiskDirectoryOptions options)
+      : writable(*dir),
+        readable(kj::mv(dir)),
+        options(options) {}
+  KJ_DISALLOW_COPY_AND_MOVE(HostDirectory);
+
+  const kj::ReadableDirectory& getReadable() const {
+    return *readable;
+  }
+
+  kj::Maybe<const kj::Directory&> getWritable() const {
+    return writable;
+  }
+
+  bool isWritable() const {
+    return writable != kj::none;
+  }
+
+  bool isHidden(kj::PathPtr path) const {
+    if (options.allowDotfiles) return false;
+    for (auto& part: path) {
+      if (part.startsWith(".")) return true;
+    }
+    return false;
+  }
+
+  const DiskDirectoryOptions& getOptions() const {
+    return options;
+  }
+
+  // Like tryLstat() but, if the path names a symbolic link, returns the metadata
+  // of the link target instead. Symbolic links are followed the same way the
+  // DiskDirectory service follows them.
+  kj::Maybe<kj::FsNode::Metadata> tryStat(kj::PathPtr path) const {
+    KJ_IF_SOME(meta, readable->tryLstat(path)) {
+      if (meta.type != kj::FsNode::Type::SYMLINK) return meta;
+      KJ_IF_SOME(subdir, readable->tryOpenSubdir(path)) {
+        return subdir->stat();
+      }
+      KJ_IF_SOME(file, readable->tryOpenFile(path)) {
+        return file->stat();
+      }
+    }
+    return kj::none;
+  }
+
+ private:
+  kj::Maybe<const kj::Directory&> writable;
+  kj::Own<const kj::ReadableDirectory> readable;
+  DiskDirectoryOptions options;
+};
+
+kj::StringPtr getOrCreateUniqueId(kj::Maybe<kj::String>& maybeUniqueId) {
+  KJ_IF_SOME(id, maybeUniqueId) {
+    return id;
+  }
+  // Generating a UUID requires randomness, which requires an IoContext.
+  auto& ioContext = JSG_REQUIRE_NONNULL(
+      IoContext::tryCurrent(), Error, "Cannot generate a unique ID outside of a request");
+  maybeUniqueId = workerd::randomUUID(ioContext.getEntropySource());
+  return KJ_ASSERT_NONNULL(maybeUniqueId);
+}
+
+// A file on the host file system. The host file is opened lazily on first use
+// so that listing a directory with many entries does not open every file.
+class DiskFile final: public File {
+ public:
+  DiskFile(kj::Rc<HostDirectory> host, kj::Path path): host(kj::mv(host)), path(kj::mv(path)) {}
+
+  kj::Maybe<FsError> setLastModified(jsg::Lock& js, kj::Date date) override {
+    // The kj filesystem API does not provide a way to set the modification time
+    // of a host file so, like read-only in-memory files, this is a non-op.
+    return kj::none;
+  }
+
+  Stat stat(jsg::Lock& js) override {
+    auto meta = getHandle().stat();
+    return Stat{
+      .type = FsType::FILE,
+      .size = meta.size,
+      .lastModified = meta.lastModified,
+      .writable = host->isWritable(),
+    };
+  }
+
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+    // Host files aren't capped in size like in-memory ones, so a read may have more to return
+    // than fits in the result.
+    buffer = buffer.first(kj::min(buffer.size(), (uint32_t)kj::maxValue));
+    if (buffer.size() == 0) return 0;
+    if (host->isWritable()) {
+      // Writable files may change size underneath a mapping so we read them directly.
+      return static_cast<uint32_t>(getHandle().read(offset, buffer));
+    }
+    auto data = getMapping();
+    if (offset >= data.size()) return 0;
+    auto src = data.slice(offset);
+    auto amount = kj::min(src.size(), buffer.size());
+    buffer.first(amount).copyFrom(src.first(amount));
+    return static_cast<uint32_t>(amount);
+  }
+
+  kj::OneOf<FsError, uint32_t> write(
+      jsg::Lock& js, uint32_t offset, kj::ArrayPtr<const kj::byte> data) override {
+    auto& file = KJ_UNWRAP_OR(getWritableHandle(), return FsError::READ_ONLY);
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { file.write(offset, data); })) {
+      KJ_LOG(WARNING, "failed to write to mounted host file", path, exception);
+      return FsError::FAILED;
+    }
+    return static_cast<uint32_t>(data.size());
+  }
+
+  kj::Maybe<FsError> fill(jsg::Lock& js, kj::byte val, kj::Maybe<uint32_t> offset) override {
+    auto& file = KJ_UNWRAP_OR(getWritableHandle(), return FsError::READ_ONLY);
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+      uint64_t size = file.stat().size;
+      uint64_t start = offset.orDefault(0);
+      if (start >= size) return;
+      if (val == 0) {
+        file.zero(start, size - start);
+        return;
+      }
+      auto chunk = kj::heapArray<kj::byte>(kj::min(size - start, kCopyChunkSize));
+      chunk.asPtr().fill(val);
+      while (start < size) {
+        auto amount = kj::min(size - start, chunk.size());
+        file.write(start, chunk.first(amount));
+        start += amount;
+      }
+    })) {
+      KJ_LOG(WARNING, "failed to fill mounted host file", path, exception);
+      return FsError::FAILED;
+    }
+    return kj::none;
+  }
+
+  kj::Maybe<FsError> resize(jsg::Lock& js, uint32_t size) override {
+    auto& file = KJ_UNWRAP_OR(getWritableHandle(), return FsError::READ_ONLY);
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { file.truncate(size); })) {
+      KJ_LOG(WARNING, "failed to resize mounted host file", path, exception);
+      return FsError::FAILED;
+    }
+    return kj::none;
+  }
+
+  kj::StringPtr jsgGetMemoryName() const override {
+    return "DiskFile"_kj;
+  }
+
+  size_t jsgGetMemorySelfSize() const override {
+    return sizeof(DiskFile);
+  }
+
+  void jsgGetMemoryInfo(jsg::MemoryTracker& tracker) const override {
+    // The contents of host files are either memory-mapped or read on demand,
+    // neither of which is held on the isolate heap.
+  }
+
+  kj::OneOf<FsError, kj::Rc<File>> clone(jsg::Lock& js) override {
+    // Cloning produces an in-memory copy, so it is subject to the same size
+    // limit as any other in-memory file.
+    auto maxSize = Worker::Isolate::from(js).getLimitEnforcer().getBlobSizeLimit();
+    if (host->isWritable()) {
+      if (getHandle().stat().size > maxSize) [[unlikely]] {
+        return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+      }
+      return copyToWritable(js, getHandle().readAllBytes());
+    }
+    auto data = getMapping();
+    if (data.size() > maxSize) [[unlikely]] {
+      return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+    }
+    return copyToWritable(js, data);
+  }
+
+  kj::Maybe<FsError> replace(jsg::Lock& js, kj::Rc<File> other) override {
+    auto& file = KJ_UNWRAP_OR(getWritableHandle(), return FsError::READ_ONLY);
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+      file.truncate(0);
+      copyInto(js, file, *other);
+    })) {
+      KJ_LOG(WARNING, "failed to replace mounted host file", path, exception);
+      return FsError::FAILED;
+    }
+    return kj::none;
+  }
+
+  kj::StringPtr getUniqueId(jsg::Lock&) const override {
+    return getOrCreateUniqueId(maybeUniqueId);
+  }
+
+  // Copies the full contents of the given file into the host file, starting at
+  // offset 0. The host file is expected to be empty.
+  static void copyInto(jsg::Lock& js, const kj::File& dest, File& src) {
+    auto chunk = kj::heapArray<kj::byte>(kCopyChunkSize);
+    uint64_t offset = 0;
+    for (;;) {
+      auto amount = src.read(js, offset, chunk);
+      if (amount == 0) break;
+      dest.write(offset, chunk.first(amount));
+      offset += amount;
+      if (amount < chunk.size()) break;
+    }
+  }
+
+ private:
+  mutable kj::Rc<HostDirectory> host;
+  kj::Path path;
+  mutable kj::Maybe<kj::Own<const kj::ReadableFile>> maybeHandle;
+  mutable kj::Maybe<kj::Own<const kj::File>> maybeWritableHandle;
+  // The read-only mapping of the entire file. Only used for read-only mounts.
+  mutable kj::Maybe<kj::Array<const kj::byte>> maybeMapping;
+  mutable kj::Maybe<kj::String> maybeUniqueId;
+
+  // Opened read-only even on writable mounts, so that stat() and read() never need write access
+  // to the host file.
+  const kj::ReadableFile& getHandle() const {
+    KJ_IF_SOME(handle, maybeHandle) {
+      return *handle;
+    }
+    return *maybeHandle.emplace(host->getReadable().openFile(path));
+  }
+
+  // Opened separately, the first time something writes to the file.
+  kj::Maybe<const kj::File&> getWritableHandle() const {
+    KJ_IF_SOME(handle, maybeWritableHandle) {
+      return *handle;
+    }
+    KJ_IF_SOME(dir, host->getWritable()) {
+      return *maybeWritableHandle.emplace(dir.openFile(path, kj::WriteMode::MODIFY));
+    }
+    return kj::none;
+  }
+
+  kj::ArrayPtr<const kj::byte> getMapping() const {
+    KJ_IF_SOME(mapping, maybeMapping) {
+      return mapping;
+    }
+    auto& handle = getHandle();
+    auto size = handle.stat().size;
+    // Mapping a zero-length file is not permitted, so empty files just get an
+    // empty array.
+    auto mapping = size == 0 ? kj::Array<const kj::byte>() : handle.mmap(0, size);
+    return maybeMapping.emplace(kj::mv(mapping));
+  }
+
+  static kj::Rc<File> copyToWritable(jsg::Lock& js, kj::ArrayPtr<const kj::byte> data) {
+    auto file = File::newWritable(js, static_cast<uint32_t>(data.size()));
+    KJ_ASSERT(file->write(js, 0, data).is<uint32_t>());
+    return kj::mv(file);
+  }
+};
+
+// A directory on the host file system. Instances are cheap to create: they hold
+// only a reference to the mount's host directory and their path within it.
+class DiskDirectory final: public Directory {
+ public:
+  DiskDirectory(kj::Rc<HostDirectory> host, kj::Path path): host(kj::mv(host)), path(kj::mv(path)) {}
+
+  kj::Maybe<kj::OneOf<FsError, Stat>> stat(jsg::Lock& js, kj::PathPtr ptr) override {
+    if (host->isHidden(ptr)) return kj::none;
+    auto meta = KJ_UNWRAP_OR(host->tryStat(path.append(ptr)), return kj::none);
+    KJ_IF_SOME(type, toFsType(meta.type)) {
+      return kj::Maybe<kj::OneOf<FsError, Stat>>(Stat{
+        .type = type,
+        .size = type == FsType::FILE ? meta.size : 0,
+        .lastModified = meta.lastModified,
+        .writable = host->isWritable(),
+      });
+    }
+    return kj::Maybe<kj::OneOf<FsError, Stat>>(FsError::NOT_SUPPORTED);
+  }
+
+  size_t count(jsg::Lock& js, kj::Maybe<FsType> typeFilter = kj::none) override {
+    auto& entries = getEntries();
+    KJ_IF_SOME(type, typeFilter) {
+      return std::count_if(entries.begin(), entries.end(), [type](const auto& entry) {
+        KJ_SWITCH_ONEOF(entry.value) {
+          KJ_CASE_ONEOF(file, kj::Rc<File>) {
+            return type == FsType::FILE;
+          }
+          KJ_CASE_ONEOF(dir, kj::Rc<Directory>) {
+            return type == FsType::DIRECTORY;
+          }
+          KJ_CASE_ONEOF(link, kj::Rc<SymbolicLink>) {
+            return type == FsType::SYMLINK;
+          }
+        }
+        KJ_UNREACHABLE;
+      });
+    }
+    return entries.size();
+  }
+
+  Entry* begin() override {
+    return getEntries().begin();
+  }
+
+  Entry* end() override {
+    return getEntries().end();
+  }
+
+  const Entry* begin() const override {
+    return getEntries().begin();
+  }
+
+  const Entry* end() const override {
+    return getEntries().end();
+  }
+
+  kj::Maybe<FsNodeWithError> tryOpen(
+      jsg::Lock& js, kj::PathPtr ptr, OpenOptions opts = {}) override {
+    if (ptr.size() == 0) {
+      return kj::Maybe<FsNodeWithError>(kj::Rc<Directory>(addRefToThis()));
+    }
+    if (host->isHidden(ptr)) {
+      if (opts.createAs != kj::none) {
+        return kj::Maybe<FsNodeWithError>(FsError::NOT_PERMITTED);
+      }
+      return kj::none;
+    }
+
+    auto target = path.append(ptr);
+    KJ_IF_SOME(meta, host->tryStat(target)) {
+      return kj::Maybe<FsNodeWithError>(openNode(kj::mv(target), meta.type));
+    }
+
+    KJ_IF_SOME(type, opts.createAs) {
+      auto& dir = KJ_UNWRAP_OR(
+          host->getWritable(), return kj::Maybe<FsNodeWithError>(FsError::READ_ONLY));
+      auto mode = kj::WriteMode::CREATE | kj::WriteMode::CREATE_PARENT;
+      switch (type) {
+        case FsType::FILE: {
+          dir.openFile(target, mode);
+          maybeEntries = kj::none;
+          kj::Rc<File> file = kj::rc<DiskFile>(host.addRef(), kj::mv(target));
+          return kj::Maybe<FsNodeWithError>(kj::mv(file));
+        }
+        case FsType::DIRECTORY: {
+          dir.openSubdir(target, mode);
+          maybeEntries = kj::none;
+          kj::Rc<Directory> subdir = kj::rc<DiskDirectory>(host.addRef(), kj::mv(target));
+          return kj::Maybe<FsNodeWithError>(kj::mv(subdir));
+        }
+        case FsType::SYMLINK: {
+          return kj::Maybe<FsNodeWithError>(FsError::NOT_PERMITTED);
+        }
+      }
+    }
+
+    return kj::none;
+  }
+
+  kj::Maybe<FsError> add(jsg::Lock& js, kj::StringPtr name, Item item) override {
+    auto& dir = KJ_UNWRAP_OR(host->getWritable(), return FsError::NOT_PERMITTED);
+    kj::Path child(nullptr);
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { child = path.append(name); })) {
+      return FsError::INVALID_PATH;
+    }
+    if (host->isHidden(child)) return FsError::NOT_PERMITTED;
+    if (dir.exists(child)) return FsError::ALREADY_EXISTS;
+
+    KJ_SWITCH_ONEOF(item) {
+      KJ_CASE_ONEOF(file, kj::Rc<File>) {
+        // Entries from elsewhere in the virtual file system are in-memory, so
+        // adding one here means copying its contents out to the host.
+        KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+          auto dest = dir.openFile(child, kj::WriteMode::CREATE);
+          DiskFile::copyInto(js, *dest, *file);
+        })) {
+          KJ_LOG(WARNING, "failed to copy file into mounted host directory", child, exception);
+          return FsError::FAILED;
+        }
+        maybeEntries = kj::none;
+        return kj::none;
+      }
+      KJ_CASE_ONEOF(subdir, kj::Rc<Directory>) {
+        return FsError::NOT_SUPPORTED;
+      }
+      KJ_CASE_ONEOF(link, kj::Rc<SymbolicLink>) {
+        return FsError::NOT_SUPPORTED;
+      }
+    }
+    KJ_UNREACHABLE;
+  }
+
+  kj::OneOf<FsError, bool> remove(
+      jsg::Lock& js, kj::PathPtr ptr, RemoveOptions opts = {}) override {
+    auto& dir = KJ_UNWRAP_OR(host->getWritable(), return FsError::READ_ONLY);
+    if (ptr.size() == 0 || host->isHidden(ptr)) return false;
+    auto target = path.append(ptr);
+    // Note that we do not follow symbolic links here. Removing a link removes
+    // the link itself, not its target.
+    auto meta = KJ_UNWRAP_OR(dir.tryLstat(target), return false);
+    if (meta.type == kj::FsNode::Type::DIRECTORY && !opts.recursive) {
+      auto subdir = dir.openSubdir(target);
+      if (subdir->listNames().size() > 0) {
+        return FsError::NOT_EMPTY;
+      }
+    }
+    maybeEntries = kj::none;
+    return dir.tryRemove(target);
+  }
+
+  kj::StringPtr jsgGetMemoryName() const override {
+    return "DiskDirectory"_kj;
+  }
+
+  size_t jsgGetMemorySelfSize() const override {
+    return sizeof(DiskDirectory);
+  }
+
+  void jsgGetMemoryInfo(jsg::MemoryTracker& tracker) const override {
+    // Host directories are not counted towards the isolate.
+  }
+
+  kj::StringPtr getUniqueId(jsg::Lock&) const override {
+    return getOrCreateUniqueId(maybeUniqueId);
+  }
+
+ private:
+  mutable kj::Rc<HostDirectory> host;
+  kj::Path path;
+  mutable kj::Maybe<kj::HashMap<kj::String, Item>> maybeEntries;
+  mutable kj::Maybe<kj::String> maybeUniqueId;
+
+  static kj::Maybe<FsType> toFsType(kj::FsNode::Type type) {
+    switch (type) {
+      case kj::FsNode::Type::FILE:
+        return FsType::FILE;
+      case kj::FsNode::Type::DIRECTORY:
+        return FsType::DIRECTORY;
+      default:
+        // Devices, pipes, sockets, etc are not exposed through the virtual file system.
+        return kj::none;
+    }
+  }
+
+  FsNodeWithError openNode(kj::Path target, kj::FsNode::Type type) const {
+    switch (type) {
+      case kj::FsNode::Type::FILE: {
+        kj::Rc<File> file = kj::rc<DiskFile>(host.addRef(), kj::mv(target));
+        return kj::mv(file);
+      }
+      case kj::FsNode::Type::DIRECTORY: {
+        kj::Rc<Directory> dir = kj::rc<DiskDirectory>(host.addRef(), kj::mv(target));
+        return kj::mv(dir);
+      }
+      default:
+        return FsError::NOT_SUPPORTED;
+    }
+  }
+
+  kj::HashMap<kj::String, Item>& getEntries() const {
+    KJ_IF_SOME(entries, maybeEntries) {
+      return entries;
+    }
+    kj::HashMap<kj::String, Item> entries;
+    auto& readable = host->getReadable();
+    auto listed = path.size() == 0 ? readable.listEntries() : readable.openSubdir(path)->listEntries();
+    for (auto& entry: listed) {
+      if (!host->getOptions().allowDotfiles && entry.name.startsWith(".")) continue;
+      auto target = path.append(entry.name);
+      auto type = entry.type;
+      if (type == kj::FsNode::Type::SYMLINK) {
+        type = KJ_UNWRAP_OR(host->tryStat(target), continue).type;
+      }
+      KJ_SWITCH_ONEOF(openNode(kj::mv(target), type)) {
+        KJ_CASE_ONEOF(file, kj::Rc<File>) {
+          entries.insert(kj::mv(entry.name), kj::mv(file));
+        }
+        KJ_CASE_ONEOF(dir, kj::Rc<Directory>) {
+          entries.insert(kj::mv(entry.name), kj::mv(dir));
+        }
+        KJ_CASE_ONEOF(link, kj::Rc<SymbolicLink>) {
+          KJ_UNREACHABLE;
+        }
+        KJ_CASE_ONEOF(err, FsError) {
+          // Skip node types that cannot be represented.
+        }
+      }
+    }
+    return maybeEntries.emplace(kj::mv(entries));
+  }
+};
+
+}  // namespace
+
+kj::Rc<Directory> newDiskDirectory(
+    kj::Own<const kj::ReadableDirectory> dir, DiskDirectoryOptions options) {
+  return kj::rc<DiskDirectory>(kj::rc<HostDirectory>(kj::mv(dir), options), kj::Path(nullptr));
+}
+
+kj::Rc<Directory> newDiskDirectory(kj::Own<const kj::Directory> dir, DiskDirectoryOptions options) {
+  return kj::rc<DiskDirectory>(kj::rc<HostDirectory>(kj::mv(dir), options), kj::Path(nullptr));
+}
+
+}  // namespace workerd
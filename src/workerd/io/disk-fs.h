@@ -0,0 +1,41 @@
+#pragma once
+
+#include <workerd/io/worker-fs.h>
+
+#include <kj/filesystem.h>
+
+namespace workerd {
+
+// Create a VirtualFileSystem directory that exposes a directory on the host file
+// system. This is used to "mount" a workerd DiskDirectory service at an arbitrary
+// location within a worker's virtual file system so that large data files (models,
+// assets, etc) can be read via node:fs without embedding them in the worker bundle.
+//
+// Files in a read-only mount are memory-mapped on first read. Reads copy directly
+// from the mapping into the caller's buffer, so the contents are never buffered
+// on the heap and do not count towards the isolate memory limit. Mapped files are
+// not limited to 4GB.
+//
+// When a writable directory is given, files and subdirectories can be created,
+// written, resized, and removed. Writes go directly to the host file and, unlike
+// in-memory files, are not counted towards the isolate memory limit. Because a
+// writable mapping would not observe the file growing or shrinking, files in
+// writable mounts are read with pread() rather than being memory-mapped.
+//
+// Entries whose names start with "." are hidden unless allowDotfiles is set,
+// matching the behavior of the DiskDirectory service itself.
+//
+// Directory listings (i.e. iteration via begin()/end()) are snapshotted the first
+// time they are requested and are only refreshed when the directory is modified
+// through the virtual file system. Lookups via stat() and tryOpen() always reflect
+// the current state of the host file system.
+struct DiskDirectoryOptions {
+  bool allowDotfiles = false;
+};
+
+kj::Rc<Directory> newDiskDirectory(
+    kj::Own<const kj::ReadableDirectory> dir, DiskDirectoryOptions options = {});
+kj::Rc<Directory> newDiskDirectory(
+    kj::Own<const kj::Directory> dir, DiskDirectoryOptions options = {});
+
+}  // namespace workerd
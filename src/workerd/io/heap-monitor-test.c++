@@ -0,0 +1,82 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "heap-monitor.h"
+
+#include <workerd/jsg/memory.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+class RecordingHeapMonitor final: public HeapMonitor {
+ public:
+  explicit RecordingHeapMonitor(Options options): HeapMonitor(options) {}
+
+  struct Report {
+    size_t usedHeapSize;
+    size_t heapSizeLimit;
+    kj::Vector<kj::String> nativeTypes;
+  };
+  mutable kj::Vector<Report> reports;
+  mutable kj::Vector<kj::String> snapshots;
+
+  void report(
+      kj::StringPtr isolateId, const IsolateObserver::HeapStatistics& stats) const override {
+    Report recorded{.usedHeapSize = stats.usedHeapSize, .heapSizeLimit = stats.heapSizeLimit};
+    for (auto& type: stats.nativeObjects) {
+      recorded.nativeTypes.add(kj::str(type.name));
+    }
+    reports.add(kj::mv(recorded));
+  }
+
+  void writeSnapshot(kj::StringPtr isolateId,
+      kj::Date time,
+      kj::FunctionParam<void(kj::OutputStream&)> serialize) const override {
+    kj::VectorOutputStream out;
+    serialize(out);
+    snapshots.add(kj::heapString(out.getArray().asChars()));
+  }
+};
+
+KJ_TEST("HeapMonitor reports heap statistics each interval") {
+  RecordingHeapMonitor monitor({.interval = 1 * kj::HOURS});
+  TestFixture fixture({.diagnostics = {.heapMonitor = monitor}});
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {});
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {});
+
+  // The isolate is sampled the first time it's locked, then not again within the interval.
+  KJ_ASSERT(monitor.reports.size() == 1);
+  auto& report = monitor.reports[0];
+  KJ_EXPECT(report.usedHeapSize > 0);
+  KJ_EXPECT(report.heapSizeLimit >= report.usedHeapSize);
+  bool sawIsolateBase = false;
+  for (auto& type: report.nativeTypes) {
+    if (type == "IsolateBase"_kj) sawIsolateBase = true;
+  }
+  KJ_EXPECT(sawIsolateBase);
+
+  KJ_EXPECT(monitor.snapshots.size() == 0);
+}
+
+KJ_TEST("HeapMonitor takes one snapshot once the threshold is crossed") {
+  RecordingHeapMonitor monitor({.interval = 0 * kj::SECONDS, .snapshotThreshold = 0.0});
+  TestFixture fixture({.diagnostics = {.heapMonitor = monitor}});
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {});
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {});
+
+  KJ_EXPECT(monitor.reports.size() > 1);
+  KJ_ASSERT(monitor.snapshots.size() == 1);
+  auto& snapshot = monitor.snapshots[0];
+  KJ_EXPECT(snapshot.startsWith("{\"snapshot\":"_kj));
+  KJ_EXPECT(snapshot.contains("\"nodes\":"_kj));
+  KJ_EXPECT(snapshot.contains("IsolateBase"_kj));
+}
+
+}  // namespace
+}  // namespace workerd
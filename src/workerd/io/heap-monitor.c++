@@ -0,0 +1,122 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "heap-monitor.h"
+
+#include <workerd/jsg/memory.h>
+#include <workerd/jsg/setup.h>
+
+#include <v8-profiler.h>
+
+#include <kj/debug.h>
+#include <kj/vector.h>
+
+namespace workerd {
+
+namespace {
+
+// How many native types report() logs.
+constexpr size_t LOGGED_NATIVE_TYPES = 5;
+
+}  // namespace
+
+HeapMonitor::HeapMonitor(Options options): options(options) {
+  KJ_IF_SOME(threshold, options.snapshotThreshold) {
+    KJ_REQUIRE(threshold >= 0 && threshold <= 1,
+        "heap snapshot threshold must be a fraction of the heap size limit", threshold);
+  }
+}
+
+HeapMonitor::~HeapMonitor() noexcept(false) {}
+
+void HeapMonitor::report(
+    kj::StringPtr isolateId, const IsolateObserver::HeapStatistics& stats) const {
+  kj::Vector<kj::String> largest;
+  for (auto& type: stats.nativeObjects.first(
+           kj::min(stats.nativeObjects.size(), LOGGED_NATIVE_TYPES))) {
+    largest.add(kj::str(type.name, ": ", type.count, " (", type.selfSize, " bytes)"));
+  }
+  KJ_LOG(INFO, "isolate heap statistics", isolateId, stats.usedHeapSize, stats.totalHeapSize,
+      stats.heapSizeLimit, stats.externalMemory, kj::strArray(largest, ", "));
+}
+
+void HeapMonitor::writeSnapshot(kj::StringPtr isolateId,
+    kj::Date time,
+    kj::FunctionParam<void(kj::OutputStream&)> serialize) const {}
+
+HeapMonitor::Session::Session(const HeapMonitor& monitor,
+    v8::Isolate* isolate,
+    kj::StringPtr isolateId,
+    IsolateObserver& observer)
+    : monitor(monitor),
+      isolate(isolate),
+      isolateId(kj::str(isolateId)),
+      observer(observer) {}
+
+void HeapMonitor::Session::maybeSample() {
+  auto now = kj::systemPreciseMonotonicClock().now();
+  KJ_IF_SOME(last, lastSample) {
+    if (now - last < monitor.options.interval) return;
+  }
+  lastSample = now;
+
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { sample(); })) {
+    KJ_LOG(ERROR, "failed to sample isolate heap", isolateId, exception);
+  }
+}
+
+void HeapMonitor::Session::sample() {
+  v8::HeapStatistics heap;
+  isolate->GetHeapStatistics(&heap);
+  auto nativeObjects = jsg::IsolateBase::from(isolate).getNativeObjectStats();
+
+  IsolateObserver::HeapStatistics stats{
+    .usedHeapSize = heap.used_heap_size(),
+    .totalHeapSize = heap.total_heap_size(),
+    .heapSizeLimit = heap.heap_size_limit(),
+    .externalMemory = heap.external_memory(),
+    .nativeObjects = nativeObjects,
+  };
+  observer.reportHeapStatistics(stats);
+  monitor.report(isolateId, stats);
+
+  KJ_IF_SOME(threshold, monitor.options.snapshotThreshold) {
+    if (!snapshotTaken && stats.heapSizeLimit > 0 &&
+        stats.usedHeapSize >= threshold * stats.heapSizeLimit) {
+      snapshotTaken = true;
+      KJ_LOG(WARNING, "isolate heap crossed the snapshot threshold", isolateId,
+          stats.usedHeapSize, stats.heapSizeLimit);
+      takeSnapshot();
+    }
+  }
+}
+
+void HeapMonitor::Session::takeSnapshot() {
+  monitor.writeSnapshot(
+      isolateId, kj::systemPreciseCalendarClock().now(), [&](kj::OutputStream& out) {
+    v8::HandleScope scope(isolate);
+    jsg::HeapSnapshotDeleter deleter;
+    auto snapshot = kj::Own<const v8::HeapSnapshot>(
+        isolate->GetHeapProfiler()->TakeHeapSnapshot(), deleter);
+    KJ_ASSERT(snapshot.get() != nullptr, "V8 failed to take a heap snapshot");
+
+    // Exceptions mustn't unwind through V8, so stop the serializer and rethrow once it returns.
+    kj::Maybe<kj::Exception> error;
+    jsg::HeapSnapshotWriter writer([&](kj::Maybe<kj::ArrayPtr<char>> maybeChunk) {
+      KJ_IF_SOME(chunk, maybeChunk) {
+        KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { out.write(chunk.asBytes()); })) {
+          error = kj::mv(exception);
+          return false;
+        }
+      }
+      return true;
+    });
+    snapshot->Serialize(&writer, v8::HeapSnapshot::kJSON);
+    KJ_IF_SOME(exception, error) {
+      kj::throwFatalException(kj::mv(exception));
+    }
+  });
+}
+
+}  // namespace workerd
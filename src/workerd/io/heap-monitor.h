@@ -0,0 +1,93 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/observer.h>
+
+#include <v8-isolate.h>
+
+#include <kj/function.h>
+#include <kj/io.h>
+#include <kj/string.h>
+#include <kj/time.h>
+
+namespace workerd {
+
+// Samples every isolate's heap usage once per `interval` and reports it, both to the isolate's
+// IsolateObserver (see IsolateObserver::reportHeapStatistics()) and to report(). Optionally, the
+// first time an isolate's used heap crosses `snapshotThreshold` of its limit, a heap snapshot of
+// it is taken and handed to writeSnapshot(), so that whatever is growing can be examined after the
+// fact.
+//
+// Like ContinuousCpuProfiler, this is driven by Worker::Isolate's locks: an isolate is sampled
+// when it's locked and the interval has elapsed since its last sample. Isolates that aren't
+// running anything aren't sampled, but then their heaps aren't growing either.
+//
+// Isolates are given the HeapMonitor through Worker::Isolate::Diagnostics. It must outlive every
+// Session.
+class HeapMonitor {
+ public:
+  struct Options {
+    // Minimum time between samples of each isolate. Each sample walks every native object
+    // reachable from JavaScript, so this shouldn't be much shorter than the default.
+    kj::Duration interval = 60 * kj::SECONDS;
+
+    // Fraction of the isolate's heap size limit which, once used, triggers a heap snapshot. If
+    // none, snapshots are never taken.
+    kj::Maybe<double> snapshotThreshold;
+  };
+
+  explicit HeapMonitor(Options options);
+  virtual ~HeapMonitor() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(HeapMonitor);
+
+  // Called with each sample, on the isolate's thread with the isolate locked. `isolateId` is the
+  // Worker::Isolate's ID (the service name, in workerd). By default, logs the sample along with the
+  // native types using the most memory.
+  virtual void report(
+      kj::StringPtr isolateId, const IsolateObserver::HeapStatistics& stats) const;
+
+  // Called when an isolate crosses the snapshot threshold, on the isolate's thread with the
+  // isolate locked. `serialize` takes the snapshot and writes it, in the JSON format understood by
+  // Chrome DevTools, to the given stream; no snapshot is taken unless it's called. Exceptions are
+  // logged and otherwise ignored. By default, does nothing.
+  virtual void writeSnapshot(kj::StringPtr isolateId,
+      kj::Date time,
+      kj::FunctionParam<void(kj::OutputStream&)> serialize) const;
+
+  // Monitors one isolate. Must be constructed, used, and destroyed with the isolate locked.
+  class Session {
+   public:
+    Session(const HeapMonitor& monitor,
+        v8::Isolate* isolate,
+        kj::StringPtr isolateId,
+        IsolateObserver& observer);
+    KJ_DISALLOW_COPY_AND_MOVE(Session);
+
+    // Samples the isolate's heap, if the interval has elapsed since the last sample. Called each
+    // time the isolate is locked, including right after construction.
+    void maybeSample();
+
+   private:
+    const HeapMonitor& monitor;
+    v8::Isolate* isolate;
+    kj::String isolateId;
+    IsolateObserver& observer;
+    kj::Maybe<kj::TimePoint> lastSample;
+
+    // Only one snapshot is taken per isolate. Taking one pauses the isolate for a while and the
+    // result is often larger than the heap itself, so repeating it every interval for an isolate
+    // that stays above the threshold would do more harm than good.
+    bool snapshotTaken = false;
+
+    void sample();
+    void takeSnapshot();
+  };
+
+ private:
+  Options options;
+};
+
+}  // namespace workerd
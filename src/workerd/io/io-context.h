@@ -172,6 +172,15 @@ class IoContext_IncomingRequest final {
   // worker invocation.
   tracing::InvocationSpanContext& getInvocationSpanContext();
 
+  // A short human-readable description of the request, such as the entrypoint name and, for HTTP,
+  // the method and URL. Used in stall reports, and empty unless the isolate has a StallDetector.
+  void setDescription(kj::String value) {
+    description = kj::mv(value);
+  }
+  kj::StringPtr getDescription() {
+    return description;
+  }
+
  private:
   kj::Own<IoContext> context;
   kj::Own<RequestObserver> metrics;
@@ -194,6 +203,8 @@ class IoContext_IncomingRequest final {
   kj::Maybe<tracing::InvocationSpanContext> maybeTriggerInvocationSpan;
   kj::Maybe<tracing::InvocationSpanContext> invocationSpanContext;
 
+  kj::String description;
+
   bool wasDelivered = false;
 
   // Used for debugging, tracks whether we properly called drain() or some other mechanism to
@@ -289,6 +300,13 @@ class IoContext final: public kj::Refcounted, private kj::TaskSet::ErrorHandler
     return getCurrentIncomingRequest().getAccessInfo();
   }
 
+  // Describes the current incoming request (see IncomingRequest::getDescription()), or returns an
+  // empty string if there is none.
+  kj::StringPtr getCurrentRequestDescription() {
+    if (incomingRequests.empty()) return ""_kj;
+    return getCurrentIncomingRequest().getDescription();
+  }
+
   LimitEnforcer& getLimitEnforcer() {
     return *limitEnforcer;
   }
@@ -723,6 +741,12 @@ class IoContext final: public kj::Refcounted, private kj::TaskSet::ErrorHandler
     return addTaskCounter;
   }
 
+  // Returns the number of heap allocations made so far to track objects passed to addObject()
+  // and addObjectReverse().
+  size_t ownedObjectAllocationCount() const {
+    return ownedObjects.getAllocationCount();
+  }
+
   // Indicates that the script has requested that it stay active until the given promise resolves.
   // drain() waits until all such promises have completed.
   void addWaitUntil(kj::Promise<void> promise);
@@ -1146,7 +1170,8 @@ class IoContext final: public kj::Refcounted, private kj::TaskSet::ErrorHandler
   kj::Maybe<PendingEvent&> pendingEvent;
   kj::Maybe<kj::Promise<void>> abortFromHangTask;
 
-  // Objects pointed to by IoOwn<T>s.
+  // Objects pointed to by IoOwn<T>s. Their list nodes come from a per-context arena when the
+  // IO_OWN_ARENA autogate is enabled.
   // NOTE: This must live below `deleteQueue`, as some of these OwnedObjects may own attachctx()'ed
   //   objects which reference `deleteQueue` in their destructors.
   OwnedObjectList ownedObjects;
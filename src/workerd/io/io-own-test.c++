@@ -92,5 +92,35 @@ KJ_TEST("ReverseIoOwn remains safe after its IoContext is destroyed") {
   }
 }
 
+KJ_TEST("IoContext arena reuses freed nodes and releases the rest with the context") {
+  TestFixture fixture({.autogates = kj::arr("io-own-arena"_kj)});
+  uint destructionCount = 0;
+  kj::Vector<ReverseIoOwn<TrackedObject>> objects;
+  auto context = fixture.newIoContext();
+  auto initialAllocations = context->ownedObjectAllocationCount();
+
+  for (uint i: kj::zeroTo(100)) {
+    objects.add(context->addObjectReverse(kj::heap<TrackedObject>(destructionCount, i)));
+  }
+  // Slabs grow geometrically, so 100 nodes take only a handful of allocations.
+  auto allocations = context->ownedObjectAllocationCount() - initialAllocations;
+  KJ_EXPECT(allocations > 0 && allocations <= 4, allocations);
+
+  objects.truncate(50);
+  KJ_EXPECT(destructionCount == 50);
+  for (uint i: kj::zeroTo(50)) {
+    objects.add(context->addObjectReverse(kj::heap<TrackedObject>(destructionCount, i)));
+  }
+  KJ_EXPECT(context->ownedObjectAllocationCount() - initialAllocations == allocations);
+
+  for (auto i: kj::indices(objects)) {
+    KJ_EXPECT(objects[i]->value == i % 50);
+  }
+
+  context = nullptr;
+  KJ_EXPECT(destructionCount == 150);
+  KJ_EXPECT(objects[0].tryGet() == kj::none);
+}
+
 }  // namespace
 }  // namespace workerd
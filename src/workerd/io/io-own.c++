@@ -97,6 +97,34 @@ void OwnedObjectList::unlink(OwnedObject& object) {
   *object.prev = kj::mv(object.next);
 }
 
+void* OwnedObjectList::allocateBlock() {
+  ArenaBlock* block;
+  if (arenaFreeList != nullptr) {
+    block = arenaFreeList;
+    arenaFreeList = block->nextFree;
+  } else {
+    if (arenaSlabs.empty() || arenaSlabUsed == arenaSlabs.back().size()) {
+      size_t size = arenaSlabs.empty()
+          ? MIN_ARENA_SLAB_BLOCKS
+          : kj::min(arenaSlabs.back().size() * 2, MAX_ARENA_SLAB_BLOCKS);
+      arenaSlabs.add(kj::heapArray<ArenaBlock>(size));
+      arenaSlabUsed = 0;
+      ++allocationCount;
+    }
+    block = &arenaSlabs.back()[arenaSlabUsed++];
+  }
+  block->list = this;
+  return block->storage;
+}
+
+void OwnedObjectList::freeBlock(void* storage) {
+  auto block = reinterpret_cast<ArenaBlock*>(
+      static_cast<kj::byte*>(storage) - offsetof(ArenaBlock, storage));
+  auto& list = *block->list;
+  block->nextFree = list.arenaFreeList;
+  list.arenaFreeList = block;
+}
+
 void OwnedObjectList::link(kj::Own<OwnedObject> object) {
   object->next = kj::mv(head);
   KJ_IF_SOME(next, object->next) {
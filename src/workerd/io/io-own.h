@@ -75,16 +75,104 @@ struct SpecificOwnedObject: public OwnedObject {
 class OwnedObjectList {
  public:
   OwnedObjectList() = default;
+
+  // If `useArena` is true, nodes created by add() are carved out of slabs owned by the list
+  // instead of being allocated from the heap one by one. Nodes freed before the list is destroyed
+  // are recycled, and the slabs are released all at once when the list is destroyed.
+  explicit OwnedObjectList(bool useArena): useArena(useArena) {}
+
   KJ_DISALLOW_COPY_AND_MOVE(OwnedObjectList);
   ~OwnedObjectList() noexcept(false);
 
+  // Creates a node owning `obj` and links it into the list.
+  template <typename T>
+  SpecificOwnedObject<T>* add(kj::Own<T> obj);
+
   void link(kj::Own<OwnedObject> object);
   static void unlink(OwnedObject& object);
 
+  // Returns the number of heap allocations made for nodes so far. With the arena enabled, this
+  // is the number of slabs.
+  size_t getAllocationCount() const {
+    return allocationCount;
+  }
+
  private:
+  // Arena memory for one node. Every SpecificOwnedObject<T> has the same size, since it holds
+  // only the list links and a kj::Own<T>, so the arena only needs to deal in one block size.
+  struct ArenaBlock {
+    // The list whose arena this block belongs to, so that a disposer can return the block.
+    OwnedObjectList* list;
+    union {
+      ArenaBlock* nextFree;
+      alignas(SpecificOwnedObject<void>) kj::byte storage[sizeof(SpecificOwnedObject<void>)];
+    };
+  };
+
+  template <typename T>
+  class ArenaDisposer;
+
+  static constexpr size_t MIN_ARENA_SLAB_BLOCKS = 16;
+  static constexpr size_t MAX_ARENA_SLAB_BLOCKS = 512;
+
+  bool useArena = false;
+  size_t allocationCount = 0;
+
+  // Slabs grow geometrically, up to MAX_ARENA_SLAB_BLOCKS. Blocks are handed out from the last
+  // slab in order, after first reusing any blocks on the free list.
+  kj::Vector<kj::Array<ArenaBlock>> arenaSlabs;
+  size_t arenaSlabUsed = 0;
+  ArenaBlock* arenaFreeList = nullptr;
+
+  // Declared after the arena so that any nodes still linked are destroyed first.
   kj::Maybe<kj::Own<OwnedObject>> head;
+
+  void* allocateBlock();
+  static void freeBlock(void* storage);
+};
+
+template <typename T>
+class OwnedObjectList::ArenaDisposer final: public kj::Disposer {
+ public:
+  static const ArenaDisposer instance;
+
+  void disposeImpl(void* pointer) const override {
+    auto object = static_cast<SpecificOwnedObject<T>*>(pointer);
+    kj::dtor(*object);
+    freeBlock(object);
+  }
 };
 
+template <typename T>
+const OwnedObjectList::ArenaDisposer<T> OwnedObjectList::ArenaDisposer<T>::instance =
+    OwnedObjectList::ArenaDisposer<T>();
+
+template <typename T>
+inline SpecificOwnedObject<T>* OwnedObjectList::add(kj::Own<T> obj) {
+  static_assert(sizeof(SpecificOwnedObject<T>) == sizeof(SpecificOwnedObject<void>));
+
+  // HACK: We need an Own<OwnedObject>, but we actually need to allocate it as the subclass
+  //   SpecificOwnedObject<T>. OwnedObject is not polymorphic, which means kj::Own will refuse
+  //   to upcast kj::Own<SpecificOwnedObject<T>> to kj::Own<OwnedObject> since it can't guarantee
+  //   the disposers are compatible. However, since we're only using single inheritance here, the
+  //   disposers *are* compatible (the numeric value of pointers to SpecificOwnedObject<T> and
+  //   its parent OwnedObject are equal). So, instead of forcing OwnedObject to be polymorphic
+  //   (which would have forced a bunch of useless vtables and vtable pointers)... I'm manually
+  //   constructing the kj::Own<> using a disposer that I know is compatible.
+  // TODO(cleanup): Can KJ be made to support this use case?
+  SpecificOwnedObject<T>* result;
+  if (useArena) {
+    result = static_cast<SpecificOwnedObject<T>*>(allocateBlock());
+    kj::ctor(*result, kj::mv(obj));
+    link(kj::Own<OwnedObject>(result, ArenaDisposer<T>::instance));
+  } else {
+    result = new SpecificOwnedObject<T>(kj::mv(obj));
+    ++allocationCount;
+    link(kj::Own<OwnedObject>(result, kj::_::HeapDisposer<SpecificOwnedObject<T>>::instance));
+  }
+  return result;
+}
+
 // Object which receives possibly-cross-thread deletions of owned objects.
 class DeleteQueue: public kj::AtomicRefcounted {
  public:
@@ -155,21 +243,7 @@ class IoCrossContextExecutor {
 template <typename T>
 inline SpecificOwnedObject<T>* DeleteQueue::addObjectImpl(
     kj::Own<T> obj, OwnedObjectList& ownedObjects) const {
-  // HACK: We need an Own<OwnedObject>, but we actually need to allocate it as the subclass
-  //   SpecificOwnedObject<T>. OwnedObject is not polymorphic, which means kj::Own will refuse
-  //   to upcast kj::Own<SpecificOwnedObject<T>> to kj::Own<OwnedObject> since it can't guarantee
-  //   the disposers are compatible. However, since we're only using single inheritance here, the
-  //   disposers *are* compatible (the numeric value of pointers to SpecificOwnedObject<T> and
-  //   its parent OwnedObject are equal). So, instead of forcing OwnedObject to be polymorphic
-  //   (which would have forced a bunch of useless vtables and vtable pointers)... I'm manually
-  //   constructing the kj::Own<> using a disposer that I know is compatible.
-  // TODO(cleanup): Can KJ be made to support this use case?
-  kj::Own<OwnedObject> ownedObject(new SpecificOwnedObject<T>(kj::mv(obj)),
-      kj::_::HeapDisposer<SpecificOwnedObject<T>>::instance);
-
-  auto result = static_cast<SpecificOwnedObject<T>*>(ownedObject.get());
-  ownedObjects.link(kj::mv(ownedObject));
-  return result;
+  return ownedObjects.add(kj::mv(obj));
 }
 
 template <typename T>
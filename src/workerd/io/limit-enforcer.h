@@ -194,6 +194,11 @@ class LimitEnforcer {
   // execution, such as the CPU or memory limit.
   virtual void requireLimitsNotExceeded() = 0;
 
+  // Charges the request for CPU time that was spent on its behalf on a background thread, such as
+  // crypto work offloaded from the isolate. That time isn't seen by the isolate's own CPU limit,
+  // so implementations that bill or limit CPU time should add it here.
+  virtual void chargeBackgroundCpuTime(kj::Duration cpuTime) {}
+
   // Report resource usage metrics to the given request metrics object.
   virtual void reportMetrics(RequestObserver& requestMetrics) = 0;
 
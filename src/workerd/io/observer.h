@@ -18,6 +18,10 @@
 
 namespace workerd {
 
+namespace jsg {
+struct NativeObjectStats;
+}  // namespace jsg
+
 class IoContext;
 
 // Whether an outgoing subrequest's request body can be rewound (e.g. a buffered or null body), and
@@ -196,6 +200,22 @@ class IsolateObserver: public kj::AtomicRefcounted {
   virtual void teardownLockAcquired() {}
   virtual void teardownFinished() {}
 
+  struct HeapStatistics {
+    size_t usedHeapSize;
+    size_t totalHeapSize;
+    size_t heapSizeLimit;
+
+    // Memory held outside the V8 heap on behalf of JavaScript objects, e.g. ArrayBuffer contents.
+    size_t externalMemory;
+
+    // Native objects reachable from JavaScript, by type, largest first.
+    kj::ArrayPtr<const jsg::NativeObjectStats> nativeObjects;
+  };
+
+  // Called with the isolate's heap usage every HeapMonitor::Options::interval, while a
+  // HeapMonitor is running. Called with the isolate locked.
+  virtual void reportHeapStatistics(const HeapStatistics& stats) {}
+
   // Describes why a worker was started.
   enum class StartType : uint8_t {
     // Cold start with active request waiting.
@@ -349,6 +369,12 @@ class ActorObserver: public kj::Refcounted, public SqliteObserver {
 
   virtual void blockConcurrencyWhileDepth(uint32_t depth) {}
 
+  // Container.getTcpPort() reused a pooled tunnel, had to build a new one, or dropped a pooled
+  // tunnel because the pool was full or the tunnel sat idle too long.
+  virtual void containerTunnelPoolHit() {}
+  virtual void containerTunnelPoolMiss() {}
+  virtual void containerTunnelPoolEviction() {}
+
   virtual void shutdown(uint16_t reasonCode, LimitEnforcer& limitEnforcer) {}
 };
 
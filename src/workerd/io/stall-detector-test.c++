@@ -0,0 +1,94 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "stall-detector.h"
+
+#include <workerd/jsg/script.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/test.h>
+
+#include <unistd.h>
+
+namespace workerd {
+namespace {
+
+class RecordingStallDetector final: public StallDetector {
+ public:
+  RecordingStallDetector(): StallDetector({.threshold = 20 * kj::MILLISECONDS}) {}
+
+  struct Recorded {
+    kj::Duration heldFor;
+    kj::Maybe<kj::String> jsStack;
+  };
+
+  // Reports are made on the thread holding the isolate lock, which is the test's thread.
+  mutable kj::Vector<Recorded> reports;
+
+  void report(const Report& report) const override {
+    reports.add(Recorded{.heldFor = report.heldFor,
+      .jsStack = report.jsStack.map([](kj::StringPtr s) { return kj::str(s); })});
+  }
+};
+
+KJ_TEST("StallDetector captures the JavaScript stack of a long-running script") {
+  RecordingStallDetector detector;
+  TestFixture fixture({.diagnostics = {.stallDetector = detector}});
+  detector.reports.clear();
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    jsg::NonModuleScript::compile(env.js, R"(
+      function spinForAWhile() {
+        let x = 0;
+        for (let i = 0; i < 300000000; i++) x = (x * 31 + i) | 0;
+        return x;
+      }
+      spinForAWhile();
+    )",
+        "stall.js")
+        .run(env.js);
+  });
+
+  KJ_ASSERT(detector.reports.size() == 1);
+  auto& report = detector.reports[0];
+  KJ_EXPECT(report.heldFor >= 20 * kj::MILLISECONDS);
+  auto& stack = KJ_ASSERT_NONNULL(report.jsStack);
+  KJ_EXPECT(stack.contains("at spinForAWhile (stall.js:"_kj), stack);
+}
+
+KJ_TEST("StallDetector reports native stalls without a stack") {
+  RecordingStallDetector detector;
+  TestFixture fixture({.diagnostics = {.stallDetector = detector}});
+  detector.reports.clear();
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) { usleep(100'000); });
+
+  KJ_ASSERT(detector.reports.size() == 1);
+  KJ_EXPECT(detector.reports[0].heldFor >= 100 * kj::MILLISECONDS);
+  KJ_EXPECT(detector.reports[0].jsStack == kj::none);
+
+  // Every lock taken by the fixture was counted, including the one held past the threshold.
+  // Buckets 7 and up count holds of 64ms or more.
+  auto histogram = detector.getHistogram();
+  uint64_t shortHolds = 0;
+  uint64_t longHolds = 0;
+  for (auto i: kj::indices(histogram)) {
+    (i < 7 ? shortHolds : longHolds) += histogram[i];
+  }
+  KJ_EXPECT(shortHolds > 0);
+  KJ_EXPECT(longHolds == 1);
+}
+
+KJ_TEST("StallDetector does not report short lock holds") {
+  RecordingStallDetector detector;
+  TestFixture fixture({.diagnostics = {.stallDetector = detector}});
+  detector.reports.clear();
+
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {});
+
+  KJ_EXPECT(detector.reports.size() == 0);
+}
+
+}  // namespace
+}  // namespace workerd
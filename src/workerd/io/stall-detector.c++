@@ -0,0 +1,252 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "stall-detector.h"
+
+#include <workerd/io/io-context.h>
+#include <workerd/jsg/jsg.h>
+
+#include <kj/debug.h>
+
+namespace workerd {
+
+namespace {
+
+// Distinguishes StallDetector instances, so that a thread's cached slot isn't mistaken for one
+// belonging to a later detector allocated at the same address.
+std::atomic<uint64_t> nextDetectorId = 1;
+
+// Its address identifies the calling thread among the live ones.
+thread_local char threadToken;
+
+constexpr int MAX_STACK_FRAMES = 20;
+
+// Returns none if no JavaScript is on the stack, e.g. when the interrupt was serviced while V8 ran
+// microtasks queued by native code.
+kj::Maybe<kj::String> captureStack(v8::Isolate* isolate) {
+  v8::HandleScope scope(isolate);
+  auto trace = v8::StackTrace::CurrentStackTrace(isolate, MAX_STACK_FRAMES);
+  if (trace->GetFrameCount() == 0) return kj::none;
+  kj::Vector<kj::String> frames(trace->GetFrameCount());
+  for (int i = 0; i < trace->GetFrameCount(); i++) {
+    auto frame = trace->GetFrame(isolate, i);
+    auto function = frame->GetFunctionName();
+    auto script = frame->GetScriptNameOrSourceURL();
+    frames.add(kj::str("at ",
+        function.IsEmpty() || function->Length() == 0 ? kj::str("<anonymous>") : kj::str(function),
+        " (", script.IsEmpty() ? kj::str("<unknown>") : kj::str(script), ":",
+        frame->GetLineNumber(), ":", frame->GetColumn(), ")"));
+  }
+  return kj::strArray(frames, "\n");
+}
+
+}  // namespace
+
+struct StallDetector::ThreadSlot {
+  ThreadSlot(const StallDetector& detector, const char* thread)
+      : detector(detector),
+        thread(thread) {}
+
+  const StallDetector& detector;
+  const char* thread;
+
+  struct State {
+    // The isolate whose lock the thread holds under a watched Hold, if any.
+    kj::Maybe<v8::Isolate&> isolate;
+    kj::TimePoint start = kj::origin<kj::TimePoint>();
+
+    bool interruptRequested = false;
+    bool reported = false;
+  };
+
+  kj::MutexGuarded<State> state;
+};
+
+StallDetector::StallDetector(Options options)
+    : options(options),
+      id(nextDetectorId.fetch_add(1, std::memory_order_relaxed)),
+      nextHistogramLog(kj::systemPreciseMonotonicClock().now() + options.histogramLogInterval),
+      lastHistogram(getHistogram()) {
+  KJ_REQUIRE(options.threshold > 0 * kj::NANOSECONDS, "stall threshold must be positive");
+  watchdog.runDetached([this]() { check(); }, checkInterval());
+}
+
+StallDetector::~StallDetector() noexcept(false) {}
+
+StallDetector::Hold::Hold(const StallDetector& detector, v8::Isolate* isolate)
+    : detector(detector),
+      start(kj::systemPreciseMonotonicClock().now()) {
+  auto state = detector.getThreadSlot().state.lockExclusive();
+  watched = state->isolate == kj::none;
+  if (watched) {
+    state->isolate = *isolate;
+    state->start = start;
+    state->interruptRequested = false;
+    state->reported = false;
+  }
+}
+
+StallDetector::Hold::~Hold() noexcept(false) {
+  auto heldFor = kj::systemPreciseMonotonicClock().now() - start;
+  detector.record(heldFor);
+  if (!watched) return;
+
+  bool reported;
+  {
+    auto state = detector.getThreadSlot().state.lockExclusive();
+    state->isolate = kj::none;
+    reported = state->reported;
+  }
+
+  if (!reported && heldFor >= detector.options.threshold) {
+    // No JavaScript ran after the watchdog's interrupt request, so the time went to native code.
+    auto request = describeCurrentRequest();
+    detector.report({.heldFor = heldFor, .request = request, .jsStack = kj::none});
+  }
+}
+
+void StallDetector::report(const Report& report) const {
+  KJ_IF_SOME(stack, report.jsStack) {
+    KJ_LOG(WARNING, "isolate lock held past the stall threshold", report.heldFor, report.request,
+        stack);
+  } else {
+    KJ_LOG(WARNING, "isolate lock held past the stall threshold outside of JavaScript",
+        report.heldFor, report.request);
+  }
+}
+
+kj::Array<uint64_t> StallDetector::getHistogram() const {
+  auto counts = kj::heapArray<uint64_t>(HISTOGRAM_BUCKETS);
+  for (auto i: kj::zeroTo(HISTOGRAM_BUCKETS)) {
+    counts[i] = histogram[i].load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+StallDetector::ThreadSlot& StallDetector::getThreadSlot() const {
+  static thread_local uint64_t cachedDetectorId = 0;
+  static thread_local ThreadSlot* cachedSlot = nullptr;
+  if (cachedDetectorId != id) {
+    // Slots live as long as the detector, even if their thread exits first. There are only ever
+    // a handful of threads taking isolate locks. A thread switching between detectors only caches
+    // the last one's slot, so look for an existing one before adding another.
+    auto lock = slots.lockExclusive();
+    cachedSlot = nullptr;
+    for (auto& slot: *lock) {
+      if (slot->thread == &threadToken) {
+        cachedSlot = slot.get();
+        break;
+      }
+    }
+    if (cachedSlot == nullptr) {
+      auto slot = kj::heap<ThreadSlot>(*this, &threadToken);
+      cachedSlot = slot.get();
+      lock->add(kj::mv(slot));
+    }
+    cachedDetectorId = id;
+  }
+  return *cachedSlot;
+}
+
+void StallDetector::record(kj::Duration heldFor) const {
+  uint bucket = 0;
+  for (auto ms = heldFor / kj::MILLISECONDS; ms > 0 && bucket < HISTOGRAM_BUCKETS - 1; ms >>= 1) {
+    ++bucket;
+  }
+  histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+kj::Duration StallDetector::checkInterval() const {
+  return kj::max(options.threshold / 4, 1 * kj::MILLISECONDS);
+}
+
+void StallDetector::check() {
+  auto now = kj::systemPreciseMonotonicClock().now();
+  checkHolds(now);
+
+  if (now >= nextHistogramLog) {
+    nextHistogramLog = now + options.histogramLogInterval;
+    auto counts = getHistogram();
+    for (auto i: kj::indices(counts)) {
+      lastHistogram[i] = counts[i] - lastHistogram[i];
+    }
+    logHistogram(lastHistogram);
+    lastHistogram = kj::mv(counts);
+  }
+
+  // Dropped if the detector is being destroyed.
+  watchdog.runDetached([this]() { check(); }, checkInterval());
+}
+
+void StallDetector::checkHolds(kj::TimePoint now) {
+  auto lock = slots.lockExclusive();
+  for (auto& slot: *lock) {
+    auto state = slot->state.lockExclusive();
+    KJ_IF_SOME(isolate, state->isolate) {
+      if (!state->interruptRequested && now - state->start >= options.threshold) {
+        state->interruptRequested = true;
+        // The isolate can't be unlocked, let alone destroyed, until its thread has cleared
+        // `state->isolate`, which it can't do while we hold `state`.
+        isolate.RequestInterrupt(&onInterrupt, slot.get());
+      }
+    }
+  }
+}
+
+void StallDetector::logHistogram(kj::ArrayPtr<const uint64_t> counts) {
+  kj::Vector<kj::String> buckets;
+  for (auto i: kj::indices(counts)) {
+    if (counts[i] == 0) continue;
+    if (i == 0) {
+      buckets.add(kj::str("<1ms: ", counts[i]));
+    } else if (i == HISTOGRAM_BUCKETS - 1) {
+      buckets.add(kj::str(">=", 1ull << (i - 1), "ms: ", counts[i]));
+    } else {
+      buckets.add(kj::str(1ull << (i - 1), "-", 1ull << i, "ms: ", counts[i]));
+    }
+  }
+  if (buckets.size() > 0) {
+    KJ_LOG(INFO, "isolate lock hold durations", kj::strArray(buckets, ", "));
+  }
+}
+
+void StallDetector::onInterrupt(v8::Isolate* isolate, void* data) {
+  // `data` is the slot of the thread that held the lock when the interrupt was requested. That
+  // thread may have released the lock since, in which case this may be running on another thread
+  // entirely, so the slot is checked rather than assumed to be ours.
+  auto& slot = *reinterpret_cast<ThreadSlot*>(data);
+  {
+    auto state = slot.state.lockShared();
+    KJ_IF_SOME(held, state->isolate) {
+      if (&held != isolate || !state->interruptRequested || state->reported) {
+        // The Hold this was requested for has ended.
+        return;
+      }
+    } else {
+      return;
+    }
+  }
+
+  // Without a stack, leave it to the Hold to report the stall once it ends.
+  auto maybeStack = captureStack(isolate);
+  KJ_IF_SOME(stack, maybeStack) {
+    kj::Duration heldFor = 0 * kj::NANOSECONDS;
+    {
+      auto state = slot.state.lockExclusive();
+      state->reported = true;
+      heldFor = kj::systemPreciseMonotonicClock().now() - state->start;
+    }
+    auto request = describeCurrentRequest();
+    slot.detector.report({.heldFor = heldFor, .request = request, .jsStack = stack.asPtr()});
+  }
+}
+
+kj::String StallDetector::describeCurrentRequest() {
+  KJ_IF_SOME(context, IoContext::tryCurrent()) {
+    return kj::str(context.getCurrentRequestDescription());
+  }
+  return kj::String();
+}
+
+}  // namespace workerd
@@ -0,0 +1,112 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/util/thread-pool.h>
+
+#include <v8-isolate.h>
+
+#include <kj/array.h>
+#include <kj/mutex.h>
+#include <kj/string.h>
+#include <kj/time.h>
+#include <kj/vector.h>
+
+#include <atomic>
+
+namespace workerd {
+
+// Watches how long isolate locks are held. All requests to an isolate share its event loop, so
+// while one of them runs JavaScript (or native code) without yielding, every other request waits;
+// a single slow handler inflates everyone's latency without showing up in its own metrics.
+//
+// Worker::Isolate takes a Hold for as long as it holds the lock. A background thread checks on
+// the holds every `threshold / 4`, and when one has gone on for longer than `threshold`, asks V8
+// to interrupt the isolate so that the current JavaScript stack can be captured and reported
+// together with the request being handled. If no JavaScript runs before the lock is released --
+// the time went to native code -- the stall is reported without a stack when the Hold ends.
+//
+// Hold durations are also counted in a histogram, which the background thread logs at INFO level
+// every `histogramLogInterval` if anything was recorded.
+//
+// Isolates are given the StallDetector through Worker::Isolate::Diagnostics. It must outlive every
+// isolate it has watched, since an interrupt it requested may be serviced after the Hold it was
+// requested for has ended.
+class StallDetector {
+ public:
+  struct Options {
+    kj::Duration threshold;
+    kj::Duration histogramLogInterval = 60 * kj::SECONDS;
+  };
+
+  explicit StallDetector(Options options);
+  virtual ~StallDetector() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(StallDetector);
+
+  // Tracks one hold of an isolate lock, from construction to destruction. Must be constructed and
+  // destroyed on the thread holding the lock, while holding it. If the thread already has a Hold
+  // in effect (for another isolate), the inner one only contributes to the histogram.
+  class Hold {
+   public:
+    Hold(const StallDetector& detector, v8::Isolate* isolate);
+    ~Hold() noexcept(false);
+    KJ_DISALLOW_COPY_AND_MOVE(Hold);
+
+   private:
+    const StallDetector& detector;
+    kj::TimePoint start;
+    bool watched;
+  };
+
+  struct Report {
+    // How long the lock had been held when the stall was reported.
+    kj::Duration heldFor;
+
+    // Describes the request the isolate was handling, e.g. "default: GET https://example.com/".
+    // Empty if unknown.
+    kj::StringPtr request;
+
+    // The JavaScript stack at the time of the report, one frame per line, or none if no
+    // JavaScript ran while the lock was held past the threshold.
+    kj::Maybe<kj::StringPtr> jsStack;
+  };
+
+  // Called on the isolate's thread, with the isolate locked, for each stall. By default, logs the
+  // report as a warning.
+  virtual void report(const Report& report) const;
+
+  // Hold durations bucketed by powers of two: bucket 0 counts holds under 1ms, bucket i counts
+  // holds of [2^(i-1), 2^i) ms, and the last bucket counts everything longer.
+  static constexpr uint HISTOGRAM_BUCKETS = 16;
+  kj::Array<uint64_t> getHistogram() const;
+
+ private:
+  struct ThreadSlot;
+
+  Options options;
+  uint64_t id;
+  kj::MutexGuarded<kj::Vector<kj::Own<ThreadSlot>>> slots;
+  mutable std::atomic<uint64_t> histogram[HISTOGRAM_BUCKETS] = {};
+
+  // Only touched by check(), on the watchdog thread.
+  kj::TimePoint nextHistogramLog;
+  kj::Array<uint64_t> lastHistogram;
+
+  // Runs check() every `threshold / 4`. Must stay the last member: check() reads `slots`, which
+  // has to outlive the watchdog's thread.
+  ThreadPool watchdog{{.threadCount = 1}};
+
+  ThreadSlot& getThreadSlot() const;
+  void record(kj::Duration heldFor) const;
+  kj::Duration checkInterval() const;
+  void check();
+  void checkHolds(kj::TimePoint now);
+  void logHistogram(kj::ArrayPtr<const uint64_t> counts);
+
+  static void onInterrupt(v8::Isolate* isolate, void* data);
+  static kj::String describeCurrentRequest();
+};
+
+}  // namespace workerd
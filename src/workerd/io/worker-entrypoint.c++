@@ -105,6 +105,10 @@ class WorkerEntrypoint final: public WorkerInterface {
   kj::Maybe<kj::String> cfBlobJson;
   kj::Maybe<Worker::VersionInfo> versionInfo;
 
+  // Whether to set the IncomingRequest's description. Only the StallDetector reads it, so it isn't
+  // built for isolates without one.
+  bool describeRequest = false;
+
   // Hacky members used to hold some temporary state while processing a request.
   // See gory details in WorkerEntrypoint::request().
 
@@ -305,6 +309,18 @@ void WorkerEntrypoint::init(kj::Own<const Worker> worker,
       kj::mv(metrics), kj::mv(workerTracer), kj::mv(maybeTriggerInvocationSpan), kj::mv(accessInfo),
       kj::mv(selfTokenFactory))
                         .attach(kj::mv(actor));
+
+  // Refined by the event handlers below, e.g. with the URL for HTTP requests.
+  auto& request = *KJ_ASSERT_NONNULL(incomingRequest);
+  describeRequest =
+      request.getContext().getWorker().getIsolate().getDiagnostics().stallDetector != kj::none;
+  if (describeRequest) {
+    KJ_IF_SOME(name, entrypointName) {
+      request.setDescription(kj::str(name));
+    } else {
+      request.setDescription(kj::str("default"));
+    }
+  }
 }
 
 // To match our historical behavior (when we used to pull the headers from the JavaScript object
@@ -382,6 +398,10 @@ kj::Promise<void> WorkerEntrypoint::requestImpl(kj::HttpMethod method,
   auto& context = incomingRequest->getContext();
   auto wrappedResponse = kj::heap<ResponseSentTracker>(response);
   bool isActor = context.getActor() != kj::none;
+  if (describeRequest) {
+    incomingRequest->setDescription(
+        kj::str(incomingRequest->getDescription(), ": ", method, " ", url));
+  }
 
   // HACK: Capture workerTracer directly, it's unclear how to acquire the right tracer from context
   // when we need it (for DOs, IoContext may point to a different WorkerTracer by the time we use
@@ -665,6 +685,10 @@ kj::Promise<void> WorkerEntrypoint::connect(kj::StringPtr host,
 
   // TODO(soon): Implement basic TLS support for connect handler.
   JSG_REQUIRE(!settings.useTls, Error, "Incoming CONNECT with TLS not supported");
+  if (describeRequest) {
+    incomingRequest->setDescription(
+        kj::str(incomingRequest->getDescription(), ": CONNECT ", host));
+  }
   // Capture workerTracer, see request() for rationale.
   kj::Maybe<BaseTracer&> workerTracer;
 
@@ -690,13 +690,13 @@ class FileImpl final: public File {
   Stat stat(jsg::Lock& js) override {
     return Stat{
       .type = FsType::FILE,
-      .size = static_cast<uint32_t>(readableView().size()),
+      .size = readableView().size(),
       .lastModified = lastModified,
       .writable = isWritable(),
     };
   }
 
-  uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
     auto data = readableView();
     if (offset >= data.size() || buffer.size() == 0) return 0;
     auto src = data.slice(offset);
@@ -833,6 +833,11 @@ class FileImpl final: public File {
     }
 
     auto stat = file->stat(js);
+    // The source may be a host file larger than an in-memory file is allowed to be.
+    auto maxSize = Worker::Isolate::from(js).getLimitEnforcer().getBlobSizeLimit();
+    if (stat.size > maxSize) [[unlikely]] {
+      return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+    }
     auto buffer = kj::heapArray<kj::byte>(stat.size);
     file->read(js, 0, buffer.asPtr());
     auto& owned = ownedOrView.get<Owned>();
@@ -1174,6 +1179,10 @@ kj::OneOf<FsError, jsg::JsString> File::readAllText(jsg::Lock& js) {
   auto info = stat(js);
   KJ_DASSERT(info.type == FsType::FILE);
   if (info.size == 0) return js.str();
+  // In-memory files can't grow past the limit, but files on a host mount can be any size.
+  if (info.size > Worker::Isolate::from(js).getLimitEnforcer().getBlobSizeLimit()) [[unlikely]] {
+    return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+  }
 
   KJ_STACK_ARRAY(char, data, info.size, 4096, 4096);
   auto size = read(js, 0, data.asBytes());
@@ -1186,9 +1195,13 @@ kj::OneOf<FsError, jsg::JsString> File::readAllText(jsg::Lock& js) {
 kj::OneOf<FsError, jsg::JsRef<jsg::JsUint8Array>> File::readAllBytes(jsg::Lock& js) {
   auto info = stat(js);
   KJ_DASSERT(info.type == FsType::FILE);
+  if (info.size > Worker::Isolate::from(js).getLimitEnforcer().getBlobSizeLimit()) [[unlikely]] {
+    return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+  }
   auto u8 = jsg::JsUint8Array::create(js, info.size);
-  if (info.size > 0) {
-    KJ_ASSERT(read(js, 0, u8.asArrayPtr()) == info.size);
+  // A file on a writable host mount can shrink between the stat() and the read().
+  if (info.size > 0 && read(js, 0, u8.asArrayPtr()) != info.size) {
+    return FsError::FAILED;
   }
   return u8.addRef(js);
 }
@@ -1305,12 +1318,16 @@ kj::Own<VirtualFileSystem> newVirtualFileSystem(
 
 kj::Own<VirtualFileSystem> newWorkerFileSystem(kj::Own<FsMap> fsMap,
     kj::Rc<Directory> bundleDirectory,
-    kj::Own<VirtualFileSystem::Observer> observer) {
+    kj::Own<VirtualFileSystem::Observer> observer,
+    kj::Array<VfsMount> mounts) {
   // Our root directory is a read-only directory
   Directory::Builder builder;
   builder.addPath(fsMap->getBundlePath(), kj::mv(bundleDirectory));
   builder.addPath(fsMap->getTempPath(), getTmpDirectoryImpl());
   builder.addPath(fsMap->getDevPath(), getDevDirectory());
+  for (auto& mount: mounts) {
+    builder.addPath(mount.path, kj::mv(mount.directory));
+  }
   return newVirtualFileSystem(kj::mv(fsMap), builder.finish(), kj::mv(observer));
 }
 
@@ -1535,7 +1552,7 @@ class DevNullFile final: public File {
     // No-op.
   }
 
-  uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
     return 0;
   }
 
@@ -1608,7 +1625,7 @@ class DevZeroFile final: public File {
     // No-op.
   }
 
-  uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
     buffer.fill(0);
     return buffer.size();
   }
@@ -1682,7 +1699,7 @@ class DevFullFile final: public File {
     // No-op.
   }
 
-  uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
     buffer.fill(0);
     return buffer.size();
   }
@@ -1759,7 +1776,7 @@ class DevRandomFile final: public File {
     return FsError::NOT_PERMITTED;
   }
 
-  uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
+  uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const override {
     // We can only generate random bytes when we have an active IoContext.
     // If there is no IoContext, this will return 0 bytes.
     KJ_IF_SOME(ioContext, IoContext::tryCurrent()) {
@@ -1953,7 +1970,7 @@ class StdioFile final: public File {
     return static_cast<uint32_t>(buffer.size());
   }
 
-  uint32_t read(jsg::Lock&, uint32_t, kj::ArrayPtr<kj::byte>) const override {
+  uint32_t read(jsg::Lock&, uint64_t, kj::ArrayPtr<kj::byte>) const override {
     return 0;  // EOF
   }
 
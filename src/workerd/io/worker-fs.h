@@ -153,11 +153,11 @@ struct Stat final {
   FsType type = FsType::FILE;
 
   // The size of the node in bytes. For directories, this value will
-  // always be 0. Note that we are intentionally limiting the size of
-  // files to max(uint32_t) or 4GB. This is well above the maximum
-  // isolate heap limit so in-memory files should generally never
-  // get this large.
-  uint32_t size = 0;
+  // always be 0. In-memory files are intentionally limited to
+  // max(uint32_t) or 4GB, which is well above the maximum isolate heap
+  // limit, but files backed by a host directory mount (see disk-fs.h)
+  // may be larger.
+  uint64_t size = 0;
 
   // The last modified time of the node.
   kj::Date lastModified = kj::UNIX_EPOCH;
@@ -223,8 +223,10 @@ class File: public kj::Refcounted {
   kj::OneOf<FsError, jsg::JsRef<jsg::JsUint8Array>> readAllBytes(
       jsg::Lock& js) KJ_WARN_UNUSED_RESULT;
 
-  // Reads data from the file at the given offset into the given buffer.
-  virtual uint32_t read(jsg::Lock& js, uint32_t offset, kj::ArrayPtr<kj::byte> buffer) const = 0;
+  // Reads data from the file at the given offset into the given buffer. The
+  // offset is 64-bit so that files larger than 4GB (e.g. memory-mapped host
+  // files) can be read in full, but a single read is bounded by the buffer size.
+  virtual uint32_t read(jsg::Lock& js, uint64_t offset, kj::ArrayPtr<kj::byte> buffer) const = 0;
 
   // Replaces the full contents of the file with the given data.
   // Equivalent to resize(js, data.size()) followed by write(js, 0, data).
@@ -645,7 +647,7 @@ class VirtualFileSystem {
     // When reading from or writing to the file, if an offset is not
     // explicitly given then the offset will be set to the current
     // position in the file.
-    uint32_t position = 0;
+    uint64_t position = 0;
   };
 
   enum class Stdio {
@@ -801,15 +803,25 @@ class SymbolicLinkRecursionGuardScope final {
   kj::HashSet<SymbolicLink*> linksSeen;
 };
 
+// An additional directory exposed at a user-configured location in the
+// worker's virtual filesystem, e.g. a host directory mounted via
+// newDiskDirectory() (see disk-fs.h). The path is relative to the root and
+// must not overlap any of the known roots in the FsMap.
+struct VfsMount {
+  kj::Path path;
+  kj::Rc<Directory> directory;
+};
+
 // Every Worker instance has its own virtual filesystem. At a minimum, this
 // filesystem contains the worker's own bundled modules/files and a temporary
 // in-memory directory for the worker to use. The filesystem is not shared
 // between workers. The bundle delegate is a virtual directory delegate that
-// provides the directory structure for the worker's bundle.
+// provides the directory structure for the worker's bundle. Any additional
+// mounts are added alongside the known roots.
 kj::Own<VirtualFileSystem> newWorkerFileSystem(kj::Own<FsMap> fsMap,
     kj::Rc<Directory> bundleDirectory,
-    kj::Own<VirtualFileSystem::Observer> observer = kj::heap<VirtualFileSystem::Observer>())
-    KJ_WARN_UNUSED_RESULT;
+    kj::Own<VirtualFileSystem::Observer> observer = kj::heap<VirtualFileSystem::Observer>(),
+    kj::Array<VfsMount> mounts = nullptr) KJ_WARN_UNUSED_RESULT;
 
 // Exposed only for testing purposes.
 kj::Rc<Directory> getTmpDirectoryImpl() KJ_WARN_UNUSED_RESULT;
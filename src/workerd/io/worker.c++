@@ -12,9 +12,12 @@
 #include <workerd/io/actor-sqlite.h>
 #include <workerd/io/cdp.capnp.h>
 #include <workerd/io/compatibility-date.h>
+#include <workerd/io/continuous-profiler.h>
 #include <workerd/io/features.h>
 #include <workerd/io/frankenvalue.h>
+#include <workerd/io/heap-monitor.h>
 #include <workerd/io/per-isolate-bootstrap.h>
+#include <workerd/io/stall-detector.h>
 #include <workerd/io/tracer.h>
 #include <workerd/io/wasm-instantiate-shim.embed.h>
 #include <workerd/io/worker.h>
@@ -535,6 +538,17 @@ struct Worker::Isolate::Impl {
   kj::Maybe<kj::Own<v8::CpuProfiler>> profiler;
   ActorCache::SharedLru actorCacheLru;
 
+  // Started by the first Lock taken, if the isolate was given a ContinuousCpuProfiler. Protected
+  // by the isolate lock, like `currentLock`.
+  mutable kj::Maybe<kj::Own<ContinuousCpuProfiler::Session>> cpuProfileSession;
+
+  // Likewise, started by the first Lock taken if the isolate was given a HeapMonitor.
+  mutable kj::Maybe<kj::Own<HeapMonitor::Session>> heapMonitorSession;
+
+  // Set by ~Isolate before it takes its last Lock, which only drops the sessions above and
+  // shouldn't start, rotate or sample them.
+  bool tearingDown = false;
+
   // Used by JSG/Rust integration.
   ::rust::Box<::workerd::rust::jsg::Realm> realm;
 
@@ -569,8 +583,7 @@ struct Worker::Isolate::Impl {
           metrics([&isolate, &lockType]() -> kj::Maybe<kj::Own<IsolateObserver::LockTiming>> {
             KJ_SWITCH_ONEOF(lockType.origin) {
               KJ_CASE_ONEOF(sync, Worker::Lock::TakeSynchronously) {
-                // TODO(perf): We could do some tracking here to discover overly harmful synchronous
-                //   locks.
+                // Overly long holds, synchronous or not, are caught by the StallDetector.
                 return isolate.getMetrics().tryCreateLockTiming(sync.getRequest());
               }
               KJ_CASE_ONEOF(async, AsyncLock*) {
@@ -592,6 +605,21 @@ struct Worker::Isolate::Impl {
       __atomic_add_fetch(&impl.lockSuccessCount, 1, __ATOMIC_RELAXED);
       metrics.locked();
 
+      KJ_IF_SOME(detector, isolate.diagnostics.stallDetector) {
+        stallHold.emplace(detector, lock->v8Isolate);
+      }
+
+      KJ_IF_SOME(profiler, isolate.diagnostics.cpuProfiler) {
+        if (!impl.tearingDown) {
+          KJ_IF_SOME(session, impl.cpuProfileSession) {
+            session->maybeRotate();
+          } else {
+            impl.cpuProfileSession = kj::heap<ContinuousCpuProfiler::Session>(
+                profiler, lock->v8Isolate, isolate.getId());
+          }
+        }
+      }
+
       // We record the current lock so our GC prologue/epilogue callbacks can report GC time via
       // Jaeger tracing.
       KJ_DASSERT(impl.currentLock == kj::none, "Isolate lock taken recursively");
@@ -607,6 +635,18 @@ struct Worker::Isolate::Impl {
       }
 
       currentApi = isolate.api.get();
+
+      // Sample the heap once the lock is fully set up, so that GC time spent taking a snapshot is
+      // reported through `impl.currentLock` like any other.
+      KJ_IF_SOME(monitor, isolate.diagnostics.heapMonitor) {
+        if (!impl.tearingDown) {
+          if (impl.heapMonitorSession == kj::none) {
+            impl.heapMonitorSession = kj::heap<HeapMonitor::Session>(
+                monitor, lock->v8Isolate, isolate.getId(), impl.metrics);
+          }
+          KJ_ASSERT_NONNULL(impl.heapMonitorSession)->maybeSample();
+        }
+      }
     }
     ~Lock() noexcept(false) {
       currentApi = oldCurrentApi;
@@ -681,6 +721,10 @@ struct Worker::Isolate::Impl {
 
    public:
     kj::Own<jsg::Lock> lock;
+
+   private:
+    // Declared after `lock` so that the hold ends before the lock is released.
+    kj::Maybe<StallDetector::Hold> stallHold;
   };
 
   // Protected by v8::Locker -- if v8::Locker::IsLocked(isolate) is true, then it is safe to access
@@ -1097,7 +1141,8 @@ Worker::Isolate::Isolate(kj::Own<Api> apiParam,
     kj::StringPtr id,
     kj::Own<IsolateLimitEnforcer> limitEnforcerParam,
     InspectorPolicy inspectorPolicy,
-    LoggingOptions loggingOptions)
+    LoggingOptions loggingOptions,
+    Diagnostics diagnostics)
     : metrics(kj::mv(metricsParam)),
       id(kj::str(id)),
       limitEnforcer(kj::mv(limitEnforcerParam)),
@@ -1105,6 +1150,7 @@ Worker::Isolate::Isolate(kj::Own<Api> apiParam,
           kj::MutexGuarded<kj::Maybe<kj::Function<void(void)>>>(kj::none)),
       api(kj::mv(apiParam)),
       loggingOptions(loggingOptions),
+      diagnostics(diagnostics),
       featureFlagsForFl(makeCompatJson(decompileCompatibilityFlagsForFl(api->getFeatureFlags()))),
       impl(kj::heap<Impl>(*api, *metrics, *limitEnforcer, inspectorPolicy)),
       weakIsolateRef(WeakIsolateRef::wrap(this)),
@@ -1600,6 +1646,7 @@ Worker::Isolate::~Isolate() noexcept(false) {
   // is about to be destroyed, but we have to take the lock in order to enter the isolate.
   // It's also important that we lock one last time, in order to destroy any remaining workers in
   // worker destruction queue.
+  impl->tearingDown = true;
   jsg::runInV8Stack([&](jsg::V8StackScope& stackScope) {
     Isolate::Impl::Lock recordedLock(*this, Worker::Lock::TakeSynchronously(kj::none), stackScope);
     metrics->teardownLockAcquired();
@@ -1610,6 +1657,10 @@ Worker::Isolate::~Isolate() noexcept(false) {
     // and calls drop functions that may interact with V8.
     auto dropRealm = kj::mv(impl->realm);
 
+    // Writes out the last of the isolate's samples, if it was being profiled.
+    auto dropCpuProfileSession = kj::mv(impl->cpuProfileSession);
+    auto dropHeapMonitorSession = kj::mv(impl->heapMonitorSession);
+
     // Release all tracked WASM instance entries while V8 is still alive. Each entry holds a
     // shared_ptr<v8::BackingStore> whose destructor who needs the isolate to still be alive.
     // This is analogous to the cpuTimeLimitNearlyExceededCallback detaching above ^^^
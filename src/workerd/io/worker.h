@@ -60,7 +60,10 @@ KJ_DECLARE_NON_POLYMORPHIC(ArtifactBundler_State);
 }  // namespace pyodide
 }  // namespace api
 
+class ContinuousCpuProfiler;
+class HeapMonitor;
 class IsolateLimitEnforcer;
+class StallDetector;
 enum class UncaughtExceptionSource;
 class VirtualFileSystem;
 
@@ -339,6 +342,13 @@ class Worker::Isolate: public kj::AtomicRefcounted {
     ALLOW_FULLY_TRUSTED,
   };
 
+  // Process-wide diagnostics that watch the isolate's locks. Each must outlive the isolate.
+  struct Diagnostics {
+    kj::Maybe<const StallDetector&> stallDetector;
+    kj::Maybe<const ContinuousCpuProfiler&> cpuProfiler;
+    kj::Maybe<const HeapMonitor&> heapMonitor;
+  };
+
   // Creates an isolate with the given ID. The ID only matters for metrics-reporting purposes.
   // Usually it matches the script ID. An exception is preview isolates: there, each preview
   // session has one isolate which may load many iterations of the script (this allows the
@@ -351,7 +361,8 @@ class Worker::Isolate: public kj::AtomicRefcounted {
       kj::StringPtr id,
       kj::Own<IsolateLimitEnforcer> limitEnforcer,
       InspectorPolicy inspectorPolicy,
-      LoggingOptions loggingOptions = {});
+      LoggingOptions loggingOptions = {},
+      Diagnostics diagnostics = {});
 
   ~Isolate() noexcept(false);
   KJ_DISALLOW_COPY_AND_MOVE(Isolate);
@@ -391,6 +402,10 @@ class Worker::Isolate: public kj::AtomicRefcounted {
     return id;
   }
 
+  inline const Diagnostics& getDiagnostics() const {
+    return diagnostics;
+  }
+
   // Parses the given code to create a new script object and returns it.
   //
   // Note that the `source` is fully consumed before this method returns, so the underlying buffers
@@ -543,6 +558,7 @@ class Worker::Isolate: public kj::AtomicRefcounted {
   kj::MutexGuarded<kj::Maybe<kj::Function<void(void)>>> cpuLimitNearlyExceededCallback;
   kj::Own<Api> api;
   LoggingOptions loggingOptions;
+  Diagnostics diagnostics;
 
   // If non-null, a serialized JSON object with a single "flags" property, which is a list of
   // compatibility enable-flags that are relevant to FL.
@@ -105,5 +105,25 @@ KJ_TEST("MemoryTracker test") {
   });
 }
 
+KJ_TEST("IsolateBase::getNativeObjectStats tallies the memory graph by type") {
+  runTest([&](jsg::Lock& js, const TypeHandler<Ref<Foo>>& fooHandler) {
+    auto foo1 = fooHandler.wrap(js, js.alloc<Foo>(js));
+    auto foo2 = fooHandler.wrap(js, js.alloc<Foo>(js));
+
+    auto stats = IsolateBase::from(js.v8Isolate).getNativeObjectStats();
+    kj::HashMap<kj::StringPtr, const NativeObjectStats*> byName;
+    for (auto& entry: stats) byName.insert(entry.name, &entry);
+
+    auto& isolateBase = *KJ_ASSERT_NONNULL(byName.find("IsolateBase"_kj));
+    KJ_EXPECT(isolateBase.count == 1);
+    auto& foos = *KJ_ASSERT_NONNULL(byName.find("Foo"_kj));
+    KJ_EXPECT(foos.count >= 2, foos.count);
+
+    for (auto i: kj::range<size_t>(1, stats.size())) {
+      KJ_EXPECT(stats[i - 1].selfSize >= stats[i].selfSize);
+    }
+  });
+}
+
 }  // namespace
 }  // namespace workerd::jsg::test
@@ -108,7 +108,8 @@ namespace workerd::jsg {
 // memory leaks, detecting bugs, optimizing memory usage, etc) so the information
 // should include details that are most useful for those purposes.
 //
-// This code is only ever called when a heap snapshot is being generated so
+// This code is only ever called when a heap snapshot is being generated, or
+// when IsolateBase::getNativeObjectStats() is tallying the same graph, so
 // typically it should have very little cost. Heap snapshots are generally
 // fairly expensive to create, however, so care should be taken not to make
 // things too complicated. Ideally, none of the implementation methods in a
@@ -120,6 +121,15 @@ namespace workerd::jsg {
 class MemoryTracker;
 class MemoryRetainerNode;
 
+// Totals for one type of node in the graph built by MemoryTracker, as returned by
+// IsolateBase::getNativeObjectStats(). `name` is what jsgGetMemoryName() (or the edge or node name
+// passed to trackField()) returned.
+struct NativeObjectStats {
+  kj::String name;
+  size_t count;
+  size_t selfSize;
+};
+
 template <typename T>
 class V8Ref;
 template <typename T>
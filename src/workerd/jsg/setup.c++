@@ -14,6 +14,8 @@
 #include <v8-cppgc.h>
 #include <v8-initialization.h>
 
+#include <algorithm>
+
 #if !_WIN32
 #include <cxxabi.h>
 #include <ucontext.h>
@@ -249,6 +251,74 @@ void IsolateBase::buildEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* gr
   }
 }
 
+namespace {
+
+// Collects the nodes MemoryTracker adds instead of building a heap snapshot from them.
+class CountingEmbedderGraph final: public v8::EmbedderGraph {
+ public:
+  using v8::EmbedderGraph::V8Node;
+
+  Node* V8Node(const v8::Local<v8::Value>& value) override {
+    return &v8Placeholder;
+  }
+
+  Node* AddNode(std::unique_ptr<Node> node) override {
+    auto result = node.get();
+    nodes.add(kj::mv(node));
+    return result;
+  }
+
+  void AddEdge(Node* from, Node* to, const char* name) override {}
+
+  // Call once the walk is done: MemoryTracker adjusts a node's size as it visits its children.
+  kj::Array<NativeObjectStats> tally() {
+    kj::HashMap<kj::StringPtr, NativeObjectStats> byName;
+    for (auto& node: nodes) {
+      kj::StringPtr name = node->Name();
+      auto& stats = byName.findOrCreate(name, [&]() -> decltype(byName)::Entry {
+        return {name, {.name = kj::str(name), .count = 0, .selfSize = 0}};
+      });
+      ++stats.count;
+      stats.selfSize += node->SizeInBytes();
+    }
+
+    auto result = KJ_MAP(entry, byName) { return kj::mv(entry.value); };
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+      return a.selfSize > b.selfSize;
+    });
+    return result;
+  }
+
+ private:
+  class Placeholder final: public Node {
+   public:
+    const char* Name() override {
+      return "(V8)";
+    }
+    size_t SizeInBytes() override {
+      return 0;
+    }
+    bool IsEmbedderNode() override {
+      return false;
+    }
+  };
+
+  Placeholder v8Placeholder;
+  kj::Vector<std::unique_ptr<Node>> nodes;
+};
+
+}  // namespace
+
+kj::Array<NativeObjectStats> IsolateBase::getNativeObjectStats() {
+  CountingEmbedderGraph graph;
+  {
+    v8::HandleScope scope(ptr);
+    MemoryTracker tracker(ptr, &graph);
+    tracker.track(this);
+  }
+  return graph.tally();
+}
+
 void IsolateBase::jsgGetMemoryInfo(MemoryTracker& tracker) const {
   tracker.trackField("heapTracer", heapTracer);
 }
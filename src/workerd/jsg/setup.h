@@ -323,6 +323,12 @@ class IsolateBase {
     return true;
   }
 
+  // Tallies the native objects that a heap snapshot would include -- everything reachable through
+  // jsgGetMemoryInfo() -- by type, largest total self size first. Must be called with the isolate
+  // locked. Takes time proportional to the number of objects, but unlike a snapshot doesn't walk
+  // the JavaScript heap.
+  kj::Array<NativeObjectStats> getNativeObjectStats();
+
   // Get an object referencing this isolate that can be used to adjust external memory usage later
   kj::Arc<const ExternalMemoryTarget> getExternalMemoryTarget();
 
@@ -871,8 +871,10 @@ class ExternString: public Type {
     allocator.deallocate(this);
   }
 
+  // If `owned` is non-null, `buf` points into it and the string frees it once V8 disposes of the
+  // string. Otherwise `buf` must outlive the isolate.
   static v8::MaybeLocal<v8::String> createExtern(
-      v8::Isolate* isolate, kj::ArrayPtr<const Data>& buf) {
+      v8::Isolate* isolate, kj::ArrayPtr<const Data> buf, kj::Array<const Data> owned = nullptr) {
     if (buf.size() == 0) {
       return v8::String::Empty(isolate);
     }
@@ -890,7 +892,7 @@ class ExternString: public Type {
       return v8::MaybeLocal<v8::String>();
     }
 
-    auto resource = new (mem) ExternString<Type, Data>(isolate, buf);
+    auto resource = new (mem) ExternString<Type, Data>(isolate, buf, kj::mv(owned));
 
     v8::MaybeLocal<v8::String> str;
     if constexpr (kj::isSameType<Type, v8::String::ExternalOneByteStringResource>()) {
@@ -914,10 +916,13 @@ class ExternString: public Type {
  private:
   v8::Isolate* isolate;
   kj::ArrayPtr<const Data> buf;
+  kj::Array<const Data> owned;
 
-  inline ExternString(v8::Isolate* isolate, kj::ArrayPtr<const Data>& buf)
+  inline ExternString(
+      v8::Isolate* isolate, kj::ArrayPtr<const Data> buf, kj::Array<const Data> owned)
       : isolate(isolate),
-        buf(buf) {}
+        buf(buf),
+        owned(kj::mv(owned)) {}
 };
 
 using ExternOneByteString = ExternString<v8::String::ExternalOneByteStringResource, char>;
@@ -931,6 +936,16 @@ v8::Local<v8::String> newExternalTwoByteString(Lock& js, kj::ArrayPtr<const uint
   return check(ExternTwoByteString::createExtern(js.v8Isolate, buf));
 }
 
+v8::Local<v8::String> newExternalOneByteString(Lock& js, kj::Array<const char> buf) {
+  kj::ArrayPtr<const char> ptr = buf;
+  return check(ExternOneByteString::createExtern(js.v8Isolate, ptr, kj::mv(buf)));
+}
+
+v8::Local<v8::String> newExternalTwoByteString(Lock& js, kj::Array<const uint16_t> buf) {
+  kj::ArrayPtr<const uint16_t> ptr = buf;
+  return check(ExternTwoByteString::createExtern(js.v8Isolate, ptr, kj::mv(buf)));
+}
+
 // ======================================================================================
 // Module utilities
 
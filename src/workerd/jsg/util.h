@@ -572,6 +572,12 @@ v8::Local<v8::String> newExternalOneByteString(Lock& js, kj::ArrayPtr<const char
 // that are not owned by the v8 heap.
 v8::Local<v8::String> newExternalTwoByteString(Lock& js, kj::ArrayPtr<const uint16_t> buf);
 
+// Like the above, but the string takes ownership of `buf` and frees it once V8 collects the
+// string, so the buffer need not be static. This lets a large buffer become a JS string without
+// being copied onto the V8 heap. The same latin-1 caveat applies to the OneByteString variant.
+v8::Local<v8::String> newExternalOneByteString(Lock& js, kj::Array<const char> buf);
+v8::Local<v8::String> newExternalTwoByteString(Lock& js, kj::Array<const uint16_t> buf);
+
 // Use this type to mark APIs that are not implemented. Attempts to use the API will throw an
 // exception.
 // - Use Unimplemented as a method parameter type or struct field type to mark that
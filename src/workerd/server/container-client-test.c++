@@ -13,6 +13,8 @@
 
 #include "container-client.h"
 
+#include <kj/async-io.h>
+#include <kj/compat/http.h>
 #include <kj/test.h>
 
 namespace workerd::server {
@@ -303,5 +305,208 @@ KJ_TEST("ContainerCreateRequest omits empty container privileges") {
   KJ_EXPECT(decodedHostConfig.getSecurityOpt().size() == 0);
 }
 
+// A minimal stand-in for the Docker Engine API, just capable enough for ContainerWarmPool and
+// DockerApiClient. Every
+// container exists as soon as it is created, and the sidecar ingress port it reports is this
+// server's own port, so the pool's sidecar readiness check lands here too.
+class FakeDockerService final: public kj::HttpService {
+ public:
+  explicit FakeDockerService(kj::HttpHeaderTable& headerTable): headerTable(headerTable) {}
+
+  uint16_t port = 0;
+  uint connections = 0;
+  uint creates = 0;
+  uint starts = 0;
+  uint inspects = 0;
+  kj::Vector<kj::String> removed;
+
+  // Like HttpServer::listenHttp(), but counts the connections accepted.
+  kj::Promise<void> listen(kj::ConnectionReceiver& listener, kj::HttpServer& server) {
+    for (;;) {
+      auto connection = co_await listener.accept();
+      ++connections;
+      connectionTasks.add(server.listenHttp(kj::mv(connection)).eagerlyEvaluate(nullptr));
+    }
+  }
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override {
+    co_await requestBody.readAllBytes();
+    co_await reply(response, route(method, url));
+  }
+
+ private:
+  kj::HttpHeaderTable& headerTable;
+  kj::Vector<kj::Promise<void>> connectionTasks;
+
+  struct Reply {
+    uint status;
+    kj::String body;
+  };
+
+  Reply route(kj::HttpMethod method, kj::StringPtr url) {
+    if (method == kj::HttpMethod::DELETE && url.startsWith("/containers/")) {
+      auto end = KJ_ASSERT_NONNULL(url.findFirst('?'));
+      removed.add(kj::str(url.slice("/containers/"_kj.size(), end)));
+      return {404, kj::str("{}")};
+    } else if (method == kj::HttpMethod::GET && url == "/networks/bridge") {
+      return {200,
+        kj::str(
+            R"({"Name":"bridge","IPAM":{"Config":[{"Subnet":"172.17.0.0/16","Gateway":"172.17.0.1"}]}})")};
+    } else if (method == kj::HttpMethod::POST && url.startsWith("/containers/create?name=")) {
+      ++creates;
+      auto name = url.slice("/containers/create?name="_kj.size());
+      return {201, kj::str(R"({"Id":"id-)", name, R"("})")};
+    } else if (method == kj::HttpMethod::POST && url.endsWith("/start")) {
+      ++starts;
+      return {204, kj::str()};
+    } else if (method == kj::HttpMethod::GET && url.endsWith("/json")) {
+      ++inspects;
+      return {200,
+        kj::str(R"({"State":{"Status":"running"},"NetworkSettings":{"Ports":{"39001/tcp":)",
+            R"([{"HostIp":"0.0.0.0","HostPort":")", port, R"("}]}}})")};
+    } else if (method == kj::HttpMethod::PUT && url == "/egress") {
+      return {200, kj::str("{}")};
+    }
+
+    KJ_FAIL_EXPECT("unexpected Docker API request", method, url);
+    return {500, kj::str("{}")};
+  }
+
+  kj::Promise<void> reply(Response& response, Reply r) {
+    kj::HttpHeaders headers(headerTable);
+    auto stream = response.send(r.status, "OK"_kj, headers, r.body.size());
+    if (r.body.size() > 0) {
+      co_await stream->write(r.body.asBytes());
+    }
+  }
+};
+
+struct ExpectNoTaskErrors final: public kj::TaskSet::ErrorHandler {
+  void taskFailed(kj::Exception&& exception) override {
+    KJ_FAIL_EXPECT(exception);
+  }
+};
+
+void waitUntilReady(
+    ContainerWarmPool& pool, size_t count, kj::Timer& timer, kj::WaitScope& waitScope) {
+  for (auto i KJ_UNUSED: kj::zeroTo(5000)) {
+    if (pool.readyCount() == count) return;
+    timer.afterDelay(1 * kj::MILLISECONDS).wait(waitScope);
+  }
+  KJ_FAIL_REQUIRE("warm pool did not fill", pool.readyCount(), count);
+}
+
+KJ_TEST("ContainerWarmPool fills, hands out, and refills containers") {
+  auto io = kj::setupAsyncIo();
+  auto& network = io.provider->getNetwork();
+  auto& timer = io.provider->getTimer();
+
+  kj::HttpHeaderTable headerTable;
+  FakeDockerService docker(headerTable);
+  auto listener = network.parseAddress("127.0.0.1", 0).wait(io.waitScope)->listen();
+  docker.port = listener->getPort();
+  kj::HttpServer server(timer, headerTable, docker);
+  auto serverTask = server.listenHttp(*listener).eagerlyEvaluate(nullptr);
+
+  ExpectNoTaskErrors errorHandler;
+  kj::TaskSet waitUntilTasks(errorHandler);
+
+  {
+    ContainerWarmPool pool(timer,
+        kj::refcounted<DockerApiClient>(timer, network, kj::str("127.0.0.1:", docker.port)),
+        "workerd-test"_kj, kj::str("app-image"), kj::str("sidecar-image"), ContainerPrivileges{},
+        false, 2, waitUntilTasks);
+
+    pool.fill();
+    waitUntilReady(pool, 2, timer, io.waitScope);
+    // Each slot is an app container plus its sidecar.
+    KJ_EXPECT(docker.creates == 4);
+    KJ_EXPECT(docker.starts == 4);
+    // Slot names are cleared of leftovers before being filled.
+    KJ_EXPECT(docker.removed.size() == 4);
+
+    auto maybeEntry = pool.tryTake();
+    auto& entry = KJ_ASSERT_NONNULL(maybeEntry);
+    KJ_EXPECT(entry.containerId.startsWith("id-workerd-test-pool-"));
+    KJ_EXPECT(entry.sidecarId.endsWith("-proxy"));
+    KJ_EXPECT(entry.ingressHostPort == docker.port);
+    KJ_EXPECT(pool.getMetrics().hits == 1);
+    KJ_EXPECT(pool.getMetrics().misses == 0);
+
+    // The vacated slot is refilled in the background.
+    waitUntilReady(pool, 2, timer, io.waitScope);
+    KJ_EXPECT(docker.creates == 6);
+
+    KJ_EXPECT(pool.tryTake() != kj::none);
+    KJ_EXPECT(pool.tryTake() != kj::none);
+    KJ_EXPECT(pool.tryTake() == kj::none);
+    KJ_EXPECT(pool.getMetrics().hits == 3);
+    KJ_EXPECT(pool.getMetrics().misses == 1);
+    KJ_EXPECT(pool.getMetrics().failures == 0);
+
+    waitUntilReady(pool, 2, timer, io.waitScope);
+    docker.removed.clear();
+  }
+
+  // Destroying the pool removes the containers it still holds.
+  waitUntilTasks.onEmpty().wait(io.waitScope);
+  KJ_EXPECT(docker.removed.size() == 4);
+}
+
+KJ_TEST("DockerApiClient reuses connections and coalesces concurrent inspects") {
+  auto io = kj::setupAsyncIo();
+  auto& network = io.provider->getNetwork();
+  auto& timer = io.provider->getTimer();
+
+  kj::HttpHeaderTable headerTable;
+  FakeDockerService docker(headerTable);
+  auto listener = network.parseAddress("127.0.0.1", 0).wait(io.waitScope)->listen();
+  docker.port = listener->getPort();
+  kj::HttpServer server(timer, headerTable, docker);
+  auto serverTask = docker.listen(*listener, server).eagerlyEvaluate(nullptr);
+
+  auto client = kj::refcounted<DockerApiClient>(timer, network, kj::str("127.0.0.1:", docker.port));
+  auto get = [&](kj::StringPtr endpoint) {
+    return client->request(kj::HttpMethod::GET, endpoint, kj::none, nullptr, 1024 * 1024);
+  };
+
+  // Sequential requests share one connection.
+  for (auto i KJ_UNUSED: kj::zeroTo(3)) {
+    auto response = get("/networks/bridge").wait(io.waitScope);
+    KJ_EXPECT(response.statusCode == 200);
+  }
+  KJ_EXPECT(docker.connections == 1);
+
+  // Concurrent inspects of the same container are sent once, and every caller gets the response.
+  auto responses = kj::joinPromises(kj::arr(get("/containers/a/json"), get("/containers/a/json"),
+                                        get("/containers/a/json")))
+                       .wait(io.waitScope);
+  KJ_EXPECT(docker.inspects == 1);
+  for (auto& response: responses) {
+    KJ_EXPECT(response.statusCode == 200);
+    KJ_EXPECT(kj::str(response.body.asChars()).contains("running"));
+  }
+
+  // Different containers are inspected separately.
+  kj::joinPromises(kj::arr(get("/containers/a/json"), get("/containers/b/json")))
+      .wait(io.waitScope);
+  KJ_EXPECT(docker.inspects == 3);
+
+  // An inspect sent before a mutation is not shared with callers after it.
+  auto body = "{}"_kj.asBytes();
+  auto before = get("/containers/a/json");
+  auto start = client->request(kj::HttpMethod::POST, "/containers/a/start", body,
+      "application/json"_kj, 1024 * 1024);
+  auto after = get("/containers/a/json");
+  before.wait(io.waitScope);
+  start.wait(io.waitScope);
+  after.wait(io.waitScope);
+  KJ_EXPECT(docker.inspects == 5);
+}
+
 }  // namespace
 }  // namespace workerd::server
@@ -87,10 +87,7 @@ struct DockerResponse {
   kj::String body;
 };
 
-struct DockerBinaryResponse {
-  kj::uint statusCode;
-  kj::Array<kj::byte> body;
-};
+using DockerBinaryResponse = DockerApiClient::Response;
 
 struct DockerStreamedResponse {
   kj::uint statusCode;
@@ -525,45 +522,42 @@ kj::Array<kj::byte> createTarWithFile(
   return tar;
 }
 
-// Shared Docker API HTTP helper. Connects to the Docker socket, sends a request with an
-// optional body, and reads the response as raw bytes.
-kj::Promise<DockerBinaryResponse> dockerApiRequestRaw(kj::Network& network,
-    kj::String dockerPath,
+// Sends a request to the HTTP API of a container sidecar, over a connection of its own, and
+// reads the response as a string.
+kj::Promise<DockerResponse> sidecarApiRequest(kj::Network& network,
+    kj::String address,
     kj::HttpMethod method,
     kj::String endpoint,
-    kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
-    kj::StringPtr contentType,
-    uint64_t maxResponseSize) {
+    kj::Maybe<kj::String> body = kj::none) {
   kj::HttpHeaderTable headerTable;
-  auto address = co_await network.parseAddress(dockerPath);
-  auto connection = co_await address->connect();
+  auto addr = co_await network.parseAddress(address);
+  auto connection = co_await addr->connect();
   auto httpClient = kj::newHttpClient(headerTable, *connection).attach(kj::mv(connection));
   kj::HttpHeaders headers(headerTable);
   headers.setPtr(kj::HttpHeaderId::HOST, "localhost");
 
   KJ_IF_SOME(requestBody, body) {
-    headers.setPtr(kj::HttpHeaderId::CONTENT_TYPE, contentType);
+    headers.setPtr(kj::HttpHeaderId::CONTENT_TYPE, "application/json");
     headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(requestBody.size()));
 
     auto req = httpClient->request(method, endpoint, headers, requestBody.size());
     {
       auto stream = kj::mv(req.body);
-      co_await stream->write(requestBody);
+      co_await stream->write(requestBody.asBytes());
     }
     auto response = co_await req.response;
-    auto result = co_await response.body->readAllBytes(maxResponseSize);
-    co_return DockerBinaryResponse{.statusCode = response.statusCode, .body = kj::mv(result)};
+    auto result = co_await response.body->readAllText(MAX_JSON_RESPONSE_SIZE);
+    co_return DockerResponse{.statusCode = response.statusCode, .body = kj::mv(result)};
   } else {
     auto req = httpClient->request(method, endpoint, headers);
     { auto stream = kj::mv(req.body); }
     auto response = co_await req.response;
-    auto result = co_await response.body->readAllBytes(maxResponseSize);
-    co_return DockerBinaryResponse{.statusCode = response.statusCode, .body = kj::mv(result)};
+    auto result = co_await response.body->readAllText(MAX_JSON_RESPONSE_SIZE);
+    co_return DockerResponse{.statusCode = response.statusCode, .body = kj::mv(result)};
   }
 }
 
-kj::Promise<DockerResponse> dockerApiRequest(kj::Network& network,
-    kj::String dockerPath,
+kj::Promise<DockerResponse> dockerApiRequest(DockerApiClient& docker,
     kj::HttpMethod method,
     kj::String endpoint,
     kj::Maybe<kj::String> body = kj::none) {
@@ -571,13 +565,12 @@ kj::Promise<DockerResponse> dockerApiRequest(kj::Network& network,
   KJ_IF_SOME(b, body) {
     bodyBytes = b.asBytes();
   }
-  auto raw = co_await dockerApiRequestRaw(network, kj::mv(dockerPath), method, kj::mv(endpoint),
-      bodyBytes, "application/json"_kj, MAX_JSON_RESPONSE_SIZE);
+  auto raw = co_await docker.request(
+      method, endpoint, bodyBytes, "application/json"_kj, MAX_JSON_RESPONSE_SIZE);
   co_return DockerResponse{.statusCode = raw.statusCode, .body = kj::str(raw.body.asChars())};
 }
 
-kj::Promise<DockerBinaryResponse> dockerApiBinaryRequest(kj::Network& network,
-    kj::String dockerPath,
+kj::Promise<DockerBinaryResponse> dockerApiBinaryRequest(DockerApiClient& docker,
     kj::HttpMethod method,
     kj::String endpoint,
     kj::Maybe<kj::Array<kj::byte>> body,
@@ -586,25 +579,25 @@ kj::Promise<DockerBinaryResponse> dockerApiBinaryRequest(kj::Network& network,
   KJ_IF_SOME(b, body) {
     bodyBytes = b.asPtr();
   }
-  co_return co_await dockerApiRequestRaw(network, kj::mv(dockerPath), method, kj::mv(endpoint),
-      bodyBytes, "application/x-tar"_kj, maxResponseSize);
+  co_return co_await docker.request(
+      method, endpoint, bodyBytes, "application/x-tar"_kj, maxResponseSize);
 }
 
-kj::Promise<void> deleteVolume(kj::Network& network, kj::String dockerPath, kj::String volumeName) {
+kj::Promise<void> deleteVolume(DockerApiClient& docker, kj::String volumeName) {
   auto response = co_await dockerApiRequest(
-      network, kj::mv(dockerPath), kj::HttpMethod::DELETE, kj::str("/volumes/", volumeName));
+      docker, kj::HttpMethod::DELETE, kj::str("/volumes/", volumeName));
   if (response.statusCode != 204 && response.statusCode != 404) {
     KJ_LOG(WARNING, "failed to delete volume", volumeName, response.statusCode, response.body);
   }
 }
 
 kj::Promise<void> deleteVolumes(
-    kj::Network& network, kj::String dockerPath, kj::Array<kj::String> snapshotCloneVolumes) {
+    DockerApiClient& docker, kj::Array<kj::String> snapshotCloneVolumes) {
   kj::Vector<kj::Promise<void>> volumeDeletes;
   volumeDeletes.reserve(snapshotCloneVolumes.size());
   for (auto& volumeName: snapshotCloneVolumes) {
     auto logName = kj::str(volumeName);
-    volumeDeletes.add(deleteVolume(network, kj::str(dockerPath), kj::mv(volumeName))
+    volumeDeletes.add(deleteVolume(docker, kj::mv(volumeName))
                           .catch_([logName = kj::mv(logName)](kj::Exception&& e) {
       KJ_LOG(WARNING, "failed to delete volume", logName, e);
     }));
@@ -613,10 +606,9 @@ kj::Promise<void> deleteVolumes(
 }
 
 kj::Promise<void> removeContainer(
-    kj::Network& network, kj::String dockerPath, kj::String containerName, bool wait = true) {
+    DockerApiClient& docker, kj::String containerName, bool wait = true) {
   auto endpoint = kj::str("/containers/", containerName, "?force=true");
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::DELETE, kj::mv(endpoint));
+  auto response = co_await dockerApiRequest(docker, kj::HttpMethod::DELETE, kj::mv(endpoint));
   // 204 means the container was removed.
   // 404 means it was already gone.
   // 409 means removal is already in progress, which is fine for our teardown paths.
@@ -626,7 +618,7 @@ kj::Promise<void> removeContainer(
   // If removal succeeded or is already in progress, wait for Docker to report the container as
   // fully removed before proceeding with any follow-up cleanup like deleting mounted volumes.
   if (wait && (response.statusCode == 204 || response.statusCode == 409)) {
-    response = co_await dockerApiRequest(network, kj::mv(dockerPath), kj::HttpMethod::POST,
+    response = co_await dockerApiRequest(docker, kj::HttpMethod::POST,
         kj::str("/containers/", containerName, "/wait?condition=removed"));
     // 200 means Docker observed the removal. 404 means the container disappeared before the wait
     // request was processed, which is also fine.
@@ -701,14 +693,13 @@ kj::Promise<DockerStreamedResponse> readDockerStreamedResponse(
   }
 }
 
-kj::Promise<DockerStreamedResponse> dockerApiStreamedRequest(kj::Network& network,
-    kj::String dockerPath,
+kj::Promise<DockerStreamedResponse> dockerApiStreamedRequest(DockerApiClient& docker,
     kj::HttpMethod method,
     kj::String endpoint,
     const kj::HttpHeaders& headers,
     kj::Maybe<kj::ArrayPtr<const kj::byte>> body = kj::none) {
-  auto address = co_await network.parseAddress(dockerPath);
-  auto connection = co_await address->connect();
+  // The connection is handed over to the caller, so it can't come from the keep-alive pool.
+  auto connection = co_await docker.connect();
 
   auto requestHeaders = headers.serializeRequest(method, endpoint);
   KJ_IF_SOME(requestBody, body) {
@@ -873,7 +864,7 @@ kj::Maybe<int64_t> tryGetSnapshotCreatedAt(capnp::JsonValue::Reader labels) {
   return kj::none;
 }
 
-kj::Promise<void> warnAboutStaleSnapshotVolumes(kj::Network& network, kj::String dockerPath) {
+kj::Promise<void> warnAboutStaleSnapshotVolumes(DockerApiClient& docker) {
   capnp::JsonCodec codec;
   codec.handleByAnnotation<docker_api::Docker::VolumeListFilters>();
   capnp::MallocMessageBuilder filterMessage;
@@ -881,7 +872,7 @@ kj::Promise<void> warnAboutStaleSnapshotVolumes(kj::Network& network, kj::String
   auto names = filters.initName(1);
   names.set(0, SNAPSHOT_VOLUME_PREFIX);
 
-  auto response = co_await dockerApiRequest(network, kj::mv(dockerPath), kj::HttpMethod::GET,
+  auto response = co_await dockerApiRequest(docker, kj::HttpMethod::GET,
       kj::str("/volumes?filters=", kj::encodeUriComponent(codec.encode(filters))));
   if (response.statusCode != 200) {
     co_return;
@@ -950,6 +941,206 @@ kj::String killTokenPidFile(kj::StringPtr killToken) {
   return kj::str("/tmp/.workerd-exec-", killToken, ".pid");
 }
 
+constexpr kj::StringPtr DEFAULT_CONTAINER_ENV[] = {"CLOUDFLARE_COUNTRY_A2=XX"_kj,
+  "CLOUDFLARE_DEPLOYMENT_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
+  "CLOUDFLARE_LOCATION=loc01"_kj, "CLOUDFLARE_REGION=REGN"_kj,
+  "CLOUDFLARE_APPLICATION_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
+  "CLOUDFLARE_DURABLE_OBJECT_ID=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"_kj};
+
+struct IPAMConfigResult {
+  kj::String gateway;
+  kj::String subnet;
+};
+
+// Get the Docker bridge network gateway IP and subnet.
+kj::Promise<IPAMConfigResult> getDockerBridgeIPAMConfig(DockerApiClient& docker) {
+  auto response = co_await dockerApiRequest(
+      docker, kj::HttpMethod::GET, kj::str("/networks/bridge"));
+  if (response.statusCode == 200) {
+    auto message = decodeJsonResponse<docker_api::Docker::NetworkInspectResponse>(response.body);
+    auto jsonRoot = message->getRoot<docker_api::Docker::NetworkInspectResponse>();
+    auto ipamConfig = jsonRoot.getIpam().getConfig();
+    if (ipamConfig.size() > 0) {
+      auto config = ipamConfig[0];
+      co_return IPAMConfigResult{
+        .gateway = kj::str(config.getGateway()),
+        .subnet = kj::str(config.getSubnet()),
+      };
+    }
+  }
+
+  JSG_FAIL_REQUIRE(Error,
+      "Failed to get bridge. "
+      "Status: ",
+      response.statusCode, ", Body: ", response.body);
+}
+
+// Check if the Docker daemon has IPv6 enabled by inspecting the default bridge network's
+// IPAM config for IPv6 subnets.
+kj::Promise<bool> isDaemonIpv6Enabled(DockerApiClient& docker) {
+  // Inspect the default bridge network. When the Docker daemon has "ipv6": true in
+  // daemon.json, the default bridge gets an IPv6 IPAM subnet entry (e.g. "fd00::/80").
+  auto response = co_await dockerApiRequest(
+      docker, kj::HttpMethod::GET, kj::str("/networks/bridge"));
+
+  if (response.statusCode != 200) {
+    co_return false;
+  }
+
+  auto message = decodeJsonResponse<docker_api::Docker::NetworkInspectResponse>(response.body);
+  auto jsonRoot = message->getRoot<docker_api::Docker::NetworkInspectResponse>();
+  for (auto config: jsonRoot.getIpam().getConfig()) {
+    // IPv6 subnets contain ':' (e.g. "fd00::/80", "2001:db8::/64")
+    if (kj::StringPtr(config.getSubnet()).findFirst(':') != kj::none) {
+      co_return true;
+    }
+  }
+
+  co_return false;
+}
+
+// Builds the ContainerCreate request body for a networking sidecar.
+// Equivalent to: docker run --cap-add=NET_ADMIN -p <random-host>:39001 ...
+kj::String encodeSidecarCreateRequest(
+    kj::StringPtr image, uint16_t egressPort, kj::StringPtr networkCidr, bool ipv6Enabled) {
+  capnp::JsonCodec codec;
+  codec.handleByAnnotation<docker_api::Docker::ContainerCreateRequest>();
+  capnp::MallocMessageBuilder message;
+  auto jsonRoot = message.initRoot<docker_api::Docker::ContainerCreateRequest>();
+  jsonRoot.setImage(image);
+
+  // determined by the number of flags we need to pass to proxy-everything
+  uint32_t cmdSize =
+      8;  // --http-egress-port <port> --http-ingress-address 0.0.0.0:<port> --docker-gateway-cidr <cidr> --dns-enabled --tls-intercept
+  if (!ipv6Enabled) cmdSize += 1;  // --disable-ipv6
+
+  auto cmd = jsonRoot.initCmd(cmdSize);
+  uint32_t idx = 0;
+  cmd.set(idx++, "--http-egress-port");
+  cmd.set(idx++, kj::str(egressPort));
+  cmd.set(idx++, "--http-ingress-address");
+  cmd.set(idx++, kj::str("0.0.0.0:", SIDECAR_INGRESS_PORT));
+  cmd.set(idx++, "--docker-gateway-cidr");
+  cmd.set(idx++, networkCidr);
+  cmd.set(idx++, "--dns-enabled");
+  cmd.set(idx++, "--tls-intercept");
+  if (!ipv6Enabled) {
+    cmd.set(idx++, "--disable-ipv6");
+  }
+
+  jsonRoot.initExposedPorts().setRaw(kj::str("{\"", SIDECAR_INGRESS_PORT, "/tcp\":{}}"));
+
+  auto hostConfig = jsonRoot.initHostConfig();
+  hostConfig.setPublishAllPorts(true);
+  hostConfig.setNetworkMode("bridge");
+  auto dns = hostConfig.initDns(kj::size(SIDECAR_DNS_SERVERS));
+  for (auto i: kj::indices(SIDECAR_DNS_SERVERS)) {
+    dns.set(i, SIDECAR_DNS_SERVERS[i]);
+  }
+
+  auto extraHosts = hostConfig.initExtraHosts(1);
+  extraHosts.set(0, "host.docker.internal:host-gateway"_kj);
+
+  // Sidecar needs NET_ADMIN capability for iptables/TPROXY
+  auto capAdd = hostConfig.initCapAdd(1);
+  capAdd.set(0, "NET_ADMIN");
+
+  return codec.encode(jsonRoot);
+}
+
+// Inspects a sidecar container and returns the host port its ingress is published on, or
+// kj::none if the sidecar does not exist or is not running.
+kj::Promise<kj::Maybe<uint16_t>> inspectSidecarIngressPort(
+    DockerApiClient& docker, kj::StringPtr sidecarName) {
+  auto endpoint = kj::str("/containers/", sidecarName, "/json");
+  auto response = co_await dockerApiRequest(docker, kj::HttpMethod::GET, kj::mv(endpoint));
+
+  if (response.statusCode == 404) {
+    co_return kj::none;
+  }
+
+  JSG_REQUIRE(response.statusCode == 200, Error, "Sidecar container inspect failed");
+
+  auto message = decodeJsonResponse<docker_api::Docker::ContainerInspectResponse>(response.body);
+  auto jsonRoot = message->getRoot<docker_api::Docker::ContainerInspectResponse>();
+
+  // Check if sidecar is actually running
+  bool running = false;
+  if (jsonRoot.hasState()) {
+    auto state = jsonRoot.getState();
+    if (state.hasStatus()) {
+      auto status = state.getStatus();
+      running = status == "running" || status == "restarting";
+    }
+  }
+
+  if (!running) {
+    co_return kj::none;
+  }
+
+  kj::Maybe<uint16_t> ingressHostPort;
+
+  auto ingressPortKey = kj::str(SIDECAR_INGRESS_PORT, "/tcp");
+  for (auto portMapping: jsonRoot.getNetworkSettings().getPorts().getObject()) {
+    if (portMapping.getName() != ingressPortKey) {
+      continue;
+    }
+
+    ingressHostPort = tryParsePublishedHostPort(portMapping.getValue());
+    break;
+  }
+
+  co_return KJ_REQUIRE_NONNULL(ingressHostPort, "running sidecar missing ingress host port");
+}
+
+// Points a sidecar's egress proxy at the given workerd egress listener port.
+kj::Promise<void> putSidecarEgressPort(
+    kj::Network& network, uint16_t ingressHostPort, uint16_t egressPort) {
+  capnp::JsonCodec codec;
+  codec.handleByAnnotation<docker_api::ProxyEverything::Port>();
+  capnp::MallocMessageBuilder message;
+  auto jsonRoot = message.initRoot<docker_api::ProxyEverything::Port>();
+  jsonRoot.setPort(egressPort);
+
+  auto body = codec.encode(jsonRoot);
+  auto response = co_await sidecarApiRequest(network, kj::str("127.0.0.1:", ingressHostPort),
+      kj::HttpMethod::PUT, kj::str("/egress"), kj::mv(body));
+
+  JSG_REQUIRE(response.statusCode >= 200 && response.statusCode < 300, Error,
+      "Updating sidecar egress port failed with: ", response.statusCode, " ", response.body);
+}
+
+// Waits for a freshly started sidecar's HTTP server to be ready by calling `attempt` in a retry
+// loop with a per-attempt timeout.
+kj::Promise<void> waitForSidecarReady(
+    kj::Timer& timer, kj::Function<kj::Promise<void>()> attempt) {
+  constexpr int MAX_READY_RETRIES = 10;
+  constexpr auto READY_RETRY_DELAY = 200 * kj::MILLISECONDS;
+  constexpr auto READY_ATTEMPT_TIMEOUT = 2 * kj::SECONDS;
+  for (int i = 0;; ++i) {
+    kj::Maybe<kj::Exception> maybeError;
+    try {
+      co_await timer.timeoutAfter(READY_ATTEMPT_TIMEOUT, attempt());
+    } catch (...) {
+      maybeError = kj::getCaughtExceptionAsKj();
+    }
+
+    if (maybeError == kj::none) break;
+    if (i >= MAX_READY_RETRIES - 1) kj::throwFatalException(kj::mv(KJ_REQUIRE_NONNULL(maybeError)));
+    co_await timer.afterDelay(READY_RETRY_DELAY);
+  }
+}
+
+// Renames a container. `container` may be a name or an ID.
+kj::Promise<void> renameContainer(
+    DockerApiClient& docker, kj::StringPtr container, kj::StringPtr newName) {
+  auto response = co_await dockerApiRequest(docker, kj::HttpMethod::POST,
+      kj::str("/containers/", container, "/rename?name=", newName));
+  // statusCode 204 refers to "no error"
+  JSG_REQUIRE(response.statusCode == 204, Error, "Renaming container failed with: [",
+      response.statusCode, "] ", response.body);
+}
+
 }  // namespace
 
 void configureContainerPrivileges(
@@ -1006,7 +1197,7 @@ struct ContainerClient::EgressState {
 ContainerClient::ContainerClient(capnp::ByteStreamFactory& byteStreamFactory,
     kj::Timer& timer,
     kj::Network& network,
-    kj::String dockerPath,
+    kj::Own<DockerApiClient> docker,
     kj::String containerName,
     kj::String imageName,
     kj::String containerEgressInterceptorImage,
@@ -1014,23 +1205,26 @@ ContainerClient::ContainerClient(capnp::ByteStreamFactory& byteStreamFactory,
     kj::Promise<void> pendingCleanup,
     kj::Function<void(kj::Promise<void>)> cleanupCallback,
     ChannelTokenHandler& channelTokenHandler,
-    ContainerPrivileges privileges)
+    ContainerPrivileges privileges,
+    kj::Maybe<ContainerWarmPool&> warmPool)
     : byteStreamFactory(byteStreamFactory),
       timer(timer),
       network(network),
-      dockerPath(kj::mv(dockerPath)),
+      docker(kj::mv(docker)),
       containerName(kj::encodeUriComponent(kj::str(containerName))),
       sidecarContainerName(kj::encodeUriComponent(kj::str(containerName, "-proxy"))),
       imageName(kj::mv(imageName)),
       containerEgressInterceptorImage(kj::mv(containerEgressInterceptorImage)),
       privileges(kj::mv(privileges)),
+      warmPool(warmPool),
       waitUntilTasks(waitUntilTasks),
       pendingCleanup(kj::mv(pendingCleanup).fork()),
       cleanupCallback(kj::mv(cleanupCallback)),
       channelTokenHandler(channelTokenHandler),
       egressState(kj::heap<EgressState>()) {
   if (!staleSnapshotVolumeCheckScheduled.exchange(true)) {
-    waitUntilTasks.add(warnAboutStaleSnapshotVolumes(network, kj::str(this->dockerPath))
+    waitUntilTasks.add(warnAboutStaleSnapshotVolumes(*this->docker)
+                           .attach(this->docker->addRef())
                            .catch_([](kj::Exception&& e) {
       KJ_LOG(WARNING, "failed to inspect snapshot volumes for staleness", e);
     }));
@@ -1041,17 +1235,16 @@ ContainerClient::~ContainerClient() noexcept(false) {
   stopEgressListener();
 
   // Best-effort cleanup for both containers.
-  auto sidecarCleanup =
-      removeContainer(network, kj::str(dockerPath), kj::str(sidecarContainerName), false)
-          .catch_([](kj::Exception&&) {});
+  auto sidecarCleanup = removeContainer(*docker, kj::str(sidecarContainerName), false)
+                            .attach(docker->addRef())
+                            .catch_([](kj::Exception&&) {});
 
   // Also try to delete any cloned snapshot volumes.
   auto volumes = snapshotClones.releaseAsArray();
-  auto mainCleanup = removeContainer(network, kj::str(dockerPath), kj::str(containerName))
+  auto mainCleanup = removeContainer(*docker, kj::str(containerName))
                          .catch_([](kj::Exception&&) {})
-                         .then([&network = network, dockerPath = kj::str(dockerPath),
-                                   volumes = kj::mv(volumes)]() mutable {
-    return deleteVolumes(network, kj::mv(dockerPath), kj::mv(volumes));
+                         .then([docker = docker->addRef(), volumes = kj::mv(volumes)]() mutable {
+    return deleteVolumes(*docker, kj::mv(volumes)).attach(kj::mv(docker));
   }).catch_([](kj::Exception&&) {});
 
   // Pass the joined cleanup promise to the callback. The callback wraps it with the
@@ -1488,50 +1681,6 @@ class EgressHttpService final: public kj::HttpService {
   kj::HttpHeaderTable& headerTable;
 };
 
-kj::Promise<ContainerClient::IPAMConfigResult> ContainerClient::getDockerBridgeIPAMConfig() {
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::str("/networks/bridge"));
-  if (response.statusCode == 200) {
-    auto message = decodeJsonResponse<docker_api::Docker::NetworkInspectResponse>(response.body);
-    auto jsonRoot = message->getRoot<docker_api::Docker::NetworkInspectResponse>();
-    auto ipamConfig = jsonRoot.getIpam().getConfig();
-    if (ipamConfig.size() > 0) {
-      auto config = ipamConfig[0];
-      co_return IPAMConfigResult{
-        .gateway = kj::str(config.getGateway()),
-        .subnet = kj::str(config.getSubnet()),
-      };
-    }
-  }
-
-  JSG_FAIL_REQUIRE(Error,
-      "Failed to get bridge. "
-      "Status: ",
-      response.statusCode, ", Body: ", response.body);
-}
-
-kj::Promise<bool> ContainerClient::isDaemonIpv6Enabled() {
-  // Inspect the default bridge network. When the Docker daemon has "ipv6": true in
-  // daemon.json, the default bridge gets an IPv6 IPAM subnet entry (e.g. "fd00::/80").
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::str("/networks/bridge"));
-
-  if (response.statusCode != 200) {
-    co_return false;
-  }
-
-  auto message = decodeJsonResponse<docker_api::Docker::NetworkInspectResponse>(response.body);
-  auto jsonRoot = message->getRoot<docker_api::Docker::NetworkInspectResponse>();
-  for (auto config: jsonRoot.getIpam().getConfig()) {
-    // IPv6 subnets contain ':' (e.g. "fd00::/80", "2001:db8::/64")
-    if (kj::StringPtr(config.getSubnet()).findFirst(':') != kj::none) {
-      co_return true;
-    }
-  }
-
-  co_return false;
-}
-
 kj::Promise<uint16_t> ContainerClient::startEgressListener(
     kj::String listenAddress, uint16_t port) {
   auto service = kj::heap<EgressHttpService>(*this, headerTable);
@@ -1575,29 +1724,13 @@ kj::Promise<void> ContainerClient::writeFileToContainer(kj::StringPtr container,
     kj::StringPtr dir,
     kj::StringPtr filename,
     kj::ArrayPtr<const kj::byte> content) {
-  kj::HttpHeaderTable table;
-  auto address = co_await network.parseAddress(kj::str(dockerPath));
-  auto connection = co_await address->connect();
-  auto httpClient = kj::newHttpClient(table, *connection).attach(kj::mv(connection));
-
   auto tar = createTarWithFile(filename, content);
 
-  kj::HttpHeaders headers(table);
-  headers.setPtr(kj::HttpHeaderId::HOST, "localhost");
-  headers.setPtr(kj::HttpHeaderId::CONTENT_TYPE, "application/x-tar");
-  headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(tar.size()));
-
   auto endpoint = kj::str("/containers/", container, "/archive?path=", kj::encodeUriComponent(dir));
-  auto req = httpClient->request(kj::HttpMethod::PUT, endpoint, headers, tar.size());
-  {
-    auto body = kj::mv(req.body);
-    co_await body->write(tar.asBytes());
-  }
-
-  auto response = co_await req.response;
-  auto result = co_await response.body->readAllText();
+  auto response = co_await dockerApiBinaryRequest(
+      *docker, kj::HttpMethod::PUT, kj::mv(endpoint), kj::mv(tar), MAX_JSON_RESPONSE_SIZE);
   JSG_REQUIRE(response.statusCode == 200, Error, "Failed to write file ", dir, "/", filename,
-      " to container [", response.statusCode, "] ", result);
+      " to container [", response.statusCode, "] ", response.body.asChars());
 }
 
 static constexpr kj::StringPtr cloudflareCaDir = "/etc"_kj;
@@ -1608,7 +1741,7 @@ kj::Promise<void> ContainerClient::readCACert() {
   auto ingressPort = KJ_REQUIRE_NONNULL(
       sidecarIngressHostPort, "Cannot read CA cert: sidecar ingress port not known");
 
-  auto response = co_await dockerApiRequest(
+  auto response = co_await sidecarApiRequest(
       network, kj::str("127.0.0.1:", ingressPort), kj::HttpMethod::GET, kj::str("/ca"));
 
   JSG_REQUIRE(response.statusCode == 200, Error,
@@ -1639,8 +1772,7 @@ kj::Promise<void> ContainerClient::injectCACert() {
 kj::Promise<kj::Maybe<ContainerClient::InspectResponse>> ContainerClient::inspectContainer() {
   auto endpoint = kj::str("/containers/", containerName, "/json");
 
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::mv(endpoint));
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::GET, kj::mv(endpoint));
   // We check if the container with the given name exist, and if it's not,
   // we simply return false while avoiding an unnecessary error.
   if (response.statusCode == 404) {
@@ -1675,67 +1807,18 @@ kj::Promise<kj::Maybe<ContainerClient::InspectResponse>> ContainerClient::inspec
 }
 
 kj::Promise<kj::Maybe<ContainerClient::SidecarInspectResponse>> ContainerClient::inspectSidecar() {
-  auto endpoint = kj::str("/containers/", sidecarContainerName, "/json");
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::mv(endpoint));
-
-  if (response.statusCode == 404) {
-    co_return kj::none;
-  }
-
-  JSG_REQUIRE(response.statusCode == 200, Error, "Sidecar container inspect failed");
-
-  auto message = decodeJsonResponse<docker_api::Docker::ContainerInspectResponse>(response.body);
-  auto jsonRoot = message->getRoot<docker_api::Docker::ContainerInspectResponse>();
-
-  // Check if sidecar is actually running
-  bool running = false;
-  if (jsonRoot.hasState()) {
-    auto state = jsonRoot.getState();
-    if (state.hasStatus()) {
-      auto status = state.getStatus();
-      running = status == "running" || status == "restarting";
-    }
-  }
-
-  if (!running) {
-    co_return kj::none;
-  }
-
-  kj::Maybe<uint16_t> ingressHostPort;
-
-  auto ingressPortKey = kj::str(SIDECAR_INGRESS_PORT, "/tcp");
-  for (auto portMapping: jsonRoot.getNetworkSettings().getPorts().getObject()) {
-    if (portMapping.getName() != ingressPortKey) {
-      continue;
-    }
-
-    ingressHostPort = tryParsePublishedHostPort(portMapping.getValue());
-    break;
+  KJ_IF_SOME(ingressHostPort,
+      co_await inspectSidecarIngressPort(*docker, sidecarContainerName)) {
+    co_return SidecarInspectResponse{
+      .ingressHostPort = ingressHostPort,
+    };
   }
-
-  auto requiredIngressHostPort =
-      KJ_REQUIRE_NONNULL(ingressHostPort, "running sidecar missing ingress host port");
-
-  co_return SidecarInspectResponse{
-    .ingressHostPort = requiredIngressHostPort,
-  };
+  co_return kj::none;
 }
 
 kj::Promise<void> ContainerClient::updateSidecarEgressPort(
     uint16_t ingressHostPort, uint16_t egressPort) {
-  capnp::JsonCodec codec;
-  codec.handleByAnnotation<docker_api::ProxyEverything::Port>();
-  capnp::MallocMessageBuilder message;
-  auto jsonRoot = message.initRoot<docker_api::ProxyEverything::Port>();
-  jsonRoot.setPort(egressPort);
-
-  auto body = codec.encode(jsonRoot);
-  auto response = co_await dockerApiRequest(network, kj::str("127.0.0.1:", ingressHostPort),
-      kj::HttpMethod::PUT, kj::str("/egress"), kj::mv(body));
-
-  JSG_REQUIRE(response.statusCode >= 200 && response.statusCode < 300, Error,
-      "Updating sidecar egress port failed with: ", response.statusCode, " ", response.body);
+  return putSidecarEgressPort(network, ingressHostPort, egressPort);
 }
 
 kj::Promise<void> ContainerClient::updateSidecarEgressConfig(
@@ -1758,7 +1841,7 @@ kj::Promise<void> ContainerClient::updateSidecarEgressConfig(
   }
 
   auto body = codec.encode(jsonRoot);
-  auto response = co_await dockerApiRequest(network, kj::str("127.0.0.1:", ingressHostPort),
+  auto response = co_await sidecarApiRequest(network, kj::str("127.0.0.1:", ingressHostPort),
       kj::HttpMethod::PUT, kj::str("/egress"), kj::mv(body));
 
   JSG_REQUIRE(response.statusCode >= 200 && response.statusCode < 300, Error,
@@ -1784,7 +1867,7 @@ kj::Promise<void> ContainerClient::createContainer(kj::StringPtr effectiveImage,
   }
 
   auto envSize = environment.map([](auto& env) { return env.size(); }).orDefault(0);
-  auto jsonEnv = jsonRoot.initEnv(envSize + kj::size(defaultEnv));
+  auto jsonEnv = jsonRoot.initEnv(envSize + kj::size(DEFAULT_CONTAINER_ENV));
 
   KJ_IF_SOME(env, environment) {
     for (uint32_t i: kj::zeroTo(env.size())) {
@@ -1792,8 +1875,8 @@ kj::Promise<void> ContainerClient::createContainer(kj::StringPtr effectiveImage,
     }
   }
 
-  for (uint32_t i: kj::zeroTo(kj::size(defaultEnv))) {
-    jsonEnv.set(envSize + i, defaultEnv[i]);
+  for (uint32_t i: kj::zeroTo(kj::size(DEFAULT_CONTAINER_ENV))) {
+    jsonEnv.set(envSize + i, DEFAULT_CONTAINER_ENV[i]);
   }
 
   auto hostConfig = jsonRoot.initHostConfig();
@@ -1835,7 +1918,7 @@ kj::Promise<void> ContainerClient::createContainer(kj::StringPtr effectiveImage,
   }
   configureContainerPrivileges(hostConfig, privileges);
 
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
 
   // statusCode 409 refers to "conflict". Occurs when a container with the given name exists.
@@ -1845,9 +1928,9 @@ kj::Promise<void> ContainerClient::createContainer(kj::StringPtr effectiveImage,
   constexpr auto RETRY_DELAY = 100 * kj::MILLISECONDS;
 
   for (int attempt = 0; response.statusCode == 409 && attempt < MAX_RETRIES; ++attempt) {
-    co_await removeContainer(network, kj::str(dockerPath), kj::str(containerName));
+    co_await removeContainer(*docker, kj::str(containerName));
     co_await timer.afterDelay(RETRY_DELAY);
-    response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+    response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
         kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
   }
 
@@ -1911,7 +1994,7 @@ kj::Promise<kj::String> ContainerClient::createExec(capnp::List<capnp::Text>::Re
     request.setUser(params.getUser());
   }
 
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/containers/", containerName, "/exec"), codec.encode(request));
   JSG_REQUIRE(response.statusCode == 201, Error, "Creating Docker exec failed with [",
       response.statusCode, "] ", response.body);
@@ -1951,8 +2034,8 @@ kj::Promise<kj::Own<kj::AsyncIoStream>> ContainerClient::startExec(
   headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(encodedBody.size()));
   kj::ArrayPtr<const kj::byte> encodedBodyBytes = encodedBody.asBytes();
 
-  auto response = co_await dockerApiStreamedRequest(network, kj::str(dockerPath),
-      kj::HttpMethod::POST, kj::str("/exec/", execId, "/start"), headers, encodedBodyBytes);
+  auto response = co_await dockerApiStreamedRequest(*docker, kj::HttpMethod::POST,
+      kj::str("/exec/", execId, "/start"), headers, encodedBodyBytes);
   if (response.statusCode != 101) {
     auto errorBodyBytes = co_await response.connection->readAllBytes(MAX_JSON_RESPONSE_SIZE);
     auto errorBody = kj::str(errorBodyBytes.asChars());
@@ -1965,7 +2048,7 @@ kj::Promise<kj::Own<kj::AsyncIoStream>> ContainerClient::startExec(
 
 kj::Promise<void> ContainerClient::resizeExec(kj::StringPtr execId, uint16_t cols, uint16_t rows) {
   KJ_REQUIRE(cols > 0 && rows > 0, "PTY resize dimensions must be non-zero.");
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/exec/", execId, "/resize?h=", rows, "&w=", cols));
   JSG_REQUIRE(response.statusCode == 200 || response.statusCode == 201, Error,
       "Resizing Docker exec failed with [", response.statusCode, "] ", response.body);
@@ -1974,7 +2057,7 @@ kj::Promise<void> ContainerClient::resizeExec(kj::StringPtr execId, uint16_t col
 kj::Promise<ContainerClient::ExecInspectResponse> ContainerClient::inspectExec(
     kj::StringPtr execId) {
   auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::str("/exec/", execId, "/json"));
+      *docker, kj::HttpMethod::GET, kj::str("/exec/", execId, "/json"));
   JSG_REQUIRE(response.statusCode == 200, Error, "Inspecting Docker exec failed with [",
       response.statusCode, "] ", response.body);
 
@@ -2006,7 +2089,7 @@ kj::Promise<void> ContainerClient::runSimpleExec(kj::ArrayPtr<const kj::String>
   }
 
   auto createResponse =
-      co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+      co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
           kj::str("/containers/", containerName, "/exec"), codec.encode(createRequest));
   JSG_REQUIRE(createResponse.statusCode == 201, Error, "Creating helper Docker exec failed with [",
       createResponse.statusCode, "] ", createResponse.body);
@@ -2023,7 +2106,7 @@ kj::Promise<void> ContainerClient::runSimpleExec(kj::ArrayPtr<const kj::String>
   startRequest.setDetach(true);
   startRequest.setTty(false);
 
-  auto startResponse = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto startResponse = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/exec/", execId, "/start"), startCodec.encode(startRequest));
   JSG_REQUIRE(startResponse.statusCode == 200, Error, "Starting helper Docker exec failed with [",
       startResponse.statusCode, "] ", startResponse.body);
@@ -2043,17 +2126,57 @@ kj::Promise<void> ContainerClient::startContainer() {
   auto endpoint = kj::str("/containers/", containerName, "/start");
   // We have to send an empty body since docker API will throw an error if we don't.
   auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint), kj::str(""));
+      *docker, kj::HttpMethod::POST, kj::mv(endpoint), kj::str(""));
   // statusCode 304 refers to "container already started"
   JSG_REQUIRE(response.statusCode != 304, Error, "Container already started");
   // statusCode 204 refers to "no error"
   JSG_REQUIRE(response.statusCode == 204, Error, "Starting container failed with: ", response.body);
 }
 
+kj::Promise<bool> ContainerClient::tryAdoptWarmContainer(ContainerWarmPool& pool) {
+  auto maybeEntry = pool.tryTake();
+  if (maybeEntry == kj::none) co_return false;
+  auto& entry = KJ_ASSERT_NONNULL(maybeEntry);
+
+  kj::Maybe<kj::Exception> maybeError;
+  try {
+    // Anything still using our names (e.g. from before a workerd restart) would make the
+    // renames below conflict.
+    co_await removeContainer(*docker, kj::str(containerName));
+    co_await destroySidecarContainer();
+    co_await renameContainer(*docker, entry.sidecarId, sidecarContainerName);
+    co_await renameContainer(*docker, entry.containerId, containerName);
+
+    // The pooled sidecar was not pointed at any egress listener; point it at ours, and apply
+    // this start()'s internet and DNS settings.
+    co_await ensureEgressListenerStarted();
+    co_await updateSidecarEgressConfig(entry.ingressHostPort, egressListenerPort);
+  } catch (...) {
+    maybeError = kj::getCaughtExceptionAsKj();
+  }
+
+  KJ_IF_SOME(error, maybeError) {
+    KJ_LOG(WARNING, "failed to adopt warm container, falling back to a cold start", containerName,
+        error);
+    pool.reportFailure();
+    // Remove by ID, since we don't know which renames went through.
+    co_await kj::joinPromises(kj::arr(
+        removeContainer(*docker, kj::mv(entry.containerId))
+            .catch_([](kj::Exception&&) {}),
+        removeContainer(*docker, kj::mv(entry.sidecarId))
+            .catch_([](kj::Exception&&) {})));
+    co_return false;
+  }
+
+  containerSidecarStarted.store(true, std::memory_order_release);
+  sidecarIngressHostPort = entry.ingressHostPort;
+  co_await readCACert();
+  co_return true;
+}
+
 kj::Promise<void> ContainerClient::stopContainer() {
   auto endpoint = kj::str("/containers/", containerName, "/stop");
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST, kj::mv(endpoint));
   // statusCode 204 refers to "no error"
   // statusCode 304 refers to "container already stopped"
   // Both are fine to avoid when stop container is called.
@@ -2063,8 +2186,7 @@ kj::Promise<void> ContainerClient::stopContainer() {
 
 kj::Promise<void> ContainerClient::killContainer(uint32_t signal) {
   auto endpoint = kj::str("/containers/", containerName, "/kill?signal=", signalToString(signal));
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST, kj::mv(endpoint));
   // statusCode 409 refers to "container is not running"
   // We should not throw an error when the container is already not running.
   JSG_REQUIRE(response.statusCode == 204 || response.statusCode == 409, Error,
@@ -2075,61 +2197,20 @@ kj::Promise<void> ContainerClient::killContainer(uint32_t signal) {
 // No-op when the container does not exist.
 // Wait for the container to actually be stopped and removed when it exists.
 kj::Promise<void> ContainerClient::destroyContainer() {
-  co_await removeContainer(network, kj::str(dockerPath), kj::str(containerName));
-  co_await deleteVolumes(network, kj::str(dockerPath), snapshotClones.releaseAsArray());
+  co_await removeContainer(*docker, kj::str(containerName));
+  co_await deleteVolumes(*docker, snapshotClones.releaseAsArray());
 }
 
 // Creates the sidecar container that owns the shared network namespace.
 // The application container joins this namespace and all ingress/egress goes through it.
 kj::Promise<void> ContainerClient::createSidecarContainer(
     uint16_t egressPort, kj::String networkCidr) {
-  // Equivalent to: docker run --cap-add=NET_ADMIN -p <random-host>:39001 ...
-  capnp::JsonCodec codec;
-  codec.handleByAnnotation<docker_api::Docker::ContainerCreateRequest>();
-  capnp::MallocMessageBuilder message;
-  auto jsonRoot = message.initRoot<docker_api::Docker::ContainerCreateRequest>();
-  jsonRoot.setImage(containerEgressInterceptorImage);
+  auto ipv6Enabled = co_await isDaemonIpv6Enabled(*docker);
+  auto body = encodeSidecarCreateRequest(
+      containerEgressInterceptorImage, egressPort, networkCidr, ipv6Enabled);
 
-  auto ipv6Enabled = co_await isDaemonIpv6Enabled();
-
-  // determined by the number of flags we need to pass to proxy-everything
-  uint32_t cmdSize =
-      8;  // --http-egress-port <port> --http-ingress-address 0.0.0.0:<port> --docker-gateway-cidr <cidr> --dns-enabled --tls-intercept
-  if (!ipv6Enabled) cmdSize += 1;  // --disable-ipv6
-
-  auto cmd = jsonRoot.initCmd(cmdSize);
-  uint32_t idx = 0;
-  cmd.set(idx++, "--http-egress-port");
-  cmd.set(idx++, kj::str(egressPort));
-  cmd.set(idx++, "--http-ingress-address");
-  cmd.set(idx++, kj::str("0.0.0.0:", SIDECAR_INGRESS_PORT));
-  cmd.set(idx++, "--docker-gateway-cidr");
-  cmd.set(idx++, networkCidr);
-  cmd.set(idx++, "--dns-enabled");
-  cmd.set(idx++, "--tls-intercept");
-  if (!ipv6Enabled) {
-    cmd.set(idx++, "--disable-ipv6");
-  }
-
-  jsonRoot.initExposedPorts().setRaw(kj::str("{\"", SIDECAR_INGRESS_PORT, "/tcp\":{}}"));
-
-  auto hostConfig = jsonRoot.initHostConfig();
-  hostConfig.setPublishAllPorts(true);
-  hostConfig.setNetworkMode("bridge");
-  auto dns = hostConfig.initDns(kj::size(SIDECAR_DNS_SERVERS));
-  for (auto i: kj::indices(SIDECAR_DNS_SERVERS)) {
-    dns.set(i, SIDECAR_DNS_SERVERS[i]);
-  }
-
-  auto extraHosts = hostConfig.initExtraHosts(1);
-  extraHosts.set(0, "host.docker.internal:host-gateway"_kj);
-
-  // Sidecar needs NET_ADMIN capability for iptables/TPROXY
-  auto capAdd = hostConfig.initCapAdd(1);
-  capAdd.set(0, "NET_ADMIN");
-
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
-      kj::str("/containers/create?name=", sidecarContainerName), codec.encode(jsonRoot));
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
+      kj::str("/containers/create?name=", sidecarContainerName), kj::mv(body));
 
   if (response.statusCode == 409) {
     // Already created, nothing to do
@@ -2148,7 +2229,7 @@ kj::Promise<void> ContainerClient::createSidecarContainer(
 kj::Promise<void> ContainerClient::startSidecarContainer() {
   auto endpoint = kj::str("/containers/", sidecarContainerName, "/start");
   auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint), kj::str(""));
+      *docker, kj::HttpMethod::POST, kj::mv(endpoint), kj::str(""));
   // statusCode 304 refers to "container already started"
   // statusCode 204 refers to "request succeeded"
   JSG_REQUIRE(response.statusCode == 204 || response.statusCode == 304, Error,
@@ -2156,7 +2237,7 @@ kj::Promise<void> ContainerClient::startSidecarContainer() {
 }
 
 kj::Promise<void> ContainerClient::destroySidecarContainer() {
-  co_await removeContainer(network, kj::str(dockerPath), kj::str(sidecarContainerName));
+  co_await removeContainer(*docker, kj::str(sidecarContainerName));
 }
 
 kj::Promise<void> ContainerClient::createVolume(kj::StringPtr volumeName) {
@@ -2169,7 +2250,7 @@ kj::Promise<void> ContainerClient::createVolume(kj::StringPtr volumeName) {
   labels[0].setName(SNAPSHOT_VOLUME_CREATED_AT_LABEL);
   labels[0].initValue().setString(currentSnapshotVolumeTimestamp());
 
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/volumes/create"), codec.encode(req));
   // Docker returns 201 for new volumes and 200 for existing ones.
   JSG_REQUIRE(response.statusCode == 201 || response.statusCode == 200, Error,
@@ -2179,7 +2260,7 @@ kj::Promise<void> ContainerClient::createVolume(kj::StringPtr volumeName) {
 
 kj::Promise<void> ContainerClient::deleteVolume(kj::String volumeName) {
   auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::DELETE, kj::str("/volumes/", volumeName));
+      *docker, kj::HttpMethod::DELETE, kj::str("/volumes/", volumeName));
   // 204 = deleted, 404 = not found (both are fine)
   JSG_REQUIRE(response.statusCode == 204 || response.statusCode == 404, Error,
       "Failed to delete Docker volume '", volumeName, "': ", response.statusCode, " ",
@@ -2187,7 +2268,7 @@ kj::Promise<void> ContainerClient::deleteVolume(kj::String volumeName) {
 }
 
 kj::Promise<void> ContainerClient::commitContainer(kj::StringPtr imageRef) {
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/commit?container=", containerName,
           "&pause=true&repo=", kj::encodeUriComponent(imageRef)),
       kj::str(""));
@@ -2197,7 +2278,7 @@ kj::Promise<void> ContainerClient::commitContainer(kj::StringPtr imageRef) {
 
 kj::Promise<ContainerClient::ImageInspectResponse> ContainerClient::inspectImage(
     kj::StringPtr imageRef) {
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::GET,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::GET,
       kj::str("/images/", kj::encodeUriComponent(imageRef), "/json"));
   JSG_REQUIRE(response.statusCode == 200, Error, "Failed to inspect Docker image '", imageRef,
       "': ", response.statusCode, " ", response.body);
@@ -2208,7 +2289,7 @@ kj::Promise<ContainerClient::ImageInspectResponse> ContainerClient::inspectImage
 }
 
 kj::Promise<void> ContainerClient::deleteImage(kj::String imageRef) {
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::DELETE,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::DELETE,
       kj::str("/images/", kj::encodeUriComponent(imageRef), "?noprune=true"));
   JSG_REQUIRE(response.statusCode == 200 || response.statusCode == 404, Error,
       "Failed to delete Docker image '", imageRef, "': ", response.statusCode, " ", response.body);
@@ -2226,7 +2307,7 @@ kj::Promise<kj::String> ContainerClient::createTempContainerWithVolume(
   auto binds = hostConfig.initBinds(1);
   binds.set(0, kj::str(volumeName, ":", mountPath));
 
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/containers/create"), codec.encode(jsonRoot));
   JSG_REQUIRE(response.statusCode == 201, Error, "Failed to create temp container for volume '",
       volumeName, "': ", response.statusCode, " ", response.body);
@@ -2265,8 +2346,8 @@ kj::Promise<void> ContainerClient::cloneSnapshot(SnapshotRestoreMount& snapshot)
   binds.set(0, kj::str(snapshot.sourceVolume, ":/src:ro"));
   binds.set(1, kj::str(snapshot.cloneVolume, ":/dst"));
 
-  auto createResponse = co_await dockerApiRequest(network, kj::str(dockerPath),
-      kj::HttpMethod::POST, kj::str("/containers/create"), codec.encode(jsonRoot));
+  auto createResponse = co_await dockerApiRequest(
+      *docker, kj::HttpMethod::POST, kj::str("/containers/create"), codec.encode(jsonRoot));
   JSG_REQUIRE(createResponse.statusCode == 201, Error,
       "Failed to create snapshot clone helper container for volume '", snapshot.sourceVolume,
       "': ", createResponse.statusCode, " ", createResponse.body);
@@ -2282,13 +2363,13 @@ kj::Promise<void> ContainerClient::cloneSnapshot(SnapshotRestoreMount& snapshot)
     }).attach(addRef()));
   });
 
-  auto startResponse = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto startResponse = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/containers/", helperContainerId, "/start"), kj::str(""));
   JSG_REQUIRE(startResponse.statusCode == 204, Error,
       "Failed to start snapshot clone helper container '", helperContainerId,
       "': ", startResponse.statusCode, " ", startResponse.body);
 
-  auto waitResponse = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
+  auto waitResponse = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
       kj::str("/containers/", helperContainerId, "/wait?condition=not-running"));
   JSG_REQUIRE(waitResponse.statusCode == 200, Error,
       "Failed waiting for snapshot clone helper container '", helperContainerId,
@@ -2308,7 +2389,7 @@ kj::Promise<void> ContainerClient::cloneSnapshot(SnapshotRestoreMount& snapshot)
 }
 
 kj::Promise<void> ContainerClient::deleteTempContainer(kj::String tempContainerId) {
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::DELETE,
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::DELETE,
       kj::str("/containers/", tempContainerId, "?force=true"));
   // 204 = deleted, 404 = not found (both are fine).
   KJ_REQUIRE(response.statusCode == 204 || response.statusCode == 404,
@@ -2459,6 +2540,22 @@ kj::Promise<void> ContainerClient::start(StartContext context) {
     }
   }
 
+  // A pooled container runs the namespace's image with its default entrypoint and environment, so
+  // it can only stand in for a start() that asks for exactly that.
+  KJ_IF_SOME(pool, warmPool) {
+    bool eligible = !params.hasEntrypoint() && !params.hasEnvironmentVariables() &&
+        !params.hasDirectorySnapshots() && effectiveImage == imageName &&
+        !containerSidecarStarted.load(std::memory_order_acquire);
+    for (auto& mapping: egressState->mappings) {
+      // The CA cert must be in place before the container's entrypoint runs.
+      if (mapping.protocol == EgressProtocol::HTTPS) eligible = false;
+    }
+    if (eligible && co_await tryAdoptWarmContainer(pool)) {
+      containerStarted.store(true, std::memory_order_release);
+      co_return;
+    }
+  }
+
   // If startup fails after we clone any snapshot volumes, tear down the app container first and
   // then delete those clone volumes so we don't leave mounted Docker volumes behind.
   KJ_DEFER(if (!containerStarted.load(std::memory_order_acquire)) {
@@ -2480,7 +2577,7 @@ kj::Promise<void> ContainerClient::start(StartContext context) {
       auto sourceVolume = kj::str(SNAPSHOT_VOLUME_PREFIX, snapshotId);
 
       auto inspectResp = co_await dockerApiRequest(
-          network, kj::str(dockerPath), kj::HttpMethod::GET, kj::str("/volumes/", sourceVolume));
+          *docker, kj::HttpMethod::GET, kj::str("/volumes/", sourceVolume));
       JSG_REQUIRE(inspectResp.statusCode == 200, Error, "Snapshot '", snapshotId,
           "' not found (volume '", sourceVolume, "' does not exist)");
 
@@ -2539,8 +2636,7 @@ kj::Promise<void> ContainerClient::monitor(MonitorContext context) {
 
   try {
     auto endpoint = kj::str("/containers/", containerName, "/wait");
-    auto response = co_await dockerApiRequest(
-        network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+    auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST, kj::mv(endpoint));
 
     JSG_REQUIRE(response.statusCode == 200, Error,
         "Monitoring container failed with: ", response.statusCode, " ", response.body);
@@ -2703,8 +2799,7 @@ kj::Promise<void> ContainerClient::snapshotDirectory(SnapshotDirectoryContext co
   // Append "/." to the path to get directory contents without the directory wrapper.
   // For dir == "/", this is just "/."; for others, e.g. "/app/data" → "/app/data/.".
   auto archivePath = dir == "/" ? kj::str("/.") : kj::str(dir, "/.");
-  auto tarResponse = co_await dockerApiBinaryRequest(network, kj::str(dockerPath),
-      kj::HttpMethod::GET,
+  auto tarResponse = co_await dockerApiBinaryRequest(*docker, kj::HttpMethod::GET,
       kj::str("/containers/", containerName, "/archive?path=", kj::encodeUriComponent(archivePath)),
       kj::none, MAX_SNAPSHOT_TAR_SIZE);
 
@@ -2731,9 +2826,9 @@ kj::Promise<void> ContainerClient::snapshotDirectory(SnapshotDirectoryContext co
   auto tempId = co_await createTempContainerWithVolume(volumeName, "/mnt");
   KJ_DEFER(waitUntilTasks.add(deleteTempContainer(kj::str(tempId)).attach(addRef())));
 
-  auto putResponse = co_await dockerApiBinaryRequest(network, kj::str(dockerPath),
-      kj::HttpMethod::PUT, kj::str("/containers/", tempId, "/archive?path=/mnt"),
-      kj::mv(tarResponse.body), MAX_JSON_RESPONSE_SIZE);
+  auto putResponse = co_await dockerApiBinaryRequest(*docker, kj::HttpMethod::PUT,
+      kj::str("/containers/", tempId, "/archive?path=/mnt"), kj::mv(tarResponse.body),
+      MAX_JSON_RESPONSE_SIZE);
   JSG_REQUIRE(putResponse.statusCode == 200, Error,
       "snapshotDirectory(): failed to store snapshot in volume '", volumeName,
       "': ", putResponse.statusCode);
@@ -2914,32 +3009,16 @@ kj::Promise<void> ContainerClient::ensureSidecarStarted() {
 
   KJ_ON_SCOPE_FAILURE(containerSidecarStarted.store(false, std::memory_order_release));
 
-  auto ipamConfig = co_await getDockerBridgeIPAMConfig();
+  auto ipamConfig = co_await getDockerBridgeIPAMConfig(*docker);
   co_await createSidecarContainer(egressListenerPort, kj::mv(ipamConfig.subnet));
   co_await startSidecarContainer();
 
   auto sidecar = KJ_REQUIRE_NONNULL(co_await inspectSidecar(), "started sidecar not running");
   this->sidecarIngressHostPort = sidecar.ingressHostPort;
 
-  // Wait for the sidecar's HTTP server to be ready by calling updateSidecarEgressConfig
-  // in a retry loop with a per-attempt timeout.
-  constexpr int MAX_READY_RETRIES = 10;
-  constexpr auto READY_RETRY_DELAY = 200 * kj::MILLISECONDS;
-  constexpr auto READY_ATTEMPT_TIMEOUT = 2 * kj::SECONDS;
-  for (int attempt = 0;; ++attempt) {
-    kj::Maybe<kj::Exception> maybeError;
-    try {
-      co_await timer.timeoutAfter(READY_ATTEMPT_TIMEOUT,
-          updateSidecarEgressConfig(sidecar.ingressHostPort, egressListenerPort));
-    } catch (...) {
-      maybeError = kj::getCaughtExceptionAsKj();
-    }
-
-    if (maybeError == kj::none) break;
-    if (attempt >= MAX_READY_RETRIES - 1)
-      kj::throwFatalException(kj::mv(KJ_REQUIRE_NONNULL(maybeError)));
-    co_await timer.afterDelay(READY_RETRY_DELAY);
-  }
+  co_await waitForSidecarReady(timer, [this, ingressHostPort = sidecar.ingressHostPort]() {
+    return updateSidecarEgressConfig(ingressHostPort, egressListenerPort);
+  });
 
   co_await readCACert();
 }
@@ -2954,7 +3033,7 @@ kj::Promise<void> ContainerClient::ensureEgressListenerStarted(uint16_t port) {
   // Determine the listen address: on Linux, use the Docker bridge gateway IP
   // and fall back to loopback (Docker Desktop
   // routes host-gateway to host loopback through the VM).
-  auto ipamConfig = co_await getDockerBridgeIPAMConfig();
+  auto ipamConfig = co_await getDockerBridgeIPAMConfig(*docker);
   egressListenerPort = co_await startEgressListener(
       gatewayForPlatform(kj::mv(ipamConfig.gateway)).orDefault(kj::str("127.0.0.1")), port);
 }
@@ -3071,4 +3150,351 @@ kj::Own<ContainerClient> ContainerClient::addRef() {
   return kj::addRef(*this);
 }
 
+// =======================================================================================
+// DockerApiClient
+
+DockerApiClient::DockerApiClient(kj::Timer& timer, kj::Network& network, kj::String dockerPath)
+    : timer(timer),
+      network(network),
+      dockerPath(kj::mv(dockerPath)),
+      tasks(*this) {}
+
+kj::Promise<DockerApiClient::Response> DockerApiClient::request(kj::HttpMethod method,
+    kj::StringPtr endpoint,
+    kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+    kj::StringPtr contentType,
+    uint64_t maxResponseSize) {
+  if (method != kj::HttpMethod::GET) {
+    return sendMutation(method, endpoint, body, contentType, maxResponseSize);
+  }
+  if (body != kj::none || !endpoint.endsWith("/json")) {
+    return send(method, endpoint, body, contentType, maxResponseSize);
+  }
+
+  KJ_IF_SOME(pending, pendingInspects.find(endpoint)) {
+    if (pending.mutationCount != mutationCount) {
+      // The pending inspect may not reflect a mutation made since it was sent.
+      return send(method, endpoint, body, contentType, maxResponseSize);
+    }
+    auto paf = kj::newPromiseAndFulfiller<Response>();
+    pending.waiters.add(kj::mv(paf.fulfiller));
+    return kj::mv(paf.promise);
+  }
+
+  auto paf = kj::newPromiseAndFulfiller<Response>();
+  auto& pending =
+      pendingInspects.insert(kj::str(endpoint), PendingInspect{.mutationCount = mutationCount})
+          .value;
+  pending.waiters.add(kj::mv(paf.fulfiller));
+  tasks.add(sendSharedInspect(kj::str(endpoint), maxResponseSize));
+  return kj::mv(paf.promise);
+}
+
+kj::Promise<kj::Own<kj::AsyncIoStream>> DockerApiClient::connect() {
+  co_await ensureAddress();
+  co_return co_await KJ_ASSERT_NONNULL(address)->connect();
+}
+
+kj::Promise<void> DockerApiClient::ensureAddress() {
+  if (httpClient != kj::none) {
+    return kj::READY_NOW;
+  }
+  KJ_IF_SOME(ready, addressReady) {
+    return ready.addBranch();
+  }
+
+  auto promise = network.parseAddress(dockerPath).then([this](kj::Own<kj::NetworkAddress> addr) {
+    // newHttpClient() over an address (rather than a connection) keeps idle connections open for
+    // reuse, and opens additional ones when all of them are busy.
+    httpClient = kj::newHttpClient(timer, headerTable, *addr);
+    address = kj::mv(addr);
+  });
+  return addressReady.emplace(promise.fork()).addBranch();
+}
+
+kj::Promise<DockerApiClient::Response> DockerApiClient::send(kj::HttpMethod method,
+    kj::StringPtr endpoint,
+    kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+    kj::StringPtr contentType,
+    uint64_t maxResponseSize) {
+  co_await ensureAddress();
+  auto& client = *KJ_ASSERT_NONNULL(httpClient);
+
+  kj::HttpHeaders headers(headerTable);
+  headers.setPtr(kj::HttpHeaderId::HOST, "localhost");
+
+  KJ_IF_SOME(requestBody, body) {
+    headers.setPtr(kj::HttpHeaderId::CONTENT_TYPE, contentType);
+    headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(requestBody.size()));
+
+    auto req = client.request(method, endpoint, headers, requestBody.size());
+    {
+      auto stream = kj::mv(req.body);
+      co_await stream->write(requestBody);
+    }
+    auto response = co_await req.response;
+    auto result = co_await response.body->readAllBytes(maxResponseSize);
+    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
+  } else {
+    auto req = client.request(method, endpoint, headers);
+    { auto stream = kj::mv(req.body); }
+    auto response = co_await req.response;
+    auto result = co_await response.body->readAllBytes(maxResponseSize);
+    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
+  }
+}
+
+kj::Promise<DockerApiClient::Response> DockerApiClient::sendMutation(kj::HttpMethod method,
+    kj::StringPtr endpoint,
+    kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+    kj::StringPtr contentType,
+    uint64_t maxResponseSize) {
+  ++mutationCount;
+  KJ_DEFER(++mutationCount);
+  co_return co_await send(method, endpoint, body, contentType, maxResponseSize);
+}
+
+kj::Promise<void> DockerApiClient::sendSharedInspect(
+    kj::String endpoint, uint64_t maxResponseSize) {
+  kj::Maybe<Response> maybeResponse;
+  kj::Maybe<kj::Exception> maybeError;
+  try {
+    maybeResponse =
+        co_await send(kj::HttpMethod::GET, endpoint, kj::none, nullptr, maxResponseSize);
+  } catch (...) {
+    maybeError = kj::getCaughtExceptionAsKj();
+  }
+
+  auto waiters = kj::mv(KJ_ASSERT_NONNULL(pendingInspects.find(endpoint)).waiters);
+  pendingInspects.erase(endpoint);
+
+  for (auto& waiter: waiters) {
+    KJ_IF_SOME(error, maybeError) {
+      waiter->reject(kj::cp(error));
+    } else {
+      auto& response = KJ_ASSERT_NONNULL(maybeResponse);
+      waiter->fulfill(Response{
+        .statusCode = response.statusCode,
+        .body = kj::heapArray(response.body.asPtr()),
+      });
+    }
+  }
+}
+
+void DockerApiClient::taskFailed(kj::Exception&& exception) {
+  KJ_LOG(ERROR, "Docker API client task failed", exception);
+}
+
+// =======================================================================================
+// ContainerWarmPool
+
+namespace {
+
+kj::StringPtr getWarmPoolNonce() {
+  static const kj::String nonce = kj::str(randomUUID(kj::none).slice(0, 8));
+  return nonce;
+}
+
+}  // namespace
+
+ContainerWarmPool::ContainerWarmPool(kj::Timer& timer,
+    kj::Own<DockerApiClient> docker,
+    kj::StringPtr namePrefix,
+    kj::String imageName,
+    kj::String containerEgressInterceptorImage,
+    ContainerPrivileges privileges,
+    bool pidNamespace,
+    uint32_t size,
+    kj::TaskSet& waitUntilTasks)
+    : timer(timer),
+      docker(kj::mv(docker)),
+      imageName(kj::mv(imageName)),
+      containerEgressInterceptorImage(kj::mv(containerEgressInterceptorImage)),
+      privileges(kj::mv(privileges)),
+      pidNamespace(pidNamespace),
+      waitUntilTasks(waitUntilTasks),
+      tasks(*this) {
+  auto builder = kj::heapArrayBuilder<Slot>(size);
+  for (auto i: kj::zeroTo(size)) {
+    auto name = kj::str(namePrefix, "-pool-", getWarmPoolNonce(), '-', i);
+    builder.add(Slot{
+      .containerName = kj::encodeUriComponent(name),
+      .sidecarName = kj::encodeUriComponent(kj::str(name, "-proxy")),
+    });
+  }
+  slots = builder.finish();
+
+  tasks.add(logMetricsPeriodically());
+}
+
+ContainerWarmPool::~ContainerWarmPool() noexcept(false) {
+  KJ_LOG(INFO, "container warm pool shutting down", imageName, metrics.hits, metrics.misses,
+      metrics.failures);
+
+  // Best-effort removal of every pooled container, including those still being created. Adopted
+  // containers have been renamed and belong to their ContainerClient.
+  for (auto& slot: slots) {
+    waitUntilTasks.add(removeSlotContainers(slot));
+  }
+}
+
+void ContainerWarmPool::fill() {
+  for (auto& slot: slots) {
+    if (slot.ready == kj::none && !slot.filling) {
+      slot.filling = true;
+      tasks.add(fillSlot(slot));
+    }
+  }
+}
+
+kj::Maybe<ContainerWarmPool::Entry> ContainerWarmPool::tryTake() {
+  for (auto& slot: slots) {
+    KJ_IF_SOME(entry, slot.ready) {
+      auto result = kj::mv(entry);
+      slot.ready = kj::none;
+      ++metrics.hits;
+      fill();
+      return kj::mv(result);
+    }
+  }
+
+  // Slots whose last fill failed are only retried here, so that a persistent Docker error
+  // doesn't turn into a busy loop.
+  ++metrics.misses;
+  fill();
+  return kj::none;
+}
+
+size_t ContainerWarmPool::readyCount() const {
+  size_t count = 0;
+  for (auto& slot: slots) {
+    if (slot.ready != kj::none) ++count;
+  }
+  return count;
+}
+
+kj::Promise<void> ContainerWarmPool::fillSlot(Slot& slot) {
+  KJ_DEFER(slot.filling = false);
+
+  kj::Maybe<kj::Exception> maybeError;
+  try {
+    slot.ready = co_await createEntry(slot);
+  } catch (...) {
+    maybeError = kj::getCaughtExceptionAsKj();
+  }
+
+  KJ_IF_SOME(error, maybeError) {
+    ++metrics.failures;
+    KJ_LOG(WARNING, "failed to create warm container", slot.containerName, error);
+    waitUntilTasks.add(removeSlotContainers(slot));
+  }
+}
+
+kj::Promise<ContainerWarmPool::Entry> ContainerWarmPool::createEntry(Slot& slot) {
+  co_await removeSlotContainers(slot);
+
+  auto ipamConfig = co_await getDockerBridgeIPAMConfig(*docker);
+  auto ipv6Enabled = co_await isDaemonIpv6Enabled(*docker);
+
+  // The pool has no egress listener of its own, so the sidecar starts out pointing nowhere. The
+  // adopting ContainerClient points it at its listener before handing the container to the DO.
+  auto sidecarId = co_await createNamedContainer(slot.sidecarName,
+      encodeSidecarCreateRequest(
+          containerEgressInterceptorImage, 0, ipamConfig.subnet, ipv6Enabled));
+  co_await startContainer(sidecarId);
+
+  auto ingressHostPort = KJ_REQUIRE_NONNULL(
+      co_await inspectSidecarIngressPort(*docker, sidecarId),
+      "started sidecar not running");
+  co_await waitForSidecarReady(timer, [this, ingressHostPort]() {
+    return putSidecarEgressPort(docker->getNetwork(), ingressHostPort, 0);
+  });
+
+  auto containerId = co_await createNamedContainer(
+      slot.containerName, encodeContainerCreateRequest(sidecarId));
+  co_await startContainer(containerId);
+
+  co_return Entry{
+    .containerId = kj::mv(containerId),
+    .sidecarId = kj::mv(sidecarId),
+    .ingressHostPort = ingressHostPort,
+  };
+}
+
+kj::Promise<kj::String> ContainerWarmPool::createNamedContainer(
+    kj::StringPtr name, kj::String body) {
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
+      kj::str("/containers/create?name=", name), kj::mv(body));
+  // statusCode 201 refers to "container created successfully"
+  KJ_REQUIRE(response.statusCode == 201, "Create container failed", name, response.statusCode,
+      response.body);
+
+  auto message = decodeJsonResponse<docker_api::Docker::ContainerCreateResponse>(response.body);
+  co_return kj::str(message->getRoot<docker_api::Docker::ContainerCreateResponse>().getId());
+}
+
+kj::Promise<void> ContainerWarmPool::startContainer(kj::StringPtr id) {
+  // We have to send an empty body since docker API will throw an error if we don't.
+  auto response = co_await dockerApiRequest(*docker, kj::HttpMethod::POST,
+      kj::str("/containers/", id, "/start"), kj::str(""));
+  // statusCode 204 refers to "no error"
+  KJ_REQUIRE(response.statusCode == 204, "Starting container failed", id, response.statusCode,
+      response.body);
+}
+
+kj::String ContainerWarmPool::encodeContainerCreateRequest(kj::StringPtr sidecarId) {
+  // Mirrors ContainerClient::createContainer() for a start() without overrides.
+  capnp::JsonCodec codec;
+  codec.handleByAnnotation<docker_api::Docker::ContainerCreateRequest>();
+  capnp::MallocMessageBuilder message;
+  auto jsonRoot = message.initRoot<docker_api::Docker::ContainerCreateRequest>();
+  jsonRoot.setImage(imageName);
+
+  auto jsonEnv = jsonRoot.initEnv(kj::size(DEFAULT_CONTAINER_ENV));
+  for (uint32_t i: kj::zeroTo(kj::size(DEFAULT_CONTAINER_ENV))) {
+    jsonEnv.set(i, DEFAULT_CONTAINER_ENV[i]);
+  }
+
+  auto hostConfig = jsonRoot.initHostConfig();
+  hostConfig.initRestartPolicy().setName("on-failure");
+
+  // Join the sidecar by ID rather than by name, since the sidecar is renamed on adoption.
+  hostConfig.setNetworkMode(kj::str("container:", sidecarId));
+
+  if (!pidNamespace) {
+    hostConfig.setPidMode("host");
+  }
+
+  configureContainerPrivileges(hostConfig, privileges);
+
+  return codec.encode(jsonRoot);
+}
+
+kj::Promise<void> ContainerWarmPool::removeSlotContainers(const Slot& slot) {
+  // Copy the names and take a reference to the client, since this may outlive the pool.
+  auto docker = this->docker->addRef();
+  auto containerName = kj::str(slot.containerName);
+  auto sidecarName = kj::str(slot.sidecarName);
+
+  co_await removeContainer(*docker, kj::mv(containerName)).catch_([](kj::Exception&&) {});
+  co_await removeContainer(*docker, kj::mv(sidecarName)).catch_([](kj::Exception&&) {});
+}
+
+kj::Promise<void> ContainerWarmPool::logMetricsPeriodically() {
+  constexpr auto METRICS_LOG_INTERVAL = 60 * kj::SECONDS;
+
+  Metrics logged;
+  for (;;) {
+    co_await timer.afterDelay(METRICS_LOG_INTERVAL);
+    if (metrics == logged) continue;
+    logged = metrics;
+    KJ_LOG(INFO, "container warm pool metrics", imageName, readyCount(), metrics.hits,
+        metrics.misses, metrics.failures);
+  }
+}
+
+void ContainerWarmPool::taskFailed(kj::Exception&& exception) {
+  KJ_LOG(ERROR, "container warm pool task failed", exception);
+}
+
 }  // namespace workerd::server
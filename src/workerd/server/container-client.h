@@ -21,6 +21,7 @@
 #include <kj/map.h>
 #include <kj/refcount.h>
 #include <kj/string.h>
+#include <kj/vector.h>
 
 #include <atomic>
 
@@ -71,6 +72,178 @@ void configureContainerPrivileges(
     docker_api::Docker::ContainerCreateRequest::HostConfig::Builder hostConfig,
     const ContainerPrivileges& privileges);
 
+// HTTP client for the Docker Engine API, shared by every ContainerClient (and the warm pool) of
+// a Durable Object namespace.
+//
+// Requests are sent over a pool of keep-alive connections to the Docker socket rather than over
+// a fresh connection per request, so the per-request connect and HTTP client setup cost is paid
+// only when every pooled connection is busy. Concurrent requests each get their own connection.
+//
+// Concurrent inspect requests (GET .../json) for the same endpoint are coalesced into a single
+// request to Docker, whose response is handed to every caller. A caller never joins an inspect
+// that was sent before, or concurrently with, a mutating request sent through this client, so it
+// can't observe state older than its own preceding writes.
+class DockerApiClient final: public kj::Refcounted, private kj::TaskSet::ErrorHandler {
+ public:
+  DockerApiClient(kj::Timer& timer, kj::Network& network, kj::String dockerPath);
+
+  struct Response {
+    kj::uint statusCode;
+    kj::Array<kj::byte> body;
+  };
+
+  kj::Promise<Response> request(kj::HttpMethod method,
+      kj::StringPtr endpoint,
+      kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+      kj::StringPtr contentType,
+      uint64_t maxResponseSize);
+
+  // Opens a dedicated connection to the Docker socket, for requests that take over the
+  // connection (e.g. attaching to an exec).
+  kj::Promise<kj::Own<kj::AsyncIoStream>> connect();
+
+  kj::Network& getNetwork() {
+    return network;
+  }
+
+  kj::Own<DockerApiClient> addRef() {
+    return kj::addRef(*this);
+  }
+
+ private:
+  struct PendingInspect {
+    // Value of `mutationCount` when the request was sent.
+    uint64_t mutationCount;
+    kj::Vector<kj::Own<kj::PromiseFulfiller<Response>>> waiters;
+  };
+
+  kj::Timer& timer;
+  kj::Network& network;
+  kj::String dockerPath;
+  kj::HttpHeaderTable headerTable;
+
+  kj::Maybe<kj::Own<kj::NetworkAddress>> address;
+  kj::Maybe<kj::Own<kj::HttpClient>> httpClient;
+  kj::Maybe<kj::ForkedPromise<void>> addressReady;
+
+  // Incremented when a mutating request is sent and again when it completes.
+  uint64_t mutationCount = 0;
+  kj::HashMap<kj::String, PendingInspect> pendingInspects;
+
+  // Shared inspect requests run here rather than in any one caller, so that a caller going away
+  // doesn't cancel the request for everyone else. Declared last so that they are cancelled first.
+  kj::TaskSet tasks;
+
+  kj::Promise<void> ensureAddress();
+  kj::Promise<Response> send(kj::HttpMethod method,
+      kj::StringPtr endpoint,
+      kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+      kj::StringPtr contentType,
+      uint64_t maxResponseSize);
+  kj::Promise<Response> sendMutation(kj::HttpMethod method,
+      kj::StringPtr endpoint,
+      kj::Maybe<kj::ArrayPtr<const kj::byte>> body,
+      kj::StringPtr contentType,
+      uint64_t maxResponseSize);
+  kj::Promise<void> sendSharedInspect(kj::String endpoint, uint64_t maxResponseSize);
+
+  void taskFailed(kj::Exception&& exception) override;
+};
+
+// Keeps a fixed number of containers created and running, but not yet assigned to any Durable
+// Object, for a single Durable Object namespace. ContainerClient::start() adopts one of these
+// instead of paying image create + start latency when the start parameters don't require a
+// customized container.
+//
+// Each pooled container is paired with its own networking sidecar, exactly as ContainerClient
+// would create them, but under pool-private names derived from `namePrefix` and a random nonce
+// chosen once per process, so that workerd processes sharing a Docker daemon with the same config
+// don't take each other's containers. Adopting an entry renames both containers to the Durable
+// Object's names; the vacated slot is then refilled in the background.
+//
+// Hits, misses and failures are logged at INFO level every minute in which they changed, and
+// once more when the pool shuts down.
+class ContainerWarmPool final: private kj::TaskSet::ErrorHandler {
+ public:
+  ContainerWarmPool(kj::Timer& timer,
+      kj::Own<DockerApiClient> docker,
+      kj::StringPtr namePrefix,
+      kj::String imageName,
+      kj::String containerEgressInterceptorImage,
+      ContainerPrivileges privileges,
+      bool pidNamespace,
+      uint32_t size,
+      kj::TaskSet& waitUntilTasks);
+
+  ~ContainerWarmPool() noexcept(false);
+
+  struct Entry {
+    kj::String containerId;
+    kj::String sidecarId;
+    uint16_t ingressHostPort;
+  };
+
+  struct Metrics {
+    // start() calls that adopted a pooled container.
+    uint64_t hits = 0;
+    // start() calls that could have used a pooled container but none was ready.
+    uint64_t misses = 0;
+    // Pooled containers that could not be created, or could not be adopted.
+    uint64_t failures = 0;
+
+    bool operator==(const Metrics&) const = default;
+  };
+
+  // Begin creating containers for every slot that is neither ready nor already being filled.
+  void fill();
+
+  // Takes a ready container out of the pool, if there is one, and schedules its slot to be
+  // refilled. Counts towards hits or misses.
+  kj::Maybe<Entry> tryTake();
+
+  // Called by ContainerClient when an entry returned by tryTake() could not be adopted.
+  void reportFailure() {
+    ++metrics.failures;
+  }
+
+  const Metrics& getMetrics() const {
+    return metrics;
+  }
+
+  size_t readyCount() const;
+
+ private:
+  struct Slot {
+    kj::String containerName;
+    kj::String sidecarName;
+    kj::Maybe<Entry> ready;
+    bool filling = false;
+  };
+
+  kj::Timer& timer;
+  kj::Own<DockerApiClient> docker;
+  kj::String imageName;
+  kj::String containerEgressInterceptorImage;
+  ContainerPrivileges privileges;
+  bool pidNamespace;
+  kj::TaskSet& waitUntilTasks;
+  Metrics metrics;
+
+  // Declared before `tasks` so that in-flight fills are cancelled before their slots go away.
+  kj::Array<Slot> slots;
+  kj::TaskSet tasks;
+
+  kj::Promise<void> fillSlot(Slot& slot);
+  kj::Promise<Entry> createEntry(Slot& slot);
+  kj::Promise<kj::String> createNamedContainer(kj::StringPtr name, kj::String body);
+  kj::Promise<void> startContainer(kj::StringPtr id);
+  kj::String encodeContainerCreateRequest(kj::StringPtr sidecarId);
+  kj::Promise<void> removeSlotContainers(const Slot& slot);
+  kj::Promise<void> logMetricsPeriodically();
+
+  void taskFailed(kj::Exception&& exception) override;
+};
+
 // Docker-based implementation that implements the rpc::Container::Server interface
 // so it can be used as a rpc::Container::Client via kj::heap<ContainerClient>().
 // This allows the Container JSG class to use Docker directly without knowing
@@ -84,7 +257,7 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
   ContainerClient(capnp::ByteStreamFactory& byteStreamFactory,
       kj::Timer& timer,
       kj::Network& network,
-      kj::String dockerPath,
+      kj::Own<DockerApiClient> docker,
       kj::String containerName,
       kj::String imageName,
       kj::String containerEgressInterceptorImage,
@@ -92,7 +265,8 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
       kj::Promise<void> pendingCleanup,
       kj::Function<void(kj::Promise<void>)> cleanupCallback,
       ChannelTokenHandler& channelTokenHandler,
-      ContainerPrivileges privileges);
+      ContainerPrivileges privileges,
+      kj::Maybe<ContainerWarmPool&> warmPool = kj::none);
 
   ~ContainerClient() noexcept(false);
 
@@ -121,7 +295,7 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
   kj::HttpHeaderTable headerTable;
   kj::Timer& timer;
   kj::Network& network;
-  kj::String dockerPath;
+  kj::Own<DockerApiClient> docker;
   kj::String containerName;
   kj::String sidecarContainerName;
   kj::String imageName;
@@ -131,6 +305,9 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
 
   ContainerPrivileges privileges;
 
+  // Pool of pre-started containers for this namespace, if configured.
+  kj::Maybe<ContainerWarmPool&> warmPool;
+
   kj::TaskSet& waitUntilTasks;
 
   // Forked promise representing pending cleanup from a previous ContainerClient for the same
@@ -139,12 +316,6 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
   // via containerCleanupCanceler, in which case the .catch_() resolves it immediately).
   kj::ForkedPromise<void> pendingCleanup;
 
-  static constexpr kj::StringPtr defaultEnv[] = {"CLOUDFLARE_COUNTRY_A2=XX"_kj,
-    "CLOUDFLARE_DEPLOYMENT_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
-    "CLOUDFLARE_LOCATION=loc01"_kj, "CLOUDFLARE_REGION=REGN"_kj,
-    "CLOUDFLARE_APPLICATION_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
-    "CLOUDFLARE_DURABLE_OBJECT_ID=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"_kj};
-
   // Docker-specific Port implementation
   class DockerPort;
   class DockerProcessHandle;
@@ -157,11 +328,6 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
     kj::String image;
   };
 
-  struct IPAMConfigResult {
-    kj::String gateway;
-    kj::String subnet;
-  };
-
   struct SidecarInspectResponse {
     uint16_t ingressHostPort;
   };
@@ -205,6 +371,9 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
   kj::Promise<void> resizeExec(kj::StringPtr execId, uint16_t cols, uint16_t rows);
   kj::Promise<void> runSimpleExec(kj::ArrayPtr<const kj::String> cmd);
   kj::Promise<void> startContainer();
+  // Adopts a container from the warm pool under this client's container names. Returns false,
+  // having cleaned up, if the pool had nothing ready or adoption failed.
+  kj::Promise<bool> tryAdoptWarmContainer(ContainerWarmPool& pool);
   kj::Promise<void> stopContainer();
   kj::Promise<void> killContainer(uint32_t signal);
   kj::Promise<void> destroyContainer();
@@ -303,11 +472,6 @@ class ContainerClient final: public rpc::Container::Server, public kj::Refcounte
   // when they finish through a KJ defer.
   RpcTurn getRpcTurn();
 
-  // Get the Docker bridge network gateway IP and subnet.
-  kj::Promise<IPAMConfigResult> getDockerBridgeIPAMConfig();
-  // Check if the Docker daemon has IPv6 enabled by inspecting the default bridge network's
-  // IPAM config for IPv6 subnets.
-  kj::Promise<bool> isDaemonIpv6Enabled();
   // Start the egress listener on the given address. If port is 0, an OS-chosen port is used.
   kj::Promise<uint16_t> startEgressListener(kj::String listenAddress, uint16_t port = 0);
   void stopEgressListener();
@@ -0,0 +1,478 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "http2-server.h"
+
+#include <kj/encoding.h>
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+kj::String decodeToString(HpackDecoder& decoder, kj::StringPtr hex) {
+  auto block = kj::decodeHex(hex);
+  KJ_ASSERT(!block.hadErrors);
+  kj::Vector<kj::String> fields;
+  decoder.decode(block, [&](kj::StringPtr name, kj::StringPtr value) {
+    fields.add(kj::str(name, ": ", value));
+  });
+  return kj::strArray(fields, "\n");
+}
+
+KJ_TEST("HPACK decodes the RFC 7541 request examples") {
+  // Appendix C.3, without Huffman coding.
+  {
+    HpackDecoder decoder;
+    KJ_EXPECT(decodeToString(decoder, "828684410f7777772e6578616d706c652e636f6d") ==
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com");
+    KJ_EXPECT(decodeToString(decoder, "828684be58086e6f2d6361636865") ==
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+        "cache-control: no-cache");
+    KJ_EXPECT(decodeToString(decoder,
+                  "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565") ==
+        ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+        "custom-key: custom-value");
+  }
+
+  // Appendix C.4, the same requests with Huffman coding.
+  {
+    HpackDecoder decoder;
+    KJ_EXPECT(decodeToString(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff") ==
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com");
+    KJ_EXPECT(decodeToString(decoder, "828684be5886a8eb10649cbf") ==
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+        "cache-control: no-cache");
+    KJ_EXPECT(decodeToString(decoder, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf") ==
+        ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+        "custom-key: custom-value");
+  }
+}
+
+KJ_TEST("HPACK rejects malformed blocks") {
+  HpackDecoder decoder;
+  auto expectFailure = [&](kj::StringPtr hex) {
+    auto block = kj::decodeHex(hex);
+    KJ_EXPECT_THROW(FAILED, decoder.decode(block, [](kj::StringPtr, kj::StringPtr) {}));
+  };
+  // Index beyond the static table, with an empty dynamic table.
+  expectFailure("be");
+  // Index 0.
+  expectFailure("80");
+  // String length runs past the end of the block.
+  expectFailure("400a6375");
+  // Huffman string padded with a zero bit rather than EOS.
+  expectFailure("408125");
+  // Table size update larger than allowed.
+  expectFailure("3fe21f");
+}
+
+KJ_TEST("HPACK encoder output round-trips and reuses the dynamic table") {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+
+  auto roundTrip = [&]() {
+    kj::Vector<kj::byte> block;
+    encoder.startBlock(block);
+    encoder.encode(block, ":status", "200");
+    encoder.encode(block, "content-type", "text/plain;charset=UTF-8");
+    encoder.encode(block, "set-cookie", "session=secret");
+    encoder.encode(block, "x-custom", "\x01\xff binary");
+
+    kj::Vector<kj::String> fields;
+    decoder.decode(block, [&](kj::StringPtr name, kj::StringPtr value) {
+      fields.add(kj::str(name, ": ", value));
+    });
+    KJ_EXPECT(kj::strArray(fields, "\n") ==
+        ":status: 200\ncontent-type: text/plain;charset=UTF-8\nset-cookie: session=secret\n"
+        "x-custom: \x01\xff binary");
+    return block.size();
+  };
+
+  auto first = roundTrip();
+  auto second = roundTrip();
+  // The second time, everything but the cookie is a one-byte index.
+  KJ_EXPECT(second < first / 2, first, second);
+
+  // Shrinking the peer's table evicts everything, and the next block announces the new size.
+  encoder.setPeerMaxTableSize(0);
+  encoder.setPeerMaxTableSize(256);
+  roundTrip();
+}
+
+// ---------------------------------------------------------------------------------------
+// End-to-end
+
+constexpr kj::byte DATA = 0x0;
+constexpr kj::byte HEADERS = 0x1;
+constexpr kj::byte RST_STREAM = 0x3;
+constexpr kj::byte SETTINGS = 0x4;
+constexpr kj::byte PING = 0x6;
+constexpr kj::byte GOAWAY = 0x7;
+constexpr kj::byte WINDOW_UPDATE = 0x8;
+
+constexpr kj::byte END_STREAM = 0x1;
+constexpr kj::byte ACK = 0x1;
+constexpr kj::byte END_HEADERS = 0x4;
+
+struct Frame {
+  kj::byte type;
+  kj::byte flags;
+  uint32_t streamId;
+  kj::Array<kj::byte> payload;
+};
+
+kj::String text(const Frame& frame) {
+  return kj::str(frame.payload.asChars());
+}
+
+kj::Array<kj::byte> makeFrame(
+    kj::byte type, kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  auto frame = kj::heapArray<kj::byte>(9 + payload.size());
+  frame[0] = payload.size() >> 16;
+  frame[1] = payload.size() >> 8;
+  frame[2] = payload.size();
+  frame[3] = type;
+  frame[4] = flags;
+  frame[5] = streamId >> 24;
+  frame[6] = streamId >> 16;
+  frame[7] = streamId >> 8;
+  frame[8] = streamId;
+  frame.slice(9).copyFrom(payload);
+  return frame;
+}
+
+class EchoPathService final: public kj::HttpService {
+ public:
+  explicit EchoPathService(const kj::HttpHeaderTable& headerTable): headerTable(headerTable) {}
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override {
+    auto requestText = co_await requestBody.readAllText();
+    auto body = kj::str(method, " ", url, " ",
+        KJ_ASSERT_NONNULL(headers.get(kj::HttpHeaderId::HOST)), " ", requestText);
+    kj::HttpHeaders responseHeaders(headerTable);
+    responseHeaders.set(kj::HttpHeaderId::CONTENT_TYPE, "text/plain");
+    auto stream = response.send(200, "OK", responseHeaders, body.size());
+    co_await stream->write(body.asBytes());
+  }
+
+ private:
+  const kj::HttpHeaderTable& headerTable;
+};
+
+struct Http2Fixture {
+  explicit Http2Fixture(Http2Server::Settings settings = {})
+      : server(timer, headerTable, service, settings) {}
+
+  kj::EventLoop loop;
+  kj::WaitScope waitScope{loop};
+  kj::TimerImpl timer{kj::origin<kj::TimePoint>()};
+  kj::HttpHeaderTable headerTable;
+  EchoPathService service{headerTable};
+  Http2Server server;
+  kj::TwoWayPipe pipe = kj::newTwoWayPipe();
+  kj::Own<kj::AsyncIoStream>& client = pipe.ends[1];
+  kj::Promise<void> serverDone = server.listenHttp2(kj::mv(pipe.ends[0]));
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+
+  void send(kj::ArrayPtr<const kj::byte> bytes) {
+    client->write(bytes).wait(waitScope);
+  }
+
+  void send(kj::byte type, kj::byte flags, uint32_t streamId,
+      kj::ArrayPtr<const kj::byte> payload = nullptr) {
+    send(makeFrame(type, flags, streamId, payload));
+  }
+
+  void sendRequest(uint32_t streamId, kj::StringPtr method, kj::StringPtr path, bool endStream) {
+    kj::Vector<kj::byte> block;
+    encoder.startBlock(block);
+    encoder.encode(block, ":method", method);
+    encoder.encode(block, ":scheme", "http");
+    encoder.encode(block, ":authority", "example.com");
+    encoder.encode(block, ":path", path);
+    send(HEADERS, END_HEADERS | (endStream ? END_STREAM : 0), streamId, block);
+  }
+
+  // Returns the next frame, or none if the server hasn't sent one.
+  kj::Maybe<Frame> tryReceive() {
+    kj::byte header[9];
+    auto promise = client->tryRead(header, 1, 1);
+    if (!promise.poll(waitScope)) return kj::none;
+    KJ_ASSERT(promise.wait(waitScope) == 1, "server closed the connection");
+    client->read(header + 1, 8).wait(waitScope);
+    size_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+    auto payload = kj::heapArray<kj::byte>(length);
+    client->read(payload.begin(), length).wait(waitScope);
+    uint32_t streamId = (header[5] << 24) | (header[6] << 16) | (header[7] << 8) | header[8];
+    return Frame{header[3], header[4], streamId & 0x7fffffff, kj::mv(payload)};
+  }
+
+  Frame receive() {
+    return KJ_ASSERT_NONNULL(tryReceive(), "expected a frame from the server");
+  }
+
+  // Exchanges SETTINGS with the server, sending `settings` as our own.
+  void handshake(kj::ArrayPtr<const kj::byte> settings = nullptr) {
+    send(SETTINGS, 0, 0, settings);
+    auto serverSettings = receive();
+    KJ_EXPECT(serverSettings.type == SETTINGS);
+    KJ_EXPECT(serverSettings.flags == 0);
+    send(SETTINGS, ACK, 0);
+    auto windowUpdate = receive();
+    KJ_EXPECT(windowUpdate.type == WINDOW_UPDATE);
+    KJ_EXPECT(windowUpdate.streamId == 0);
+    auto ack = receive();
+    KJ_EXPECT(ack.type == SETTINGS);
+    KJ_EXPECT(ack.flags == ACK);
+  }
+
+  // Returns the error code of the GOAWAY the server closes the connection with, skipping any
+  // frames sent before it.
+  uint32_t receiveGoAway() {
+    for (;;) {
+      auto frame = receive();
+      if (frame.type == GOAWAY) {
+        auto code = frame.payload.slice(4, 8);
+        return (code[0] << 24) | (code[1] << 16) | (code[2] << 8) | code[3];
+      }
+    }
+  }
+
+  void advanceTime(kj::Duration duration) {
+    timer.advanceTo(timer.now() + duration);
+    waitScope.poll();
+  }
+
+  kj::String decodeHeaders(const Frame& frame) {
+    KJ_EXPECT(frame.type == HEADERS);
+    KJ_EXPECT(frame.flags & END_HEADERS);
+    kj::Vector<kj::String> fields;
+    decoder.decode(frame.payload, [&](kj::StringPtr name, kj::StringPtr value) {
+      fields.add(kj::str(name, ": ", value));
+    });
+    return kj::strArray(fields, "\n");
+  }
+};
+
+KJ_TEST("Http2Server serves a request") {
+  Http2Fixture f;
+  f.handshake();
+  f.sendRequest(1, "GET", "/foo?bar", true);
+
+  auto headers = f.receive();
+  KJ_EXPECT(headers.streamId == 1);
+  KJ_EXPECT(f.decodeHeaders(headers) ==
+      ":status: 200\ncontent-type: text/plain\ncontent-length: 25");
+
+  auto data = f.receive();
+  KJ_EXPECT(data.type == DATA);
+  KJ_EXPECT(data.streamId == 1);
+  KJ_EXPECT(text(data) == "GET /foo?bar example.com ");
+
+  auto end = f.receive();
+  KJ_EXPECT(end.type == DATA);
+  KJ_EXPECT(end.flags == END_STREAM);
+  KJ_EXPECT(end.payload.size() == 0);
+  KJ_EXPECT(f.tryReceive() == kj::none);
+
+  // A second request on the connection reuses its HPACK state.
+  f.sendRequest(3, "GET", "/foo?bar", true);
+  KJ_EXPECT(f.receive().payload.size() < headers.payload.size());
+}
+
+KJ_TEST("Http2Server delivers request bodies") {
+  Http2Fixture f;
+  f.handshake();
+  f.sendRequest(1, "POST", "/", false);
+  f.send(DATA, 0, 1, "hello "_kjb);
+  KJ_EXPECT(f.tryReceive() == kj::none);
+  f.send(DATA, END_STREAM, 1, "world"_kjb);
+
+  auto headers = f.receive();
+  KJ_EXPECT(f.decodeHeaders(headers) ==
+      ":status: 200\ncontent-type: text/plain\ncontent-length: 30");
+  KJ_EXPECT(text(f.receive()) == "POST / example.com hello world");
+}
+
+KJ_TEST("Http2Server honors the client's flow control window") {
+  Http2Fixture f;
+  // SETTINGS_INITIAL_WINDOW_SIZE = 10
+  kj::byte settings[] = {0x00, 0x04, 0x00, 0x00, 0x00, 0x0a};
+  f.handshake(settings);
+  f.sendRequest(1, "GET", "/long/path", true);
+  f.receive();
+
+  auto first = f.receive();
+  KJ_EXPECT(text(first) == "GET /long/");
+  KJ_EXPECT(f.tryReceive() == kj::none);
+
+  kj::byte increment[] = {0x00, 0x00, 0x01, 0x00};
+  f.send(WINDOW_UPDATE, 0, 1, increment);
+  auto rest = f.receive();
+  KJ_EXPECT(text(rest) == "path example.com ");
+  KJ_EXPECT(f.receive().flags == END_STREAM);
+}
+
+KJ_TEST("Http2Server rejects malformed requests without closing the connection") {
+  Http2Fixture f;
+  f.handshake();
+
+  kj::Vector<kj::byte> block;
+  f.encoder.startBlock(block);
+  f.encoder.encode(block, ":method", "GET");
+  f.encoder.encode(block, ":scheme", "http");
+  f.encoder.encode(block, ":path", "/");
+  f.encoder.encode(block, "connection", "keep-alive");
+  f.send(HEADERS, END_HEADERS | END_STREAM, 1, block);
+  KJ_EXPECT(f.decodeHeaders(f.receive()) == ":status: 400\ncontent-length: 0");
+
+  f.sendRequest(3, "GET", "/", true);
+  KJ_EXPECT(f.decodeHeaders(f.receive()).startsWith(":status: 200"));
+}
+
+KJ_TEST("Http2Server sends GOAWAY on protocol errors") {
+  Http2Fixture f;
+  f.handshake();
+  // DATA on stream 0.
+  f.send(DATA, 0, 0, "x"_kjb);
+  auto goAway = f.receive();
+  KJ_EXPECT(goAway.type == GOAWAY);
+  KJ_EXPECT(goAway.payload[7] == 0x1);  // PROTOCOL_ERROR
+  f.serverDone.wait(f.waitScope);
+}
+
+KJ_TEST("Http2Server drains connections") {
+  Http2Fixture f;
+  f.handshake();
+  f.sendRequest(1, "POST", "/", false);
+  KJ_EXPECT(f.tryReceive() == kj::none);
+
+  auto drained = f.server.drain();
+  auto goAway = f.receive();
+  KJ_EXPECT(goAway.type == GOAWAY);
+  KJ_EXPECT(goAway.payload[3] == 1);  // last stream ID
+  KJ_EXPECT(!drained.poll(f.waitScope));
+
+  // The stream in progress still completes.
+  f.send(DATA, END_STREAM, 1, nullptr);
+  KJ_EXPECT(f.decodeHeaders(f.receive()).startsWith(":status: 200"));
+  f.receive();
+  f.receive();
+  f.serverDone.wait(f.waitScope);
+  drained.wait(f.waitScope);
+}
+
+KJ_TEST("Http2Server closes connections whose client floods it with PINGs without reading") {
+  Http2Fixture f({.maxQueuedControlBytes = 1024});
+  f.handshake();
+
+  // Far more PINGs than the acknowledgements we allow to pile up. The server stops reading them
+  // once it gives up, so this write never completes.
+  kj::Vector<kj::byte> pings;
+  for (auto i KJ_UNUSED: kj::zeroTo(1000)) {
+    pings.addAll(makeFrame(PING, 0, 0, kj::heapArray<kj::byte>(8)));
+  }
+  auto flood = f.client->write(pings.asPtr());
+  KJ_EXPECT(!f.serverDone.poll(f.waitScope));
+
+  // Once the client does read, it finds out why.
+  KJ_EXPECT(f.receiveGoAway() == 0xb);  // ENHANCE_YOUR_CALM
+  f.serverDone.wait(f.waitScope);
+}
+
+KJ_TEST("Http2Server closes connections whose client keeps resetting streams") {
+  kj::byte cancel[] = {0x00, 0x00, 0x00, 0x08};
+  {
+    Http2Fixture f({.maxStreamResets = 3});
+    f.handshake();
+    for (uint32_t id = 1; id <= 7; id += 2) {
+      f.sendRequest(id, "POST", "/", false);
+      f.send(RST_STREAM, 0, id, cancel);
+    }
+    KJ_EXPECT(f.receiveGoAway() == 0xb);  // ENHANCE_YOUR_CALM
+    f.serverDone.wait(f.waitScope);
+  }
+
+  {
+    // Resets spread out over time are fine.
+    Http2Fixture f({.maxStreamResets = 3});
+    f.handshake();
+    for (uint32_t id = 1; id <= 7; id += 2) {
+      f.sendRequest(id, "POST", "/", false);
+      f.send(RST_STREAM, 0, id, cancel);
+      f.advanceTime(4 * kj::SECONDS);
+    }
+    KJ_EXPECT(f.tryReceive() == kj::none);
+  }
+}
+
+KJ_TEST("Http2Server closes idle connections") {
+  Http2Fixture f;
+  f.handshake();
+  f.sendRequest(1, "POST", "/", false);
+
+  // Not while a stream is open.
+  f.advanceTime(2 * kj::MINUTES);
+  KJ_EXPECT(f.tryReceive() == kj::none);
+
+  f.send(DATA, END_STREAM, 1, nullptr);
+  KJ_EXPECT(f.decodeHeaders(f.receive()).startsWith(":status: 200"));
+  f.receive();
+  f.receive();
+
+  f.advanceTime(2 * kj::MINUTES);
+  KJ_EXPECT(f.receiveGoAway() == 0x0);
+  f.serverDone.wait(f.waitScope);
+}
+
+KJ_TEST("Http2Server closes connections whose client never acknowledges SETTINGS") {
+  Http2Fixture f;
+  f.send(SETTINGS, 0, 0);
+  f.advanceTime(15 * kj::SECONDS);
+  KJ_EXPECT(f.receiveGoAway() == 0x4);  // SETTINGS_TIMEOUT
+  f.serverDone.wait(f.waitScope);
+}
+
+KJ_TEST("sniffHttp2Preface") {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  {
+    auto pipe = kj::newTwoWayPipe();
+    pipe.ends[1]->write(Http2Server::PREFACE.asBytes()).wait(waitScope);
+    pipe.ends[1]->write("rest"_kjb).wait(waitScope);
+    KJ_EXPECT(sniffHttp2Preface(pipe.ends[0]).wait(waitScope));
+    char buffer[4];
+    pipe.ends[0]->read(buffer, 4).wait(waitScope);
+    KJ_EXPECT(kj::str(kj::arrayPtr(buffer)) == "rest");
+  }
+
+  {
+    // An HTTP/1.1 request shorter than the preface must not block waiting for more.
+    auto pipe = kj::newTwoWayPipe();
+    auto request = "GET / HTTP/1.1\r\n\r\n"_kj;
+    pipe.ends[1]->write(request.asBytes()).wait(waitScope);
+    KJ_EXPECT(!sniffHttp2Preface(pipe.ends[0]).wait(waitScope));
+    pipe.ends[1]->shutdownWrite();
+    KJ_EXPECT(pipe.ends[0]->readAllText().wait(waitScope) == request);
+  }
+
+  {
+    // Diverging only after a matching prefix.
+    auto pipe = kj::newTwoWayPipe();
+    auto request = "PRI * HTTP/1.1\r\n"_kj;
+    pipe.ends[1]->write(request.asBytes()).wait(waitScope);
+    KJ_EXPECT(!sniffHttp2Preface(pipe.ends[0]).wait(waitScope));
+    pipe.ends[1]->shutdownWrite();
+    KJ_EXPECT(pipe.ends[0]->readAllText().wait(waitScope) == request);
+  }
+}
+
+}  // namespace
+}  // namespace workerd::server
@@ -0,0 +1,1924 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "http2-server.h"
+
+#include <workerd/util/stream-utils.h>
+#include <workerd/util/strings.h>
+
+#include <kj/debug.h>
+#include <kj/map.h>
+
+#include <cstring>
+
+namespace workerd::server {
+
+namespace {
+
+// =======================================================================================
+// HPACK primitives
+
+constexpr size_t HPACK_ENTRY_OVERHEAD = 32;
+
+struct StaticTableEntry {
+  kj::StringPtr name;
+  kj::StringPtr value;
+};
+
+// RFC 7541 Appendix A.
+constexpr StaticTableEntry HPACK_STATIC_TABLE[] = {
+  {":authority"_kj, ""_kj},
+  {":method"_kj, "GET"_kj},
+  {":method"_kj, "POST"_kj},
+  {":path"_kj, "/"_kj},
+  {":path"_kj, "/index.html"_kj},
+  {":scheme"_kj, "http"_kj},
+  {":scheme"_kj, "https"_kj},
+  {":status"_kj, "200"_kj},
+  {":status"_kj, "204"_kj},
+  {":status"_kj, "206"_kj},
+  {":status"_kj, "304"_kj},
+  {":status"_kj, "400"_kj},
+  {":status"_kj, "404"_kj},
+  {":status"_kj, "500"_kj},
+  {"accept-charset"_kj, ""_kj},
+  {"accept-encoding"_kj, "gzip, deflate"_kj},
+  {"accept-language"_kj, ""_kj},
+  {"accept-ranges"_kj, ""_kj},
+  {"accept"_kj, ""_kj},
+  {"access-control-allow-origin"_kj, ""_kj},
+  {"age"_kj, ""_kj},
+  {"allow"_kj, ""_kj},
+  {"authorization"_kj, ""_kj},
+  {"cache-control"_kj, ""_kj},
+  {"content-disposition"_kj, ""_kj},
+  {"content-encoding"_kj, ""_kj},
+  {"content-language"_kj, ""_kj},
+  {"content-length"_kj, ""_kj},
+  {"content-location"_kj, ""_kj},
+  {"content-range"_kj, ""_kj},
+  {"content-type"_kj, ""_kj},
+  {"cookie"_kj, ""_kj},
+  {"date"_kj, ""_kj},
+  {"etag"_kj, ""_kj},
+  {"expect"_kj, ""_kj},
+  {"expires"_kj, ""_kj},
+  {"from"_kj, ""_kj},
+  {"host"_kj, ""_kj},
+  {"if-match"_kj, ""_kj},
+  {"if-modified-since"_kj, ""_kj},
+  {"if-none-match"_kj, ""_kj},
+  {"if-range"_kj, ""_kj},
+  {"if-unmodified-since"_kj, ""_kj},
+  {"last-modified"_kj, ""_kj},
+  {"link"_kj, ""_kj},
+  {"location"_kj, ""_kj},
+  {"max-forwards"_kj, ""_kj},
+  {"proxy-authenticate"_kj, ""_kj},
+  {"proxy-authorization"_kj, ""_kj},
+  {"range"_kj, ""_kj},
+  {"referer"_kj, ""_kj},
+  {"refresh"_kj, ""_kj},
+  {"retry-after"_kj, ""_kj},
+  {"server"_kj, ""_kj},
+  {"set-cookie"_kj, ""_kj},
+  {"strict-transport-security"_kj, ""_kj},
+  {"transfer-encoding"_kj, ""_kj},
+  {"user-agent"_kj, ""_kj},
+  {"vary"_kj, ""_kj},
+  {"via"_kj, ""_kj},
+  {"www-authenticate"_kj, ""_kj},
+};
+
+constexpr size_t HPACK_STATIC_TABLE_SIZE = kj::size(HPACK_STATIC_TABLE);
+
+struct HuffmanCode {
+  uint32_t code;
+  uint8_t length;
+};
+
+// RFC 7541 Appendix B, indexed by symbol. Symbol 256 is EOS.
+constexpr HuffmanCode HUFFMAN_CODES[257] = {
+  {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28}, {0xfffffe4, 28}, {0xfffffe5, 28},
+  {0xfffffe6, 28}, {0xfffffe7, 28}, {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30},
+  {0xfffffe9, 28}, {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+  {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28}, {0xffffff1, 28},
+  {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28}, {0xffffff4, 28}, {0xffffff5, 28},
+  {0xffffff6, 28}, {0xffffff7, 28}, {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28},
+  {0xffffffb, 28}, {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12}, {0x1ff9, 13}, {0x15, 6},
+  {0xf8, 8}, {0x7fa, 11}, {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11}, {0xfa, 8}, {0x16, 6},
+  {0x17, 6}, {0x18, 6}, {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6}, {0x1a, 6}, {0x1b, 6}, {0x1c, 6},
+  {0x1d, 6}, {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8}, {0x7ffc, 15}, {0x20, 6}, {0xffb, 12},
+  {0x3fc, 10}, {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7}, {0x5f, 7}, {0x60, 7}, {0x61, 7},
+  {0x62, 7}, {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7}, {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+  {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7}, {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7}, {0xfc, 8},
+  {0x73, 7}, {0xfd, 8}, {0x1ffb, 13}, {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+  {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5}, {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6}, {0x27, 6},
+  {0x6, 5}, {0x74, 7}, {0x75, 7}, {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5}, {0x2b, 6}, {0x76, 7},
+  {0x2c, 6}, {0x8, 5}, {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7}, {0x79, 7}, {0x7a, 7}, {0x7b, 7},
+  {0x7ffe, 15}, {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28}, {0xfffe6, 20},
+  {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20}, {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22},
+  {0x7fffd9, 23}, {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23}, {0x7fffdd, 23},
+  {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23}, {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22},
+  {0x7fffe0, 23}, {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23}, {0x7fffe4, 23},
+  {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23}, {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23},
+  {0xffffef, 24}, {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22}, {0x3fffdc, 22},
+  {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21}, {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22},
+  {0xfffff0, 24}, {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23}, {0x1fffe0, 21},
+  {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21}, {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23},
+  {0x7fffef, 23}, {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22}, {0x7ffff0, 23},
+  {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23}, {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20},
+  {0x7fff1, 19}, {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25}, {0x3ffffe2, 26},
+  {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27}, {0x7ffffdf, 27}, {0x3ffffe5, 26},
+  {0xfffff1, 24}, {0x1ffffed, 25}, {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+  {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24}, {0x1fffe4, 21}, {0x1fffe5, 21},
+  {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27},
+  {0x7ffffe5, 27}, {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21}, {0x3fffe9, 22},
+  {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23}, {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25},
+  {0x1ffffef, 25}, {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23}, {0x3ffffeb, 26},
+  {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26}, {0x7ffffe7, 27}, {0x7ffffe8, 27},
+  {0x7ffffe9, 27}, {0x7ffffea, 27}, {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27},
+  {0x7ffffed, 27}, {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+  {0x3fffffff, 30},
+};
+
+// The Huffman code as a binary tree, walked one bit at a time to decode. The code is complete, so
+// every internal node has both children.
+class HuffmanDecoder {
+ public:
+  HuffmanDecoder() {
+    uint16_t count = 1;
+    for (uint16_t symbol = 0; symbol < kj::size(HUFFMAN_CODES); symbol++) {
+      auto code = HUFFMAN_CODES[symbol];
+      uint16_t node = 0;
+      for (auto bit = code.length - 1; bit > 0; bit--) {
+        auto& child = nodes[node].children[(code.code >> bit) & 1];
+        if (child == 0) child = count++;
+        node = child;
+      }
+      nodes[node].children[code.code & 1] = LEAF | symbol;
+    }
+    KJ_ASSERT(count == kj::size(nodes));
+  }
+
+  kj::String decode(kj::ArrayPtr<const kj::byte> input) const {
+    // The shortest code is five bits.
+    kj::Vector<char> out(input.size() * 8 / 5 + 1);
+    uint16_t node = 0;
+    uint depth = 0;
+    bool allOnes = true;
+    for (auto byte: input) {
+      for (auto bit = 7; bit >= 0; bit--) {
+        uint one = (byte >> bit) & 1;
+        allOnes = allOnes && one;
+        auto child = nodes[node].children[one];
+        if (child & LEAF) {
+          auto symbol = child & ~LEAF;
+          KJ_REQUIRE(symbol != 256, "HPACK string contains EOS");
+          out.add(static_cast<char>(symbol));
+          node = 0;
+          depth = 0;
+          allOnes = true;
+        } else {
+          node = child;
+          depth++;
+        }
+      }
+    }
+    // What's left over must be padding: a prefix of EOS, which is all ones, shorter than a byte.
+    KJ_REQUIRE(depth < 8 && allOnes, "invalid HPACK Huffman padding");
+    out.add('\0');
+    return kj::String(out.releaseAsArray());
+  }
+
+ private:
+  static constexpr uint16_t LEAF = 0x8000;
+
+  struct Node {
+    uint16_t children[2] = {0, 0};
+  };
+  Node nodes[256];
+};
+
+const HuffmanDecoder& getHuffmanDecoder() {
+  static const HuffmanDecoder decoder;
+  return decoder;
+}
+
+size_t huffmanEncodedSize(kj::StringPtr text) {
+  size_t bits = 0;
+  for (auto c: text.asBytes()) {
+    bits += HUFFMAN_CODES[c].length;
+  }
+  return (bits + 7) / 8;
+}
+
+void huffmanEncode(kj::Vector<kj::byte>& out, kj::StringPtr text) {
+  // Codes are at most 30 bits and fewer than 8 are left over between symbols, so the low 37 bits
+  // of `bits` are all that matter.
+  uint64_t bits = 0;
+  uint count = 0;
+  for (auto c: text.asBytes()) {
+    auto code = HUFFMAN_CODES[c];
+    bits = (bits << code.length) | code.code;
+    count += code.length;
+    while (count >= 8) {
+      count -= 8;
+      out.add(static_cast<kj::byte>(bits >> count));
+    }
+  }
+  if (count > 0) {
+    // Pad with the most significant bits of EOS, which are all ones.
+    out.add(static_cast<kj::byte>((bits << (8 - count)) | (0xff >> count)));
+  }
+}
+
+// RFC 7541 section 5.1.
+size_t decodeInteger(kj::ArrayPtr<const kj::byte>& input, uint prefixBits) {
+  KJ_REQUIRE(input.size() > 0, "truncated HPACK integer");
+  size_t mask = (1u << prefixBits) - 1;
+  size_t value = input[0] & mask;
+  input = input.slice(1);
+  if (value < mask) return value;
+  for (uint shift = 0;; shift += 7) {
+    KJ_REQUIRE(input.size() > 0, "truncated HPACK integer");
+    KJ_REQUIRE(shift <= 28, "HPACK integer too large");
+    auto byte = input[0];
+    input = input.slice(1);
+    value += static_cast<size_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+}
+
+void encodeInteger(kj::Vector<kj::byte>& out, uint prefixBits, kj::byte flags, size_t value) {
+  size_t mask = (1u << prefixBits) - 1;
+  if (value < mask) {
+    out.add(flags | value);
+    return;
+  }
+  out.add(flags | mask);
+  value -= mask;
+  while (value >= 0x80) {
+    out.add(0x80 | (value & 0x7f));
+    value >>= 7;
+  }
+  out.add(value);
+}
+
+// RFC 7541 section 5.2.
+kj::String decodeString(kj::ArrayPtr<const kj::byte>& input) {
+  KJ_REQUIRE(input.size() > 0, "truncated HPACK string");
+  bool huffman = input[0] & 0x80;
+  auto length = decodeInteger(input, 7);
+  KJ_REQUIRE(length <= input.size(), "truncated HPACK string");
+  auto bytes = input.first(length);
+  input = input.slice(length);
+  if (huffman) {
+    return getHuffmanDecoder().decode(bytes);
+  }
+  return kj::str(bytes.asChars());
+}
+
+void encodeString(kj::Vector<kj::byte>& out, kj::StringPtr text) {
+  auto huffmanSize = huffmanEncodedSize(text);
+  if (huffmanSize < text.size()) {
+    encodeInteger(out, 7, 0x80, huffmanSize);
+    huffmanEncode(out, text);
+  } else {
+    encodeInteger(out, 7, 0, text.size());
+    out.addAll(text.asBytes());
+  }
+}
+
+enum class Indexing {
+  // Added to the dynamic table, so it can be sent by index next time.
+  INCREMENTAL,
+  // Not added, because the value is unlikely to repeat.
+  NONE,
+  // Not added, and intermediaries must not add it either, because the value is a secret that
+  // mustn't be exposed to compression oracles.
+  NEVER,
+};
+
+Indexing indexingFor(kj::StringPtr name) {
+  if (name == "authorization" || name == "proxy-authorization" || name == "cookie" ||
+      name == "set-cookie") {
+    return Indexing::NEVER;
+  }
+  if (name == "content-length" || name == "content-range" || name == "etag" ||
+      name == "last-modified") {
+    return Indexing::NONE;
+  }
+  return Indexing::INCREMENTAL;
+}
+
+}  // namespace
+
+// =======================================================================================
+// HPACK
+
+kj::Maybe<HpackTable::Field> HpackTable::get(size_t index) const {
+  if (index == 0) return kj::none;
+  if (index <= HPACK_STATIC_TABLE_SIZE) {
+    auto& entry = HPACK_STATIC_TABLE[index - 1];
+    return Field{entry.name, entry.value};
+  }
+  size_t dynamicIndex = index - HPACK_STATIC_TABLE_SIZE - 1;
+  if (dynamicIndex >= dynamicCount()) return kj::none;
+  auto& entry = entries[entries.size() - 1 - dynamicIndex];
+  return Field{entry.name, entry.value};
+}
+
+kj::Maybe<HpackTable::Match> HpackTable::find(kj::StringPtr name, kj::StringPtr value) const {
+  kj::Maybe<Match> result;
+  for (auto i: kj::zeroTo(HPACK_STATIC_TABLE_SIZE)) {
+    auto& entry = HPACK_STATIC_TABLE[i];
+    if (entry.name == name) {
+      if (entry.value == value) return Match{i + 1, true};
+      if (result == kj::none) result = Match{i + 1, false};
+    }
+  }
+  for (auto i: kj::zeroTo(dynamicCount())) {
+    auto& entry = entries[entries.size() - 1 - i];
+    if (entry.name == name) {
+      auto index = HPACK_STATIC_TABLE_SIZE + 1 + i;
+      if (entry.value == value) return Match{index, true};
+      if (result == kj::none) result = Match{index, false};
+    }
+  }
+  return result;
+}
+
+void HpackTable::add(kj::StringPtr name, kj::StringPtr value) {
+  // Copy first: `name` may point into an entry that is about to be evicted.
+  Entry entry{kj::str(name), kj::str(value)};
+  auto entrySize = name.size() + value.size() + HPACK_ENTRY_OVERHEAD;
+  if (entrySize > maxSize) {
+    evictTo(0);
+    return;
+  }
+  evictTo(maxSize - entrySize);
+  entries.add(kj::mv(entry));
+  size += entrySize;
+}
+
+void HpackTable::setMaxSize(size_t newMaxSize) {
+  maxSize = newMaxSize;
+  evictTo(maxSize);
+}
+
+void HpackTable::evictTo(size_t targetSize) {
+  while (size > targetSize) {
+    auto& entry = entries[oldest++];
+    size -= entry.name.size() + entry.value.size() + HPACK_ENTRY_OVERHEAD;
+    entry = {};
+  }
+  if (oldest > 0 && oldest * 2 >= entries.size()) {
+    kj::Vector<Entry> kept(dynamicCount());
+    for (auto i: kj::range(oldest, entries.size())) {
+      kept.add(kj::mv(entries[i]));
+    }
+    entries = kj::mv(kept);
+    oldest = 0;
+  }
+}
+
+void HpackDecoder::decode(kj::ArrayPtr<const kj::byte> block,
+    kj::FunctionParam<void(kj::StringPtr name, kj::StringPtr value)> callback) {
+  bool sawField = false;
+  while (block.size() > 0) {
+    auto first = block[0];
+    if (first & 0x80) {
+      // Indexed field.
+      auto index = decodeInteger(block, 7);
+      auto field =
+          KJ_UNWRAP_OR(table.get(index), KJ_FAIL_REQUIRE("invalid HPACK index", index));
+      callback(field.name, field.value);
+    } else if ((first & 0xe0) == 0x20) {
+      // Dynamic table size update, only allowed ahead of the first field.
+      KJ_REQUIRE(!sawField, "HPACK table size update after a field");
+      auto size = decodeInteger(block, 5);
+      KJ_REQUIRE(size <= maxTableSize, "HPACK table size update exceeds our limit", size);
+      table.setMaxSize(size);
+      continue;
+    } else {
+      // Literal field, with incremental indexing (01xxxxxx), without indexing (0000xxxx) or never
+      // indexed (0001xxxx).
+      bool indexed = (first & 0xc0) == 0x40;
+      auto nameIndex = decodeInteger(block, indexed ? 6 : 4);
+      kj::String name;
+      if (nameIndex == 0) {
+        name = decodeString(block);
+      } else {
+        name = kj::str(KJ_UNWRAP_OR(
+            table.get(nameIndex), KJ_FAIL_REQUIRE("invalid HPACK index", nameIndex))
+                .name);
+      }
+      auto value = decodeString(block);
+      callback(name, value);
+      if (indexed) {
+        table.add(name, value);
+      }
+    }
+    sawField = true;
+  }
+}
+
+void HpackEncoder::setPeerMaxTableSize(size_t size) {
+  auto newSize = kj::min(size, maxTableSize);
+  if (newSize == table.getMaxSize()) return;
+
+  // The peer will shrink its table to the smallest size we announce before growing it to the
+  // final one, so we must evict everything it will.
+  auto smallest = kj::min(newSize, table.getMaxSize());
+  KJ_IF_SOME(s, smallestSizeSinceLastBlock) {
+    smallest = kj::min(smallest, s);
+  }
+  smallestSizeSinceLastBlock = smallest;
+  table.setMaxSize(smallest);
+  table.setMaxSize(newSize);
+}
+
+void HpackEncoder::startBlock(kj::Vector<kj::byte>& block) {
+  KJ_IF_SOME(smallest, smallestSizeSinceLastBlock) {
+    if (smallest < table.getMaxSize()) {
+      encodeInteger(block, 5, 0x20, smallest);
+    }
+    encodeInteger(block, 5, 0x20, table.getMaxSize());
+    smallestSizeSinceLastBlock = kj::none;
+  }
+}
+
+void HpackEncoder::encode(kj::Vector<kj::byte>& block, kj::StringPtr name, kj::StringPtr value) {
+  auto indexing = indexingFor(name);
+  kj::byte flags = 0;
+  uint prefixBits = 4;
+  switch (indexing) {
+    case Indexing::INCREMENTAL:
+      flags = 0x40;
+      prefixBits = 6;
+      break;
+    case Indexing::NONE:
+      break;
+    case Indexing::NEVER:
+      flags = 0x10;
+      break;
+  }
+
+  KJ_IF_SOME(match, table.find(name, value)) {
+    if (match.valueMatches && indexing != Indexing::NEVER) {
+      encodeInteger(block, 7, 0x80, match.index);
+      return;
+    }
+    encodeInteger(block, prefixBits, flags, match.index);
+  } else {
+    block.add(flags);
+    encodeString(block, name);
+  }
+  encodeString(block, value);
+  if (indexing == Indexing::INCREMENTAL) {
+    table.add(name, value);
+  }
+}
+
+// =======================================================================================
+// HTTP/2 framing
+
+namespace {
+
+constexpr size_t FRAME_HEADER_SIZE = 9;
+constexpr uint32_t DEFAULT_WINDOW_SIZE = 65535;
+constexpr int64_t MAX_WINDOW_SIZE = 0x7fffffff;
+constexpr uint32_t DEFAULT_MAX_FRAME_SIZE = 16384;
+constexpr uint32_t MAX_MAX_FRAME_SIZE = (1 << 24) - 1;
+constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+
+enum class FrameType : kj::byte {
+  DATA = 0x0,
+  HEADERS = 0x1,
+  PRIORITY = 0x2,
+  RST_STREAM = 0x3,
+  SETTINGS = 0x4,
+  PUSH_PROMISE = 0x5,
+  PING = 0x6,
+  GOAWAY = 0x7,
+  WINDOW_UPDATE = 0x8,
+  CONTINUATION = 0x9,
+};
+
+constexpr kj::byte FLAG_END_STREAM = 0x1;
+constexpr kj::byte FLAG_ACK = 0x1;
+constexpr kj::byte FLAG_END_HEADERS = 0x4;
+constexpr kj::byte FLAG_PADDED = 0x8;
+constexpr kj::byte FLAG_PRIORITY = 0x20;
+
+enum class ErrorCode : uint32_t {
+  // NO_ERROR in the RFC, which Windows headers define as a macro.
+  NONE = 0x0,
+  PROTOCOL_ERROR = 0x1,
+  INTERNAL_ERROR = 0x2,
+  FLOW_CONTROL_ERROR = 0x3,
+  SETTINGS_TIMEOUT = 0x4,
+  STREAM_CLOSED = 0x5,
+  FRAME_SIZE_ERROR = 0x6,
+  REFUSED_STREAM = 0x7,
+  CANCEL = 0x8,
+  COMPRESSION_ERROR = 0x9,
+  ENHANCE_YOUR_CALM = 0xb,
+};
+
+enum class SettingId : uint16_t {
+  HEADER_TABLE_SIZE = 0x1,
+  ENABLE_PUSH = 0x2,
+  MAX_CONCURRENT_STREAMS = 0x3,
+  INITIAL_WINDOW_SIZE = 0x4,
+  MAX_FRAME_SIZE = 0x5,
+  MAX_HEADER_LIST_SIZE = 0x6,
+};
+
+uint32_t readUint32(const kj::byte* bytes) {
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+      (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+}
+
+void writeUint32(kj::byte* bytes, uint32_t value) {
+  bytes[0] = value >> 24;
+  bytes[1] = value >> 16;
+  bytes[2] = value >> 8;
+  bytes[3] = value;
+}
+
+bool isConnectionSpecificHeader(kj::StringPtr name) {
+  return name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+      name == "transfer-encoding" || name == "upgrade";
+}
+
+// RFC 9113 section 8.2.1: names are lower-case tokens, and values contain no NUL, CR or LF.
+bool isValidFieldName(kj::StringPtr name) {
+  if (name.size() == 0) return false;
+  for (char c: name) {
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) continue;
+    switch (c) {
+      case '!':
+      case '#':
+      case '$':
+      case '%':
+      case '&':
+      case '\'':
+      case '*':
+      case '+':
+      case '-':
+      case '.':
+      case '^':
+      case '_':
+      case '`':
+      case '|':
+      case '~':
+        continue;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool isValidFieldValue(kj::StringPtr value) {
+  for (char c: value) {
+    if (c == '\0' || c == '\r' || c == '\n') return false;
+  }
+  return true;
+}
+
+// Serves the bytes consumed while sniffing for the preface before reading on from the connection.
+class ReplayStream final: public kj::AsyncIoStream {
+ public:
+  ReplayStream(kj::Own<kj::AsyncIoStream> inner, kj::Array<kj::byte> replay)
+      : inner(kj::mv(inner)),
+        replay(kj::mv(replay)) {}
+
+  kj::Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    auto remaining = replay.asPtr().slice(replayed);
+    if (remaining.size() == 0) {
+      return inner->tryRead(buffer, minBytes, maxBytes);
+    }
+    auto n = kj::min(remaining.size(), maxBytes);
+    memcpy(buffer, remaining.begin(), n);
+    replayed += n;
+    if (n >= minBytes) return n;
+    return inner->tryRead(reinterpret_cast<kj::byte*>(buffer) + n, minBytes - n, maxBytes - n)
+        .then([n](size_t more) { return n + more; });
+  }
+
+  kj::Maybe<uint64_t> tryGetLength() override {
+    return kj::none;
+  }
+
+  kj::Promise<void> write(kj::ArrayPtr<const kj::byte> buffer) override {
+    return inner->write(buffer);
+  }
+  kj::Promise<void> write(kj::ArrayPtr<const kj::ArrayPtr<const kj::byte>> pieces) override {
+    return inner->write(pieces);
+  }
+  kj::Maybe<kj::Promise<uint64_t>> tryPumpFrom(
+      kj::AsyncInputStream& input, uint64_t amount = kj::maxValue) override {
+    return inner->tryPumpFrom(input, amount);
+  }
+  kj::Promise<void> whenWriteDisconnected() override {
+    return inner->whenWriteDisconnected();
+  }
+  void abortWrite(kj::Exception&& exception) override {
+    inner->abortWrite(kj::mv(exception));
+  }
+  void shutdownWrite() override {
+    inner->shutdownWrite();
+  }
+  void abortRead() override {
+    inner->abortRead();
+  }
+  void getsockopt(int level, int option, void* value, kj::uint* length) override {
+    inner->getsockopt(level, option, value, length);
+  }
+  void setsockopt(int level, int option, const void* value, kj::uint length) override {
+    inner->setsockopt(level, option, value, length);
+  }
+  void getsockname(struct sockaddr* addr, kj::uint* length) override {
+    inner->getsockname(addr, length);
+  }
+  void getpeername(struct sockaddr* addr, kj::uint* length) override {
+    inner->getpeername(addr, length);
+  }
+  kj::Maybe<int> getFd() const override {
+    return inner->getFd();
+  }
+
+ private:
+  kj::Own<kj::AsyncIoStream> inner;
+  kj::Array<kj::byte> replay;
+  size_t replayed = 0;
+};
+
+}  // namespace
+
+// =======================================================================================
+// Http2Server::Connection
+
+class Http2Server::Connection final: private kj::TaskSet::ErrorHandler {
+ public:
+  Connection(Http2Server& server, kj::Own<kj::AsyncIoStream> stream);
+  ~Connection() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(Connection);
+
+  kj::Promise<void> run();
+
+ private:
+  friend class Stream;
+  friend class ResponseBody;
+
+  Http2Server& server;
+  kj::Own<kj::AsyncIoStream> stream;
+  HpackDecoder decoder;
+  HpackEncoder encoder;
+
+  kj::Array<kj::byte> readBuffer;
+  size_t readStart = 0;
+  size_t readEnd = 0;
+
+  uint32_t peerInitialWindowSize = DEFAULT_WINDOW_SIZE;
+  uint32_t peerMaxFrameSize = DEFAULT_MAX_FRAME_SIZE;
+
+  // Connection-level flow control windows. Stream-level ones are in Stream.
+  int64_t sendWindow = DEFAULT_WINDOW_SIZE;
+  int64_t receiveWindow = DEFAULT_WINDOW_SIZE;
+  uint32_t receiveCredit = 0;
+
+  uint32_t lastStreamId = 0;
+  kj::HashMap<uint32_t, kj::Own<Stream>> streams;
+
+  // A header block whose CONTINUATION frames are still arriving.
+  struct PartialHeaderBlock {
+    uint32_t streamId;
+    bool endStream;
+    kj::Vector<kj::byte> block;
+  };
+  kj::Maybe<PartialHeaderBlock> partialHeaderBlock;
+
+  // Set once we've sent GOAWAY: streams after `goAwayStreamId` are ignored, and the connection
+  // closes once the rest have finished.
+  bool draining = false;
+  uint32_t goAwayStreamId = 0;
+  kj::PromiseFulfillerPair<void> idle = kj::newPromiseAndFulfiller<void>();
+
+  // Set by fail(), so that run() can tell the client what it did wrong.
+  kj::Maybe<ErrorCode> protocolError;
+
+  // Fulfilled when the client acknowledges our SETTINGS.
+  kj::PromiseFulfillerPair<void> settingsAcked = kj::newPromiseAndFulfiller<void>();
+
+  // Streams the client has reset since `streamResetWindowStart`; see Settings::maxStreamResets.
+  uint32_t streamResets = 0;
+  kj::TimePoint streamResetWindowStart = kj::origin<kj::TimePoint>();
+
+  // When we last received a frame or finished a stream; see Settings::idleTimeout.
+  kj::TimePoint lastActivity = kj::origin<kj::TimePoint>();
+
+  // Frames waiting for the write loop, which writes everything queued at once. Entries with a
+  // fulfiller are flush markers.
+  struct Outgoing {
+    kj::Array<kj::byte> frame;
+    kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> flushed;
+  };
+  kj::Vector<Outgoing> outgoing;
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> writerWaiting;
+
+  // Bytes of frames other than DATA in `outgoing`; see Settings::maxQueuedControlBytes.
+  size_t queuedControlBytes = 0;
+  bool closing = false;
+  bool writeFailed = false;
+
+  struct RequestHead {
+    kj::HttpMethod method;
+    kj::String path;
+    kj::Own<kj::HttpHeaders> headers;
+    kj::Maybe<uint64_t> contentLength;
+  };
+
+  // Declared last so that request tasks are canceled before anything they use is destroyed.
+  kj::TaskSet tasks;
+
+  [[noreturn]] void fail(ErrorCode code, kj::StringPtr reason);
+
+  kj::Promise<bool> fill(size_t bytes);
+  kj::Promise<void> readLoop();
+  kj::Promise<void> closeWhenIdle();
+  kj::Promise<void> writeLoop();
+
+  void handleFrame(
+      kj::byte type, kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleData(kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleHeaders(kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleContinuation(kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleHeaderBlock(uint32_t streamId, bool endStream, kj::ArrayPtr<const kj::byte> block);
+  void handleRstStream(uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleSettings(kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handlePing(kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+  void handleWindowUpdate(uint32_t streamId, kj::ArrayPtr<const kj::byte> payload);
+
+  kj::ArrayPtr<const kj::byte> stripPadding(kj::byte flags, kj::ArrayPtr<const kj::byte> payload);
+  void decodeHeaderBlock(kj::ArrayPtr<const kj::byte> block,
+      kj::FunctionParam<void(kj::StringPtr name, kj::StringPtr value)> callback);
+  kj::OneOf<RequestHead, uint> decodeRequest(kj::ArrayPtr<const kj::byte> block);
+  kj::Promise<void> handleRequest(
+      kj::Own<Stream> stream, kj::String path, kj::Own<kj::HttpHeaders> headers);
+
+  kj::Maybe<Stream&> findStream(uint32_t streamId);
+  void endRequest(Stream& stream);
+  void finishStream(Stream& stream);
+  void resetStream(Stream& stream, ErrorCode code);
+  void removeStream(Stream& stream, kj::Maybe<kj::Exception> reason);
+  void wakeAllWriters();
+  void startDrain();
+  void checkIdle();
+
+  kj::Vector<kj::byte> encodeResponseHead(
+      uint statusCode, const kj::HttpHeaders& headers, kj::Maybe<uint64_t> bodySize);
+  void respondAndClose(uint32_t streamId, uint statusCode, bool requestEnded);
+
+  void queueFrame(kj::Array<kj::byte> frame);
+  void queueFrame(FrameType type,
+      kj::byte flags,
+      uint32_t streamId,
+      kj::ArrayPtr<const kj::byte> payload = nullptr);
+  void queueHeaders(uint32_t streamId, kj::ArrayPtr<const kj::byte> block, bool endStream);
+  void queueRstStream(uint32_t streamId, ErrorCode code);
+  void queueWindowUpdate(uint32_t streamId, uint32_t increment);
+  void queueGoAway(ErrorCode code, kj::StringPtr debugData);
+  kj::Promise<void> flush();
+  void wakeWriter();
+
+  void taskFailed(kj::Exception&& exception) override;
+};
+
+// =======================================================================================
+// Http2Server::Stream
+
+// One request/response exchange. The service reads the request body from it and sends the
+// response through it.
+class Http2Server::Stream final: public kj::Refcounted,
+                                 public kj::AsyncInputStream,
+                                 public kj::HttpService::Response {
+ public:
+  Stream(Connection& connection,
+      uint32_t id,
+      kj::HttpMethod method,
+      kj::Maybe<uint64_t> requestLength,
+      bool requestEnded)
+      : id(id),
+        method(method),
+        requestLength(requestLength),
+        requestEnded(requestEnded),
+        receiveWindow(connection.server.settings.initialWindowSize),
+        sendWindow(connection.peerInitialWindowSize),
+        connection(connection) {}
+
+  const uint32_t id;
+  const kj::HttpMethod method;
+
+  // Request side: body data the client has sent that the service hasn't read yet.
+  kj::Vector<kj::Array<kj::byte>> requestChunks;
+  size_t requestChunkIndex = 0;
+  size_t requestChunkOffset = 0;
+  kj::Maybe<uint64_t> requestLength;
+  uint64_t requestBytesReceived = 0;
+  uint64_t requestBytesRead = 0;
+  bool requestEnded;
+  kj::Maybe<kj::Exception> requestError;
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> readWaiter;
+
+  // Stream-level flow control windows. The receive credit is what the service has read but we
+  // haven't yet returned to the client with WINDOW_UPDATE.
+  int64_t receiveWindow;
+  uint32_t receiveCredit = 0;
+  int64_t sendWindow;
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> windowWaiter;
+
+  bool responseStarted = false;
+  bool responseEnded = false;
+
+  // Fulfilled when the stream is detached from the connection, which cancels the service's
+  // request if it's still running.
+  kj::PromiseFulfillerPair<void> detached = kj::newPromiseAndFulfiller<void>();
+  kj::ForkedPromise<void> whenDetached = detached.promise.fork();
+
+  // Cleared once the stream is finished or reset, or the connection is gone.
+  kj::Maybe<Connection&> connection;
+
+  Connection& getConnection() {
+    KJ_IF_SOME(c, connection) {
+      return c;
+    }
+    kj::throwFatalException(KJ_EXCEPTION(DISCONNECTED, "HTTP/2 stream was reset"));
+  }
+
+  void receiveData(kj::ArrayPtr<const kj::byte> data) {
+    requestBytesReceived += data.size();
+    if (data.size() > 0) {
+      requestChunks.add(kj::heapArray(data));
+      wakeReader();
+    }
+  }
+
+  void endRequestBody() {
+    requestEnded = true;
+    wakeReader();
+  }
+
+  // Returns `bytes` of flow control credit to the client once enough has built up.
+  void credit(size_t bytes) {
+    receiveCredit += bytes;
+    KJ_IF_SOME(c, connection) {
+      if (!requestEnded && receiveCredit >= c.server.settings.initialWindowSize / 2) {
+        c.queueWindowUpdate(id, receiveCredit);
+        receiveWindow += receiveCredit;
+        receiveCredit = 0;
+      }
+    }
+  }
+
+  void wakeReader() {
+    KJ_IF_SOME(w, readWaiter) {
+      w->fulfill();
+      readWaiter = kj::none;
+    }
+  }
+
+  void wakeWriter() {
+    KJ_IF_SOME(w, windowWaiter) {
+      w->fulfill();
+      windowWaiter = kj::none;
+    }
+  }
+
+  void detach(kj::Maybe<kj::Exception> reason) {
+    connection = kj::none;
+    auto exception = kj::mv(reason).orDefault(
+        [] { return KJ_EXCEPTION(DISCONNECTED, "HTTP/2 stream is closed"); });
+    if (!requestEnded && requestError == kj::none) {
+      requestError = kj::cp(exception);
+    }
+    KJ_IF_SOME(w, readWaiter) {
+      w->reject(kj::cp(exception));
+      readWaiter = kj::none;
+    }
+    KJ_IF_SOME(w, windowWaiter) {
+      w->reject(kj::mv(exception));
+      windowWaiter = kj::none;
+    }
+    if (detached.fulfiller->isWaiting()) {
+      detached.fulfiller->fulfill();
+    }
+  }
+
+  // Sends response body data as the flow control windows allow, resolving once it's written.
+  kj::Promise<void> sendData(kj::ArrayPtr<const kj::byte> data) {
+    while (data.size() > 0) {
+      auto& c = getConnection();
+      if (c.sendWindow <= 0 || sendWindow <= 0) {
+        auto paf = kj::newPromiseAndFulfiller<void>();
+        windowWaiter = kj::mv(paf.fulfiller);
+        co_await paf.promise;
+        continue;
+      }
+      auto n = kj::min(data.size(),
+          kj::min(static_cast<size_t>(c.peerMaxFrameSize),
+              static_cast<size_t>(kj::min(c.sendWindow, sendWindow))));
+      c.sendWindow -= n;
+      sendWindow -= n;
+      c.queueFrame(FrameType::DATA, 0, id, data.first(n));
+      data = data.slice(n);
+    }
+    co_await getConnection().flush();
+  }
+
+  void endResponse(bool complete) {
+    KJ_IF_SOME(c, connection) {
+      if (complete) {
+        responseEnded = true;
+        c.queueFrame(FrameType::DATA, FLAG_END_STREAM, id);
+      } else {
+        c.resetStream(*this, ErrorCode::INTERNAL_ERROR);
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // implements kj::AsyncInputStream
+
+  kj::Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    auto out = kj::arrayPtr(reinterpret_cast<kj::byte*>(buffer), maxBytes);
+    size_t total = 0;
+    for (;;) {
+      while (total < out.size() && requestChunkIndex < requestChunks.size()) {
+        auto chunk = requestChunks[requestChunkIndex].asPtr().slice(requestChunkOffset);
+        auto n = kj::min(chunk.size(), out.size() - total);
+        out.slice(total).first(n).copyFrom(chunk.first(n));
+        total += n;
+        requestChunkOffset += n;
+        if (requestChunkOffset == requestChunks[requestChunkIndex].size()) {
+          requestChunks[requestChunkIndex] = nullptr;
+          requestChunkIndex++;
+          requestChunkOffset = 0;
+        }
+      }
+      if (requestChunkIndex == requestChunks.size()) {
+        requestChunks.clear();
+        requestChunkIndex = 0;
+      }
+      if (total > 0) {
+        requestBytesRead += total;
+        credit(total);
+      }
+
+      if (total >= minBytes) co_return total;
+      KJ_IF_SOME(e, requestError) {
+        kj::throwFatalException(kj::cp(e));
+      }
+      if (requestEnded) co_return total;
+
+      auto paf = kj::newPromiseAndFulfiller<void>();
+      readWaiter = kj::mv(paf.fulfiller);
+      co_await paf.promise;
+
+      // Bytes already copied have been accounted for.
+      out = out.slice(total);
+      minBytes -= total;
+      total = 0;
+    }
+  }
+
+  kj::Maybe<uint64_t> tryGetLength() override {
+    if (requestEnded) {
+      return requestBytesReceived - requestBytesRead;
+    }
+    KJ_IF_SOME(length, requestLength) {
+      return length - requestBytesRead;
+    }
+    return kj::none;
+  }
+
+  // ---------------------------------------------------------------------------
+  // implements kj::HttpService::Response
+
+  kj::Own<kj::AsyncOutputStream> send(uint statusCode,
+      kj::StringPtr statusText,
+      const kj::HttpHeaders& headers,
+      kj::Maybe<uint64_t> expectedBodySize = kj::none) override;
+
+  kj::Own<kj::WebSocket> acceptWebSocket(const kj::HttpHeaders& headers) override {
+    // Upgrade headers are connection-specific, so requests carrying them are rejected before they
+    // reach the service, and it has no business accepting a WebSocket here. Answer the client
+    // with a 501 rather than resetting the stream, and fail the service's call the way
+    // kj::HttpServer does for requests that aren't upgrades.
+    if (!responseStarted) {
+      kj::HttpHeaders responseHeaders(getConnection().server.headerTable);
+      send(501, "Not Implemented", responseHeaders, uint64_t(0));
+    }
+    KJ_FAIL_REQUIRE("can't accept a WebSocket on an HTTP/2 stream; RFC 8441 isn't supported");
+  }
+};
+
+class Http2Server::ResponseBody final: public kj::AsyncOutputStream {
+ public:
+  ResponseBody(kj::Own<Stream> stream, kj::Maybe<uint64_t> expectedSize)
+      : stream(kj::mv(stream)),
+        expectedSize(expectedSize) {}
+
+  ~ResponseBody() noexcept(false) {
+    // As with HTTP/1.1, dropping the body ends it, unless that's clearly not what happened.
+    bool complete = !writeInProgress && !unwindDetector.isUnwinding();
+    KJ_IF_SOME(size, expectedSize) {
+      complete = complete && written == size;
+    }
+    stream->endResponse(complete);
+  }
+
+  kj::Promise<void> write(kj::ArrayPtr<const kj::byte> buffer) override {
+    KJ_IF_SOME(size, expectedSize) {
+      KJ_REQUIRE(written + buffer.size() <= size, "overwrote Content-Length");
+    }
+    written += buffer.size();
+    writeInProgress = true;
+    co_await stream->sendData(buffer);
+    writeInProgress = false;
+  }
+
+  kj::Promise<void> write(kj::ArrayPtr<const kj::ArrayPtr<const kj::byte>> pieces) override {
+    for (auto piece: pieces) {
+      co_await write(piece);
+    }
+  }
+
+  kj::Promise<void> whenWriteDisconnected() override {
+    return stream->whenDetached.addBranch();
+  }
+
+ private:
+  kj::Own<Stream> stream;
+  kj::Maybe<uint64_t> expectedSize;
+  uint64_t written = 0;
+  bool writeInProgress = false;
+  kj::UnwindDetector unwindDetector;
+};
+
+kj::Own<kj::AsyncOutputStream> Http2Server::Stream::send(uint statusCode,
+    kj::StringPtr statusText,
+    const kj::HttpHeaders& headers,
+    kj::Maybe<uint64_t> expectedBodySize) {
+  KJ_REQUIRE(!responseStarted, "already called send()");
+  auto& c = getConnection();
+  responseStarted = true;
+
+  // HTTP/2 has no reason phrase, so `statusText` goes nowhere.
+  bool noBody = method == kj::HttpMethod::HEAD || statusCode == 204 || statusCode == 304;
+  KJ_IF_SOME(size, expectedBodySize) {
+    noBody = noBody || size == 0;
+  }
+  c.queueHeaders(id, c.encodeResponseHead(statusCode, headers, expectedBodySize), noBody);
+  if (noBody) {
+    responseEnded = true;
+    return newNullOutputStream();
+  }
+  return kj::heap<ResponseBody>(kj::addRef(*this), expectedBodySize);
+}
+
+// =======================================================================================
+// Http2Server::Connection implementation
+
+Http2Server::Connection::Connection(Http2Server& server, kj::Own<kj::AsyncIoStream> stream)
+    : server(server),
+      stream(kj::mv(stream)),
+      readBuffer(kj::heapArray<kj::byte>(
+          kj::max(FRAME_HEADER_SIZE + server.settings.maxFrameSize, READ_BUFFER_SIZE))),
+      tasks(*this) {
+  ++server.connectionCount;
+}
+
+Http2Server::Connection::~Connection() noexcept(false) {
+  for (auto& entry: streams) {
+    entry.value->detach(KJ_EXCEPTION(DISCONNECTED, "HTTP/2 connection closed"));
+  }
+  if (--server.connectionCount == 0) {
+    KJ_IF_SOME(f, server.allClosedFulfiller) {
+      f->fulfill();
+      server.allClosedFulfiller = kj::none;
+    }
+  }
+}
+
+kj::Promise<void> Http2Server::Connection::run() {
+  // Our SETTINGS must be the first frame we send.
+  auto& settings = server.settings;
+  kj::byte settingsPayload[24];
+  auto putSetting = [&](size_t i, SettingId id, uint32_t value) {
+    settingsPayload[i * 6] = static_cast<uint16_t>(id) >> 8;
+    settingsPayload[i * 6 + 1] = static_cast<uint16_t>(id);
+    writeUint32(settingsPayload + i * 6 + 2, value);
+  };
+  putSetting(0, SettingId::MAX_CONCURRENT_STREAMS, settings.maxConcurrentStreams);
+  putSetting(1, SettingId::INITIAL_WINDOW_SIZE, settings.initialWindowSize);
+  putSetting(2, SettingId::MAX_FRAME_SIZE, settings.maxFrameSize);
+  putSetting(3, SettingId::MAX_HEADER_LIST_SIZE, settings.maxHeaderListSize);
+  queueFrame(FrameType::SETTINGS, 0, 0, settingsPayload);
+  if (settings.connectionWindowSize > DEFAULT_WINDOW_SIZE) {
+    queueWindowUpdate(0, settings.connectionWindowSize - DEFAULT_WINDOW_SIZE);
+    receiveWindow = settings.connectionWindowSize;
+  }
+
+  auto writer = writeLoop().fork();
+  tasks.add(server.onDrain.addBranch().then([this]() { startDrain(); }));
+  lastActivity = server.timer.now();
+  tasks.add(closeWhenIdle());
+
+  auto settingsTimeout =
+      kj::mv(settingsAcked.promise)
+          .then([]() -> kj::Promise<void> { return kj::NEVER_DONE; })
+          .exclusiveJoin(server.timer.afterDelay(settings.settingsTimeout).then([this]() {
+    fail(ErrorCode::SETTINGS_TIMEOUT, "SETTINGS not acknowledged");
+  }));
+
+  kj::Maybe<kj::Exception> error;
+  try {
+    co_await readLoop()
+        .exclusiveJoin(kj::mv(idle.promise))
+        .exclusiveJoin(writer.addBranch())
+        .exclusiveJoin(kj::mv(settingsTimeout));
+  } catch (...) {
+    error = kj::getCaughtExceptionAsKj();
+  }
+
+  bool rethrow = false;
+  KJ_IF_SOME(e, error) {
+    KJ_IF_SOME(code, protocolError) {
+      queueGoAway(code, e.getDescription());
+    } else if (e.getType() != kj::Exception::Type::DISCONNECTED) {
+      queueGoAway(ErrorCode::INTERNAL_ERROR, nullptr);
+      rethrow = true;
+    }
+  }
+
+  for (auto& entry: streams) {
+    entry.value->detach(KJ_EXCEPTION(DISCONNECTED, "HTTP/2 connection closed"));
+  }
+  streams.clear();
+
+  if (!writeFailed) {
+    closing = true;
+    wakeWriter();
+    try {
+      // A client that has stopped reading doesn't get to keep the connection open.
+      co_await writer.addBranch().exclusiveJoin(server.timer.afterDelay(settings.idleTimeout));
+    } catch (...) {
+      // The client is gone; nothing more to tell it.
+    }
+  }
+
+  if (rethrow) {
+    kj::throwFatalException(kj::mv(KJ_ASSERT_NONNULL(error)));
+  }
+}
+
+void Http2Server::Connection::fail(ErrorCode code, kj::StringPtr reason) {
+  protocolError = code;
+  kj::throwFatalException(KJ_EXCEPTION(FAILED, reason));
+}
+
+// Ensures that `bytes` bytes are buffered starting at `readStart`. Returns false if the client
+// closed the connection cleanly instead.
+kj::Promise<bool> Http2Server::Connection::fill(size_t bytes) {
+  if (readEnd - readStart >= bytes) co_return true;
+  if (readBuffer.size() - readStart < bytes) {
+    memmove(readBuffer.begin(), readBuffer.begin() + readStart, readEnd - readStart);
+    readEnd -= readStart;
+    readStart = 0;
+  }
+  while (readEnd - readStart < bytes) {
+    auto needed = bytes - (readEnd - readStart);
+    auto n = co_await stream->tryRead(
+        readBuffer.begin() + readEnd, needed, readBuffer.size() - readEnd);
+    readEnd += n;
+    if (n < needed) {
+      if (readEnd == readStart) co_return false;
+      kj::throwFatalException(KJ_EXCEPTION(DISCONNECTED, "HTTP/2 connection ended mid-frame"));
+    }
+  }
+  co_return true;
+}
+
+kj::Promise<void> Http2Server::Connection::readLoop() {
+  for (;;) {
+    if (!co_await fill(FRAME_HEADER_SIZE)) co_return;
+    auto header = readBuffer.slice(readStart, readStart + FRAME_HEADER_SIZE);
+    size_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+    auto type = header[3];
+    auto flags = header[4];
+    auto streamId = readUint32(header.begin() + 5) & 0x7fffffff;
+    if (length > server.settings.maxFrameSize) {
+      fail(ErrorCode::FRAME_SIZE_ERROR, "frame exceeds SETTINGS_MAX_FRAME_SIZE");
+    }
+
+    if (!co_await fill(FRAME_HEADER_SIZE + length)) co_return;
+    auto payload = readBuffer.slice(
+        readStart + FRAME_HEADER_SIZE, readStart + FRAME_HEADER_SIZE + length);
+    readStart += FRAME_HEADER_SIZE + length;
+    lastActivity = server.timer.now();
+    handleFrame(type, flags, streamId, payload);
+
+    // Checked here rather than as frames are queued, since only a frame from the client can make
+    // it the client's fault.
+    if (queuedControlBytes > server.settings.maxQueuedControlBytes) {
+      fail(ErrorCode::ENHANCE_YOUR_CALM, "too many frames awaiting the client's reads");
+    }
+  }
+}
+
+kj::Promise<void> Http2Server::Connection::closeWhenIdle() {
+  auto& timer = server.timer;
+  auto timeout = server.settings.idleTimeout;
+  for (;;) {
+    co_await timer.atTime(lastActivity + timeout);
+    if (streams.size() > 0) {
+      // Open streams keep the connection busy; the count starts over once the last one finishes.
+      lastActivity = timer.now();
+    } else if (timer.now() - lastActivity >= timeout) {
+      startDrain();
+      co_return;
+    }
+  }
+}
+
+kj::Promise<void> Http2Server::Connection::writeLoop() {
+  try {
+    for (;;) {
+      if (outgoing.empty()) {
+        if (closing) co_return;
+        auto paf = kj::newPromiseAndFulfiller<void>();
+        writerWaiting = kj::mv(paf.fulfiller);
+        co_await paf.promise;
+        continue;
+      }
+
+      auto batch = kj::mv(outgoing);
+      outgoing = kj::Vector<Outgoing>();
+      queuedControlBytes = 0;
+      kj::Vector<kj::ArrayPtr<const kj::byte>> pieces(batch.size());
+      for (auto& item: batch) {
+        if (item.frame.size() > 0) pieces.add(item.frame);
+      }
+      if (pieces.size() > 0) {
+        co_await stream->write(pieces.asPtr());
+      }
+      for (auto& item: batch) {
+        KJ_IF_SOME(f, item.flushed) {
+          f->fulfill();
+        }
+      }
+    }
+  } catch (...) {
+    writeFailed = true;
+    throw;
+  }
+}
+
+void Http2Server::Connection::handleFrame(
+    kj::byte type, kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (partialHeaderBlock != kj::none && type != static_cast<kj::byte>(FrameType::CONTINUATION)) {
+    fail(ErrorCode::PROTOCOL_ERROR, "expected CONTINUATION");
+  }
+
+  switch (static_cast<FrameType>(type)) {
+    case FrameType::DATA:
+      return handleData(flags, streamId, payload);
+    case FrameType::HEADERS:
+      return handleHeaders(flags, streamId, payload);
+    case FrameType::PRIORITY:
+      // Priorities are advisory, and we don't act on them.
+      if (streamId == 0) fail(ErrorCode::PROTOCOL_ERROR, "PRIORITY on stream 0");
+      if (payload.size() != 5) fail(ErrorCode::FRAME_SIZE_ERROR, "bad PRIORITY frame size");
+      return;
+    case FrameType::RST_STREAM:
+      return handleRstStream(streamId, payload);
+    case FrameType::SETTINGS:
+      return handleSettings(flags, streamId, payload);
+    case FrameType::PUSH_PROMISE:
+      fail(ErrorCode::PROTOCOL_ERROR, "clients may not send PUSH_PROMISE");
+    case FrameType::PING:
+      return handlePing(flags, streamId, payload);
+    case FrameType::GOAWAY:
+      // The client won't start any more streams; let the ones it has finish, then close.
+      if (streamId != 0) fail(ErrorCode::PROTOCOL_ERROR, "GOAWAY on a stream");
+      return startDrain();
+    case FrameType::WINDOW_UPDATE:
+      return handleWindowUpdate(streamId, payload);
+    case FrameType::CONTINUATION:
+      return handleContinuation(flags, streamId, payload);
+  }
+
+  // Frames of unknown types must be ignored.
+}
+
+kj::ArrayPtr<const kj::byte> Http2Server::Connection::stripPadding(
+    kj::byte flags, kj::ArrayPtr<const kj::byte> payload) {
+  if ((flags & FLAG_PADDED) == 0) return payload;
+  if (payload.size() == 0) fail(ErrorCode::FRAME_SIZE_ERROR, "padded frame too short");
+  size_t padLength = payload[0];
+  if (padLength >= payload.size()) fail(ErrorCode::PROTOCOL_ERROR, "padding exceeds frame");
+  return payload.slice(1, payload.size() - padLength);
+}
+
+void Http2Server::Connection::handleData(
+    kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (streamId == 0) fail(ErrorCode::PROTOCOL_ERROR, "DATA on stream 0");
+
+  // The whole payload, padding included, counts against flow control. The connection window is
+  // returned as soon as the data arrives; see Settings::connectionWindowSize.
+  if (static_cast<int64_t>(payload.size()) > receiveWindow) {
+    fail(ErrorCode::FLOW_CONTROL_ERROR, "DATA exceeds the connection window");
+  }
+  receiveWindow -= payload.size();
+  receiveCredit += payload.size();
+  if (receiveCredit >= server.settings.connectionWindowSize / 2) {
+    queueWindowUpdate(0, receiveCredit);
+    receiveWindow += receiveCredit;
+    receiveCredit = 0;
+  }
+
+  auto data = stripPadding(flags, payload);
+  KJ_IF_SOME(stream, findStream(streamId)) {
+    if (stream.requestEnded) {
+      return resetStream(stream, ErrorCode::STREAM_CLOSED);
+    }
+    if (static_cast<int64_t>(payload.size()) > stream.receiveWindow) {
+      return resetStream(stream, ErrorCode::FLOW_CONTROL_ERROR);
+    }
+    stream.receiveWindow -= payload.size();
+    KJ_IF_SOME(length, stream.requestLength) {
+      if (stream.requestBytesReceived + data.size() > length) {
+        return resetStream(stream, ErrorCode::PROTOCOL_ERROR);
+      }
+    }
+    stream.receiveData(data);
+    // Padding never reaches the service, so it can be credited back right away.
+    stream.credit(payload.size() - data.size());
+    if (flags & FLAG_END_STREAM) {
+      endRequest(stream);
+    }
+  } else if (streamId > lastStreamId) {
+    fail(ErrorCode::PROTOCOL_ERROR, "DATA on idle stream");
+  }
+  // Otherwise the stream has finished or been reset; data still in flight is dropped.
+}
+
+void Http2Server::Connection::handleHeaders(
+    kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (streamId == 0) fail(ErrorCode::PROTOCOL_ERROR, "HEADERS on stream 0");
+  auto fragment = stripPadding(flags, payload);
+  if (flags & FLAG_PRIORITY) {
+    if (fragment.size() < 5) fail(ErrorCode::FRAME_SIZE_ERROR, "HEADERS too short for priority");
+    fragment = fragment.slice(5);
+  }
+
+  bool endStream = flags & FLAG_END_STREAM;
+  if (flags & FLAG_END_HEADERS) {
+    handleHeaderBlock(streamId, endStream, fragment);
+  } else {
+    PartialHeaderBlock partial{streamId, endStream, {}};
+    partial.block.addAll(fragment);
+    partialHeaderBlock = kj::mv(partial);
+  }
+}
+
+void Http2Server::Connection::handleContinuation(
+    kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  KJ_IF_SOME(partial, partialHeaderBlock) {
+    if (streamId != partial.streamId) {
+      fail(ErrorCode::PROTOCOL_ERROR, "CONTINUATION on the wrong stream");
+    }
+    // A compressed block is never much larger than the header list it decodes to.
+    if (partial.block.size() + payload.size() > server.settings.maxHeaderListSize * 2) {
+      fail(ErrorCode::ENHANCE_YOUR_CALM, "header block too large");
+    }
+    partial.block.addAll(payload);
+    if (flags & FLAG_END_HEADERS) {
+      auto complete = kj::mv(partial);
+      partialHeaderBlock = kj::none;
+      handleHeaderBlock(complete.streamId, complete.endStream, complete.block);
+    }
+  } else {
+    fail(ErrorCode::PROTOCOL_ERROR, "CONTINUATION without HEADERS");
+  }
+}
+
+void Http2Server::Connection::decodeHeaderBlock(kj::ArrayPtr<const kj::byte> block,
+    kj::FunctionParam<void(kj::StringPtr name, kj::StringPtr value)> callback) {
+  try {
+    decoder.decode(block, callback);
+  } catch (...) {
+    auto exception = kj::getCaughtExceptionAsKj();
+    fail(ErrorCode::COMPRESSION_ERROR, exception.getDescription());
+  }
+}
+
+void Http2Server::Connection::handleHeaderBlock(
+    uint32_t streamId, bool endStream, kj::ArrayPtr<const kj::byte> block) {
+  KJ_IF_SOME(stream, findStream(streamId)) {
+    // Trailers. The service has no way to receive them, but they must be decoded regardless to
+    // keep the HPACK table in sync.
+    decodeHeaderBlock(block, [](kj::StringPtr, kj::StringPtr) {});
+    if (stream.requestEnded) {
+      return resetStream(stream, ErrorCode::STREAM_CLOSED);
+    }
+    if (!endStream) {
+      return resetStream(stream, ErrorCode::PROTOCOL_ERROR);
+    }
+    return endRequest(stream);
+  }
+
+  if (streamId % 2 == 0) fail(ErrorCode::PROTOCOL_ERROR, "client opened an even-numbered stream");
+  if (streamId <= lastStreamId) {
+    // Trailers for a stream we've already finished.
+    decodeHeaderBlock(block, [](kj::StringPtr, kj::StringPtr) {});
+    return;
+  }
+  lastStreamId = streamId;
+
+  auto decoded = decodeRequest(block);
+  if (draining && streamId > goAwayStreamId) {
+    // The client will retry it on another connection.
+    return;
+  }
+  if (streams.size() >= server.settings.maxConcurrentStreams) {
+    return queueRstStream(streamId, ErrorCode::REFUSED_STREAM);
+  }
+
+  KJ_SWITCH_ONEOF(decoded) {
+    KJ_CASE_ONEOF(status, uint) {
+      return respondAndClose(streamId, status, endStream);
+    }
+    KJ_CASE_ONEOF(head, RequestHead) {
+      KJ_IF_SOME(length, head.contentLength) {
+        if (endStream && length != 0) {
+          return respondAndClose(streamId, 400, endStream);
+        }
+      }
+      auto stream =
+          kj::refcounted<Stream>(*this, streamId, head.method, head.contentLength, endStream);
+      streams.insert(streamId, kj::addRef(*stream));
+      auto whenDetached = stream->whenDetached.addBranch();
+      tasks.add(handleRequest(kj::mv(stream), kj::mv(head.path), kj::mv(head.headers))
+                    .exclusiveJoin(kj::mv(whenDetached)));
+      return;
+    }
+  }
+}
+
+// Decodes a request's header block into a RequestHead, or the status to reject it with.
+kj::OneOf<Http2Server::Connection::RequestHead, uint> Http2Server::Connection::decodeRequest(
+    kj::ArrayPtr<const kj::byte> block) {
+  kj::Maybe<kj::String> method;
+  kj::Maybe<kj::String> scheme;
+  kj::Maybe<kj::String> authority;
+  kj::Maybe<kj::String> path;
+  kj::Vector<kj::String> cookies;
+  auto headers = kj::heap<kj::HttpHeaders>(server.headerTable);
+  size_t listSize = 0;
+  bool malformed = false;
+  bool sawRegularField = false;
+
+  // The whole block must be decoded even once we know the request is bad.
+  decodeHeaderBlock(block, [&](kj::StringPtr name, kj::StringPtr value) {
+    listSize += name.size() + value.size() + HPACK_ENTRY_OVERHEAD;
+    if (malformed || listSize > server.settings.maxHeaderListSize) return;
+
+    if (name.startsWith(":")) {
+      kj::Maybe<kj::String>* slot;
+      if (name == ":method") {
+        slot = &method;
+      } else if (name == ":scheme") {
+        slot = &scheme;
+      } else if (name == ":authority") {
+        slot = &authority;
+      } else if (name == ":path") {
+        slot = &path;
+      } else {
+        malformed = true;
+        return;
+      }
+      if (sawRegularField || *slot != kj::none) {
+        malformed = true;
+        return;
+      }
+      *slot = kj::str(value);
+      return;
+    }
+
+    sawRegularField = true;
+    if (!isValidFieldName(name) || !isValidFieldValue(value) || isConnectionSpecificHeader(name) ||
+        (name == "te" && value != "trailers")) {
+      malformed = true;
+      return;
+    }
+    if (name == "cookie") {
+      // HTTP/2 lets clients split cookies into separate fields for better compression.
+      cookies.add(kj::str(value));
+      return;
+    }
+    headers->add(kj::str(name), kj::str(value));
+  });
+
+  if (listSize > server.settings.maxHeaderListSize) return uint(431);
+  if (malformed || method == kj::none) return uint(400);
+
+  // CONNECT is the only method without :scheme and :path, and we don't support it.
+  auto parsedMethod =
+      KJ_UNWRAP_OR(kj::tryParseHttpMethod(KJ_ASSERT_NONNULL(method)), return uint(501));
+  if (scheme == kj::none || path == kj::none || KJ_ASSERT_NONNULL(path).size() == 0) {
+    return uint(400);
+  }
+
+  KJ_IF_SOME(a, authority) {
+    headers->set(kj::HttpHeaderId::HOST, kj::mv(a));
+  }
+  if (cookies.size() > 0) {
+    headers->add("cookie", kj::strArray(cookies, "; "));
+  }
+
+  kj::Maybe<uint64_t> contentLength;
+  KJ_IF_SOME(value, headers->get(kj::HttpHeaderId::CONTENT_LENGTH)) {
+    contentLength = KJ_UNWRAP_OR(value.tryParseAs<uint64_t>(), return uint(400));
+  }
+
+  return RequestHead{
+    .method = parsedMethod,
+    .path = kj::mv(KJ_ASSERT_NONNULL(path)),
+    .headers = kj::mv(headers),
+    .contentLength = contentLength,
+  };
+}
+
+kj::Promise<void> Http2Server::Connection::handleRequest(
+    kj::Own<Stream> stream, kj::String path, kj::Own<kj::HttpHeaders> headers) {
+  // Runs even if the request is canceled because the stream was reset, in which case the stream
+  // is already detached and this does nothing.
+  KJ_DEFER(finishStream(*stream));
+
+  kj::Maybe<kj::Exception> error;
+  try {
+    co_await server.service.request(stream->method, path, *headers, *stream, *stream);
+  } catch (...) {
+    error = kj::getCaughtExceptionAsKj();
+  }
+
+  if (stream->connection == kj::none) co_return;
+
+  auto& errorHandler = server.getErrorHandler();
+  KJ_IF_SOME(e, error) {
+    if (stream->responseStarted) {
+      co_await errorHandler.handleApplicationError(kj::mv(e), kj::none);
+    } else {
+      co_await errorHandler.handleApplicationError(kj::mv(e), *stream);
+    }
+  } else if (!stream->responseStarted) {
+    co_await errorHandler.handleNoResponse(*stream);
+  }
+}
+
+kj::Maybe<Http2Server::Stream&> Http2Server::Connection::findStream(uint32_t streamId) {
+  KJ_IF_SOME(stream, streams.find(streamId)) {
+    return *stream;
+  }
+  return kj::none;
+}
+
+void Http2Server::Connection::endRequest(Stream& stream) {
+  KJ_IF_SOME(length, stream.requestLength) {
+    if (stream.requestBytesReceived != length) {
+      return resetStream(stream, ErrorCode::PROTOCOL_ERROR);
+    }
+  }
+  stream.endRequestBody();
+}
+
+void Http2Server::Connection::finishStream(Stream& stream) {
+  if (stream.connection == kj::none) return;
+  if (!stream.responseEnded) {
+    // The service returned, or failed, without finishing the response body.
+    return resetStream(stream, ErrorCode::INTERNAL_ERROR);
+  }
+  if (!stream.requestEnded) {
+    // We've responded without reading the whole request, so the client needn't send the rest.
+    queueRstStream(stream.id, ErrorCode::NONE);
+  }
+  removeStream(stream, kj::none);
+}
+
+void Http2Server::Connection::resetStream(Stream& stream, ErrorCode code) {
+  queueRstStream(stream.id, code);
+  removeStream(stream, KJ_EXCEPTION(DISCONNECTED, "HTTP/2 stream was reset"));
+}
+
+void Http2Server::Connection::removeStream(Stream& stream, kj::Maybe<kj::Exception> reason) {
+  auto id = stream.id;
+  stream.detach(kj::mv(reason));
+  // This may destroy `stream`.
+  streams.eraseMatch(id);
+  lastActivity = server.timer.now();
+  checkIdle();
+}
+
+void Http2Server::Connection::handleRstStream(
+    uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (streamId == 0) fail(ErrorCode::PROTOCOL_ERROR, "RST_STREAM on stream 0");
+  if (payload.size() != 4) fail(ErrorCode::FRAME_SIZE_ERROR, "bad RST_STREAM frame size");
+  if (streamId > lastStreamId) fail(ErrorCode::PROTOCOL_ERROR, "RST_STREAM on idle stream");
+  KJ_IF_SOME(stream, findStream(streamId)) {
+    // Opening streams and resetting them right away would otherwise start requests without limit
+    // (CVE-2023-44487).
+    auto now = server.timer.now();
+    if (now - streamResetWindowStart >= server.settings.streamResetWindow) {
+      streamResetWindowStart = now;
+      streamResets = 0;
+    }
+    if (++streamResets > server.settings.maxStreamResets) {
+      fail(ErrorCode::ENHANCE_YOUR_CALM, "too many streams reset");
+    }
+    removeStream(stream, KJ_EXCEPTION(DISCONNECTED, "HTTP/2 stream was reset by the client"));
+  }
+}
+
+void Http2Server::Connection::handleSettings(
+    kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (streamId != 0) fail(ErrorCode::PROTOCOL_ERROR, "SETTINGS on a stream");
+  if (flags & FLAG_ACK) {
+    if (payload.size() != 0) fail(ErrorCode::FRAME_SIZE_ERROR, "SETTINGS ack with payload");
+    if (settingsAcked.fulfiller->isWaiting()) settingsAcked.fulfiller->fulfill();
+    return;
+  }
+  if (payload.size() % 6 != 0) fail(ErrorCode::FRAME_SIZE_ERROR, "bad SETTINGS frame size");
+
+  for (size_t i = 0; i < payload.size(); i += 6) {
+    uint16_t id = (payload[i] << 8) | payload[i + 1];
+    uint32_t value = readUint32(payload.begin() + i + 2);
+    switch (static_cast<SettingId>(id)) {
+      case SettingId::HEADER_TABLE_SIZE:
+        encoder.setPeerMaxTableSize(value);
+        break;
+      case SettingId::ENABLE_PUSH:
+        if (value > 1) fail(ErrorCode::PROTOCOL_ERROR, "bad SETTINGS_ENABLE_PUSH");
+        break;
+      case SettingId::INITIAL_WINDOW_SIZE: {
+        if (value > MAX_WINDOW_SIZE) {
+          fail(ErrorCode::FLOW_CONTROL_ERROR, "SETTINGS_INITIAL_WINDOW_SIZE too large");
+        }
+        // Applies retroactively to the streams already open.
+        int64_t delta = static_cast<int64_t>(value) - peerInitialWindowSize;
+        peerInitialWindowSize = value;
+        for (auto& entry: streams) {
+          entry.value->sendWindow += delta;
+          if (entry.value->sendWindow > MAX_WINDOW_SIZE) {
+            fail(ErrorCode::FLOW_CONTROL_ERROR, "stream window overflow");
+          }
+        }
+        if (delta > 0) wakeAllWriters();
+        break;
+      }
+      case SettingId::MAX_FRAME_SIZE:
+        if (value < DEFAULT_MAX_FRAME_SIZE || value > MAX_MAX_FRAME_SIZE) {
+          fail(ErrorCode::PROTOCOL_ERROR, "bad SETTINGS_MAX_FRAME_SIZE");
+        }
+        peerMaxFrameSize = value;
+        break;
+      default:
+        // The rest either only constrain the client, or are unknown and must be ignored.
+        break;
+    }
+  }
+  queueFrame(FrameType::SETTINGS, FLAG_ACK, 0);
+}
+
+void Http2Server::Connection::handlePing(
+    kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (streamId != 0) fail(ErrorCode::PROTOCOL_ERROR, "PING on a stream");
+  if (payload.size() != 8) fail(ErrorCode::FRAME_SIZE_ERROR, "bad PING frame size");
+  if ((flags & FLAG_ACK) == 0) {
+    queueFrame(FrameType::PING, FLAG_ACK, 0, payload);
+  }
+}
+
+void Http2Server::Connection::handleWindowUpdate(
+    uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  if (payload.size() != 4) fail(ErrorCode::FRAME_SIZE_ERROR, "bad WINDOW_UPDATE frame size");
+  uint32_t increment = readUint32(payload.begin()) & 0x7fffffff;
+
+  if (streamId == 0) {
+    if (increment == 0) fail(ErrorCode::PROTOCOL_ERROR, "zero WINDOW_UPDATE");
+    sendWindow += increment;
+    if (sendWindow > MAX_WINDOW_SIZE) fail(ErrorCode::FLOW_CONTROL_ERROR, "window overflow");
+    wakeAllWriters();
+  } else KJ_IF_SOME(stream, findStream(streamId)) {
+    if (increment == 0) {
+      return resetStream(stream, ErrorCode::PROTOCOL_ERROR);
+    }
+    stream.sendWindow += increment;
+    if (stream.sendWindow > MAX_WINDOW_SIZE) {
+      return resetStream(stream, ErrorCode::FLOW_CONTROL_ERROR);
+    }
+    stream.wakeWriter();
+  }
+}
+
+void Http2Server::Connection::wakeAllWriters() {
+  for (auto& entry: streams) {
+    entry.value->wakeWriter();
+  }
+}
+
+void Http2Server::Connection::startDrain() {
+  if (draining) return;
+  draining = true;
+  goAwayStreamId = lastStreamId;
+  queueGoAway(ErrorCode::NONE, nullptr);
+  checkIdle();
+}
+
+void Http2Server::Connection::checkIdle() {
+  if (draining && streams.size() == 0 && idle.fulfiller->isWaiting()) {
+    idle.fulfiller->fulfill();
+  }
+}
+
+kj::Vector<kj::byte> Http2Server::Connection::encodeResponseHead(
+    uint statusCode, const kj::HttpHeaders& headers, kj::Maybe<uint64_t> bodySize) {
+  kj::Vector<kj::byte> block(256);
+  encoder.startBlock(block);
+  encoder.encode(block, ":status", kj::str(statusCode));
+  bool sawContentLength = false;
+  headers.forEach([&](kj::StringPtr name, kj::StringPtr value) {
+    auto lowerName = toLower(name);
+    if (isConnectionSpecificHeader(lowerName)) return;
+    sawContentLength = sawContentLength || lowerName == "content-length";
+    encoder.encode(block, lowerName, value);
+  });
+  if (!sawContentLength && statusCode != 204 && statusCode != 304) {
+    KJ_IF_SOME(size, bodySize) {
+      encoder.encode(block, "content-length", kj::str(size));
+    }
+  }
+  return block;
+}
+
+// Responds to a request that never reaches the service.
+void Http2Server::Connection::respondAndClose(
+    uint32_t streamId, uint statusCode, bool requestEnded) {
+  kj::Vector<kj::byte> block;
+  encoder.startBlock(block);
+  encoder.encode(block, ":status", kj::str(statusCode));
+  encoder.encode(block, "content-length", "0");
+  queueHeaders(streamId, block, true);
+  if (!requestEnded) {
+    queueRstStream(streamId, ErrorCode::NONE);
+  }
+}
+
+void Http2Server::Connection::queueFrame(kj::Array<kj::byte> frame) {
+  outgoing.add(Outgoing{kj::mv(frame), kj::none});
+  wakeWriter();
+}
+
+void Http2Server::Connection::queueFrame(
+    FrameType type, kj::byte flags, uint32_t streamId, kj::ArrayPtr<const kj::byte> payload) {
+  auto frame = kj::heapArray<kj::byte>(FRAME_HEADER_SIZE + payload.size());
+  frame[0] = payload.size() >> 16;
+  frame[1] = payload.size() >> 8;
+  frame[2] = payload.size();
+  frame[3] = static_cast<kj::byte>(type);
+  frame[4] = flags;
+  writeUint32(frame.begin() + 5, streamId);
+  frame.slice(FRAME_HEADER_SIZE).copyFrom(payload);
+  if (type != FrameType::DATA) queuedControlBytes += frame.size();
+  queueFrame(kj::mv(frame));
+}
+
+void Http2Server::Connection::queueHeaders(
+    uint32_t streamId, kj::ArrayPtr<const kj::byte> block, bool endStream) {
+  // Queued back to back, so that no other frame can come between them.
+  auto type = FrameType::HEADERS;
+  kj::byte flags = endStream ? FLAG_END_STREAM : 0;
+  do {
+    auto fragment = block.first(kj::min(block.size(), peerMaxFrameSize));
+    block = block.slice(fragment.size());
+    if (block.size() == 0) flags |= FLAG_END_HEADERS;
+    queueFrame(type, flags, streamId, fragment);
+    type = FrameType::CONTINUATION;
+    flags = 0;
+  } while (block.size() > 0);
+}
+
+void Http2Server::Connection::queueRstStream(uint32_t streamId, ErrorCode code) {
+  kj::byte payload[4];
+  writeUint32(payload, static_cast<uint32_t>(code));
+  queueFrame(FrameType::RST_STREAM, 0, streamId, payload);
+}
+
+void Http2Server::Connection::queueWindowUpdate(uint32_t streamId, uint32_t increment) {
+  kj::byte payload[4];
+  writeUint32(payload, increment);
+  queueFrame(FrameType::WINDOW_UPDATE, 0, streamId, payload);
+}
+
+void Http2Server::Connection::queueGoAway(ErrorCode code, kj::StringPtr debugData) {
+  auto payload = kj::heapArray<kj::byte>(8 + debugData.size());
+  writeUint32(payload.begin(), lastStreamId);
+  writeUint32(payload.begin() + 4, static_cast<uint32_t>(code));
+  payload.slice(8).copyFrom(debugData.asBytes());
+  queueFrame(FrameType::GOAWAY, 0, 0, payload);
+}
+
+kj::Promise<void> Http2Server::Connection::flush() {
+  auto paf = kj::newPromiseAndFulfiller<void>();
+  outgoing.add(Outgoing{nullptr, kj::mv(paf.fulfiller)});
+  wakeWriter();
+  return kj::mv(paf.promise);
+}
+
+void Http2Server::Connection::wakeWriter() {
+  KJ_IF_SOME(w, writerWaiting) {
+    w->fulfill();
+    writerWaiting = kj::none;
+  }
+}
+
+void Http2Server::Connection::taskFailed(kj::Exception&& exception) {
+  if (exception.getType() != kj::Exception::Type::DISCONNECTED) {
+    KJ_LOG(ERROR, "HTTP/2 request task failed", exception);
+  }
+}
+
+// =======================================================================================
+// Http2Server
+
+Http2Server::Http2Server(kj::Timer& timer,
+    const kj::HttpHeaderTable& headerTable,
+    kj::HttpService& service,
+    Settings settings)
+    : timer(timer),
+      headerTable(headerTable),
+      service(service),
+      settings(kj::mv(settings)) {
+  KJ_REQUIRE(this->settings.initialWindowSize >= DEFAULT_WINDOW_SIZE &&
+          this->settings.initialWindowSize <= MAX_WINDOW_SIZE,
+      "bad HTTP/2 initial window size", this->settings.initialWindowSize);
+  KJ_REQUIRE(this->settings.connectionWindowSize >= DEFAULT_WINDOW_SIZE &&
+          this->settings.connectionWindowSize <= MAX_WINDOW_SIZE,
+      "bad HTTP/2 connection window size", this->settings.connectionWindowSize);
+  KJ_REQUIRE(this->settings.maxFrameSize >= DEFAULT_MAX_FRAME_SIZE &&
+          this->settings.maxFrameSize <= MAX_MAX_FRAME_SIZE,
+      "bad HTTP/2 max frame size", this->settings.maxFrameSize);
+}
+
+kj::Promise<void> Http2Server::listenHttp2(kj::Own<kj::AsyncIoStream> connection) {
+  auto conn = kj::heap<Connection>(*this, kj::mv(connection));
+  co_await conn->run();
+}
+
+kj::Promise<void> Http2Server::drain() {
+  if (drainRequested.fulfiller->isWaiting()) {
+    drainRequested.fulfiller->fulfill();
+  }
+  if (connectionCount == 0) {
+    return kj::READY_NOW;
+  }
+  auto paf = kj::newPromiseAndFulfiller<void>();
+  allClosedFulfiller = kj::mv(paf.fulfiller);
+  return kj::mv(paf.promise);
+}
+
+kj::Promise<bool> sniffHttp2Preface(kj::Own<kj::AsyncIoStream>& stream) {
+  auto preface = Http2Server::PREFACE.asBytes();
+  auto buffer = kj::heapArray<kj::byte>(preface.size());
+  size_t filled = 0;
+  while (filled < buffer.size()) {
+    // Read only what's needed: an HTTP/1.1 client may send less than the preface's length and
+    // then wait for a response.
+    auto n = co_await stream->tryRead(buffer.begin() + filled, 1, buffer.size() - filled);
+    if (n == 0) break;
+    bool matches = memcmp(buffer.begin() + filled, preface.begin() + filled, n) == 0;
+    filled += n;
+    if (!matches) break;
+    if (filled == buffer.size()) co_return true;
+  }
+
+  stream = kj::heap<ReplayStream>(kj::mv(stream), kj::heapArray<kj::byte>(buffer.first(filled)));
+  co_return false;
+}
+
+}  // namespace workerd::server
@@ -0,0 +1,225 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <kj/async-io.h>
+#include <kj/compat/http.h>
+#include <kj/function.h>
+#include <kj/string.h>
+#include <kj/timer.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+// =======================================================================================
+// HPACK (RFC 7541)
+
+// The dynamic table size both ends of an HTTP/2 connection start with.
+constexpr size_t HPACK_DEFAULT_TABLE_SIZE = 4096;
+
+// The static table followed by one end's dynamic table. Each HTTP/2 connection has two of these,
+// one in its decoder and one in its encoder, and they live as long as the connection, so fields
+// repeated across requests on a connection are sent as a single index.
+class HpackTable {
+ public:
+  explicit HpackTable(size_t maxSize): maxSize(maxSize) {}
+  KJ_DISALLOW_COPY_AND_MOVE(HpackTable);
+
+  struct Field {
+    kj::StringPtr name;
+    kj::StringPtr value;
+  };
+
+  // Looks up a field by HPACK index: 1 to 61 are the static table, and higher indexes count into
+  // the dynamic table from the newest entry.
+  kj::Maybe<Field> get(size_t index) const;
+
+  struct Match {
+    size_t index;
+    bool valueMatches;
+  };
+
+  // Finds the field with this name and value, or failing that any field with this name.
+  kj::Maybe<Match> find(kj::StringPtr name, kj::StringPtr value) const;
+
+  // Inserts a field, evicting old ones as needed. A field larger than the whole table just
+  // empties it, as the RFC requires.
+  void add(kj::StringPtr name, kj::StringPtr value);
+
+  void setMaxSize(size_t newMaxSize);
+  size_t getMaxSize() const {
+    return maxSize;
+  }
+
+ private:
+  struct Entry {
+    kj::String name;
+    kj::String value;
+  };
+
+  // Oldest first, starting at `oldest`; evicted entries before that are compacted away lazily.
+  kj::Vector<Entry> entries;
+  size_t oldest = 0;
+  size_t size = 0;
+  size_t maxSize;
+
+  size_t dynamicCount() const {
+    return entries.size() - oldest;
+  }
+  void evictTo(size_t targetSize);
+};
+
+class HpackDecoder {
+ public:
+  // `maxTableSize` is the SETTINGS_HEADER_TABLE_SIZE we advertise; the peer may not ask for more.
+  explicit HpackDecoder(size_t maxTableSize = HPACK_DEFAULT_TABLE_SIZE)
+      : table(maxTableSize),
+        maxTableSize(maxTableSize) {}
+
+  // Decodes a complete header block, calling `callback` for each field in order. Throws if the
+  // block is malformed, after which the table is out of sync with the peer's; HTTP/2 treats that
+  // as fatal to the connection.
+  void decode(kj::ArrayPtr<const kj::byte> block,
+      kj::FunctionParam<void(kj::StringPtr name, kj::StringPtr value)> callback);
+
+ private:
+  HpackTable table;
+  size_t maxTableSize;
+};
+
+class HpackEncoder {
+ public:
+  // `maxTableSize` caps the dynamic table regardless of how large a table the peer allows.
+  explicit HpackEncoder(size_t maxTableSize = HPACK_DEFAULT_TABLE_SIZE)
+      : table(kj::min(maxTableSize, HPACK_DEFAULT_TABLE_SIZE)),
+        maxTableSize(maxTableSize) {}
+
+  // Applies the peer's SETTINGS_HEADER_TABLE_SIZE. The new size is announced at the start of the
+  // next header block.
+  void setPeerMaxTableSize(size_t size);
+
+  // Must be called before the first field of each header block.
+  void startBlock(kj::Vector<kj::byte>& block);
+
+  // Appends one field to `block`. `name` must be lower-case. Fields whose values are secrets or
+  // rarely repeat (cookies, lengths) are never added to the dynamic table.
+  void encode(kj::Vector<kj::byte>& block, kj::StringPtr name, kj::StringPtr value);
+
+ private:
+  HpackTable table;
+  size_t maxTableSize;
+
+  // The smallest size the table has had since the last block, if it has changed since then.
+  kj::Maybe<size_t> smallestSizeSinceLastBlock;
+};
+
+// =======================================================================================
+// HTTP/2 (RFC 9113)
+
+// Serves HTTP/2 connections by mapping each stream onto one call to kj::HttpService::request(),
+// so the service behind it can't tell the request didn't arrive over HTTP/1.1.
+//
+// Each connection's HPACK tables are shared by all of its streams. Request bodies are
+// flow-controlled per stream: the client may only send as far ahead of the service's reads as the
+// stream window allows, and reading reopens it. Response bodies honor the client's windows in
+// turn, and a write to a response body completes once its frames have been written to the
+// connection, so a slow client pushes back on the service the same way it would over HTTP/1.1.
+//
+// Server push, priorities, WebSocket and CONNECT over HTTP/2 are not supported.
+class Http2Server final {
+ public:
+  struct Settings {
+    // Advertised as SETTINGS_MAX_CONCURRENT_STREAMS. Streams beyond it are refused.
+    uint32_t maxConcurrentStreams = 128;
+
+    // Advertised as SETTINGS_INITIAL_WINDOW_SIZE: how many request body bytes a client may send
+    // on a stream ahead of the service reading them. Must be at least the protocol default of
+    // 65535.
+    uint32_t initialWindowSize = 256 * 1024;
+
+    // Receive window for the connection as a whole. It's replenished as DATA arrives rather than
+    // as it's read, so that a stream whose body isn't being read can't stall the others; memory
+    // is bounded by the per-stream windows instead.
+    uint32_t connectionWindowSize = 1024 * 1024;
+
+    // Advertised as SETTINGS_MAX_FRAME_SIZE.
+    uint32_t maxFrameSize = 16384;
+
+    // Advertised as SETTINGS_MAX_HEADER_LIST_SIZE. Larger requests get a 431 response.
+    uint32_t maxHeaderListSize = 64 * 1024;
+
+    // How long a connection with no open streams may go without receiving a frame before it is
+    // closed with GOAWAY. Also bounds how long a closing connection waits for the client to read
+    // the frames still queued for it.
+    kj::Duration idleTimeout = 60 * kj::SECONDS;
+
+    // How long the client has to acknowledge our SETTINGS before the connection is closed with
+    // SETTINGS_TIMEOUT.
+    kj::Duration settingsTimeout = 10 * kj::SECONDS;
+
+    // How many bytes of frames other than DATA may wait to be written. Beyond this, the client is
+    // sending frames that need a reply (PING, SETTINGS, requests) faster than it reads the
+    // replies, and the connection is closed with ENHANCE_YOUR_CALM.
+    size_t maxQueuedControlBytes = 1024 * 1024;
+
+    // How many streams the client may reset within `streamResetWindow` before the connection is
+    // closed with ENHANCE_YOUR_CALM. A reset stream stops counting against maxConcurrentStreams
+    // right away, but the request it started may still be running.
+    uint32_t maxStreamResets = 200;
+    kj::Duration streamResetWindow = 10 * kj::SECONDS;
+
+    // Gets the same calls kj::HttpServer would make for failed or unanswered requests.
+    kj::Maybe<kj::HttpServerErrorHandler&> errorHandler;
+  };
+
+  Http2Server(kj::Timer& timer,
+      const kj::HttpHeaderTable& headerTable,
+      kj::HttpService& service,
+      Settings settings = {});
+  KJ_DISALLOW_COPY_AND_MOVE(Http2Server);
+
+  // The client connection preface. A connection that begins with it is HTTP/2 by prior
+  // knowledge.
+  static constexpr kj::StringPtr PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"_kj;
+
+  // Serves a connection whose client preface has already been consumed, e.g. by
+  // sniffHttp2Preface(). Resolves once the connection is closed.
+  kj::Promise<void> listenHttp2(kj::Own<kj::AsyncIoStream> connection);
+
+  // Sends GOAWAY on every connection, present and future, letting streams already started run to
+  // completion. Resolves once all connections have closed.
+  kj::Promise<void> drain();
+
+ private:
+  class Connection;
+  class Stream;
+  class ResponseBody;
+
+  kj::Timer& timer;
+  const kj::HttpHeaderTable& headerTable;
+  kj::HttpService& service;
+  Settings settings;
+  kj::HttpServerErrorHandler defaultErrorHandler;
+
+  uint connectionCount = 0;
+  kj::PromiseFulfillerPair<void> drainRequested = kj::newPromiseAndFulfiller<void>();
+  kj::ForkedPromise<void> onDrain = drainRequested.promise.fork();
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> allClosedFulfiller;
+
+  kj::HttpServerErrorHandler& getErrorHandler() {
+    KJ_IF_SOME(handler, settings.errorHandler) {
+      return handler;
+    }
+    return defaultErrorHandler;
+  }
+};
+
+// Reads from `stream` just far enough to tell whether the client is starting an HTTP/2 connection
+// by prior knowledge, i.e. with Http2Server::PREFACE. If so, the preface is consumed and the
+// result is true. Otherwise `stream` is replaced by one that replays what was read, so that it can
+// be served as HTTP/1.1; no HTTP/1.1 request can begin with the preface.
+kj::Promise<bool> sniffHttp2Preface(kj::Own<kj::AsyncIoStream>& stream);
+
+}  // namespace workerd::server
@@ -0,0 +1,234 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "otlp-exporter.h"
+
+#include <kj/compat/http.h>
+#include <kj/test.h>
+#include <kj/timer.h>
+
+namespace workerd::server {
+namespace {
+
+// Records every export request it receives.
+class FakeCollector final: public kj::HttpService {
+ public:
+  struct Request {
+    kj::String url;
+    kj::String contentType;
+    kj::String body;
+  };
+
+  explicit FakeCollector(const kj::HttpHeaderTable& headerTable): headerTable(headerTable) {}
+
+  kj::Vector<Request> requests;
+  uint statusCode = 200;
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override {
+    KJ_EXPECT(method == kj::HttpMethod::POST);
+    auto body = co_await requestBody.readAllText();
+    requests.add(Request{
+      .url = kj::str(url),
+      .contentType = kj::str(KJ_ASSERT_NONNULL(headers.get(kj::HttpHeaderId::CONTENT_TYPE))),
+      .body = kj::mv(body),
+    });
+    kj::HttpHeaders responseHeaders(headerTable);
+    response.send(statusCode, "OK", responseHeaders, uint64_t(0));
+  }
+
+ private:
+  const kj::HttpHeaderTable& headerTable;
+};
+
+struct ExporterFixture {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope{loop};
+  kj::TimerImpl timer{kj::origin<kj::TimePoint>()};
+  kj::HttpHeaderTable headerTable;
+  FakeCollector collector{headerTable};
+  kj::Own<OtlpExporter> exporter;
+
+  explicit ExporterFixture(OtlpExporter::Options options)
+      : exporter(kj::refcounted<OtlpExporter>(timer, headerTable,
+            [this]() { return kj::newHttpClient(collector); }, kj::mv(options))) {}
+
+  void advance(kj::Duration duration) {
+    timer.advanceTo(timer.now() + duration);
+    waitScope.poll();
+  }
+};
+
+OtlpExporter::SpanRecord makeSpan(kj::StringPtr name, uint64_t spanId) {
+  Span::TagMap tags;
+  tags.insert("http.status"_kjc, int64_t(200));
+  return {
+    .traceId = tracing::TraceId(0x2222, 0x1111),
+    .spanId = tracing::SpanId(spanId),
+    .parentSpanId = tracing::SpanId(1),
+    .name = kj::ConstString(kj::str(name)),
+    .startTime = kj::UNIX_EPOCH + 1 * kj::SECONDS,
+    .endTime = kj::UNIX_EPOCH + 2 * kj::SECONDS,
+    .tags = kj::mv(tags),
+  };
+}
+
+KJ_TEST("OtlpExporter sends a batch once maxBatchSize records are queued") {
+  ExporterFixture fixture({
+    .serviceName = kj::str("my-worker"),
+    .encoding = OtlpExporter::Encoding::JSON,
+    .maxBatchSize = 2,
+  });
+
+  fixture.exporter->addSpan(makeSpan("first", 2));
+  fixture.waitScope.poll();
+  KJ_EXPECT(fixture.collector.requests.size() == 0);
+
+  fixture.exporter->addSpan(makeSpan("second", 3));
+  fixture.waitScope.poll();
+  KJ_ASSERT(fixture.collector.requests.size() == 1);
+
+  auto& request = fixture.collector.requests[0];
+  KJ_EXPECT(request.url == "http://localhost/v1/traces");
+  KJ_EXPECT(request.contentType == "application/json");
+  KJ_EXPECT(request.body.contains(
+                "{\"key\":\"service.name\",\"value\":{\"stringValue\":\"my-worker\"}}"_kj),
+      request.body);
+  KJ_EXPECT(request.body.contains("{\"traceId\":\"00000000000011110000000000002222\","
+                                  "\"spanId\":\"0000000000000002\","
+                                  "\"parentSpanId\":\"0000000000000001\","
+                                  "\"name\":\"first\",\"kind\":1,"
+                                  "\"startTimeUnixNano\":\"1000000000\","
+                                  "\"endTimeUnixNano\":\"2000000000\","
+                                  "\"attributes\":[{\"key\":\"http.status\","
+                                  "\"value\":{\"intValue\":\"200\"}}]}"_kj),
+      request.body);
+  KJ_EXPECT(request.body.contains("\"name\":\"second\""_kj));
+  KJ_EXPECT(fixture.exporter->getStats().exportedSpans == 2);
+}
+
+KJ_TEST("OtlpExporter flushes a partial batch after flushInterval") {
+  ExporterFixture fixture({
+    .serviceName = kj::str("my-worker"),
+    .flushInterval = 1 * kj::SECONDS,
+  });
+
+  fixture.exporter->addLog({
+    .traceId = tracing::TraceId(0x2222, 0x1111),
+    .timestamp = kj::UNIX_EPOCH,
+    .level = LogLevel::WARN,
+    .message = kj::str("careful"),
+  });
+  fixture.advance(500 * kj::MILLISECONDS);
+  KJ_EXPECT(fixture.collector.requests.size() == 0);
+
+  fixture.advance(500 * kj::MILLISECONDS);
+  KJ_ASSERT(fixture.collector.requests.size() == 1);
+  auto& request = fixture.collector.requests[0];
+  KJ_EXPECT(request.url == "http://localhost/v1/logs");
+  KJ_EXPECT(request.contentType == "application/x-protobuf");
+  // ExportLogsServiceRequest.resource_logs is field 1, length-delimited.
+  KJ_EXPECT(request.body[0] == 0x0a);
+  KJ_EXPECT(request.body.contains("careful"_kj));
+  KJ_EXPECT(request.body.contains("warn"_kj));
+  KJ_EXPECT(fixture.exporter->getStats().exportedLogs == 1);
+}
+
+KJ_TEST("OtlpExporter drops records beyond maxQueueSize") {
+  ExporterFixture fixture({
+    .serviceName = kj::str("my-worker"),
+    .maxQueueSize = 2,
+  });
+
+  fixture.exporter->addSpan(makeSpan("a", 2));
+  fixture.exporter->addSpan(makeSpan("b", 3));
+  fixture.exporter->addSpan(makeSpan("c", 4));
+  KJ_EXPECT(fixture.exporter->getStats().droppedSpans == 1);
+
+  fixture.exporter->flush().wait(fixture.waitScope);
+  KJ_EXPECT(fixture.collector.requests.size() == 1);
+  KJ_EXPECT(fixture.exporter->getStats().exportedSpans == 2);
+}
+
+KJ_TEST("OtlpExporter counts rejected exports as dropped") {
+  ExporterFixture fixture({.serviceName = kj::str("my-worker")});
+  fixture.collector.statusCode = 503;
+
+  fixture.exporter->addSpan(makeSpan("a", 2));
+  fixture.exporter->flush().wait(fixture.waitScope);
+  KJ_EXPECT(fixture.exporter->getStats().exportedSpans == 0);
+  KJ_EXPECT(fixture.exporter->getStats().droppedSpans == 1);
+  KJ_EXPECT(fixture.exporter->getStats().failedExports == 1);
+}
+
+KJ_TEST("OtlpExporter samples by trace ID unless the caller decided") {
+  ExporterFixture fixture({
+    .serviceName = kj::str("my-worker"),
+    .samplingRatio = 0.25,
+  });
+  auto& exporter = *fixture.exporter;
+
+  KJ_EXPECT(exporter.shouldSample(tracing::TraceId(0, 1), kj::none));
+  KJ_EXPECT(exporter.shouldSample(tracing::TraceId(0x3fffffffffffffff, 1), kj::none));
+  KJ_EXPECT(!exporter.shouldSample(tracing::TraceId(0x4000000000000000, 1), kj::none));
+  KJ_EXPECT(!exporter.shouldSample(tracing::TraceId(0xffffffffffffffff, 1), kj::none));
+
+  KJ_EXPECT(exporter.shouldSample(tracing::TraceId(0xffffffffffffffff, 1), tracing::TraceFlags(1)));
+  KJ_EXPECT(!exporter.shouldSample(tracing::TraceId(0, 1), tracing::TraceFlags(0)));
+}
+
+KJ_TEST("OtlpTraceRecorder exports the spans and logs of sampled requests") {
+  ExporterFixture fixture({
+    .serviceName = kj::str("my-worker"),
+    .encoding = OtlpExporter::Encoding::JSON,
+    .samplingRatio = 0.5,
+  });
+
+  auto makeTrace = []() {
+    auto trace = kj::refcounted<Trace>(kj::none, kj::none, kj::none, kj::none, kj::none, nullptr,
+        kj::none, ExecutionModel::STATELESS);
+    trace->logs.add(kj::UNIX_EPOCH, LogLevel::LOG, kj::str("say \"hi\"\n"));
+    trace->exceptions.add(kj::UNIX_EPOCH, kj::str("TypeError"), kj::str("oops"), kj::none);
+    return trace;
+  };
+
+  auto sampled = kj::refcounted<OtlpTraceRecorder>(kj::addRef(*fixture.exporter));
+  sampled->start(tracing::TraceId(1, 7), kj::none);
+  KJ_EXPECT(sampled->isSampled());
+  sampled->spanOpen(tracing::SpanId(5), tracing::SpanId::nullId, "fetch"_kjc, kj::UNIX_EPOCH);
+  sampled->spanOpen(tracing::SpanId(6), tracing::SpanId(5), "never_closed"_kjc, kj::UNIX_EPOCH);
+  sampled->spanClose(tracing::SpanId(5), kj::UNIX_EPOCH, kj::UNIX_EPOCH, {});
+  sampled->finish(*makeTrace());
+
+  auto unsampled = kj::refcounted<OtlpTraceRecorder>(kj::addRef(*fixture.exporter));
+  unsampled->start(tracing::TraceId(0xffffffffffffffff, 7), kj::none);
+  KJ_EXPECT(!unsampled->isSampled());
+  unsampled->spanOpen(tracing::SpanId(5), tracing::SpanId::nullId, "fetch"_kjc, kj::UNIX_EPOCH);
+  unsampled->spanClose(tracing::SpanId(5), kj::UNIX_EPOCH, kj::UNIX_EPOCH, {});
+  unsampled->finish(*makeTrace());
+
+  fixture.exporter->flush().wait(fixture.waitScope);
+  KJ_ASSERT(fixture.collector.requests.size() == 2);
+
+  auto& spans = fixture.collector.requests[0].body;
+  KJ_EXPECT(spans.contains("\"name\":\"fetch\""_kj), spans);
+  KJ_EXPECT(!spans.contains("parentSpanId"_kj), spans);
+  KJ_EXPECT(!spans.contains("never_closed"_kj), spans);
+
+  auto& logs = fixture.collector.requests[1].body;
+  KJ_EXPECT(logs.contains("\"body\":{\"stringValue\":\"say \\\"hi\\\"\\n\"}"_kj), logs);
+  KJ_EXPECT(logs.contains("\"body\":{\"stringValue\":\"TypeError: oops\"}"_kj), logs);
+  KJ_EXPECT(logs.contains(
+                "{\"key\":\"exception.type\",\"value\":{\"stringValue\":\"TypeError\"}}"_kj),
+      logs);
+
+  KJ_EXPECT(fixture.exporter->getStats().exportedSpans == 1);
+  KJ_EXPECT(fixture.exporter->getStats().exportedLogs == 2);
+}
+
+}  // namespace
+}  // namespace workerd::server
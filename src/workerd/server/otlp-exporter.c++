@@ -0,0 +1,646 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "otlp-exporter.h"
+
+#include <workerd/util/sentry.h>
+
+#include <kj/debug.h>
+
+#include <cmath>
+
+namespace workerd::server {
+
+namespace {
+
+// The OTLP/HTTP request URL. The host is irrelevant: the collector service designator decides
+// where requests actually go.
+constexpr kj::StringPtr COLLECTOR_ORIGIN = "http://localhost"_kj;
+constexpr kj::StringPtr SCOPE_NAME = "workerd"_kj;
+
+// OTLP SpanKind.SPAN_KIND_INTERNAL.
+constexpr uint SPAN_KIND_INTERNAL = 1;
+
+// OTLP SeverityNumber values.
+constexpr uint SEVERITY_DEBUG = 5;
+constexpr uint SEVERITY_INFO = 9;
+constexpr uint SEVERITY_WARN = 13;
+constexpr uint SEVERITY_ERROR = 17;
+
+uint severityNumber(LogLevel level) {
+  switch (level) {
+    case LogLevel::DEBUG_:
+      return SEVERITY_DEBUG;
+    case LogLevel::INFO:
+    case LogLevel::LOG:
+      return SEVERITY_INFO;
+    case LogLevel::WARN:
+      return SEVERITY_WARN;
+    case LogLevel::ERROR:
+      return SEVERITY_ERROR;
+  }
+  KJ_UNREACHABLE;
+}
+
+kj::StringPtr severityText(LogLevel level) {
+  switch (level) {
+    case LogLevel::DEBUG_:
+      return "debug"_kj;
+    case LogLevel::INFO:
+      return "info"_kj;
+    case LogLevel::LOG:
+      return "log"_kj;
+    case LogLevel::WARN:
+      return "warn"_kj;
+    case LogLevel::ERROR:
+      return "error"_kj;
+  }
+  KJ_UNREACHABLE;
+}
+
+uint64_t toUnixNanos(kj::Date date) {
+  return (date - kj::UNIX_EPOCH) / kj::NANOSECONDS;
+}
+
+// Moves the first `count` elements of `queue` into an array, keeping the rest queued in order.
+template <typename T>
+kj::Array<T> takeBatch(kj::Vector<T>& queue, size_t count) {
+  if (count == queue.size()) {
+    return queue.releaseAsArray();
+  }
+  auto batch = kj::heapArrayBuilder<T>(count);
+  kj::Vector<T> rest(queue.size() - count);
+  for (auto i: kj::indices(queue)) {
+    if (i < count) {
+      batch.add(kj::mv(queue[i]));
+    } else {
+      rest.add(kj::mv(queue[i]));
+    }
+  }
+  queue = kj::mv(rest);
+  return batch.finish();
+}
+
+// ---------------------------------------------------------------------------------------
+// Protobuf encoding
+//
+// The OTLP messages are simple enough that we write the wire format directly rather than pull
+// in the protobuf runtime and the opentelemetry-proto schemas. Field numbers below come from
+// opentelemetry/proto/{collector,trace,logs,common,resource}/v1.
+
+class ProtoWriter {
+ public:
+  void varintField(uint field, uint64_t value) {
+    tag(field, 0);
+    varint(value);
+  }
+
+  void fixed64Field(uint field, uint64_t value) {
+    tag(field, 1);
+    for (auto i: kj::zeroTo(8)) {
+      bytes.add(static_cast<kj::byte>(value >> (i * 8)));
+    }
+  }
+
+  void bytesField(uint field, kj::ArrayPtr<const kj::byte> value) {
+    tag(field, 2);
+    varint(value.size());
+    bytes.addAll(value);
+  }
+
+  void stringField(uint field, kj::StringPtr value) {
+    bytesField(field, value.asBytes());
+  }
+
+  // Writes a length-delimited embedded message whose content is produced by `func`.
+  template <typename Func>
+  void messageField(uint field, Func&& func) {
+    ProtoWriter nested;
+    func(nested);
+    bytesField(field, nested.bytes);
+  }
+
+  kj::Array<kj::byte> finish() {
+    return bytes.releaseAsArray();
+  }
+
+ private:
+  kj::Vector<kj::byte> bytes;
+
+  void tag(uint field, uint wireType) {
+    varint((field << 3) | wireType);
+  }
+
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes.add(static_cast<kj::byte>(value | 0x80));
+      value >>= 7;
+    }
+    bytes.add(static_cast<kj::byte>(value));
+  }
+};
+
+kj::FixedArray<kj::byte, 16> traceIdBytes(const tracing::TraceId& id) {
+  kj::FixedArray<kj::byte, 16> result;
+  for (auto i: kj::zeroTo(8)) {
+    result[i] = static_cast<kj::byte>(id.getHigh() >> (56 - i * 8));
+    result[i + 8] = static_cast<kj::byte>(id.getLow() >> (56 - i * 8));
+  }
+  return result;
+}
+
+kj::FixedArray<kj::byte, 8> spanIdBytes(const tracing::SpanId& id) {
+  kj::FixedArray<kj::byte, 8> result;
+  for (auto i: kj::zeroTo(8)) {
+    result[i] = static_cast<kj::byte>(id.getId() >> (56 - i * 8));
+  }
+  return result;
+}
+
+// AnyValue
+void writeProtoValue(ProtoWriter& out, const tracing::Attribute::Value& value) {
+  KJ_SWITCH_ONEOF(value) {
+    KJ_CASE_ONEOF(str, kj::ConstString) {
+      out.stringField(1, str);
+    }
+    KJ_CASE_ONEOF(b, bool) {
+      out.varintField(2, b);
+    }
+    KJ_CASE_ONEOF(i, int64_t) {
+      out.varintField(3, static_cast<uint64_t>(i));
+    }
+    KJ_CASE_ONEOF(d, double) {
+      uint64_t bits;
+      memcpy(&bits, &d, sizeof(bits));
+      out.fixed64Field(4, bits);
+    }
+  }
+}
+
+// KeyValue
+void writeProtoAttribute(
+    ProtoWriter& out, uint field, kj::StringPtr key, const tracing::Attribute::Value& value) {
+  out.messageField(field, [&](ProtoWriter& kv) {
+    kv.stringField(1, key);
+    kv.messageField(2, [&](ProtoWriter& v) { writeProtoValue(v, value); });
+  });
+}
+
+void writeProtoAttribute(ProtoWriter& out, uint field, const tracing::Attribute& attribute) {
+  if (attribute.value.size() == 1) {
+    writeProtoAttribute(out, field, attribute.name, attribute.value[0]);
+    return;
+  }
+  out.messageField(field, [&](ProtoWriter& kv) {
+    kv.stringField(1, attribute.name);
+    kv.messageField(2, [&](ProtoWriter& v) {
+      // AnyValue.array_value
+      v.messageField(5, [&](ProtoWriter& array) {
+        for (auto& value: attribute.value) {
+          array.messageField(1, [&](ProtoWriter& element) { writeProtoValue(element, value); });
+        }
+      });
+    });
+  });
+}
+
+// Resource and InstrumentationScope, which are fields 1 and 2 of both ResourceSpans/ScopeSpans
+// and ResourceLogs/ScopeLogs.
+template <typename Func>
+void writeProtoResource(ProtoWriter& out, kj::StringPtr serviceName, Func&& writeScope) {
+  out.messageField(1, [&](ProtoWriter& resourceAndScope) {
+    resourceAndScope.messageField(1, [&](ProtoWriter& resource) {
+      resource.messageField(1, [&](ProtoWriter& kv) {
+        kv.stringField(1, "service.name"_kj);
+        kv.messageField(2, [&](ProtoWriter& value) { value.stringField(1, serviceName); });
+      });
+    });
+    resourceAndScope.messageField(2, [&](ProtoWriter& scopeItems) {
+      scopeItems.messageField(1, [&](ProtoWriter& scope) { scope.stringField(1, SCOPE_NAME); });
+      writeScope(scopeItems);
+    });
+  });
+}
+
+// ---------------------------------------------------------------------------------------
+// JSON encoding
+//
+// Follows the OTLP JSON mapping: IDs are hex strings, 64-bit integers are decimal strings, and
+// enums are integers.
+
+void appendJsonString(kj::Vector<char>& out, kj::StringPtr str) {
+  static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+  out.add('"');
+  for (char c: str) {
+    switch (c) {
+      case '"':
+        out.addAll("\\\""_kj);
+        break;
+      case '\\':
+        out.addAll("\\\\"_kj);
+        break;
+      case '\n':
+        out.addAll("\\n"_kj);
+        break;
+      case '\r':
+        out.addAll("\\r"_kj);
+        break;
+      case '\t':
+        out.addAll("\\t"_kj);
+        break;
+      default:
+        if (static_cast<kj::byte>(c) < 0x20) {
+          out.addAll("\\u00"_kj);
+          out.add(HEX_DIGITS[c >> 4]);
+          out.add(HEX_DIGITS[c & 0xf]);
+        } else {
+          out.add(c);
+        }
+    }
+  }
+  out.add('"');
+}
+
+template <typename... Params>
+void appendJson(kj::Vector<char>& out, Params&&... params) {
+  out.addAll(kj::str(kj::fwd<Params>(params)...));
+}
+
+void appendJsonValue(kj::Vector<char>& out, const tracing::Attribute::Value& value) {
+  KJ_SWITCH_ONEOF(value) {
+    KJ_CASE_ONEOF(str, kj::ConstString) {
+      out.addAll("{\"stringValue\":"_kj);
+      appendJsonString(out, str);
+      out.add('}');
+    }
+    KJ_CASE_ONEOF(b, bool) {
+      appendJson(out, "{\"boolValue\":", b ? "true"_kj : "false"_kj, "}");
+    }
+    KJ_CASE_ONEOF(i, int64_t) {
+      appendJson(out, "{\"intValue\":\"", i, "\"}");
+    }
+    KJ_CASE_ONEOF(d, double) {
+      if (std::isfinite(d)) {
+        appendJson(out, "{\"doubleValue\":", d, "}");
+      } else {
+        // JSON has no representation for NaN or infinity.
+        appendJson(out, "{\"stringValue\":\"", d, "\"}");
+      }
+    }
+  }
+}
+
+void appendJsonAttribute(
+    kj::Vector<char>& out, kj::StringPtr key, const tracing::Attribute::Value& value) {
+  out.addAll("{\"key\":"_kj);
+  appendJsonString(out, key);
+  out.addAll(",\"value\":"_kj);
+  appendJsonValue(out, value);
+  out.add('}');
+}
+
+void appendJsonAttribute(kj::Vector<char>& out, const tracing::Attribute& attribute) {
+  if (attribute.value.size() == 1) {
+    appendJsonAttribute(out, attribute.name, attribute.value[0]);
+    return;
+  }
+  out.addAll("{\"key\":"_kj);
+  appendJsonString(out, attribute.name);
+  out.addAll(",\"value\":{\"arrayValue\":{\"values\":["_kj);
+  bool first = true;
+  for (auto& value: attribute.value) {
+    if (!first) out.add(',');
+    first = false;
+    appendJsonValue(out, value);
+  }
+  out.addAll("]}}}"_kj);
+}
+
+void appendJsonResource(kj::Vector<char>& out, kj::StringPtr serviceName) {
+  out.addAll("\"resource\":{\"attributes\":["_kj);
+  out.addAll("{\"key\":\"service.name\",\"value\":{\"stringValue\":"_kj);
+  appendJsonString(out, serviceName);
+  out.addAll("}}]},"_kj);
+}
+
+}  // namespace
+
+// =======================================================================================
+// OtlpExporter
+
+OtlpExporter::OtlpExporter(kj::Timer& timer,
+    const kj::HttpHeaderTable& headerTable,
+    kj::Function<kj::Own<kj::HttpClient>()> newClient,
+    Options options)
+    : timer(timer),
+      headerTable(headerTable),
+      newClient(kj::mv(newClient)),
+      options(kj::mv(options)),
+      tasks(*this) {
+  KJ_REQUIRE(this->options.maxBatchSize > 0);
+}
+
+OtlpExporter::~OtlpExporter() noexcept(false) {}
+
+bool OtlpExporter::shouldSample(
+    const tracing::TraceId& traceId, kj::Maybe<tracing::TraceFlags> traceFlags) {
+  KJ_IF_SOME(flags, traceFlags) {
+    return flags.isSampled();
+  }
+  if (options.samplingRatio >= 1.0) return true;
+  if (options.samplingRatio <= 0.0) return false;
+
+  // Like OpenTelemetry's TraceIdRatioBased sampler, compare the random low half of the ID
+  // against the ratio scaled to the 64-bit range.
+  auto threshold = static_cast<uint64_t>(options.samplingRatio * 18446744073709551616.0);
+  return traceId.getLow() < threshold;
+}
+
+void OtlpExporter::addSpan(SpanRecord record) {
+  if (spans.size() >= options.maxQueueSize) {
+    ++stats.droppedSpans;
+    LOG_WARNING_PERIODICALLY("OTLP exporter queue is full; dropping spans", options.serviceName,
+        stats.droppedSpans);
+    return;
+  }
+  spans.add(kj::mv(record));
+  recordQueued(spans.size());
+}
+
+void OtlpExporter::addLog(LogRecord record) {
+  if (logs.size() >= options.maxQueueSize) {
+    ++stats.droppedLogs;
+    LOG_WARNING_PERIODICALLY("OTLP exporter queue is full; dropping logs", options.serviceName,
+        stats.droppedLogs);
+    return;
+  }
+  logs.add(kj::mv(record));
+  recordQueued(logs.size());
+}
+
+void OtlpExporter::recordQueued(size_t queued) {
+  if (queued >= options.maxBatchSize) {
+    startExport();
+  } else if (!flushScheduled) {
+    flushScheduled = true;
+    tasks.add(timer.afterDelay(options.flushInterval).then([this]() {
+      flushScheduled = false;
+      startExport();
+    }));
+  }
+}
+
+void OtlpExporter::startExport() {
+  // An export in progress keeps going until the queue is empty, so it will pick up whatever was
+  // just queued.
+  if (inFlight != kj::none || (spans.empty() && logs.empty())) return;
+
+  // Clearing `inFlight` in a continuation, rather than when exportQueued() returns, ensures it
+  // isn't touched if the exporter is destroyed mid-export.
+  auto promise = exportQueued().then([this]() { inFlight = kj::none; },
+      [this](kj::Exception&& exception) {
+    inFlight = kj::none;
+    kj::throwFatalException(kj::mv(exception));
+  });
+  tasks.add(inFlight.emplace(promise.fork()).addBranch());
+}
+
+kj::Promise<void> OtlpExporter::flush() {
+  startExport();
+  KJ_IF_SOME(promise, inFlight) {
+    return promise.addBranch();
+  }
+  return kj::READY_NOW;
+}
+
+kj::Promise<void> OtlpExporter::exportQueued() {
+  while (!spans.empty() || !logs.empty()) {
+    if (!spans.empty()) {
+      auto batch = takeBatch(spans, kj::min(spans.size(), options.maxBatchSize));
+      if (co_await send("/v1/traces"_kj, encodeSpans(batch))) {
+        stats.exportedSpans += batch.size();
+      } else {
+        stats.droppedSpans += batch.size();
+      }
+    }
+    if (!logs.empty()) {
+      auto batch = takeBatch(logs, kj::min(logs.size(), options.maxBatchSize));
+      if (co_await send("/v1/logs"_kj, encodeLogs(batch))) {
+        stats.exportedLogs += batch.size();
+      } else {
+        stats.droppedLogs += batch.size();
+      }
+    }
+  }
+}
+
+kj::Promise<bool> OtlpExporter::send(kj::StringPtr path, kj::Array<kj::byte> body) {
+  try {
+    auto client = newClient();
+    kj::HttpHeaders headers(headerTable);
+    headers.setPtr(kj::HttpHeaderId::CONTENT_TYPE,
+        options.encoding == Encoding::JSON ? "application/json"_kj
+                                           : "application/x-protobuf"_kj);
+    auto url = kj::str(COLLECTOR_ORIGIN, path);
+    auto request = client->request(kj::HttpMethod::POST, url, headers, body.size());
+    co_await request.body->write(body);
+    request.body = nullptr;
+    auto response = co_await request.response;
+    // Drain the body so the connection can be reused; OTLP responses are small.
+    co_await response.body->readAllBytes();
+    if (response.statusCode / 100 == 2) {
+      co_return true;
+    }
+    ++stats.failedExports;
+    LOG_WARNING_PERIODICALLY(
+        "OTLP collector rejected export", path, response.statusCode, response.statusText);
+  } catch (...) {
+    ++stats.failedExports;
+    auto exception = kj::getCaughtExceptionAsKj();
+    LOG_WARNING_PERIODICALLY("OTLP export failed", path, exception);
+  }
+  co_return false;
+}
+
+void OtlpExporter::taskFailed(kj::Exception&& exception) {
+  LOG_EXCEPTION("otlpExporterTask", exception);
+}
+
+kj::Array<kj::byte> OtlpExporter::encodeSpans(kj::ArrayPtr<const SpanRecord> spans) const {
+  if (options.encoding == Encoding::JSON) {
+    kj::Vector<char> out;
+    out.addAll("{\"resourceSpans\":[{"_kj);
+    appendJsonResource(out, options.serviceName);
+    appendJson(out, "\"scopeSpans\":[{\"scope\":{\"name\":\"", SCOPE_NAME, "\"},\"spans\":[");
+    bool first = true;
+    for (auto& span: spans) {
+      if (!first) out.add(',');
+      first = false;
+      appendJson(out, "{\"traceId\":\"", span.traceId.toW3C(), "\",\"spanId\":\"",
+          span.spanId.toGoString(), "\",");
+      if (span.parentSpanId != tracing::SpanId::nullId) {
+        appendJson(out, "\"parentSpanId\":\"", span.parentSpanId.toGoString(), "\",");
+      }
+      out.addAll("\"name\":"_kj);
+      appendJsonString(out, span.name);
+      appendJson(out, ",\"kind\":", SPAN_KIND_INTERNAL, ",\"startTimeUnixNano\":\"",
+          toUnixNanos(span.startTime), "\",\"endTimeUnixNano\":\"", toUnixNanos(span.endTime),
+          "\",\"attributes\":[");
+      bool firstTag = true;
+      for (auto& tag: span.tags) {
+        if (!firstTag) out.add(',');
+        firstTag = false;
+        appendJsonAttribute(out, tag.key, tag.value);
+      }
+      out.addAll("]}"_kj);
+    }
+    out.addAll("]}]}]}"_kj);
+    return out.releaseAsArray().releaseAsBytes();
+  }
+
+  // ExportTraceServiceRequest
+  ProtoWriter out;
+  writeProtoResource(out, options.serviceName, [&](ProtoWriter& scopeSpans) {
+    for (auto& span: spans) {
+      scopeSpans.messageField(2, [&](ProtoWriter& s) {
+        s.bytesField(1, traceIdBytes(span.traceId));
+        s.bytesField(2, spanIdBytes(span.spanId));
+        if (span.parentSpanId != tracing::SpanId::nullId) {
+          s.bytesField(4, spanIdBytes(span.parentSpanId));
+        }
+        s.stringField(5, span.name);
+        s.varintField(6, SPAN_KIND_INTERNAL);
+        s.fixed64Field(7, toUnixNanos(span.startTime));
+        s.fixed64Field(8, toUnixNanos(span.endTime));
+        for (auto& tag: span.tags) {
+          writeProtoAttribute(s, 9, tag.key, tag.value);
+        }
+      });
+    }
+  });
+  return out.finish();
+}
+
+kj::Array<kj::byte> OtlpExporter::encodeLogs(kj::ArrayPtr<const LogRecord> logs) const {
+  if (options.encoding == Encoding::JSON) {
+    kj::Vector<char> out;
+    out.addAll("{\"resourceLogs\":[{"_kj);
+    appendJsonResource(out, options.serviceName);
+    appendJson(out, "\"scopeLogs\":[{\"scope\":{\"name\":\"", SCOPE_NAME, "\"},\"logRecords\":[");
+    bool first = true;
+    for (auto& log: logs) {
+      if (!first) out.add(',');
+      first = false;
+      appendJson(out, "{\"timeUnixNano\":\"", toUnixNanos(log.timestamp),
+          "\",\"severityNumber\":", severityNumber(log.level), ",\"severityText\":\"",
+          severityText(log.level), "\",\"body\":{\"stringValue\":");
+      appendJsonString(out, log.message);
+      out.add('}');
+      if (log.traceId != nullptr) {
+        appendJson(out, ",\"traceId\":\"", log.traceId.toW3C(), "\"");
+      }
+      out.addAll(",\"attributes\":["_kj);
+      bool firstAttribute = true;
+      for (auto& attribute: log.attributes) {
+        if (!firstAttribute) out.add(',');
+        firstAttribute = false;
+        appendJsonAttribute(out, attribute);
+      }
+      out.addAll("]}"_kj);
+    }
+    out.addAll("]}]}]}"_kj);
+    return out.releaseAsArray().releaseAsBytes();
+  }
+
+  // ExportLogsServiceRequest
+  ProtoWriter out;
+  writeProtoResource(out, options.serviceName, [&](ProtoWriter& scopeLogs) {
+    for (auto& log: logs) {
+      scopeLogs.messageField(2, [&](ProtoWriter& l) {
+        l.fixed64Field(1, toUnixNanos(log.timestamp));
+        l.varintField(2, severityNumber(log.level));
+        l.stringField(3, severityText(log.level));
+        l.messageField(5, [&](ProtoWriter& body) { body.stringField(1, log.message); });
+        for (auto& attribute: log.attributes) {
+          writeProtoAttribute(l, 6, attribute);
+        }
+        if (log.traceId != nullptr) {
+          l.bytesField(9, traceIdBytes(log.traceId));
+        }
+      });
+    }
+  });
+  return out.finish();
+}
+
+// =======================================================================================
+// OtlpTraceRecorder
+
+void OtlpTraceRecorder::start(tracing::TraceId id, kj::Maybe<tracing::TraceFlags> traceFlags) {
+  sampled = exporter->shouldSample(id, traceFlags);
+  traceId = kj::mv(id);
+}
+
+void OtlpTraceRecorder::spanOpen(tracing::SpanId spanId,
+    tracing::SpanId parentSpanId,
+    kj::ConstString operationName,
+    kj::Date startTime) {
+  if (!sampled) return;
+  openSpans.upsert(spanId.getId(),
+      OpenSpan{
+        .parentSpanId = parentSpanId,
+        .name = kj::mv(operationName),
+      });
+}
+
+void OtlpTraceRecorder::spanClose(
+    tracing::SpanId spanId, kj::Date startTime, kj::Date endTime, Span::TagMap tags) {
+  if (!sampled) return;
+  auto& open = KJ_UNWRAP_OR_RETURN(openSpans.findEntry(spanId.getId()));
+  auto span = kj::mv(open.value);
+  openSpans.erase(open);
+  exporter->addSpan({
+    .traceId = traceId,
+    .spanId = spanId,
+    .parentSpanId = span.parentSpanId,
+    .name = kj::mv(span.name),
+    .startTime = startTime,
+    .endTime = endTime,
+    .tags = kj::mv(tags),
+  });
+}
+
+void OtlpTraceRecorder::finish(const Trace& trace) {
+  openSpans.clear();
+  if (!sampled) return;
+
+  for (auto& log: trace.logs) {
+    exporter->addLog({
+      .traceId = traceId,
+      .timestamp = log.timestamp,
+      .level = log.logLevel,
+      .message = kj::str(log.message),
+    });
+  }
+  for (auto& exception: trace.exceptions) {
+    auto attributes = kj::heapArrayBuilder<tracing::Attribute>(exception.stack == kj::none ? 2 : 3);
+    attributes.add(
+        tracing::Attribute("exception.type"_kjc, kj::ConstString(kj::str(exception.name))));
+    attributes.add(
+        tracing::Attribute("exception.message"_kjc, kj::ConstString(kj::str(exception.message))));
+    KJ_IF_SOME(stack, exception.stack) {
+      attributes.add(
+          tracing::Attribute("exception.stacktrace"_kjc, kj::ConstString(kj::str(stack))));
+    }
+    exporter->addLog({
+      .traceId = traceId,
+      .timestamp = exception.timestamp,
+      .level = LogLevel::ERROR,
+      .message = kj::str(exception.name, ": ", exception.message),
+      .attributes = attributes.finish(),
+    });
+  }
+}
+
+}  // namespace workerd::server
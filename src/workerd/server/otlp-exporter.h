@@ -0,0 +1,162 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/trace.h>
+
+#include <kj/async.h>
+#include <kj/compat/http.h>
+#include <kj/function.h>
+#include <kj/map.h>
+#include <kj/refcount.h>
+#include <kj/string.h>
+#include <kj/timer.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+// Exports spans and logs to an OpenTelemetry collector over OTLP/HTTP.
+//
+// Records are handed to the exporter as plain structs when a span closes or a request finishes,
+// and are only encoded when a batch is sent, so the cost on the request path is a move into a
+// queue. A batch is sent once `maxBatchSize` records of one kind are queued, or `flushInterval`
+// after the first record was queued, whichever comes first. At most one export request is in
+// flight at a time; records arriving meanwhile wait for the next batch. When the queue is full,
+// new records are dropped, counted, and periodically warned about, rather than applying
+// backpressure to requests.
+//
+// All methods must be called on the thread that owns the event loop.
+class OtlpExporter final: public kj::Refcounted, private kj::TaskSet::ErrorHandler {
+ public:
+  enum class Encoding {
+    PROTOBUF,
+    JSON,
+  };
+
+  struct Options {
+    kj::String serviceName;
+    Encoding encoding = Encoding::PROTOBUF;
+    double samplingRatio = 1.0;
+    size_t maxBatchSize = 512;
+    size_t maxQueueSize = 2048;
+    kj::Duration flushInterval = 5 * kj::SECONDS;
+  };
+
+  struct SpanRecord {
+    tracing::TraceId traceId;
+    tracing::SpanId spanId;
+    tracing::SpanId parentSpanId;
+    kj::ConstString name;
+    kj::Date startTime;
+    kj::Date endTime;
+    Span::TagMap tags;
+  };
+
+  struct LogRecord {
+    tracing::TraceId traceId;
+    kj::Date timestamp;
+    LogLevel level;
+    kj::String message;
+    kj::Array<tracing::Attribute> attributes = nullptr;
+  };
+
+  struct Stats {
+    uint64_t exportedSpans = 0;
+    uint64_t exportedLogs = 0;
+    uint64_t droppedSpans = 0;
+    uint64_t droppedLogs = 0;
+    uint64_t failedExports = 0;
+  };
+
+  // `newClient` is called to obtain an HTTP client for each export request.
+  OtlpExporter(kj::Timer& timer,
+      const kj::HttpHeaderTable& headerTable,
+      kj::Function<kj::Own<kj::HttpClient>()> newClient,
+      Options options);
+  ~OtlpExporter() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(OtlpExporter);
+
+  // Head-based sampling decision for a trace. An upstream decision carried in `traceFlags` wins;
+  // otherwise the trace is kept if its ID falls below `samplingRatio` of the ID space, which
+  // makes the decision deterministic for a given trace ID.
+  bool shouldSample(const tracing::TraceId& traceId, kj::Maybe<tracing::TraceFlags> traceFlags);
+
+  void addSpan(SpanRecord record);
+  void addLog(LogRecord record);
+
+  // Sends everything queued so far, resolving once the queue has been drained (or the exports
+  // failed). Server::run() calls this on every exporter once the server has drained.
+  kj::Promise<void> flush();
+
+  const Stats& getStats() const {
+    return stats;
+  }
+
+  // Encode an export request body. Exposed for testing.
+  kj::Array<kj::byte> encodeSpans(kj::ArrayPtr<const SpanRecord> spans) const;
+  kj::Array<kj::byte> encodeLogs(kj::ArrayPtr<const LogRecord> logs) const;
+
+ private:
+  kj::Timer& timer;
+  const kj::HttpHeaderTable& headerTable;
+  kj::Function<kj::Own<kj::HttpClient>()> newClient;
+  Options options;
+  Stats stats;
+
+  kj::Vector<SpanRecord> spans;
+  kj::Vector<LogRecord> logs;
+
+  // True while a timer is armed to flush the queue.
+  bool flushScheduled = false;
+
+  // Set while an export is in flight. Forked so that flush() can wait on it.
+  kj::Maybe<kj::ForkedPromise<void>> inFlight;
+
+  kj::TaskSet tasks;
+
+  void recordQueued(size_t queued);
+  void startExport();
+  kj::Promise<void> exportQueued();
+  kj::Promise<bool> send(kj::StringPtr path, kj::Array<kj::byte> body);
+
+  void taskFailed(kj::Exception&& exception) override;
+};
+
+// Collects the spans and logs of one request for an OtlpExporter. The sampling decision is made
+// in `start()`, once the request's trace ID is known; for an unsampled request every other
+// method is a no-op.
+class OtlpTraceRecorder final: public kj::Refcounted {
+ public:
+  explicit OtlpTraceRecorder(kj::Own<OtlpExporter> exporter): exporter(kj::mv(exporter)) {}
+  KJ_DISALLOW_COPY_AND_MOVE(OtlpTraceRecorder);
+
+  void start(tracing::TraceId traceId, kj::Maybe<tracing::TraceFlags> traceFlags);
+
+  bool isSampled() const {
+    return sampled;
+  }
+
+  void spanOpen(tracing::SpanId spanId,
+      tracing::SpanId parentSpanId,
+      kj::ConstString operationName,
+      kj::Date startTime);
+  void spanClose(tracing::SpanId spanId, kj::Date startTime, kj::Date endTime, Span::TagMap tags);
+
+  // Queues the request's logs and exceptions. Spans still open at this point are discarded.
+  void finish(const Trace& trace);
+
+ private:
+  struct OpenSpan {
+    tracing::SpanId parentSpanId;
+    kj::ConstString name;
+  };
+
+  kj::Own<OtlpExporter> exporter;
+  tracing::TraceId traceId = nullptr;
+  bool sampled = false;
+  kj::HashMap<uint64_t, OpenSpan> openSpans;
+};
+
+}  // namespace workerd::server
@@ -6,11 +6,13 @@
 
 #include "alarm-scheduler.h"
 #include "container-client.h"
+#include "otlp-exporter.h"
 #include "pyodide.h"
 #include "workerd-api.h"
 
 #include <workerd/api/actor-state.h>
 #include <workerd/api/analytics-engine.capnp.h>
+#include <workerd/api/headers.h>
 #include <workerd/api/pyodide/pyodide.h>
 #include <workerd/api/trace.h>
 #include <workerd/api/worker-rpc.h>
@@ -21,6 +23,7 @@
 #include <workerd/io/bundle-fs.h>
 #include <workerd/io/compatibility-date.h>
 #include <workerd/io/container.capnp.h>
+#include <workerd/io/disk-fs.h>
 #include <workerd/io/features.h>
 #include <workerd/io/io-context.h>
 #include <workerd/io/legacy-hibernation-manager.h>
@@ -35,10 +38,14 @@
 #include <workerd/server/facet-tree-index.h>
 #include <workerd/server/fallback-service.h>
 #include <workerd/util/exception.h>
+#include <workerd/util/header-validation.h>
 #include <workerd/util/http-util.h>
 #include <workerd/util/mimetype.h>
+#include <workerd/util/sqlite-checkpointer.h>
+#include <workerd/util/sqlite-pcache.h>
 #include <workerd/util/stream-utils.h>
 #include <workerd/util/strings.h>
+#include <workerd/util/thread-pool.h>
 #include <workerd/util/use-perfetto-categories.h>
 #include <workerd/util/uuid.h>
 #include <workerd/util/websocket-error-handler.h>
@@ -56,6 +63,7 @@
 #include <kj/encoding.h>
 #include <kj/glob-filter.h>
 #include <kj/map.h>
+#include <kj/thread.h>
 
 #include <cstdlib>
 #include <ctime>
@@ -356,6 +364,35 @@ Server::~Server() noexcept {
 
 // =======================================================================================
 
+namespace {
+
+ContainerPrivileges parseContainerPrivileges(
+    config::Worker::DurableObjectNamespace::ContainerOptions::ContainerPrivileges::Reader conf) {
+  auto capabilities = kj::heapArrayBuilder<kj::String>(conf.getCapabilities().size());
+  for (auto capability: conf.getCapabilities()) {
+    capabilities.add(kj::str(capability));
+  }
+  auto devices = kj::heapArrayBuilder<ContainerPrivileges::Device>(conf.getDevices().size());
+  for (auto device: conf.getDevices()) {
+    devices.add(ContainerPrivileges::Device{
+      .pathOnHost = kj::str(device.getPathOnHost()),
+      .pathInContainer = kj::str(device.getPathInContainer()),
+      .cgroupPermissions = kj::str(device.getCgroupPermissions()),
+    });
+  }
+  auto securityOpt = kj::heapArrayBuilder<kj::String>(conf.getSecurityOpt().size());
+  for (auto option: conf.getSecurityOpt()) {
+    securityOpt.add(kj::str(option));
+  }
+  return ContainerPrivileges{
+    .capabilities = capabilities.finish(),
+    .devices = devices.finish(),
+    .securityOpt = securityOpt.finish(),
+  };
+}
+
+}  // namespace
+
 class Server::ActorNamespace final {
  public:
   friend class Server;
@@ -383,11 +420,18 @@ class Server::ActorNamespace final {
         waitUntilTasks(waitUntilTasks),
         selfTokensArePersistent(selfTokensArePersistent) {}
 
-  void link(kj::Maybe<const kj::Directory&> serviceActorStorage) {
+  void link(kj::Maybe<const kj::Directory&> serviceActorStorage,
+      kj::Maybe<SqliteCheckpointer&> serviceCheckpointer) {
     KJ_IF_SOME(dir, serviceActorStorage) {
       KJ_IF_SOME(d, config.tryGet<Durable>()) {
         this->actorStorage.emplace(
             dir.openSubdir(kj::Path({d.uniqueKey}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY));
+
+        KJ_IF_SOME(options, d.sqliteOptions) {
+          if (options.getBackgroundCheckpoint()) {
+            sqliteCheckpointer = serviceCheckpointer;
+          }
+        }
       }
     }
 
@@ -421,6 +465,24 @@ class Server::ActorNamespace final {
     }
   }
 
+  // Starts filling this namespace's warm container pool, if the config asks for one.
+  void startContainerWarmPool(bool containersPidNamespace) {
+    auto& durable = KJ_UNWRAP_OR(config.tryGet<Durable>(), return);
+    auto options = KJ_UNWRAP_OR(durable.containerOptions, return);
+    if (options.getWarmPoolSize() == 0) return;
+
+    // Without a container engine, start() will report the problem when it's first called.
+    auto path = KJ_UNWRAP_OR(dockerPath, return);
+    auto sidecarImage = KJ_UNWRAP_OR(containerEgressInterceptorImage, return);
+
+    auto pool = kj::heap<ContainerWarmPool>(timer, getDockerApiClient(path),
+        kj::str("workerd-", durable.uniqueKey), kj::str(options.getImageName()),
+        kj::str(sidecarImage), parseContainerPrivileges(options.getPrivileges()),
+        containersPidNamespace, options.getWarmPoolSize(), waitUntilTasks);
+    pool->fill();
+    warmPool = kj::mv(pool);
+  }
+
   const ActorConfig& getConfig() {
     return config;
   }
@@ -713,6 +775,30 @@ class Server::ActorNamespace final {
       }
     }
 
+    // Returns the live actor's SQL statement stats, if it is running and collecting them.
+    kj::Maybe<SqliteStatementStats&> getSqlStatementStats() {
+      KJ_IF_SOME(a, actor) {
+        KJ_IF_SOME(cache, a->getPersistent()) {
+          KJ_IF_SOME(db, cache.getSqliteDatabase()) {
+            return db.getStatementStats();
+          }
+        }
+      }
+      return kj::none;
+    }
+
+    // Returns the live actor's SQLite page cache stats, if it is running and SQLite-backed.
+    kj::Maybe<SqliteDatabase::PageCacheStats> getSqlitePageCacheStats() {
+      KJ_IF_SOME(a, actor) {
+        KJ_IF_SOME(cache, a->getPersistent()) {
+          KJ_IF_SOME(db, cache.getSqliteDatabase()) {
+            return db.getPageCacheStats();
+          }
+        }
+      }
+      return kj::none;
+    }
+
     kj::Own<ActorContainer> getFacetContainer(
         kj::String childKey, kj::Function<kj::Promise<StartInfo>()> getStartInfo) {
       auto makeContainer = [&]() {
@@ -914,6 +1000,38 @@ class Server::ActorNamespace final {
       }
     }
 
+    // Applies the namespace's `sqlite` tuning options to a newly-opened (or reset) database.
+    static void configureSqlite(SqliteDatabase& db, const Durable& d) {
+      using Synchronous = config::Worker::DurableObjectNamespace::SqliteOptions::Synchronous;
+      auto options = KJ_UNWRAP_OR(d.sqliteOptions, return);
+
+      if (auto kib = options.getCacheSizeKib(); kib > 0) {
+        // A negative cache_size is in KiB rather than pages.
+        db.run(SqliteDatabase::QueryOptions{.regulator = SqliteDatabase::TRUSTED},
+            kj::str("PRAGMA cache_size=-", kib, ";"));
+      }
+      if (auto bytes = options.getMmapSizeBytes(); bytes > 0) {
+        db.run(SqliteDatabase::QueryOptions{.regulator = SqliteDatabase::TRUSTED},
+            kj::str("PRAGMA mmap_size=", bytes, ";"));
+      }
+      switch (options.getSynchronous()) {
+        case Synchronous::UNSPECIFIED:
+          break;
+        case Synchronous::OFF:
+          db.run("PRAGMA synchronous=OFF;");
+          break;
+        case Synchronous::NORMAL:
+          db.run("PRAGMA synchronous=NORMAL;");
+          break;
+        case Synchronous::FULL:
+          db.run("PRAGMA synchronous=FULL;");
+          break;
+        case Synchronous::EXTRA:
+          db.run("PRAGMA synchronous=EXTRA;");
+          break;
+      }
+    }
+
     void deleteFacetImpl(const kj::Directory& dir, FacetTreeIndex& index, uint facetId) {
       deleteDescendantStorage(dir, index, facetId);
 
@@ -1263,14 +1381,24 @@ class Server::ActorNamespace final {
             uint selfId = getFacetId();
             auto path = getSqlitePathForId(selfId);
             auto db = kj::heap<SqliteDatabase>(
-                as.vfs, kj::mv(path), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+                as.vfs, path.clone(), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
 
             // Before we do anything, make sure the database is in WAL mode. We also need to
             // do this after reset() is used, so register a callback for that.
             db->run("PRAGMA journal_mode=WAL;");
+            configureSqlite(*db, d);
+
+            if (d.sqlStatementStats) {
+              db->enableStatementStats();
+            }
+
+            KJ_IF_SOME(checkpointer, ns.sqliteCheckpointer) {
+              checkpointer.add(*db, as.vfs, kj::mv(path));
+            }
 
-            db->afterReset([this, &dir = *as.directory, selfId](SqliteDatabase& db) {
+            db->afterReset([this, &d, &dir = *as.directory, selfId](SqliteDatabase& db) {
               db.run("PRAGMA journal_mode=WAL;");
+              configureSqlite(db, d);
 
               // reset() is used when the app called deleteAll(), in which case we also want to
               // delete all child facets.
@@ -1323,31 +1451,7 @@ class Server::ActorNamespace final {
       KJ_IF_SOME(config, containerOptions) {
         KJ_ASSERT(config.hasImageName(), "Image name is required");
         auto imageName = config.getImageName();
-        auto privilegeConfig = config.getPrivileges();
-        auto capabilities =
-            kj::heapArrayBuilder<kj::String>(privilegeConfig.getCapabilities().size());
-        for (auto capability: privilegeConfig.getCapabilities()) {
-          capabilities.add(kj::str(capability));
-        }
-        auto devices =
-            kj::heapArrayBuilder<ContainerPrivileges::Device>(privilegeConfig.getDevices().size());
-        for (auto device: privilegeConfig.getDevices()) {
-          devices.add(ContainerPrivileges::Device{
-            .pathOnHost = kj::str(device.getPathOnHost()),
-            .pathInContainer = kj::str(device.getPathInContainer()),
-            .cgroupPermissions = kj::str(device.getCgroupPermissions()),
-          });
-        }
-        auto securityOpt =
-            kj::heapArrayBuilder<kj::String>(privilegeConfig.getSecurityOpt().size());
-        for (auto option: privilegeConfig.getSecurityOpt()) {
-          securityOpt.add(kj::str(option));
-        }
-        ContainerPrivileges privileges{
-          .capabilities = capabilities.finish(),
-          .devices = devices.finish(),
-          .securityOpt = securityOpt.finish(),
-        };
+        auto privileges = parseContainerPrivileges(config.getPrivileges());
         kj::String containerId;
         KJ_SWITCH_ONEOF(id) {
           KJ_CASE_ONEOF(globalId, kj::Own<ActorIdFactory::ActorId>) {
@@ -1415,6 +1519,23 @@ class Server::ActorNamespace final {
     })->addRef();
   }
 
+  // Like getActorContainer() but never starts the actor. `key` is the actor's hex ID for Durable
+  // Objects or its name for ephemeral actors.
+  kj::Maybe<ActorContainer&> findActorContainer(kj::StringPtr key) {
+    return actors.find(key).map([](kj::Own<ActorContainer>& c) -> ActorContainer& { return *c; });
+  }
+
+  // Returns a reference to the Docker API client shared by this namespace's containers, so that
+  // they all reuse the same keep-alive connections to the container engine.
+  kj::Own<DockerApiClient> getDockerApiClient(kj::StringPtr path) {
+    KJ_IF_SOME(client, dockerApiClient) {
+      return client->addRef();
+    }
+    auto& client = dockerApiClient.emplace(
+        kj::refcounted<DockerApiClient>(timer, dockerNetwork, kj::str(path)));
+    return client->addRef();
+  }
+
   kj::Own<ContainerClient> getContainerClient(
       kj::StringPtr containerId, kj::StringPtr imageName, ContainerPrivileges privileges) {
     KJ_IF_SOME(existingClient, containerClients.find(containerId)) {
@@ -1471,11 +1592,12 @@ class Server::ActorNamespace final {
     };
 
     auto client = kj::refcounted<ContainerClient>(byteStreamFactory, timer, dockerNetwork,
-        kj::str(dockerPathRef), kj::str(containerId), kj::str(imageName),
+        getDockerApiClient(dockerPathRef), kj::str(containerId), kj::str(imageName),
         kj::str(KJ_ASSERT_NONNULL(containerEgressInterceptorImage,
             "containerEgressInterceptorImage must be configured for containers.")),
         waitUntilTasks, kj::mv(previousCleanup), kj::mv(cleanupCallback), channelTokenHandler,
-        kj::mv(privileges));
+        kj::mv(privileges),
+        warmPool.map([](kj::Own<ContainerWarmPool>& pool) -> ContainerWarmPool& { return *pool; }));
 
     // Store raw pointer in map (does not own)
     containerClients.insert(kj::str(containerId), client.get());
@@ -1544,6 +1666,9 @@ class Server::ActorNamespace final {
   kj::Maybe<ActorStorage> actorStorage;
   kj::Maybe<kj::Own<AlarmScheduler>> ownAlarmScheduler;
 
+  // Set if this namespace's databases are checkpointed in the background.
+  kj::Maybe<SqliteCheckpointer&> sqliteCheckpointer;
+
   // Tracks the canceler and cleanup promise for a Docker container's lifecycle cleanup.
   // Useful to await on async calls of a ContainerClient destructor when the new
   // one appears before they've been resolved.
@@ -1566,6 +1691,13 @@ class Server::ActorNamespace final {
   // Per-container cleanup state: canceler + forked cleanup promise.
   kj::HashMap<kj::String, ContainerCleanupState> containerCleanupState;
 
+  // Created on first use by getDockerApiClient().
+  kj::Maybe<kj::Own<DockerApiClient>> dockerApiClient;
+
+  // Pre-started containers handed out by ContainerClient::start(). Declared before `actors`
+  // since their ContainerClients refer to it.
+  kj::Maybe<kj::Own<ContainerWarmPool>> warmPool;
+
   // Map of container IDs to ContainerClients (for reconnection support with inactivity timeouts).
   // The map holds raw pointers (not ownership) - ContainerClients are owned by actors and timers.
   // When the last reference is dropped, the destructor removes the entry from this map.
@@ -1848,6 +1980,7 @@ class Server::HttpRewriter {
     if (httpOptions.hasCapnpConnectHost()) {
       capnpConnectHost = httpOptions.getCapnpConnectHost();
     }
+    http2 = httpOptions.getHttp2();
   }
 
   bool hasCfBlobHeader() {
@@ -1939,11 +2072,16 @@ class Server::HttpRewriter {
     return capnpConnectHost;
   }
 
+  bool acceptsHttp2() {
+    return http2;
+  }
+
  private:
   config::HttpOptions::Style style;
   kj::Maybe<kj::HttpHeaderId> forwardedProtoHeader;
   kj::Maybe<kj::HttpHeaderId> cfBlobHeader;
   kj::Maybe<kj::StringPtr> capnpConnectHost;
+  bool http2 = false;
 
   class HeaderInjector {
    public:
@@ -2035,6 +2173,13 @@ class Server::InvalidConfigActorClass final: public ActorClass {
   }
 };
 
+SqliteCheckpointer& Server::getSqliteCheckpointer() {
+  KJ_IF_SOME(checkpointer, sqliteCheckpointer) {
+    return *checkpointer;
+  }
+  return *sqliteCheckpointer.emplace(kj::heap<SqliteCheckpointer>());
+}
+
 // Return a fake Own pointing to the singleton.
 kj::Own<Server::Service> Server::makeInvalidConfigService() {
   return {invalidConfigServiceSingleton.get(), kj::NullDisposer::instance};
@@ -2529,6 +2674,18 @@ class Server::DiskDirectoryService final: public Service, private WorkerInterfac
     return writable;
   }
 
+  // Returns a directory exposing this service's content within a Worker's virtual file system.
+  // The result is only writable if both the service and the mount are defined as writable.
+  kj::Rc<Directory> newVfsDirectory(bool mountWritable) {
+    DiskDirectoryOptions options{.allowDotfiles = allowDotfiles};
+    if (mountWritable) {
+      KJ_IF_SOME(dir, writable) {
+        return newDiskDirectory(dir.clone(), options);
+      }
+    }
+    return newDiskDirectory(readable->clone(), options);
+  }
+
   bool hasHandler(kj::StringPtr handlerName) override {
     return handlerName == "fetch"_kj;
   }
@@ -3200,11 +3357,25 @@ class RequestObserverWithTracer final: public RequestObserver, public WorkerInte
 
 class SequentialSpanSubmitter final: public SpanSubmitter {
  public:
-  SequentialSpanSubmitter(kj::Own<BaseTracer::WeakRef> weakTracer, kj::EntropySource& entropySource)
+  // If `otlpRecorder` is given, spans are also recorded for OTLP export. `tracerNeedsTags`
+  // indicates whether the tracer consumes span tags (i.e. there are streaming tail workers); if
+  // not, the recorder takes the tags without copying them.
+  SequentialSpanSubmitter(kj::Own<BaseTracer::WeakRef> weakTracer,
+      kj::EntropySource& entropySource,
+      kj::Maybe<kj::Own<OtlpTraceRecorder>> otlpRecorder = kj::none,
+      bool tracerNeedsTags = true)
       : weakTracer(kj::mv(weakTracer)),
-        entropySource(entropySource) {}
+        entropySource(entropySource),
+        otlpRecorder(kj::mv(otlpRecorder)),
+        tracerNeedsTags(tracerNeedsTags) {}
   void submitSpanClose(
       tracing::SpanId spanId, kj::Date startTime, kj::Date endTime, Span::TagMap&& tags) override {
+    KJ_IF_SOME(recorder, otlpRecorder) {
+      if (recorder->isSampled()) {
+        recorder->spanClose(
+            spanId, startTime, endTime, tracerNeedsTags ? cloneTags(tags) : kj::mv(tags));
+      }
+    }
     weakTracer->runIfAlive([&](BaseTracer& tracer) {
       tracing::SpanEndData spanEnd(spanId, endTime, kj::mv(tags));
       if (isPredictableModeForTest()) {
@@ -3220,6 +3391,11 @@ class SequentialSpanSubmitter final: public SpanSubmitter {
       kj::ConstString operationName,
       kj::Date startTime) override {
     bool submitted = false;
+    KJ_IF_SOME(recorder, otlpRecorder) {
+      if (recorder->isSampled()) {
+        recorder->spanOpen(spanId, parentSpanId, operationName.clone(), startTime);
+      }
+    }
     weakTracer->runIfAlive([&](BaseTracer& tracer) {
       if (isPredictableModeForTest()) {
         startTime = kj::UNIX_EPOCH;
@@ -3242,6 +3418,17 @@ class SequentialSpanSubmitter final: public SpanSubmitter {
   uint64_t nextSpanId = 1;
   kj::Own<BaseTracer::WeakRef> weakTracer;
   kj::EntropySource& entropySource;
+  kj::Maybe<kj::Own<OtlpTraceRecorder>> otlpRecorder;
+  bool tracerNeedsTags;
+
+  static Span::TagMap cloneTags(const Span::TagMap& tags) {
+    Span::TagMap result;
+    result.reserve(tags.size());
+    for (auto& tag: tags) {
+      result.insert(tag.key.clone(), spanTagClone(tag.value));
+    }
+    return result;
+  }
 };
 
 // IsolateLimitEnforcer that enforces no limits.
@@ -3403,8 +3590,10 @@ class Server::WorkerService final: public Service,
     kj::Array<kj::Own<IoChannelFactory::RpcChannel>> rpc;
     kj::Maybe<kj::Own<IoChannelFactory::SubrequestChannel>> cache;
     kj::Maybe<const kj::Directory&> actorStorage;
+    kj::Maybe<SqliteCheckpointer&> sqliteCheckpointer;
     kj::Array<kj::Own<IoChannelFactory::SubrequestChannel>> tails;
     kj::Array<kj::Own<IoChannelFactory::SubrequestChannel>> streamingTails;
+    kj::Maybe<kj::Own<OtlpExporter>> otlpExporter;
     kj::Array<kj::Rc<WorkerLoaderNamespace>> workerLoaders;
     kj::Maybe<kj::Network&> workerdDebugPortNetwork;
     kj::Maybe<Server&> workerdDebugPortServer;
@@ -3602,8 +3791,11 @@ class Server::WorkerService final: public Service,
         kj::mv(KJ_REQUIRE_NONNULL(ioChannels.tryGet<LinkCallback>(), "already called link()"));
     auto linked = callback(*this, errorReporter);
 
+    bool containersPidNamespace =
+        worker->getIsolate().getApi().getFeatureFlags().getContainersPidNamespace();
     for (auto& ns: actorNamespaces) {
-      ns.value->link(linked.actorStorage);
+      ns.value->link(linked.actorStorage, linked.sqliteCheckpointer);
+      ns.value->startContainerWarmPool(containersPidNamespace);
     }
 
     ioChannels = kj::mv(linked);
@@ -3864,11 +4056,19 @@ class Server::WorkerService final: public Service,
       }
     }
 
+    kj::Maybe<kj::Own<OtlpTraceRecorder>> otlpRecorder;
+    KJ_IF_SOME(exporter, channels.otlpExporter) {
+      if (entrypointName.orDefault("") != "test"_kj) {
+        otlpRecorder = kj::refcounted<OtlpTraceRecorder>(kj::addRef(*exporter));
+      }
+    }
+    bool hasStreamingTails = !streamingTailWorkers.empty();
+
     kj::Maybe<kj::Own<WorkerTracer>> workerTracer = kj::none;
 
-    if (!bufferedTailWorkers.empty() || !streamingTailWorkers.empty()) {
-      // Setting up buffered tail workers support, but only if we actually have tail workers
-      // configured.
+    if (!bufferedTailWorkers.empty() || hasStreamingTails || otlpRecorder != kj::none) {
+      // Setting up buffered tail workers support, but only if we actually have tail workers (or
+      // an OTLP exporter) configured.
       auto executionModel =
           actor == kj::none ? ExecutionModel::STATELESS : ExecutionModel::DURABLE_OBJECT;
       kj::Maybe<kj::String> durableObjectId = kj::none;
@@ -3895,10 +4095,14 @@ class Server::WorkerService final: public Service,
       // creating two references to the WorkerTracer, one held by the observer and one that will be
       // passed to the IoContext. This ensures that the tracer lives long enough to receive all
       // events.
-      if (!bufferedTailWorkers.empty()) {
+      if (!bufferedTailWorkers.empty() || otlpRecorder != kj::none) {
         waitUntilTasks.add(tracer->onComplete().then(
-            kj::coCapture([tailWorkers = bufferedTailWorkers.releaseAsArray()](
+            kj::coCapture([tailWorkers = bufferedTailWorkers.releaseAsArray(),
+                              otlpRecorder = mapAddRef(otlpRecorder)](
                               kj::Own<Trace> trace) mutable -> kj::Promise<void> {
+          KJ_IF_SOME(recorder, otlpRecorder) {
+            recorder->finish(*trace);
+          }
           for (auto& worker: tailWorkers) {
             auto event = kj::heap<workerd::api::TraceCustomEvent>(
                 workerd::api::TraceCustomEvent::TYPE, kj::arr(kj::addRef(*trace)));
@@ -3912,11 +4116,16 @@ class Server::WorkerService final: public Service,
 
     KJ_IF_SOME(w, workerTracer) {
       w->setMakeUserRequestSpanFunc(
-          [&w = *w, &entropySource = threadContext.getEntropySource()](
-              tracing::TraceId traceId, kj::Maybe<tracing::TraceFlags> traceFlags) {
+          [&w = *w, &entropySource = threadContext.getEntropySource(),
+              otlpRecorder = kj::mv(otlpRecorder), hasStreamingTails](
+              tracing::TraceId traceId, kj::Maybe<tracing::TraceFlags> traceFlags) mutable {
+        KJ_IF_SOME(recorder, otlpRecorder) {
+          recorder->start(traceId, traceFlags);
+        }
         return SpanParent(kj::refcounted<UserSpanObserver>(
-            kj::refcounted<SequentialSpanSubmitter>(w.getWeakRef(), entropySource), kj::mv(traceId),
-            traceFlags));
+            kj::refcounted<SequentialSpanSubmitter>(
+                w.getWeakRef(), entropySource, mapAddRef(otlpRecorder), hasStreamingTails),
+            kj::mv(traceId), traceFlags));
       });
     }
     kj::Own<RequestObserver> observer =
@@ -5083,6 +5292,13 @@ struct Server::WorkerDef {
 
   // ServiceDesignator for the access binding worker. Resolved during linkCallback.
   kj::Maybe<config::ServiceDesignator::Reader> accessBindingServiceDesignator;
+
+  // Host directories to mount into the worker's virtual file system. The referenced disk
+  // services are validated during linkCallback.
+  capnp::List<config::Worker::FileSystemMount>::Reader fileSystemMounts;
+
+  // OpenTelemetry export settings. The collector service is resolved during linkCallback.
+  kj::Maybe<config::Worker::OtlpExporter::Reader> otlpExporterConf;
 };
 
 class Server::WorkerLoaderNamespace: public kj::Refcounted, private kj::TaskSet::ErrorHandler {
@@ -5626,6 +5842,13 @@ kj::Promise<kj::Own<Server::Service>> Server::makeWorker(kj::StringPtr name,
     if (!conf.hasAccessBindingService()) return kj::none;
     return conf.getAccessBindingService();
   }(),
+
+    .fileSystemMounts = conf.getFileSystemMounts(),
+
+    .otlpExporterConf = [&]() -> kj::Maybe<config::Worker::OtlpExporter::Reader> {
+    if (!conf.hasOtlpExporter()) return kj::none;
+    return conf.getOtlpExporter();
+  }(),
   };
 
   co_return co_await makeWorkerImpl(name, kj::mv(def), extensions, errorReporter);
@@ -5647,7 +5870,70 @@ kj::Promise<kj::Own<Server::WorkerService>> Server::makeWorkerImpl(kj::StringPtr
   // TODO(node-fs): This is set up to allow users to configure the "mount"
   // points for known roots but we currently do not expose that in the
   // config. So for now this just uses the defaults.
-  auto workerFs = newWorkerFileSystem(kj::heap<FsMap>(), getBundleDirectory(def.source));
+  auto fsMap = kj::heap<FsMap>();
+
+  // Host directory mounts are resolved lazily because the disk services they refer to may not
+  // have been constructed yet. By the time the worker first touches the file system, all services
+  // have been linked; a misconfigured mount (reported by the link callback) is left empty.
+  kj::Vector<VfsMount> fsMounts;
+  if (def.fileSystemMounts.size() > 0) {
+    if (!experimental) {
+      errorReporter.addError(kj::str("Worker \"", name,
+          "\" configures fileSystemMounts, which is an experimental feature. "
+          "You must run workerd with `--experimental` to use this feature."));
+    } else {
+      kj::Path reserved[] = {fsMap->getBundlePath(), fsMap->getTempPath(), fsMap->getDevPath()};
+      auto overlaps = [](kj::PathPtr a, kj::PathPtr b) {
+        return a.startsWith(b) || b.startsWith(a);
+      };
+
+      for (auto mount: def.fileSystemMounts) {
+        kj::StringPtr pathStr = mount.getPath();
+        kj::Maybe<kj::Path> maybePath;
+        if (pathStr.startsWith("/")) {
+          KJ_IF_SOME(exception,
+              kj::runCatchingExceptions([&]() { maybePath = kj::Path::parse(pathStr.slice(1)); })) {
+            (void)exception;  // squash compiler warning about unused var
+          }
+        }
+        auto& path = KJ_UNWRAP_OR(maybePath, {
+          errorReporter.addError(kj::str("Worker \"", name, "\" has a fileSystemMounts entry \"",
+              pathStr, "\" that is not a valid absolute path."));
+          continue;
+        });
+
+        bool valid = path.size() > 0;
+        for (auto& root: reserved) {
+          if (overlaps(path, root)) valid = false;
+        }
+        for (auto& other: fsMounts) {
+          if (overlaps(path, other.path)) valid = false;
+        }
+        if (!valid) {
+          errorReporter.addError(kj::str("Worker \"", name, "\" has a fileSystemMounts entry \"",
+              pathStr, "\" that overlaps the root, a built-in directory, or another mount."));
+          continue;
+        }
+
+        fsMounts.add(VfsMount{
+          .path = kj::mv(path),
+          .directory = getLazyDirectoryImpl(
+              [this, disk = kj::str(mount.getDisk()), writable = mount.getWritable()]()
+                  -> kj::Rc<Directory> {
+            KJ_IF_SOME(svc, services.find(disk)) {
+              KJ_IF_SOME(diskSvc, kj::tryDowncast<DiskDirectoryService>(*svc)) {
+                return diskSvc.newVfsDirectory(writable);
+              }
+            }
+            return Directory::newEmptyReadonly();
+          }),
+        });
+      }
+    }
+  }
+
+  auto workerFs = newWorkerFileSystem(kj::mv(fsMap), getBundleDirectory(def.source),
+      kj::heap<VirtualFileSystem::Observer>(), fsMounts.releaseAsArray());
 
   // Note: Python workers do not support the new module registry;
   // isNewModuleRegistryEnabled() returns false for them regardless of the
@@ -5714,8 +6000,16 @@ kj::Promise<kj::Own<Server::WorkerService>> Server::makeWorkerImpl(kj::StringPtr
       def.source.variant.is<WorkerSource::ScriptSource>() && !usingNewModuleRegistry
       ? Worker::ConsoleMode::INSPECTOR_ONLY
       : loggingOptions.consoleMode;
+  Worker::Isolate::Diagnostics diagnostics{
+    .stallDetector = stallDetector.map(
+        [](kj::Own<StallDetector>& detector) -> const StallDetector& { return *detector; }),
+    .cpuProfiler = cpuProfiler.map([](kj::Own<ContinuousCpuProfiler>& profiler)
+                                       -> const ContinuousCpuProfiler& { return *profiler; }),
+    .heapMonitor = heapMonitor.map(
+        [](kj::Own<HeapMonitor>& monitor) -> const HeapMonitor& { return *monitor; }),
+  };
   auto isolate = kj::atomicRefcounted<Worker::Isolate>(kj::mv(api), kj::mv(observer), name,
-      kj::mv(limitEnforcer), inspectorPolicy, kj::mv(isolateLoggingOptions));
+      kj::mv(limitEnforcer), inspectorPolicy, kj::mv(isolateLoggingOptions), diagnostics);
 
   // If we are using the inspector, we need to register the Worker::Isolate
   // with the inspector service.
@@ -5872,7 +6166,41 @@ kj::Promise<kj::Own<Server::WorkerService>> Server::makeWorkerImpl(kj::StringPtr
   auto abortIsolateCallback = kj::mv(def.abortIsolateCallback);
   auto accessBlobHeaderName = kj::mv(def.accessBlobHeaderName);
 
-  auto linkCallback = [this, def = kj::mv(def), totalActorChannels](WorkerService& workerService,
+  // The OTLP exporter itself is created by the link callback, once the collector service can be
+  // looked up.
+  kj::Maybe<OtlpExporter::Options> otlpOptions;
+  KJ_IF_SOME(otlpConf, def.otlpExporterConf) {
+    double samplingRatio = otlpConf.getSamplingRatio();
+    if (!experimental) {
+      errorReporter.addError(kj::str("Worker \"", name,
+          "\" configures otlpExporter, which is an experimental feature. "
+          "You must run workerd with `--experimental` to use this feature."));
+    } else if (!otlpConf.hasCollector()) {
+      errorReporter.addError(
+          kj::str("Worker \"", name, "\" has an otlpExporter with no collector service."));
+    } else if (!(samplingRatio >= 0.0 && samplingRatio <= 1.0)) {
+      errorReporter.addError(kj::str("Worker \"", name,
+          "\" has an otlpExporter samplingRatio that is not between 0 and 1."));
+    } else if (otlpConf.getMaxBatchSize() == 0) {
+      errorReporter.addError(
+          kj::str("Worker \"", name, "\" has an otlpExporter maxBatchSize of zero."));
+    } else {
+      otlpOptions = OtlpExporter::Options{
+        .serviceName = otlpConf.hasServiceName() ? kj::str(otlpConf.getServiceName())
+                                                 : kj::str(name),
+        .encoding = otlpConf.getEncoding() == config::Worker::OtlpExporter::Encoding::JSON
+            ? OtlpExporter::Encoding::JSON
+            : OtlpExporter::Encoding::PROTOBUF,
+        .samplingRatio = samplingRatio,
+        .maxBatchSize = otlpConf.getMaxBatchSize(),
+        .maxQueueSize = otlpConf.getMaxQueueSize(),
+        .flushInterval = otlpConf.getFlushIntervalMs() * kj::MILLISECONDS,
+      };
+    }
+  }
+
+  auto linkCallback = [this, def = kj::mv(def), totalActorChannels,
+                          otlpOptions = kj::mv(otlpOptions)](WorkerService& workerService,
                           Worker::ValidationErrorReporter& errorReporter) mutable {
     WorkerService::LinkedIoChannels result;
 
@@ -5990,6 +6318,18 @@ kj::Promise<kj::Own<Server::WorkerService>> Server::makeWorkerImpl(kj::StringPtr
         KJ_IF_SOME(diskSvc, kj::tryDowncast<DiskDirectoryService>(*svc)) {
           KJ_IF_SOME(dir, diskSvc.getWritable()) {
             result.actorStorage = dir;
+
+            // Only start the checkpointer thread if some namespace will use it.
+            for (auto& entry: def.localActorConfigs) {
+              KJ_IF_SOME(d, entry.value.tryGet<Durable>()) {
+                KJ_IF_SOME(options, d.sqliteOptions) {
+                  if (options.getBackgroundCheckpoint()) {
+                    result.sqliteCheckpointer = getSqliteCheckpointer();
+                    break;
+                  }
+                }
+              }
+            }
           } else {
             errorReporter.addError(
                 kj::str("durableObjectStorage config refers to the disk service \"", diskName,
@@ -6005,10 +6345,44 @@ kj::Promise<kj::Own<Server::WorkerService>> Server::makeWorkerImpl(kj::StringPtr
       }
     }
 
+    for (auto mount: def.fileSystemMounts) {
+      kj::StringPtr diskName = mount.getDisk();
+      KJ_IF_SOME(svc, this->services.find(diskName)) {
+        KJ_IF_SOME(diskSvc, kj::tryDowncast<DiskDirectoryService>(*svc)) {
+          if (mount.getWritable() && diskSvc.getWritable() == kj::none) {
+            errorReporter.addError(kj::str("fileSystemMounts entry \"", mount.getPath(),
+                "\" is writable, but the disk service \"", diskName,
+                "\" is defined read-only."));
+          }
+        } else {
+          errorReporter.addError(kj::str("fileSystemMounts entry \"", mount.getPath(),
+              "\" refers to the service \"", diskName, "\", but that service is not a local disk "
+              "service."));
+        }
+      } else {
+        errorReporter.addError(kj::str("fileSystemMounts entry \"", mount.getPath(),
+            "\" refers to a service \"", diskName, "\", but no such service is defined."));
+      }
+    }
+
     result.tails = KJ_MAP(tail, def.tails) { return kj::mv(tail).lookup(*this); };
 
     result.streamingTails = KJ_MAP(tail, def.streamingTails) { return kj::mv(tail).lookup(*this); };
 
+    KJ_IF_SOME(options, otlpOptions) {
+      auto collector = FutureSubrequestChannel{
+        .designator = KJ_ASSERT_NONNULL(def.otlpExporterConf).getCollector(),
+        .errorContext = kj::str("Worker's otlpExporter collector"),
+      }.lookup(*this);
+      auto& threadContext = globalContext->threadContext;
+      auto exporter = kj::refcounted<OtlpExporter>(threadContext.getUnsafeTimer(),
+          threadContext.getHeaderTable(), [collector = kj::mv(collector)]() {
+        return asHttpClient(collector->startRequest({}));
+      }, kj::mv(options));
+      otlpExporters.add(kj::addRef(*exporter));
+      result.otlpExporter = kj::mv(exporter);
+    }
+
     result.workerLoaders = KJ_MAP(il, def.workerLoaderChannels) {
       KJ_IF_SOME(id, il.id) {
         return workerLoaderNamespaces
@@ -6441,6 +6815,22 @@ class Server::HttpListener final: public kj::Refcounted {
       static auto constexpr listen = [](kj::Own<HttpListener> self, kj::Own<Connection> conn,
                                          kj::Own<kj::AsyncIoStream> stream) -> kj::Promise<void> {
         try {
+          KJ_IF_SOME(http2, conn->listedHttp2) {
+            // A client that connects and sends nothing is dropped after the same delay the
+            // HTTP/1.1 server allows for request headers.
+            auto timeout = self->timer.afterDelay(kj::HttpServerSettings().headerTimeout)
+                               .then([]() -> kj::Maybe<bool> { return kj::none; });
+            auto sniffed = co_await sniffHttp2Preface(stream)
+                               .then([](bool isHttp2) -> kj::Maybe<bool> { return isHttp2; })
+                               .exclusiveJoin(kj::mv(timeout));
+            KJ_IF_SOME(isHttp2, sniffed) {
+              if (isHttp2) {
+                co_return co_await http2.http2Server.listenHttp2(kj::mv(stream));
+              }
+            } else {
+              co_return;
+            }
+          }
           co_await conn->listedHttp.httpServer.listenHttp(kj::mv(stream));
         } catch (...) {
           KJ_LOG(ERROR, kj::getCaughtExceptionAsKj());
@@ -6488,13 +6878,21 @@ class Server::HttpListener final: public kj::Refcounted {
               *this,
               kj::HttpServerSettings{.errorHandler = *this,
                 .webSocketErrorHandler = *webSocketErrorHandler,
-                .webSocketCompressionMode = kj::HttpServerSettings::MANUAL_COMPRESSION}) {}
+                .webSocketCompressionMode = kj::HttpServerSettings::MANUAL_COMPRESSION}) {
+      if (parent.rewriter->acceptsHttp2()) {
+        listedHttp2.emplace(parent.owner, parent.timer, parent.headerTable, *this,
+            Http2Server::Settings{.errorHandler = *this});
+      }
+    }
 
     HttpListener& parent;
     kj::Maybe<kj::String> cfBlobJson;
     kj::Own<JsgifyWebSocketErrors> webSocketErrorHandler;
     ListedHttpServer listedHttp;
 
+    // Present if the socket accepts HTTP/2 connections as well.
+    kj::Maybe<ListedHttp2Server> listedHttp2;
+
     class ResponseWrapper final: public kj::HttpService::Response {
      public:
       ResponseWrapper(kj::HttpService::Response& inner, HttpRewriter& rewriter)
@@ -6763,9 +7161,85 @@ class Server::WorkerdDebugPortImpl final: public rpc::WorkerdDebugPort::Server {
     return kj::READY_NOW;
   }
 
+  kj::Promise<void> getSqlStatementStats(GetSqlStatementStatsContext context) override {
+    auto params = context.getParams();
+
+    // An actor that isn't running (or doesn't collect stats) has nothing to report; we don't
+    // start it just to return an empty list.
+    kj::Array<SqliteStatementStats::Entry> entries;
+    KJ_IF_SOME(container,
+        findRunningActor(params.getService(), params.getEntrypoint(), params.getActorId())) {
+      KJ_IF_SOME(stats, container.getSqlStatementStats()) {
+        entries = stats.getEntries();
+      }
+    }
+
+    auto list = context.initResults().initStatements(entries.size());
+    for (auto i: kj::indices(entries)) {
+      auto& counters = entries[i].counters;
+      auto out = list[i];
+      out.setSql(entries[i].sql);
+      out.setInternal(counters.internal);
+      out.setCalls(counters.calls);
+      out.setTotalTimeNs(counters.totalTime / kj::NANOSECONDS);
+      out.setMaxTimeNs(counters.maxTime / kj::NANOSECONDS);
+      out.setRowsRead(counters.rowsRead);
+      out.setRowsWritten(counters.rowsWritten);
+      out.setCacheHits(counters.cacheHits);
+    }
+    return kj::READY_NOW;
+  }
+
+  kj::Promise<void> getSqlitePageCacheStats(GetSqlitePageCacheStatsContext context) override {
+    auto params = context.getParams();
+    auto results = context.initResults();
+
+    KJ_IF_SOME(container,
+        findRunningActor(params.getService(), params.getEntrypoint(), params.getActorId())) {
+      KJ_IF_SOME(stats, container.getSqlitePageCacheStats()) {
+        auto out = results.initDatabase();
+        out.setHits(stats.hits);
+        out.setMisses(stats.misses);
+        out.setUsedBytes(stats.usedBytes);
+      }
+    }
+
+    KJ_IF_SOME(stats, workerd::getSqlitePageCacheStats()) {
+      auto out = results.initShared();
+      out.setBudgetBytes(stats.budgetBytes);
+      out.setUsedBytes(stats.usedBytes);
+      out.setPages(stats.pages);
+      out.setPinnedPages(stats.pinnedPages);
+      out.setHits(stats.hits);
+      out.setMisses(stats.misses);
+      out.setEvictions(stats.evictions);
+    }
+    return kj::READY_NOW;
+  }
+
  private:
   workerd::server::Server& srv;
   capnp::HttpOverCapnpFactory& httpOverCapnpFactory;
+
+  // Finds the actor `actorId` of Durable Object class `entrypointName` in `serviceName`, if it is
+  // currently running.
+  kj::Maybe<ActorNamespace::ActorContainer&> findRunningActor(
+      kj::StringPtr serviceName, kj::StringPtr entrypointName, kj::StringPtr actorId) {
+    auto& serviceEntry = KJ_ASSERT_NONNULL(srv.services.find(serviceName),
+        kj::str("jsg.Error: Worker \"", serviceName, "\" not found"));
+    auto service = serviceEntry->service();
+    auto& workerService = KJ_REQUIRE_NONNULL(kj::tryDowncast<WorkerService>(*service),
+        "jsg.Error: Worker does not support Durable Objects");
+    auto& actorNamespace = KJ_ASSERT_NONNULL(workerService.getActorNamespace(entrypointName),
+        kj::str("jsg.Error: Worker does not export a Durable Object class named \"", entrypointName,
+            "\""));
+
+    // Actors are keyed by their lowercase hex ID, so normalize the caller's spelling.
+    kj::String key = actorNamespace.getConfig().is<Durable>()
+        ? kj::encodeHex(kj::decodeHex(actorId))
+        : kj::str(actorId);
+    return actorNamespace.findActorContainer(key);
+  }
 };
 
 class Server::DebugPortListener {
@@ -6812,6 +7286,9 @@ kj::Promise<void> Server::handleDrain(kj::Promise<void> drainWhen) {
     // doc comment, we instead add the promise to `tasks` to be safe.
     tasks.add(httpServer.httpServer.drain());
   }
+  for (auto& http2Server: http2Servers) {
+    tasks.add(http2Server.http2Server.drain());
+  }
 }
 
 kj::Promise<void> Server::run(
@@ -6832,7 +7309,20 @@ kj::Promise<void> Server::run(
     loggingOptions.structuredLogging = StructuredLogging(config.getStructuredLogging());
   }
 
+  if (auto bytes = config.getSqlitePageCacheBytes(); bytes > 0) {
+    // Must happen before any service opens a database.
+    if (!installSqlitePageCache(bytes)) {
+      reportConfigWarning(kj::str("sqlitePageCacheBytes was ignored because SQLite was already "
+                                  "initialized in this process."));
+    }
+  }
+
+  startStallDetector(config);
+  startCpuProfiler();
+  startHeapMonitor(config);
+
   kj::HttpHeaderTable::Builder headerTableBuilder;
+  internHeaders(config, headerTableBuilder);
   globalContext = kj::heap<GlobalContext>(*this, v8System, headerTableBuilder);
   invalidConfigServiceSingleton = kj::refcounted<InvalidConfigService>();
   invalidConfigActorClassSingleton = kj::refcounted<InvalidConfigActorClass>();
@@ -6854,6 +7344,173 @@ kj::Promise<void> Server::run(
   co_return co_await listenPromise.exclusiveJoin(kj::mv(fatalPromise));
 }
 
+void Server::internHeaders(
+    config::Config::Reader config, kj::HttpHeaderTable::Builder& headerTableBuilder) {
+  if (!config.hasInternedHeaders()) return;
+
+  auto configured = config.getInternedHeaders();
+  kj::Vector<kj::StringPtr> names(configured.size());
+  for (auto name: configured) {
+    bool valid = name.size() > 0;
+    for (char c: name) {
+      valid = valid && util::isHttpTokenChar(c);
+    }
+    if (!valid) {
+      reportConfigError(kj::str("internedHeaders contains an invalid header name: \"", name, "\""));
+    } else if (names.size() == api::Headers::MAX_INTERNED_HEADERS) {
+      reportConfigError(kj::str("internedHeaders can list at most ",
+          api::Headers::MAX_INTERNED_HEADERS, " names; ignoring \"", name, "\""));
+    } else {
+      headerTableBuilder.add(name);
+      names.add(name);
+    }
+  }
+
+  if (!api::Headers::internHeaderNames(names.asPtr())) {
+    reportConfigWarning(kj::str("internedHeaders was ignored by workers because header names "
+                                "were already interned in this process."));
+  }
+}
+
+void Server::startStallDetector(config::Config::Reader config) {
+  if (auto ms = config.getStallThresholdMs(); ms > 0) {
+    stallDetector = kj::heap<StallDetector>(StallDetector::Options{
+      .threshold = ms * kj::MILLISECONDS,
+    });
+  }
+}
+
+namespace {
+
+// Service names can contain anything, including slashes.
+kj::String sanitizeFileName(kj::StringPtr name) {
+  auto result = kj::heapString(name);
+  for (char& c: result) {
+    bool safe = ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') ||
+        c == '-' || c == '_' || c == '.';
+    if (!safe) c = '_';
+  }
+  return result;
+}
+
+// Writes each profile to `<service>-<start time in ms>.pb.gz` in a directory. Profiles are handed
+// to a background thread to write, so that isolates aren't kept locked while the disk catches up.
+class DirectoryCpuProfiler final: public ContinuousCpuProfiler {
+ public:
+  explicit DirectoryCpuProfiler(kj::Own<const kj::Directory> dir)
+      : ContinuousCpuProfiler({}),
+        dir(kj::mv(dir)) {}
+
+  void write(kj::StringPtr isolateId, kj::Date start, kj::Array<kj::byte> profile) const override {
+    auto path = kj::Path(kj::str(
+        sanitizeFileName(isolateId), '-', (start - kj::UNIX_EPOCH) / kj::MILLISECONDS, ".pb.gz"));
+    writer.runDetached([this, path = kj::mv(path), profile = kj::mv(profile)]() {
+      // Written atomically, so that tools picking up profiles never see a partial one.
+      KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+        auto replacer = dir->replaceFile(path, kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+        replacer->get().writeAll(profile);
+        replacer->commit();
+      })) {
+        KJ_LOG(ERROR, "failed to write CPU profile", path.toString(), exception);
+      }
+    });
+  }
+
+ private:
+  kj::Own<const kj::Directory> dir;
+
+  // Declared last so that profiles already handed to it are written out before `dir` goes away.
+  ThreadPool writer{{.threadCount = 1}};
+};
+
+}  // namespace
+
+void Server::startCpuProfiler() {
+  KJ_IF_SOME(dir, cpuProfileDir) {
+    cpuProfiler = kj::heap<DirectoryCpuProfiler>(kj::mv(dir));
+    cpuProfileDir = kj::none;
+  }
+}
+
+namespace {
+
+// Writes each heap snapshot to `<service>-<time in ms>.heapsnapshot` in a directory, if given one.
+// Like profiles, snapshots are written atomically.
+class DirectoryHeapMonitor final: public HeapMonitor {
+ public:
+  DirectoryHeapMonitor(Options options, kj::Maybe<kj::Own<const kj::Directory>> dir)
+      : HeapMonitor(options),
+        dir(kj::mv(dir)) {}
+
+  void writeSnapshot(kj::StringPtr isolateId,
+      kj::Date time,
+      kj::FunctionParam<void(kj::OutputStream&)> serialize) const override {
+    KJ_IF_SOME(d, dir) {
+      auto path = kj::Path(kj::str(sanitizeFileName(isolateId), '-',
+          (time - kj::UNIX_EPOCH) / kj::MILLISECONDS, ".heapsnapshot"));
+      auto replacer = d->replaceFile(path, kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+      FileOutputStream out(replacer->get());
+      serialize(out);
+      replacer->commit();
+    }
+  }
+
+ private:
+  kj::Maybe<kj::Own<const kj::Directory>> dir;
+
+  // Snapshots are often hundreds of megabytes, so they're streamed to the file rather than
+  // buffered.
+  class FileOutputStream final: public kj::OutputStream {
+   public:
+    explicit FileOutputStream(const kj::File& file): file(file) {}
+
+    void write(kj::ArrayPtr<const kj::byte> data) override {
+      file.write(offset, data);
+      offset += data.size();
+    }
+
+   private:
+    const kj::File& file;
+    uint64_t offset = 0;
+  };
+};
+
+}  // namespace
+
+void Server::startHeapMonitor(config::Config::Reader config) {
+  if (!config.hasHeapMonitoring()) {
+    if (heapSnapshotDir != kj::none) {
+      reportConfigWarning(kj::str("--heap-snapshot-dir was ignored because the config does not "
+                                  "enable heapMonitoring."));
+    }
+    return;
+  }
+
+  auto heapMonitoring = config.getHeapMonitoring();
+  if (heapMonitoring.getIntervalSeconds() == 0) {
+    // Each sample walks every native object in the isolate, while holding its lock.
+    reportConfigError(kj::str("heapMonitoring.intervalSeconds must be at least 1."));
+    return;
+  }
+  HeapMonitor::Options options{
+    .interval = heapMonitoring.getIntervalSeconds() * kj::SECONDS,
+  };
+  if (auto percent = heapMonitoring.getSnapshotThresholdPercent(); percent > 0) {
+    if (percent > 100) {
+      reportConfigError(kj::str("heapMonitoring.snapshotThresholdPercent must be at most 100, "
+                                "but was ", percent, "."));
+    } else if (heapSnapshotDir == kj::none) {
+      reportConfigError(kj::str("heapMonitoring.snapshotThresholdPercent requires "
+                                "--heap-snapshot-dir to say where to write snapshots."));
+    } else {
+      options.snapshotThreshold = percent / 100.0;
+    }
+  }
+
+  heapMonitor = kj::heap<DirectoryHeapMonitor>(options, kj::mv(heapSnapshotDir));
+  heapSnapshotDir = kj::none;
+}
+
 // Configure and start the inspector socket, returning the port the socket started on.
 uint startInspector(
     kj::StringPtr inspectorAddress, Server::InspectorServiceIsolateRegistrar& registrar) {
@@ -6951,7 +7608,9 @@ kj::Promise<void> Server::startServices(jsg::V8System& v8System,
                 Durable{.uniqueKey = kj::str(ns.getUniqueKey()),
                   .isEvictable = !ns.getPreventEviction(),
                   .enableSql = ns.getEnableSql(),
-                  .containerOptions = ns.hasContainer() ? kj::Maybe(ns.getContainer()) : kj::none});
+                  .containerOptions = ns.hasContainer() ? kj::Maybe(ns.getContainer()) : kj::none,
+                  .sqlStatementStats = ns.getSqlStatementStats(),
+                  .sqliteOptions = ns.hasSqlite() ? kj::Maybe(ns.getSqlite()) : kj::none});
             continue;
           case config::Worker::DurableObjectNamespace::EPHEMERAL_LOCAL:
             if (!experimental) {
@@ -7227,6 +7886,7 @@ kj::Promise<void> Server::listenOnSockets(config::Config::Reader config,
   }
 
   co_await tasks.onEmpty();
+  co_await flushOtlpExporters();
 
   // Give a chance for any errors to bubble up before we return success. In particular
   // Server::taskFailed() fulfills `fatalFulfiller`, which causes the server to exit with an error.
@@ -7239,6 +7899,18 @@ kj::Promise<void> Server::listenOnSockets(config::Config::Reader config,
   co_await kj::yieldUntilQueueEmpty();
 }
 
+kj::Promise<void> Server::flushOtlpExporters() {
+  // Don't let an unreachable collector hold up shutdown indefinitely.
+  static constexpr auto FLUSH_TIMEOUT = 10 * kj::SECONDS;
+
+  if (otlpExporters.empty()) co_return;
+  auto flushes = KJ_MAP(exporter, otlpExporters) { return exporter->flush(); };
+  auto timeout = timer.afterDelay(FLUSH_TIMEOUT).then([]() {
+    KJ_LOG(WARNING, "timed out sending queued spans and logs to OTLP collectors at shutdown");
+  });
+  co_await kj::joinPromises(kj::mv(flushes)).exclusiveJoin(kj::mv(timeout));
+}
+
 // =======================================================================================
 // Server::test()
 
@@ -7260,7 +7932,12 @@ kj::Promise<bool> Server::test(jsg::V8System& v8System,
     loggingOptions.structuredLogging = StructuredLogging(config.getStructuredLogging());
   }
 
+  startStallDetector(config);
+  startCpuProfiler();
+  startHeapMonitor(config);
+
   kj::HttpHeaderTable::Builder headerTableBuilder;
+  internHeaders(config, headerTableBuilder);
   globalContext = kj::heap<GlobalContext>(*this, v8System, headerTableBuilder);
   invalidConfigServiceSingleton = kj::refcounted<InvalidConfigService>();
 
@@ -5,9 +5,13 @@
 #pragma once
 
 #include "channel-token.h"
+#include "http2-server.h"
 
 #include <workerd/api/memory-cache.h>
 #include <workerd/api/pyodide/pyodide.h>
+#include <workerd/io/continuous-profiler.h>
+#include <workerd/io/heap-monitor.h>
+#include <workerd/io/stall-detector.h>
 #include <workerd/io/worker.h>
 #include <workerd/server/workerd.capnp.h>
 
@@ -25,10 +29,16 @@ namespace workerd::jsg {
 class V8System;
 }
 
+namespace workerd {
+class SqliteCheckpointer;
+}
+
 namespace workerd::server {
 
 using api::pyodide::PythonConfig;
 
+class OtlpExporter;
+
 // Implements the single-tenant Workers Runtime server / CLI.
 //
 // The purpose of this class is to implement the core logic independently of the CLI itself,
@@ -72,6 +82,14 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
   void enableDebugPort(kj::String addr) {
     debugPortOverride = kj::mv(addr);
   }
+  // Continuously profile every isolate and write a pprof profile for each to `dir` once a minute.
+  void enableCpuProfiling(kj::Own<const kj::Directory> dir) {
+    cpuProfileDir = kj::mv(dir);
+  }
+  // Write heap snapshots triggered by config.heapMonitoring.snapshotThresholdPercent to `dir`.
+  void enableHeapSnapshots(kj::Own<const kj::Directory> dir) {
+    heapSnapshotDir = kj::mv(dir);
+  }
   void setPackageDiskCacheRoot(kj::Maybe<kj::Own<const kj::Directory>>&& dir) {
     pythonConfig.packageDiskCacheRoot = kj::mv(dir);
   }
@@ -118,6 +136,8 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
     bool isEvictable;
     bool enableSql;
     kj::Maybe<config::Worker::DurableObjectNamespace::ContainerOptions::Reader> containerOptions;
+    bool sqlStatementStats = false;
+    kj::Maybe<config::Worker::DurableObjectNamespace::SqliteOptions::Reader> sqliteOptions;
   };
   struct Ephemeral {
     bool isEvictable;
@@ -177,6 +197,15 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
   kj::Maybe<kj::Own<InspectorServiceIsolateRegistrar>> inspectorIsolateRegistrar;
   kj::Maybe<kj::Own<kj::FdOutputStream>> controlOverride;
   kj::Maybe<kj::String> debugPortOverride;
+  kj::Maybe<kj::Own<const kj::Directory>> cpuProfileDir;
+  kj::Maybe<kj::Own<const kj::Directory>> heapSnapshotDir;
+
+  // Created from config.stallThresholdMs, cpuProfileDir, and config.heapMonitoring, respectively.
+  // Declared before anything that owns isolates, so that they outlive the isolates' locks and
+  // sessions.
+  kj::Maybe<kj::Own<StallDetector>> stallDetector;
+  kj::Maybe<kj::Own<ContinuousCpuProfiler>> cpuProfiler;
+  kj::Maybe<kj::Own<HeapMonitor>> heapMonitor;
 
   struct GlobalContext;
   // General context needed to construct workers. Initialized early in run().
@@ -193,8 +222,18 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
   // correctly construct dependent services.
   kj::HashMap<kj::String, kj::HashMap<kj::String, ActorConfig>> actorConfigs;
 
+  // Runs background WAL checkpoints for Durable Object namespaces that ask for them. Created on
+  // first use; declared before `services` since their actors' databases refer to it.
+  kj::Maybe<kj::Own<SqliteCheckpointer>> sqliteCheckpointer;
+  SqliteCheckpointer& getSqliteCheckpointer();
+
   kj::HashMap<kj::String, kj::Own<Service>> services;
 
+  // Every worker's OtlpExporter, so that run() can send what they still have queued when the
+  // server shuts down. Declared after `services`, since their collector channels refer to them.
+  kj::Vector<kj::Own<OtlpExporter>> otlpExporters;
+  kj::Promise<void> flushOtlpExporters();
+
   class ActorNamespace;
   kj::HashMap<kj::StringPtr, ActorNamespace*> actorNamespacesByUniqueKey;
 
@@ -224,6 +263,25 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
   // All active HttpServer objects -- used to implement drain().
   kj::List<ListedHttpServer, &ListedHttpServer::link> httpServers;
 
+  // Same as ListedHttpServer, for sockets that accept HTTP/2.
+  struct ListedHttp2Server {
+    Server& owner;
+    Http2Server http2Server;
+    kj::ListLink<ListedHttp2Server> link;
+
+    template <typename... Params>
+    ListedHttp2Server(Server& owner, Params&&... params)
+        : owner(owner),
+          http2Server(kj::fwd<Params>(params)...) {
+      owner.http2Servers.add(*this);
+    };
+    ~ListedHttp2Server() noexcept(false) {
+      owner.http2Servers.remove(*this);
+    }
+  };
+
+  kj::List<ListedHttp2Server, &ListedHttp2Server::link> http2Servers;
+
   // Especially includes server loop tasks to listen on sockets. Any error is considered fatal.
   kj::TaskSet tasks;
 
@@ -336,6 +394,23 @@ class Server final: private kj::TaskSet::ErrorHandler, private ChannelTokenHandl
       capnp::List<config::Extension>::Reader extensions,
       ErrorReporter& errorReporter);
 
+  // Registers config.internedHeaders with `headerTableBuilder` and with api::Headers. Must be
+  // called before any service starts.
+  void internHeaders(
+      config::Config::Reader config, kj::HttpHeaderTable::Builder& headerTableBuilder);
+
+  // Starts the StallDetector if config.stallThresholdMs is set. Must be called before any
+  // service starts.
+  void startStallDetector(config::Config::Reader config);
+
+  // Starts the ContinuousCpuProfiler if enableCpuProfiling() was called. Must be called before any
+  // service starts.
+  void startCpuProfiler();
+
+  // Starts the HeapMonitor if config.heapMonitoring is set. Must be called before any service
+  // starts.
+  void startHeapMonitor(config::Config::Reader config);
+
   kj::Promise<void> startServices(jsg::V8System& v8System,
       config::Config::Reader config,
       kj::HttpHeaderTable::Builder& headerTableBuilder,
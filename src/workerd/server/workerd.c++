@@ -805,6 +805,14 @@ class CliMain final: public SchemaFileImpl::ErrorReporter {
         .addOptionWithArg({"p", "perfetto-trace"}, CLI_METHOD(enablePerfetto),
             "<path>=<categories>", "Enable perfetto tracing output to the specified file.")
 #endif
+        .addOptionWithArg({"cpu-profile-dir"}, CLI_METHOD(enableCpuProfiling), "<path>",
+            "Continuously sample the JavaScript running in every service with V8's CPU profiler, "
+            "writing a gzipped pprof profile per service to <path> once a minute, named "
+            "<service>-<start-time-ms>.pb.gz. The directory is created if it doesn't exist.")
+        .addOptionWithArg({"heap-snapshot-dir"}, CLI_METHOD(enableHeapSnapshots), "<path>",
+            "Write the heap snapshots triggered by the config's "
+            "heapMonitoring.snapshotThresholdPercent to <path>, named "
+            "<service>-<time-ms>.heapsnapshot. The directory is created if it doesn't exist.")
         .addOption({'w', "watch"}, CLI_METHOD(watch),
             "Watch configuration files (and server binary) and reload if they change. "
             "Useful for development, but not recommended in production.")
@@ -1123,6 +1131,22 @@ class CliMain final: public SchemaFileImpl::ErrorReporter {
         kj::mv(KJ_UNWRAP_OR(dir, CLI_ERROR("package disk cache dir must exist"))));
   }
 
+  void enableCpuProfiling(kj::StringPtr pathStr) {
+    kj::Path path = fs->getCurrentPath().eval(pathStr);
+    kj::Maybe<kj::Own<const kj::Directory>> dir =
+        fs->getRoot().tryOpenSubdir(path, kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+    server->enableCpuProfiling(
+        kj::mv(KJ_UNWRAP_OR(dir, CLI_ERROR("couldn't open or create the CPU profile directory"))));
+  }
+
+  void enableHeapSnapshots(kj::StringPtr pathStr) {
+    kj::Path path = fs->getCurrentPath().eval(pathStr);
+    kj::Maybe<kj::Own<const kj::Directory>> dir =
+        fs->getRoot().tryOpenSubdir(path, kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+    server->enableHeapSnapshots(kj::mv(
+        KJ_UNWRAP_OR(dir, CLI_ERROR("couldn't open or create the heap snapshot directory"))));
+  }
+
   void setPyodideDiskCacheDir(kj::StringPtr pathStr) {
     kj::Path path = fs->getCurrentPath().eval(pathStr);
     kj::Maybe<kj::Own<const kj::Directory>> dir =
@@ -0,0 +1,123 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/io/actor-cache.h>
+#include <workerd/io/io-gate.h>
+#include <workerd/tests/bench-tools.h>
+
+#include <algorithm>
+
+namespace workerd {
+namespace {
+
+constexpr uint KEY_COUNT = 1000;
+constexpr uint LIST_KEY_COUNT = 10000;
+
+// Answers every get() with the same value, and every list() with LIST_KEY_COUNT keys, so that the
+// cache can be filled through the normal read paths and end up holding clean entries.
+class FixedValueStorage final: public rpc::ActorStorage::Stage::Server {
+ public:
+  FixedValueStorage()
+      : listKeys(KJ_MAP(i, kj::zeroTo(LIST_KEY_COUNT)) { return kj::str("key", kj::hex(i)); }) {
+    std::sort(listKeys.begin(), listKeys.end());
+  }
+
+ protected:
+  kj::Promise<void> get(GetContext context) override {
+    context.getResults().setValue("value"_kj.asBytes());
+    return kj::READY_NOW;
+  }
+
+  kj::Promise<void> list(ListContext context) override {
+    // Batched the way the storage service streams results.
+    constexpr size_t BATCH_SIZE = 128;
+    auto stream = context.getParams().getStream();
+    for (size_t i = 0; i < listKeys.size(); i += BATCH_SIZE) {
+      auto batch = listKeys.slice(i, kj::min(i + BATCH_SIZE, listKeys.size()));
+      auto req = stream.valuesRequest();
+      auto list = req.initList(batch.size());
+      for (auto j: kj::indices(batch)) {
+        list[j].setKey(batch[j].asBytes());
+        list[j].setValue("a typical small value"_kj.asBytes());
+      }
+      co_await req.send();
+    }
+    co_await stream.endRequest().send().ignoreResult();
+  }
+
+ private:
+  kj::Array<kj::String> listKeys;
+};
+
+// Shared by all benchmark threads, like the caches of all actors in one isolate.
+ActorCache::SharedLru& getSharedLru() {
+  static ActorCache::SharedLru lru({
+    .softLimit = 1ull << 30,
+    .hardLimit = 2ull << 30,
+    .staleTimeout = 1 * kj::HOURS,
+    .dirtyListByteLimit = 8ull << 20,
+    .maxKeysPerRpc = 128,
+  });
+  return lru;
+}
+
+// Cache hit throughput of ActorCache::get(). Each thread plays one actor with its own event loop
+// and cache, so with more threads this measures contention on the SharedLru.
+static void ActorCache_GetHit(benchmark::State& state) {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  OutputGate gate;
+  ActorCache cache(kj::heap<FixedValueStorage>(), getSharedLru(), gate);
+
+  auto keys = KJ_MAP(i, kj::zeroTo(KEY_COUNT)) { return kj::str("key", i); };
+  for (auto& key: keys) {
+    KJ_SWITCH_ONEOF(cache.get(kj::str(key), {})) {
+      KJ_CASE_ONEOF(value, kj::Maybe<ActorCache::Value>) {
+        KJ_FAIL_ASSERT("cache should start empty");
+      }
+      KJ_CASE_ONEOF(promise, kj::Promise<kj::Maybe<ActorCache::Value>>) {
+        promise.wait(ws);
+      }
+    }
+  }
+
+  uint i = 0;
+  for (auto _: state) {
+    auto result = cache.get(kj::str(keys[i++ % KEY_COUNT]), {});
+    KJ_ASSERT(result.is<kj::Maybe<ActorCache::Value>>());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(ActorCache_GetHit)->ThreadRange(1, 8)->UseRealTime();
+
+// Throughput of a list() of LIST_KEY_COUNT keys that all have to come from storage, including
+// adding every result to the cache.
+static void ActorCache_ListUncached(benchmark::State& state) {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  OutputGate gate;
+  rpc::ActorStorage::Stage::Client storage = kj::heap<FixedValueStorage>();
+
+  for (auto _: state) {
+    // A fresh cache each time, so nothing is served from cache.
+    ActorCache cache(storage, getSharedLru(), gate);
+    KJ_SWITCH_ONEOF(cache.list(kj::str(), kj::none, kj::none, {})) {
+      KJ_CASE_ONEOF(results, ActorCache::GetResultList) {
+        KJ_FAIL_ASSERT("cache should start empty");
+      }
+      KJ_CASE_ONEOF(promise, kj::Promise<ActorCache::GetResultList>) {
+        auto results = promise.wait(ws);
+        KJ_ASSERT(results.size() == LIST_KEY_COUNT);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * LIST_KEY_COUNT);
+}
+
+WD_BENCHMARK(ActorCache_ListUncached);
+
+}  // namespace
+}  // namespace workerd
@@ -21,6 +21,10 @@ struct ApiHeaders: public benchmark::Fixture {
   };
 
   void SetUp(benchmark::State& state) noexcept(true) override {
+    // Interning is once per process and has to precede every Headers object, so it can't be
+    // toggled per benchmark. Instead, only the x-interned-* names are interned.
+    [[maybe_unused]] static bool interned = api::Headers::internHeaderNames(kInternedNames);
+
     fixture = kj::heap<TestFixture>();
 
     kj::HttpHeaderTable::Builder builder;
@@ -69,6 +73,34 @@ struct ApiHeaders: public benchmark::Fixture {
     Header{false, "X-Forwarded-For"_kj, "203.0.113.1, 198.51.100.17"_kj},
     Header{true, "Set-Cookie"_kj, "new_session=token123; Path=/; Secure; HttpOnly"_kj},
     Header{true, "Set-Cookie"_kj, "new_session=token124; Path=/abc; Secure; HttpOnly"_kj}};
+
+  // Custom headers in the style of an application's own request metadata, in the casing a worker
+  // would typically write them. The two lists differ only in whether the names are interned.
+  static constexpr kj::StringPtr kInternedNames[] = {"X-Interned-Request-Id", "X-Interned-Tenant",
+    "X-Interned-Trace", "X-Interned-Client", "X-Interned-Flags", "X-Interned-Region",
+    "X-Interned-Cache-Key", "X-Interned-Scope"};
+  static constexpr kj::StringPtr kCustomNames[] = {"X-Custom-Request-Id", "X-Custom-Tenant",
+    "X-Custom-Trace", "X-Custom-Client", "X-Custom-Flags", "X-Custom-Region",
+    "X-Custom-Cache-Key", "X-Custom-Scope"};
+
+  void customSetGet(benchmark::State& state, kj::ArrayPtr<const kj::StringPtr> names) {
+    fixture->runInIoContext([&](const TestFixture::Environment& env) {
+      auto& js = env.js;
+      for (auto _: state) {
+        for (size_t i = 0; i < 1000; ++i) {
+          auto headers = js.alloc<api::Headers>();
+          for (auto name: names) {
+            headers->set(js, kj::str(name), kj::str("0123456789abcdef"));
+          }
+          for (auto name: names) {
+            benchmark::DoNotOptimize(headers->has(kj::str(name)));
+            benchmark::DoNotOptimize(headers->get(js, kj::str(name)));
+          }
+          benchmark::DoNotOptimize(i);
+        }
+      }
+    });
+  }
 };
 
 // initialization performs a lot of copying, benchmark it
@@ -104,5 +136,13 @@ BENCHMARK_F(ApiHeaders, set_append)(benchmark::State& state) {
     }
   });
 }
+
+BENCHMARK_F(ApiHeaders, custom_set_get)(benchmark::State& state) {
+  customSetGet(state, kCustomNames);
+}
+
+BENCHMARK_F(ApiHeaders, custom_set_get_interned)(benchmark::State& state) {
+  customSetGet(state, kInternedNames);
+}
 }  // namespace
 }  // namespace workerd
@@ -0,0 +1,92 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/node/buffer.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+// Benchmarks for the node:buffer encoding paths in BufferUtil: toString() and decodeString() in
+// each encoding, and fill() with a multi-byte pattern, on buffers of various sizes.
+
+namespace workerd {
+namespace {
+
+using api::node::BufferUtil;
+using api::node::Encoding;
+
+jsg::JsUint8Array makeBytes(jsg::Lock& js, size_t size) {
+  auto bytes = jsg::JsUint8Array::create(js, size);
+  auto ptr = bytes.asArrayPtr();
+  for (auto i: kj::indices(ptr)) {
+    // Printable ASCII, so that the "ascii" encoding takes its common path.
+    ptr[i] = ' ' + i % 95;
+  }
+  return bytes;
+}
+
+template <Encoding encoding>
+static void Buffer_ToString(benchmark::State& state) {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    BufferUtil util;
+    size_t size = state.range(0);
+    auto bytes = makeBytes(js, size);
+
+    for (auto _: state) {
+      js.withinHandleScope(
+          [&] { benchmark::DoNotOptimize(util.toString(js, bytes, 0, size, encoding)); });
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+  });
+}
+
+template <Encoding encoding>
+static void Buffer_DecodeString(benchmark::State& state) {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    BufferUtil util;
+    size_t size = state.range(0);
+    auto bytes = makeBytes(js, size);
+    auto str = util.toString(js, bytes, 0, size, encoding);
+
+    for (auto _: state) {
+      js.withinHandleScope([&] { benchmark::DoNotOptimize(util.decodeString(js, str, encoding)); });
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+  });
+}
+
+static void Buffer_Fill(benchmark::State& state) {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    BufferUtil util;
+    size_t size = state.range(0);
+    auto bytes = jsg::JsUint8Array::create(js, size);
+    auto pattern = makeBytes(js, 7);
+
+    for (auto _: state) {
+      util.fillImpl(js, bytes, pattern, 0, size, kj::none);
+      benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+  });
+}
+
+#define BUFFER_SIZES ->Arg(32)->Arg(1024)->Arg(64 * 1024)
+
+BENCHMARK(Buffer_ToString<Encoding::ASCII>) BUFFER_SIZES;
+BENCHMARK(Buffer_ToString<Encoding::LATIN1>) BUFFER_SIZES;
+BENCHMARK(Buffer_ToString<Encoding::UTF16LE>) BUFFER_SIZES;
+BENCHMARK(Buffer_ToString<Encoding::HEX>) BUFFER_SIZES;
+BENCHMARK(Buffer_ToString<Encoding::BASE64URL>) BUFFER_SIZES;
+BENCHMARK(Buffer_DecodeString<Encoding::LATIN1>) BUFFER_SIZES;
+BENCHMARK(Buffer_DecodeString<Encoding::HEX>) BUFFER_SIZES;
+BENCHMARK(Buffer_DecodeString<Encoding::BASE64URL>) BUFFER_SIZES;
+BENCHMARK(Buffer_Fill) BUFFER_SIZES;
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,38 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/crypto/crc-impl.h>
+#include <workerd/tests/bench-tools.h>
+
+#include <kj/array.h>
+
+// Throughput of the checksums behind the crc32c and crc64nvme digest algorithms, from small
+// chunks up to sizes where the interleaved and folding paths dominate.
+
+namespace workerd {
+namespace {
+
+static void Crc32c(benchmark::State& state) {
+  auto data = kj::heapArray<kj::byte>(state.range(0));
+  data.asPtr().fill(0x5a);
+  for (auto _: state) {
+    benchmark::DoNotOptimize(crc32c(0, data.begin(), data.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+static void Crc64nvme(benchmark::State& state) {
+  auto data = kj::heapArray<kj::byte>(state.range(0));
+  data.asPtr().fill(0x5a);
+  for (auto _: state) {
+    benchmark::DoNotOptimize(crc64nvme(0, data.begin(), data.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(Crc32c)->Arg(64)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+BENCHMARK(Crc64nvme)->Arg(64)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+}  // namespace
+}  // namespace workerd
@@ -41,5 +41,57 @@ BENCHMARK_F(GlobalScopeBenchmark, request)(benchmark::State& state) {
   }
 }
 
+// Measures the IoContext's bookkeeping for objects owned on behalf of JavaScript: a request adds
+// a few dozen objects and reentry callbacks, most of which live until the request ends. The
+// argument selects whether the IO_OWN_ARENA autogate is enabled; the `allocsPerRequest` counter
+// reports the heap allocations made for list nodes.
+struct IoOwnBenchmark: public benchmark::Fixture {
+  virtual ~IoOwnBenchmark() noexcept(true) {}
+
+  void SetUp(benchmark::State& state) noexcept(true) override {
+    TestFixture::SetupParams params = {.useRealTimers = false};
+    if (state.range(0)) {
+      params.autogates = kj::arr("io-own-arena"_kj);
+    }
+    fixture = kj::heap<TestFixture>(kj::mv(params));
+  }
+
+  void TearDown(benchmark::State& state) noexcept(true) override {
+    fixture = nullptr;
+  }
+
+  kj::Own<TestFixture> fixture;
+};
+
+BENCHMARK_DEFINE_F(IoOwnBenchmark, request)(benchmark::State& state) {
+  size_t allocations = 0;
+  for (auto _: state) {
+    fixture->runInIoContext([&](const TestFixture::Environment& env) {
+      auto& context = env.context;
+      auto before = context.ownedObjectAllocationCount();
+
+      for (uint i: kj::zeroTo(48)) {
+        auto object = context.addObject(kj::heap<uint>(i));
+        if (i % 4 == 0) {
+          // Released mid-request, like a stream that finished early.
+          object = nullptr;
+        } else {
+          kj::mv(object).deferGcToContext();
+        }
+      }
+      for (auto i KJ_UNUSED: kj::zeroTo(8)) {
+        auto callback = context.makeReentryCallback([](Worker::Lock&, IoContext&) {});
+        benchmark::DoNotOptimize(callback);
+      }
+
+      allocations += context.ownedObjectAllocationCount() - before;
+    });
+  }
+  state.counters["allocsPerRequest"] =
+      benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(IoOwnBenchmark, request)->Arg(0)->Arg(1);
+
 }  // namespace
 }  // namespace workerd
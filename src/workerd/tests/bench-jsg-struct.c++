@@ -0,0 +1,98 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/jsg/jsg-test.h>
+#include <workerd/jsg/jsg.h>
+#include <workerd/tests/bench-tools.h>
+
+// Benchmark for wrapping a JSG_STRUCT as a JS object: once through the cached per-isolate
+// v8::DictionaryTemplate (the `fastJsgStruct` compatibility flag), and once through the original
+// path that creates an empty object and Set()s each field.
+
+namespace workerd {
+namespace {
+
+jsg::V8System v8System;
+
+struct BenchContext: public jsg::Object, public jsg::ContextGlobal {
+  // Shaped like a typical API result, e.g. an R2 object's metadata.
+  struct TenFields {
+    kj::String key;
+    kj::String version;
+    double size;
+    kj::String etag;
+    kj::String httpEtag;
+    double uploaded;
+    kj::String contentType;
+    kj::String storageClass;
+    bool truncated;
+    jsg::Optional<kj::String> cursor;
+
+    JSG_STRUCT(key,
+        version,
+        size,
+        etag,
+        httpEtag,
+        uploaded,
+        contentType,
+        storageClass,
+        truncated,
+        cursor);
+  };
+
+  JSG_RESOURCE_TYPE(BenchContext) {}
+};
+JSG_DECLARE_ISOLATE_TYPE(FastStructIsolate, BenchContext, BenchContext::TenFields);
+JSG_DECLARE_ISOLATE_TYPE(SlowStructIsolate, BenchContext, BenchContext::TenFields);
+
+BenchContext::TenFields makeTenFields() {
+  return {
+    .key = kj::str("images/2026/10/cat.png"),
+    .version = kj::str("7e1b3c9a0f2d4e6b8a1c3e5f7a9b1d3f"),
+    .size = 123456,
+    .etag = kj::str("0f343b0931126a20f133d67c2b018a3b"),
+    .httpEtag = kj::str("\"0f343b0931126a20f133d67c2b018a3b\""),
+    .uploaded = 1790000000000,
+    .contentType = kj::str("image/png"),
+    .storageClass = kj::str("Standard"),
+    .truncated = false,
+    .cursor = kj::str("c2FtcGxlIGN1cnNvcg"),
+  };
+}
+
+template <typename IsolateType>
+void wrapStructs(benchmark::State& state, bool fast) {
+  jsg::test::Evaluator<BenchContext, IsolateType> e(v8System);
+  if (fast) {
+    e.getIsolate().setUsingFastJsgStruct();
+  }
+  e.run([&](typename IsolateType::Lock& lock) {
+    jsg::Lock& js = lock;
+    auto& handler = lock.template getTypeHandler<BenchContext::TenFields>();
+    auto etagName = js.strIntern("etag");
+
+    for (auto _: state) {
+      js.withinHandleScope([&] {
+        auto obj = jsg::JsObject(handler.wrap(js, makeTenFields()).template As<v8::Object>());
+        // Read a field back, as callers usually do soon after.
+        benchmark::DoNotOptimize(obj.get(js, etagName));
+      });
+    }
+  });
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void JsgStruct_Wrap_DictionaryTemplate(benchmark::State& state) {
+  wrapStructs<FastStructIsolate>(state, true);
+}
+
+static void JsgStruct_Wrap_SetPerField(benchmark::State& state) {
+  wrapStructs<SlowStructIsolate>(state, false);
+}
+
+WD_BENCHMARK(JsgStruct_Wrap_DictionaryTemplate);
+WD_BENCHMARK(JsgStruct_Wrap_SetPerField);
+
+}  // namespace
+}  // namespace workerd
@@ -4,6 +4,7 @@
 
 #include <workerd/api/r2-api.capnp.h>
 #include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
 
 #include <benchmark/benchmark.h>
 
@@ -11,6 +12,7 @@
 #include <capnp/message.h>
 #include <kj/string.h>
 #include <kj/test.h>
+#include <kj/vector.h>
 
 // Example test, derived from capnproto's json test.
 static void Test_JSON_ENC(benchmark::State& state) {
@@ -56,7 +58,50 @@ static void Test_JSON_DEC(benchmark::State& state) {
   }
 }
 
+// A ~400KB JSON array of small objects, ASCII as most JSON is.
+static kj::String makeLargeJson() {
+  kj::Vector<kj::String> items;
+  for (auto i: kj::zeroTo(16384)) {
+    items.add(kj::str("{\"id\":", i, ",\"name\":\"item-", i, "\"}"));
+  }
+  return kj::str("[", kj::strArray(items, ","), "]");
+}
+
+// Parses a large JSON payload the way Body.json() used to: decoding the UTF-8 text into a new
+// string on the V8 heap first.
+static void Test_JSON_PARSE_LARGE_COPIED(benchmark::State& state) {
+  workerd::TestFixture fixture;
+  auto payload = makeLargeJson();
+  fixture.runInIoContext([&](const workerd::TestFixture::Environment& env) {
+    auto& js = env.js;
+    for (auto _: state) {
+      js.withinHandleScope([&] { benchmark::DoNotOptimize(js.parseJson(payload)); });
+    }
+  });
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+
+// Parses a large JSON payload the way Body.json() does for ASCII bodies: V8 reads the buffer in
+// place through an external string. The buffer copy stands in for reading the body.
+static void Test_JSON_PARSE_LARGE_EXTERNAL(benchmark::State& state) {
+  workerd::TestFixture fixture;
+  auto payload = makeLargeJson();
+  fixture.runInIoContext([&](const workerd::TestFixture::Environment& env) {
+    auto& js = env.js;
+    for (auto _: state) {
+      js.withinHandleScope([&] {
+        auto text = workerd::jsg::newExternalOneByteString(
+            js, kj::heapArray<const char>(payload.asArray()));
+        benchmark::DoNotOptimize(js.parseJson(text));
+      });
+    }
+  });
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+
 WD_BENCHMARK(Test_JSON_ENC);
 WD_BENCHMARK(Test_JSON_DEC);
+WD_BENCHMARK(Test_JSON_PARSE_LARGE_COPIED);
+WD_BENCHMARK(Test_JSON_PARSE_LARGE_EXTERNAL);
 // Register both functions as benchmarks – we link benchmark_main so there's no need for a main
 // function.
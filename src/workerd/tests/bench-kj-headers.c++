@@ -18,10 +18,36 @@ struct KjHeaders: public benchmark::Fixture {
     builder.add("Accept");
     builder.add("Content-Type");
     builder.add("Last-Modified");
+    for (auto name: kRegisteredNames) {
+      registeredIds.add(builder.add(name));
+    }
     table = builder.build();
   }
 
+  // Custom headers in the style of an application's own request metadata. The x-registered-*
+  // names are added to the table and the x-unregistered-* ones are not, so the custom benchmarks
+  // below differ only in that.
+  static constexpr kj::StringPtr kRegisteredNames[] = {"X-Registered-Request-Id",
+    "X-Registered-Tenant", "X-Registered-Trace", "X-Registered-Client", "X-Registered-Flags",
+    "X-Registered-Region", "X-Registered-Cache-Key", "X-Registered-Scope"};
+  static constexpr kj::StringPtr kUnregisteredNames[] = {"X-Unregistered-Request-Id",
+    "X-Unregistered-Tenant", "X-Unregistered-Trace", "X-Unregistered-Client",
+    "X-Unregistered-Flags", "X-Unregistered-Region", "X-Unregistered-Cache-Key",
+    "X-Unregistered-Scope"};
+
   kj::Own<kj::HttpHeaderTable> table;
+  kj::Vector<kj::HttpHeaderId> registeredIds;
+
+  static kj::String customRequest(kj::ArrayPtr<const kj::StringPtr> names) {
+    kj::Vector<kj::String> lines;
+    for (auto name: names) {
+      lines.add(kj::str(name, ": 0123456789abcdef\r\n"));
+    }
+    return kj::str("GET /api/v1/items HTTP/1.1\r\n"
+                   "Host: example.com\r\n"
+                   "Accept: application/json\r\n",
+        kj::strArray(lines, ""), "\r\n");
+  }
 };
 
 BENCHMARK_F(KjHeaders, Parse)(benchmark::State& state) {
@@ -48,5 +74,42 @@ BENCHMARK_F(KjHeaders, Parse)(benchmark::State& state) {
   }
 }
 
+BENCHMARK_F(KjHeaders, ParseCustomRegistered)(benchmark::State& state) {
+  kj::String in = customRequest(kRegisteredNames);
+
+  for (auto _: state) {
+    kj::HttpHeaders headers(*table);
+
+    for (size_t i = 0; i < 1000; ++i) {
+      benchmark::DoNotOptimize(
+          headers.tryParseRequest(in.asArray()).is<kj::HttpHeaders::Request>());
+      for (auto id: registeredIds) {
+        benchmark::DoNotOptimize(headers.get(id));
+      }
+    }
+  }
+}
+
+BENCHMARK_F(KjHeaders, ParseCustomUnregistered)(benchmark::State& state) {
+  kj::String in = customRequest(kUnregisteredNames);
+
+  for (auto _: state) {
+    kj::HttpHeaders headers(*table);
+
+    for (size_t i = 0; i < 1000; ++i) {
+      benchmark::DoNotOptimize(
+          headers.tryParseRequest(in.asArray()).is<kj::HttpHeaders::Request>());
+      // Without an ID, the only way to find a header is to scan for it by name.
+      for (auto name: kUnregisteredNames) {
+        kj::Maybe<kj::StringPtr> found;
+        headers.forEach([&](kj::StringPtr n, kj::StringPtr value) {
+          if (found == kj::none && n == name) found = value;
+        });
+        benchmark::DoNotOptimize(found);
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace workerd
@@ -101,5 +101,53 @@ BENCHMARK_F(Response, jsonResponse)(benchmark::State& state) {
   });
 }
 
+// A ~400KB JSON array of small objects, ASCII as most JSON is.
+kj::String makeLargeJson() {
+  kj::Vector<kj::String> items;
+  for (auto i: kj::zeroTo(16384)) {
+    items.add(kj::str("{\"id\":", i, ",\"name\":\"item-", i, "\"}"));
+  }
+  return kj::str("[", kj::strArray(items, ","), "]");
+}
+
+// Benchmark: reading a large body as text
+// Pattern: await new Response(largeString).text()
+BENCHMARK_F(Response, largeBodyText)(benchmark::State& state) {
+  auto payload = makeLargeJson();
+  for (auto _: state) {
+    fixture->runInIoContext([&](const TestFixture::Environment& env) {
+      auto& js = env.js;
+      auto response = api::Response::constructor(
+          js, api::Body::Initializer(kj::str(payload)), kj::none);
+      auto promise = response->text(js);
+      return env.context.awaitJs(js,
+          promise.then(js,
+              [response = kj::mv(response)](jsg::Lock&, jsg::JsRef<jsg::JsString> text) {
+        benchmark::DoNotOptimize(text);
+      }));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+
+// Benchmark: reading a large body as JSON
+// Pattern: await new Response(largeString).json()
+BENCHMARK_F(Response, largeBodyJson)(benchmark::State& state) {
+  auto payload = makeLargeJson();
+  for (auto _: state) {
+    fixture->runInIoContext([&](const TestFixture::Environment& env) {
+      auto& js = env.js;
+      auto response = api::Response::constructor(
+          js, api::Body::Initializer(kj::str(payload)), kj::none);
+      auto promise = response->json(js);
+      return env.context.awaitJs(
+          js, promise.then(js, [response = kj::mv(response)](jsg::Lock&, jsg::Value value) {
+        benchmark::DoNotOptimize(value);
+      }));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+
 }  // namespace
 }  // namespace workerd
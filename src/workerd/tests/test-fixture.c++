@@ -359,7 +359,9 @@ TestFixture::TestFixture(SetupParams&& params)
           kj::atomicRefcounted<IsolateObserver>(),
           scriptId,
           kj::rc<MockIsolateLimitEnforcer>(kj::atomicAddRef(*heapLimitFlag)).toOwn(),
-          Worker::Isolate::InspectorPolicy::DISALLOW)),
+          Worker::Isolate::InspectorPolicy::DISALLOW,
+          Worker::LoggingOptions(),
+          params.diagnostics)),
       workerScript(kj::atomicRefcounted<Worker::Script>(kj::atomicAddRef(*workerIsolate),
           scriptId,
           server::WorkerdApi::extractSource(mainModuleName,
@@ -55,6 +55,8 @@ struct TestFixture {
     // no-op base RequestObserver. Lets tests observe metrics hooks (e.g. recording the values
     // passed to setNextSubrequestBodyRewindable()).
     kj::Maybe<kj::Function<kj::Own<RequestObserver>()>> requestObserverFactory;
+    // Passed to the Worker::Isolate, so tests can watch it with e.g. a StallDetector.
+    Worker::Isolate::Diagnostics diagnostics;
   };
 
   TestFixture(SetupParams&& params = {.useRealTimers = false});
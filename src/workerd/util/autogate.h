@@ -106,7 +106,10 @@ namespace workerd::util {
   /* Allow a Socket to be transferred over JS RPC. When disabled, serializing a Socket fails as    \
      though the type were not serializable at all, and an incoming transferred Socket is           \
      rejected. */                                                                                  \
-  V(SOCKET_RPC_TRANSFER)
+  V(SOCKET_RPC_TRANSFER)                                                                           \
+  /* Allocate IoOwn bookkeeping nodes from a per-IoContext arena instead of one heap allocation    \
+     each. */                                                                                      \
+  V(IO_OWN_ARENA)
 // clang-format on
 // --------------------------------------------------------------------------------------
 
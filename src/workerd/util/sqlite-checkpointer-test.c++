@@ -0,0 +1,108 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-checkpointer.h"
+
+#include <kj/test.h>
+
+#include <unistd.h>
+
+namespace workerd {
+namespace {
+
+struct GlobalInit {
+  GlobalInit() {
+    installSqliteCustomAllocator();
+  }
+};
+
+static GlobalInit init;
+
+// Polls until `condition` holds, failing the test if it doesn't within a few seconds.
+template <typename Func>
+void waitFor(Func&& condition) {
+  for (uint i = 0; i < 500; i++) {
+    if (condition()) return;
+    usleep(10'000);
+  }
+  KJ_FAIL_EXPECT("timed out");
+}
+
+uint walFrames(SqliteDatabase& db) {
+  return KJ_ASSERT_NONNULL(db.checkpointWal()).walFrames;
+}
+
+KJ_TEST("SqliteCheckpointer checkpoints idle databases in the background") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteCheckpointer checkpointer({
+    .idleDelay = 10 * kj::MILLISECONDS,
+    .pollInterval = 5 * kj::MILLISECONDS,
+  });
+
+  SqliteDatabase db(vfs, kj::Path({"foo"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+  db.run("PRAGMA journal_mode=WAL;");
+  checkpointer.add(db, vfs, kj::Path({"foo"}));
+
+  db.run("CREATE TABLE things (id INTEGER PRIMARY KEY, value TEXT)");
+  for (auto i: kj::zeroTo(100)) {
+    db.run("INSERT INTO things VALUES (?, ?)", i, kj::str("value ", i));
+  }
+
+  waitFor([&]() { return checkpointer.getStats().backgroundCheckpoints > 0; });
+  KJ_EXPECT(checkpointer.getStats().inlineCheckpoints == 0);
+
+  // The background checkpoint copied everything back, so the next write restarts the WAL from
+  // the beginning.
+  db.run("INSERT INTO things VALUES (1000, 'more')");
+  KJ_EXPECT(walFrames(db) < 10);
+}
+
+KJ_TEST("SqliteCheckpointer checkpoints inline when a database never goes idle") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteCheckpointer checkpointer({
+    .idleDelay = 1 * kj::HOURS,
+    .maxWalFrames = 20,
+  });
+
+  SqliteDatabase db(vfs, kj::Path({"foo"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+  db.run("PRAGMA journal_mode=WAL;");
+  checkpointer.add(db, vfs, kj::Path({"foo"}));
+
+  db.run("CREATE TABLE things (id INTEGER PRIMARY KEY, value BLOB)");
+  for (auto i: kj::zeroTo(100)) {
+    db.run("INSERT INTO things VALUES (?, zeroblob(2000))", i);
+  }
+
+  KJ_EXPECT(checkpointer.getStats().backgroundCheckpoints == 0);
+  KJ_EXPECT(checkpointer.getStats().inlineCheckpoints > 0);
+  KJ_EXPECT(walFrames(db) < 100);
+}
+
+KJ_TEST("SqliteCheckpointer keeps working across reset()") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteCheckpointer checkpointer({
+    .idleDelay = 10 * kj::MILLISECONDS,
+    .pollInterval = 5 * kj::MILLISECONDS,
+  });
+
+  SqliteDatabase db(vfs, kj::Path({"foo"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+  db.run("PRAGMA journal_mode=WAL;");
+  db.afterReset([](SqliteDatabase& db) { db.run("PRAGMA journal_mode=WAL;"); });
+  checkpointer.add(db, vfs, kj::Path({"foo"}));
+
+  db.run("CREATE TABLE things (id INTEGER PRIMARY KEY)");
+  db.reset();
+  KJ_EXPECT(db.run("SELECT COUNT(*) FROM sqlite_master").getInt(0) == 0);
+
+  // reset() waited out any checkpoint in flight, and the next one needs a new commit.
+  auto before = checkpointer.getStats().backgroundCheckpoints;
+  db.run("CREATE TABLE others (id INTEGER PRIMARY KEY)");
+  waitFor([&]() { return checkpointer.getStats().backgroundCheckpoints > before; });
+}
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,143 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-checkpointer.h"
+
+#include <kj/debug.h>
+#include <kj/vector.h>
+
+namespace workerd {
+
+// Owned by the SqliteDatabase, so checkpointing for a database stops when it is destroyed.
+class SqliteCheckpointer::Hooks final: public SqliteDatabase::WalHooks {
+ public:
+  Hooks(SqliteCheckpointer& checkpointer, uint64_t id): checkpointer(checkpointer), id(id) {}
+  ~Hooks() noexcept(false) {
+    checkpointer.remove(id);
+  }
+
+  void afterWalCommit(SqliteDatabase& db, uint walFrames) override {
+    checkpointer.afterWalCommit(id, db, walFrames);
+  }
+
+  void beforeReset() override {
+    checkpointer.pause(id);
+  }
+
+ private:
+  SqliteCheckpointer& checkpointer;
+  uint64_t id;
+};
+
+SqliteCheckpointer::SqliteCheckpointer(Options options)
+    : options(options),
+      clock(kj::systemPreciseMonotonicClock()) {
+  poller.runDetached([this]() { poll(); }, options.pollInterval);
+}
+
+void SqliteCheckpointer::add(SqliteDatabase& db, const SqliteDatabase::Vfs& vfs, kj::Path path) {
+  uint64_t id;
+  {
+    auto lock = state.lockExclusive();
+    id = lock->nextId++;
+    lock->entries.insert(id, Entry{.vfs = &vfs, .path = kj::mv(path)});
+  }
+  db.setWalHooks(kj::heap<Hooks>(*this, id));
+}
+
+void SqliteCheckpointer::afterWalCommit(uint64_t id, SqliteDatabase& db, uint walFrames) {
+  {
+    auto lock = state.lockExclusive();
+    auto& entry = KJ_ASSERT_NONNULL(lock->entries.find(id));
+    entry.pendingFrames = walFrames;
+    entry.lastCommit = clock.now();
+    ++entry.commitCount;
+    if (walFrames < options.maxWalFrames || entry.busy) {
+      return;
+    }
+  }
+
+  // The database hasn't been idle long enough for the background thread to keep up. Checkpoint
+  // here rather than let the WAL grow without bound.
+  KJ_IF_SOME(result, db.checkpointWal()) {
+    ++stats.lockExclusive()->inlineCheckpoints;
+    if (result.checkpointedFrames == result.walFrames) {
+      KJ_ASSERT_NONNULL(state.lockExclusive()->entries.find(id)).pendingFrames = 0;
+    }
+  }
+}
+
+void SqliteCheckpointer::pause(uint64_t id) {
+  auto lock = state.lockExclusive();
+  lock.wait([id](const State& s) { return !KJ_ASSERT_NONNULL(s.entries.find(id)).busy; });
+  // The next commit will make the database eligible again.
+  KJ_ASSERT_NONNULL(lock->entries.find(id)).pendingFrames = 0;
+}
+
+void SqliteCheckpointer::remove(uint64_t id) {
+  auto lock = state.lockExclusive();
+  lock.wait([id](const State& s) {
+    KJ_IF_SOME(entry, s.entries.find(id)) {
+      return !entry.busy;
+    }
+    return true;
+  });
+  lock->entries.erase(id);
+}
+
+void SqliteCheckpointer::poll() {
+  struct Due {
+    uint64_t id;
+    const SqliteDatabase::Vfs& vfs;
+    kj::Path path;
+    uint64_t commitCount;
+  };
+
+  kj::Vector<Due> due;
+  {
+    auto lock = state.lockExclusive();
+    auto now = clock.now();
+    for (auto& entry: lock->entries) {
+      auto& e = entry.value;
+      if (e.pendingFrames > 0 && !e.busy && now - e.lastCommit >= options.idleDelay) {
+        e.busy = true;
+        due.add(Due{entry.key, *e.vfs, e.path.clone(), e.commitCount});
+      }
+    }
+  }
+
+  for (auto& d: due) {
+    auto result = checkpoint(d.vfs, d.path);
+    ++stats.lockExclusive()->backgroundCheckpoints;
+
+    auto lock = state.lockExclusive();
+    auto& entry = KJ_ASSERT_NONNULL(lock->entries.find(d.id));
+    entry.busy = false;
+    KJ_IF_SOME(r, result) {
+      // If a reader was still using old frames the checkpoint is partial; we'll retry on the
+      // next pass. If a commit raced with us, its frames are still pending.
+      if (r.checkpointedFrames == r.walFrames && entry.commitCount == d.commitCount) {
+        entry.pendingFrames = 0;
+      }
+    }
+  }
+
+  // Dropped if the checkpointer is being destroyed.
+  poller.runDetached([this]() { poll(); }, options.pollInterval);
+}
+
+kj::Maybe<SqliteDatabase::WalCheckpointResult> SqliteCheckpointer::checkpoint(
+    const SqliteDatabase::Vfs& vfs, const kj::Path& path) {
+  kj::Maybe<SqliteDatabase::WalCheckpointResult> result;
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+    // Opened without CREATE so we never resurrect a database that was deleted out from under us.
+    SqliteDatabase db(vfs, path.clone(), kj::WriteMode::MODIFY);
+    result = db.checkpointWal();
+  })) {
+    KJ_LOG(ERROR, "background WAL checkpoint failed", path, exception);
+  }
+  return result;
+}
+
+}  // namespace workerd
@@ -0,0 +1,104 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/util/sqlite.h>
+#include <workerd/util/thread-pool.h>
+
+#include <kj/map.h>
+#include <kj/mutex.h>
+#include <kj/time.h>
+
+namespace workerd {
+
+// Runs WAL checkpoints for a set of databases on a background thread.
+//
+// By default, SQLite checkpoints on the thread of whichever commit pushes the WAL past 1000 pages,
+// which for a write-heavy database means a periodic multi-millisecond stall in the middle of a
+// commit. Databases added to a SqliteCheckpointer instead have PASSIVE checkpoints run on a
+// separate connection, opened through the same Vfs, once no commit has landed for `idleDelay`.
+// If a database never goes idle and its WAL reaches `maxWalFrames`, the committing thread falls
+// back to checkpointing inline, so the WAL stays bounded.
+class SqliteCheckpointer {
+ public:
+  struct Options {
+    // How long a database must go without a commit before it is checkpointed.
+    kj::Duration idleDelay = 100 * kj::MILLISECONDS;
+
+    // How often the background thread looks for databases to checkpoint.
+    kj::Duration pollInterval = 50 * kj::MILLISECONDS;
+
+    // WAL size, in frames (pages), at which the committing thread checkpoints inline.
+    uint maxWalFrames = 10000;
+  };
+
+  explicit SqliteCheckpointer(Options options);
+  SqliteCheckpointer(): SqliteCheckpointer(Options{}) {}
+  KJ_DISALLOW_COPY_AND_MOVE(SqliteCheckpointer);
+
+  // Takes over checkpointing for `db`, which must be in WAL mode. `vfs` and `path` must be the
+  // ones `db` was opened with; `vfs` must outlive `db`. Checkpointing stops when `db` is destroyed.
+  void add(SqliteDatabase& db, const SqliteDatabase::Vfs& vfs, kj::Path path);
+
+  struct Stats {
+    // Checkpoints run by the background thread.
+    uint64_t backgroundCheckpoints = 0;
+
+    // Checkpoints run inline because a WAL reached `maxWalFrames`.
+    uint64_t inlineCheckpoints = 0;
+  };
+
+  Stats getStats() const {
+    return *stats.lockShared();
+  }
+
+ private:
+  class Hooks;
+
+  struct Entry {
+    // Not a reference so that Entry stays move-assignable for the HashMap.
+    const SqliteDatabase::Vfs* vfs;
+    kj::Path path;
+
+    // Frames in the WAL as of the last commit, or 0 if they have all been checkpointed since.
+    uint pendingFrames = 0;
+    kj::TimePoint lastCommit = kj::origin<kj::TimePoint>();
+
+    // Bumped on every commit, so the background thread can tell whether its checkpoint raced
+    // with one.
+    uint64_t commitCount = 0;
+
+    // True while the background thread is checkpointing this database.
+    bool busy = false;
+  };
+
+  struct State {
+    kj::HashMap<uint64_t, Entry> entries;
+    uint64_t nextId = 0;
+  };
+
+  Options options;
+  const kj::MonotonicClock& clock;
+  kj::MutexGuarded<State> state;
+  kj::MutexGuarded<Stats> stats;
+
+  // Runs poll() every `pollInterval`. Declared last so that a pass in progress finishes before
+  // the rest of the object is torn down.
+  ThreadPool poller{{.threadCount = 1}};
+
+  // One pass over the databases, checkpointing those that have gone idle.
+  void poll();
+
+  // Opens a separate connection to the database and checkpoints it.
+  static kj::Maybe<SqliteDatabase::WalCheckpointResult> checkpoint(
+      const SqliteDatabase::Vfs& vfs, const kj::Path& path);
+
+  // Called from Hooks on the database's own thread.
+  void afterWalCommit(uint64_t id, SqliteDatabase& db, uint walFrames);
+  void pause(uint64_t id);
+  void remove(uint64_t id);
+};
+
+}  // namespace workerd
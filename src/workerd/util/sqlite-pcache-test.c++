@@ -0,0 +1,72 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-pcache.h"
+
+#include <workerd/util/sqlite.h>
+
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+constexpr size_t BUDGET = 256 * 1024;
+
+struct GlobalInit {
+  GlobalInit() {
+    // Must come before anything initializes SQLite.
+    KJ_ASSERT(installSqlitePageCache(BUDGET));
+    installSqliteCustomAllocator();
+  }
+};
+
+static GlobalInit init;
+
+void fill(SqliteDatabase& db, uint rows) {
+  db.run("CREATE TABLE things (id INTEGER PRIMARY KEY, value BLOB)");
+  for (auto i: kj::zeroTo(rows)) {
+    db.run("INSERT INTO things VALUES (?, randomblob(1000))", i);
+  }
+}
+
+KJ_TEST("shared page cache stays within its budget across databases") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteDatabase db1(vfs, kj::Path({"one"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+  SqliteDatabase db2(vfs, kj::Path({"two"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+
+  // Each database alone is bigger than the whole budget.
+  fill(db1, 500);
+  fill(db2, 500);
+
+  auto stats = KJ_ASSERT_NONNULL(getSqlitePageCacheStats());
+  KJ_EXPECT(stats.budgetBytes == BUDGET);
+  KJ_EXPECT(stats.usedBytes <= BUDGET, stats.usedBytes);
+  KJ_EXPECT(stats.evictions > 0);
+  KJ_EXPECT(stats.pinnedPages == 0);
+
+  // Evicted pages are read back correctly.
+  KJ_EXPECT(db1.run("SELECT COUNT(*) FROM things").getInt(0) == 500);
+  KJ_EXPECT(db1.run("SELECT SUM(length(value)) FROM things").getInt(0) == 500'000);
+  KJ_EXPECT(db2.run("SELECT SUM(length(value)) FROM things").getInt(0) == 500'000);
+}
+
+KJ_TEST("shared page cache reports per-database hits") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteDatabase db(vfs, kj::Path({"foo"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+  fill(db, 20);
+
+  // The table fits in the budget, so scanning it again is served from the cache.
+  db.run("SELECT SUM(length(value)) FROM things");
+  auto before = db.getPageCacheStats();
+  db.run("SELECT SUM(length(value)) FROM things");
+  auto after = db.getPageCacheStats();
+
+  KJ_EXPECT(after.hits > before.hits);
+  KJ_EXPECT(after.usedBytes > 0);
+}
+
+}  // namespace
+}  // namespace workerd
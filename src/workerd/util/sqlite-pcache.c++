@@ -0,0 +1,306 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-pcache.h"
+
+#include <sqlite3.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kj/debug.h>
+#include <kj/list.h>
+#include <kj/map.h>
+#include <kj/mutex.h>
+#include <kj/vector.h>
+
+namespace workerd {
+namespace {
+
+struct Cache;
+
+// A page is allocated as one block: this header, then the page content, then SQLite's "extra"
+// bytes.
+struct Page {
+  // Must be first: SQLite hands this back to us and we cast it to Page.
+  sqlite3_pcache_page base;
+
+  Cache* cache;
+  unsigned key;
+  size_t allocSize;
+  bool pinned;
+
+  // Linked into Pool::lru while unpinned, if the cache is purgeable.
+  kj::ListLink<Page> lruLink;
+};
+
+struct Cache {
+  int pageSize;
+  int extraSize;
+  bool purgeable;
+  kj::HashMap<unsigned, Page*> pages;
+
+  size_t pageAllocSize() const {
+    return sizeof(Page) + pageSize + extraSize;
+  }
+};
+
+struct Pool {
+  explicit Pool(size_t budgetBytes): budgetBytes(budgetBytes) {}
+
+  size_t budgetBytes;
+  size_t usedBytes = 0;
+  size_t pages = 0;
+  size_t pinnedPages = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+
+  // Unpinned pages of purgeable caches, least recently unpinned first.
+  kj::List<Page, &Page::lruLink> lru;
+
+  // Removes `page` from its cache and from the LRU list, without freeing it.
+  void detach(Page& page) {
+    if (page.lruLink.isLinked()) {
+      lru.remove(page);
+    }
+    if (page.pinned) {
+      page.pinned = false;
+      --pinnedPages;
+    }
+    page.cache->pages.erase(page.key);
+  }
+
+  void free(Page& page) {
+    detach(page);
+    usedBytes -= page.allocSize;
+    --pages;
+    kj::dtor(page.lruLink);
+    ::free(&page);
+  }
+};
+
+kj::MutexGuarded<Pool>* globalPool = nullptr;
+
+Page& toPage(sqlite3_pcache_page* page) {
+  return *reinterpret_cast<Page*>(page);
+}
+
+Cache& toCache(sqlite3_pcache* cache) {
+  return *reinterpret_cast<Cache*>(cache);
+}
+
+int pcacheInit(void*) {
+  return SQLITE_OK;
+}
+
+void pcacheShutdown(void*) {}
+
+sqlite3_pcache* pcacheCreate(int pageSize, int extraSize, int purgeable) {
+  auto cache = new Cache{.pageSize = pageSize, .extraSize = extraSize, .purgeable = !!purgeable};
+  return reinterpret_cast<sqlite3_pcache*>(cache);
+}
+
+void pcacheCachesize(sqlite3_pcache*, int) {
+  // The pool's budget applies instead.
+}
+
+int pcachePagecount(sqlite3_pcache* cache) {
+  auto lock = globalPool->lockExclusive();
+  return toCache(cache).pages.size();
+}
+
+sqlite3_pcache_page* pcacheFetch(sqlite3_pcache* cachePtr, unsigned key, int createFlag) {
+  auto& cache = toCache(cachePtr);
+  auto pool = globalPool->lockExclusive();
+
+  KJ_IF_SOME(page, cache.pages.find(key)) {
+    ++pool->hits;
+    if (!page->pinned) {
+      if (page->lruLink.isLinked()) {
+        pool->lru.remove(*page);
+      }
+      page->pinned = true;
+      ++pool->pinnedPages;
+    }
+    return &page->base;
+  }
+
+  ++pool->misses;
+  if (createFlag == 0) {
+    return nullptr;
+  }
+
+  // Make room by evicting the least recently used pages, reusing the first one if it is the
+  // right size.
+  size_t size = cache.pageAllocSize();
+  Page* page = nullptr;
+  while (pool->usedBytes + (page == nullptr ? size : 0) > pool->budgetBytes &&
+      !pool->lru.empty()) {
+    Page& victim = pool->lru.front();
+    ++pool->evictions;
+    if (page == nullptr && victim.allocSize == size) {
+      pool->detach(victim);
+      page = &victim;
+    } else {
+      pool->free(victim);
+    }
+  }
+
+  if (page == nullptr) {
+    // createFlag == 1 means SQLite can cope without the page (e.g. by spilling dirty pages), so
+    // only go over budget when it insists.
+    if (pool->usedBytes + size > pool->budgetBytes && createFlag == 1) {
+      return nullptr;
+    }
+    page = static_cast<Page*>(malloc(size));
+    if (page == nullptr) {
+      return nullptr;
+    }
+    pool->usedBytes += size;
+    ++pool->pages;
+  }
+
+  kj::ctor(page->lruLink);
+  page->base.pBuf = page + 1;
+  page->base.pExtra = static_cast<kj::byte*>(page->base.pBuf) + cache.pageSize;
+  // SQLite expects the extra bytes of a new page to start zeroed.
+  memset(page->base.pExtra, 0, cache.extraSize);
+  page->cache = &cache;
+  page->key = key;
+  page->allocSize = size;
+  page->pinned = true;
+  ++pool->pinnedPages;
+  cache.pages.insert(key, page);
+  return &page->base;
+}
+
+void pcacheUnpin(sqlite3_pcache* cachePtr, sqlite3_pcache_page* pagePtr, int discard) {
+  auto& cache = toCache(cachePtr);
+  auto& page = toPage(pagePtr);
+  auto pool = globalPool->lockExclusive();
+
+  if (discard) {
+    pool->free(page);
+    return;
+  }
+
+  page.pinned = false;
+  --pool->pinnedPages;
+  if (cache.purgeable) {
+    pool->lru.add(page);
+  }
+}
+
+void pcacheRekey(sqlite3_pcache* cachePtr,
+    sqlite3_pcache_page* pagePtr,
+    unsigned oldKey,
+    unsigned newKey) {
+  auto& cache = toCache(cachePtr);
+  auto& page = toPage(pagePtr);
+  auto pool = globalPool->lockExclusive();
+
+  // SQLite guarantees that any page already at `newKey` is unpinned, and wants it discarded.
+  KJ_IF_SOME(existing, cache.pages.find(newKey)) {
+    pool->free(*existing);
+  }
+
+  cache.pages.erase(oldKey);
+  page.key = newKey;
+  cache.pages.insert(newKey, &page);
+}
+
+void pcacheTruncate(sqlite3_pcache* cachePtr, unsigned limit) {
+  auto& cache = toCache(cachePtr);
+  auto pool = globalPool->lockExclusive();
+
+  // Pages at or beyond `limit` are discarded even if pinned.
+  kj::Vector<Page*> doomed;
+  for (auto& entry: cache.pages) {
+    if (entry.key >= limit) {
+      doomed.add(entry.value);
+    }
+  }
+  for (auto page: doomed) {
+    pool->free(*page);
+  }
+}
+
+void pcacheDestroy(sqlite3_pcache* cachePtr) {
+  auto& cache = toCache(cachePtr);
+  {
+    auto pool = globalPool->lockExclusive();
+    auto pages = KJ_MAP(entry, cache.pages) { return entry.value; };
+    for (auto page: pages) {
+      pool->free(*page);
+    }
+  }
+  delete &cache;
+}
+
+void pcacheShrink(sqlite3_pcache* cachePtr) {
+  auto& cache = toCache(cachePtr);
+  auto pool = globalPool->lockExclusive();
+
+  kj::Vector<Page*> unpinned;
+  for (auto& entry: cache.pages) {
+    if (!entry.value->pinned) {
+      unpinned.add(entry.value);
+    }
+  }
+  for (auto page: unpinned) {
+    pool->free(*page);
+  }
+}
+
+const sqlite3_pcache_methods2 kPcacheMethods = {
+  .iVersion = 1,
+  .pArg = nullptr,
+  .xInit = pcacheInit,
+  .xShutdown = pcacheShutdown,
+  .xCreate = pcacheCreate,
+  .xCachesize = pcacheCachesize,
+  .xPagecount = pcachePagecount,
+  .xFetch = pcacheFetch,
+  .xUnpin = pcacheUnpin,
+  .xRekey = pcacheRekey,
+  .xTruncate = pcacheTruncate,
+  .xDestroy = pcacheDestroy,
+  .xShrink = pcacheShrink,
+};
+
+}  // namespace
+
+bool installSqlitePageCache(size_t budgetBytes) {
+  static bool installed = [&]() {
+    // Intentionally leaked: SQLite may use the page cache until the process exits.
+    globalPool = new kj::MutexGuarded<Pool>(budgetBytes);
+    int rc = sqlite3_config(SQLITE_CONFIG_PCACHE2, &kPcacheMethods);
+    if (rc != SQLITE_OK) {
+      // SQLite was already initialized.
+      delete globalPool;
+      globalPool = nullptr;
+      return false;
+    }
+    return true;
+  }();
+  return installed;
+}
+
+kj::Maybe<SqlitePageCacheStats> getSqlitePageCacheStats() {
+  if (globalPool == nullptr) {
+    return kj::none;
+  }
+  auto pool = globalPool->lockShared();
+  return SqlitePageCacheStats{
+    .budgetBytes = pool->budgetBytes,
+    .usedBytes = pool->usedBytes,
+    .pages = pool->pages,
+    .pinnedPages = pool->pinnedPages,
+    .hits = pool->hits,
+    .misses = pool->misses,
+    .evictions = pool->evictions,
+  };
+}
+
+}  // namespace workerd
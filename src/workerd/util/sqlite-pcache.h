@@ -0,0 +1,51 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <kj/common.h>
+
+namespace workerd {
+
+// A process-wide SQLite page cache with a single byte budget.
+//
+// By default, every SQLite connection has its own page cache, capped by its `cache_size`. With
+// many databases open at once that either wastes memory on idle databases or starves hot ones.
+// Once installed, all connections draw pages from one pool instead: unpinned pages of every
+// database sit on one LRU list, and when the pool is at its budget, a new page is taken from the
+// least recently used database page anywhere in the process. Per-connection `cache_size` settings
+// are ignored.
+//
+// Pages of non-purgeable caches (temporary and in-memory databases) are counted against the
+// budget but never evicted. If every page in the pool is in use, SQLite may still get a page
+// beyond the budget rather than fail.
+//
+// Page cache memory is allocated directly with malloc(), so it is not counted against the
+// per-database limit enforced by SqliteMemoryScope.
+//
+// Returns false if SQLite has already been initialized, in which case the default page cache
+// stays in place. Like installSqliteCustomAllocator(), this must be called before the first
+// sqlite3_initialize(), sqlite3_open_v2(), or sqlite3_vfs_register() call in the process. Later
+// calls have no effect and return whether the first one succeeded.
+bool installSqlitePageCache(size_t budgetBytes);
+
+struct SqlitePageCacheStats {
+  size_t budgetBytes = 0;
+  size_t usedBytes = 0;
+  size_t pages = 0;
+  size_t pinnedPages = 0;
+
+  // xFetch() calls that found the page in the pool, and those that didn't.
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  // Pages reclaimed from the LRU list to make room for another.
+  uint64_t evictions = 0;
+};
+
+// Returns kj::none if installSqlitePageCache() hasn't been called successfully. Per-database
+// hit rates are available from SqliteDatabase::getPageCacheStats().
+kj::Maybe<SqlitePageCacheStats> getSqlitePageCacheStats();
+
+}  // namespace workerd
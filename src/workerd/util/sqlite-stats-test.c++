@@ -0,0 +1,120 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-stats.h"
+
+#include "sqlite.h"
+
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+struct GlobalInit {
+  GlobalInit() {
+    installSqliteCustomAllocator();
+  }
+};
+
+static GlobalInit init;
+
+KJ_TEST("SqliteStatementStats::normalize") {
+  auto normalize = SqliteStatementStats::normalize;
+
+  KJ_EXPECT(normalize("SELECT * FROM t WHERE id = 123") == "SELECT * FROM t WHERE id = ?");
+  KJ_EXPECT(normalize("SELECT * FROM t WHERE name = 'it''s'") == "SELECT * FROM t WHERE name = ?");
+  KJ_EXPECT(normalize("INSERT INTO t VALUES (1.5e-3, x'beef', -7)") ==
+      "INSERT INTO t VALUES (?, ?, -?)");
+  KJ_EXPECT(normalize("SELECT  a,\n\tb -- trailing\nFROM /* c */ t") == "SELECT a, b FROM t");
+
+  // Identifiers that contain digits, quoted identifiers, and parameters are kept.
+  KJ_EXPECT(normalize("SELECT col1 FROM \"t 2\" WHERE x = ?1 AND y = :y AND z = $z") ==
+      "SELECT col1 FROM \"t 2\" WHERE x = ?1 AND y = :y AND z = $z");
+  KJ_EXPECT(normalize("SELECT [a]]b], `c` FROM t") == "SELECT [a]]b], `c` FROM t");
+
+  auto longSql = kj::str("SELECT ", kj::repeat('a', SqliteStatementStats::MAX_SQL_SIZE));
+  KJ_EXPECT(normalize(longSql).size() == SqliteStatementStats::MAX_SQL_SIZE);
+}
+
+KJ_TEST("SqliteStatementStats aggregates by normalized SQL") {
+  SqliteStatementStats stats;
+  stats.record("SELECT * FROM t WHERE id = 1",
+      {.time = 3 * kj::MILLISECONDS, .rowsRead = 1, .rowsWritten = 0, .internal = false,
+        .cacheHit = false});
+  stats.record("SELECT *   FROM t WHERE id = 2",
+      {.time = 5 * kj::MILLISECONDS, .rowsRead = 2, .rowsWritten = 0, .internal = false,
+        .cacheHit = true});
+  stats.record("UPDATE t SET x = 1",
+      {.time = 10 * kj::MILLISECONDS, .rowsRead = 4, .rowsWritten = 4, .internal = true,
+        .cacheHit = false});
+
+  auto entries = stats.getEntries();
+  KJ_ASSERT(entries.size() == 2);
+
+  // Sorted by descending total time.
+  KJ_EXPECT(entries[0].sql == "UPDATE t SET x = ?");
+  KJ_EXPECT(entries[0].counters.internal);
+  KJ_EXPECT(entries[0].counters.rowsWritten == 4);
+
+  KJ_EXPECT(entries[1].sql == "SELECT * FROM t WHERE id = ?");
+  KJ_EXPECT(!entries[1].counters.internal);
+  KJ_EXPECT(entries[1].counters.calls == 2);
+  KJ_EXPECT(entries[1].counters.totalTime == 8 * kj::MILLISECONDS);
+  KJ_EXPECT(entries[1].counters.maxTime == 5 * kj::MILLISECONDS);
+  KJ_EXPECT(entries[1].counters.rowsRead == 3);
+  KJ_EXPECT(entries[1].counters.cacheHits == 1);
+
+  stats.clear();
+  KJ_EXPECT(stats.getEntries().size() == 0);
+}
+
+KJ_TEST("SqliteStatementStats is bounded") {
+  SqliteStatementStats stats;
+  SqliteStatementStats::Execution execution{
+    .time = 1 * kj::MICROSECONDS, .rowsRead = 0, .rowsWritten = 0, .internal = false,
+    .cacheHit = false};
+
+  for (auto i: kj::zeroTo(SqliteStatementStats::MAX_ENTRIES)) {
+    stats.record(kj::str("SELECT * FROM t", i), execution);
+  }
+  stats.record("SELECT * FROM overflow", execution);
+  stats.record("SELECT * FROM overflow", execution);
+  stats.record("SELECT * FROM t0", execution);
+
+  KJ_EXPECT(stats.getEntries().size() == SqliteStatementStats::MAX_ENTRIES);
+  KJ_EXPECT(stats.getDroppedCalls() == 2);
+}
+
+KJ_TEST("SqliteDatabase records statement stats once enabled") {
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  SqliteDatabase::Vfs vfs(*dir);
+  SqliteDatabase db(vfs, kj::Path({"foo"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+
+  db.run("CREATE TABLE things (id INTEGER PRIMARY KEY, value TEXT)");
+  KJ_EXPECT(db.getStatementStats() == kj::none);
+
+  db.enableStatementStats();
+  db.run("INSERT INTO things VALUES (1, 'one')");
+  db.run("INSERT INTO things VALUES (2, 'two')");
+  {
+    auto query = db.run("SELECT value FROM things WHERE id > 0");
+    while (!query.isDone()) query.nextRow();
+  }
+
+  auto entries = KJ_ASSERT_NONNULL(db.getStatementStats()).getEntries();
+  KJ_ASSERT(entries.size() == 2);
+  for (auto& entry: entries) {
+    if (entry.sql == "INSERT INTO things VALUES (?, ?)") {
+      KJ_EXPECT(entry.counters.calls == 2);
+      KJ_EXPECT(entry.counters.rowsWritten == 2);
+    } else {
+      KJ_EXPECT(entry.sql == "SELECT value FROM things WHERE id > ?", entry.sql);
+      KJ_EXPECT(entry.counters.calls == 1);
+      KJ_EXPECT(entry.counters.rowsRead >= 2);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,157 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sqlite-stats.h"
+
+#include <kj/vector.h>
+
+#include <algorithm>
+
+namespace workerd {
+
+namespace {
+
+bool isIdentifierChar(char c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' ||
+      c == '$' || static_cast<kj::byte>(c) >= 0x80;
+}
+
+bool isDigit(char c) {
+  return '0' <= c && c <= '9';
+}
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Returns the index just past the quoted token starting at `start`, which ends at the next
+// unescaped `close`. A doubled `close` character is an escaped one.
+size_t skipQuoted(kj::StringPtr sql, size_t start, char close) {
+  size_t i = start + 1;
+  while (i < sql.size()) {
+    if (sql[i] == close) {
+      if (i + 1 < sql.size() && sql[i + 1] == close && close != ']') {
+        i += 2;
+        continue;
+      }
+      return i + 1;
+    }
+    ++i;
+  }
+  return i;
+}
+
+}  // namespace
+
+kj::String SqliteStatementStats::normalize(kj::StringPtr sql) {
+  kj::Vector<char> result(kj::min(sql.size(), MAX_SQL_SIZE) + 1);
+  bool pendingSpace = false;
+
+  auto emit = [&](kj::ArrayPtr<const char> text) {
+    if (pendingSpace && result.size() > 0) {
+      result.add(' ');
+    }
+    pendingSpace = false;
+    result.addAll(text);
+  };
+
+  size_t i = 0;
+  while (i < sql.size() && result.size() < MAX_SQL_SIZE) {
+    char c = sql[i];
+    bool afterIdentifier = i > 0 && isIdentifierChar(sql[i - 1]);
+
+    if (isSpace(c)) {
+      pendingSpace = true;
+      ++i;
+    } else if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+      while (i < sql.size() && sql[i] != '\n') ++i;
+      pendingSpace = true;
+    } else if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+      auto end = sql.slice(i + 2).find("*/"_kj);
+      i = end.map([&](size_t e) { return i + 2 + e + 2; }).orDefault(sql.size());
+      pendingSpace = true;
+    } else if (c == '\'') {
+      i = skipQuoted(sql, i, '\'');
+      emit("?"_kj);
+    } else if ((c == 'x' || c == 'X') && !afterIdentifier && i + 1 < sql.size() &&
+        sql[i + 1] == '\'') {
+      i = skipQuoted(sql, i + 1, '\'');
+      emit("?"_kj);
+    } else if (c == '"' || c == '`' || c == '[') {
+      size_t end = skipQuoted(sql, i, c == '[' ? ']' : c);
+      emit(sql.slice(i, end));
+      i = end;
+    } else if (!afterIdentifier &&
+        (isDigit(c) || (c == '.' && i + 1 < sql.size() && isDigit(sql[i + 1])))) {
+      // Numeric literal, including hex (0x...) and exponent (1e-5) forms.
+      ++i;
+      while (i < sql.size()) {
+        char n = sql[i];
+        if (isIdentifierChar(n) || n == '.') {
+          ++i;
+        } else if ((n == '+' || n == '-') && (sql[i - 1] == 'e' || sql[i - 1] == 'E')) {
+          ++i;
+        } else {
+          break;
+        }
+      }
+      emit("?"_kj);
+    } else {
+      size_t end = i + 1;
+      if (isIdentifierChar(c) || c == '?' || c == ':' || c == '@') {
+        // Keep identifiers, keywords, and parameter names (?1, :name, @name, $name) whole.
+        while (end < sql.size() && isIdentifierChar(sql[end])) ++end;
+      }
+      emit(sql.slice(i, end));
+      i = end;
+    }
+  }
+
+  if (result.size() > MAX_SQL_SIZE) {
+    result.truncate(MAX_SQL_SIZE);
+  }
+  result.add('\0');
+  return kj::String(result.releaseAsArray());
+}
+
+void SqliteStatementStats::record(kj::StringPtr sql, const Execution& execution) {
+  auto key = normalize(sql);
+
+  Counters* counters;
+  KJ_IF_SOME(existing, entries.find(key)) {
+    counters = &existing;
+  } else {
+    if (entries.size() >= MAX_ENTRIES) {
+      ++droppedCalls;
+      return;
+    }
+    counters = &entries.insert(kj::mv(key), Counters{.internal = execution.internal}).value;
+  }
+
+  ++counters->calls;
+  counters->totalTime += execution.time;
+  counters->maxTime = kj::max(counters->maxTime, execution.time);
+  counters->rowsRead += execution.rowsRead;
+  counters->rowsWritten += execution.rowsWritten;
+  if (execution.cacheHit) {
+    ++counters->cacheHits;
+  }
+}
+
+kj::Array<SqliteStatementStats::Entry> SqliteStatementStats::getEntries() const {
+  auto result = KJ_MAP(entry, entries) {
+    return Entry{.sql = kj::str(entry.key), .counters = entry.value};
+  };
+  std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+    return a.counters.totalTime > b.counters.totalTime;
+  });
+  return result;
+}
+
+void SqliteStatementStats::clear() {
+  entries.clear();
+  droppedCalls = 0;
+}
+
+}  // namespace workerd
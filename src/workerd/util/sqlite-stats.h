@@ -0,0 +1,76 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <kj/map.h>
+#include <kj/string.h>
+#include <kj/time.h>
+
+namespace workerd {
+
+// Aggregate statistics about the statements executed on one SqliteDatabase, in the spirit of
+// Postgres's pg_stat_statements. Executions are grouped by normalized SQL text (see normalize()),
+// so queries that differ only in literal values, whitespace, or comments share an entry.
+//
+// The table is bounded: once it holds MAX_ENTRIES statements, executions of statements not
+// already in the table are only counted in getDroppedCalls().
+class SqliteStatementStats {
+ public:
+  static constexpr size_t MAX_ENTRIES = 1000;
+
+  // Normalized SQL longer than this is truncated, so very long statements that share a prefix
+  // may share an entry.
+  static constexpr size_t MAX_SQL_SIZE = 1024;
+
+  struct Execution {
+    // Time spent stepping the statement. Time the caller spends between rows is not included.
+    kj::Duration time;
+    uint64_t rowsRead;
+    uint64_t rowsWritten;
+
+    // True if the statement was run by the system rather than on behalf of the application.
+    bool internal;
+
+    // True if the statement was taken from the caller's prepared statement cache rather than
+    // compiled for this execution.
+    bool cacheHit;
+  };
+
+  struct Counters {
+    bool internal = false;
+    uint64_t calls = 0;
+    kj::Duration totalTime = 0 * kj::NANOSECONDS;
+    kj::Duration maxTime = 0 * kj::NANOSECONDS;
+    uint64_t rowsRead = 0;
+    uint64_t rowsWritten = 0;
+    uint64_t cacheHits = 0;
+  };
+
+  struct Entry {
+    kj::String sql;
+    Counters counters;
+  };
+
+  void record(kj::StringPtr sql, const Execution& execution);
+
+  // Returns a copy of the table, sorted by descending total time.
+  kj::Array<Entry> getEntries() const;
+
+  uint64_t getDroppedCalls() const {
+    return droppedCalls;
+  }
+
+  void clear();
+
+  // Replaces string, blob, and numeric literals with `?`, drops comments, and collapses runs of
+  // whitespace into a single space. Quoted identifiers and parameter names are left alone.
+  static kj::String normalize(kj::StringPtr sql);
+
+ private:
+  kj::HashMap<kj::String, Counters> entries;
+  uint64_t droppedCalls = 0;
+};
+
+}  // namespace workerd
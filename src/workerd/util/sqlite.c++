@@ -638,6 +638,77 @@ void SqliteDatabase::init(kj::Maybe<kj::WriteMode> maybeMode) {
   setupSecurity(db);
 
   maybeDb = *db;
+  if (walHooks != kj::none) {
+    installWalHooks();
+  }
+}
+
+void SqliteDatabase::setWalHooks(kj::Maybe<kj::Own<WalHooks>> hooks) {
+  walHooks = kj::mv(hooks);
+  installWalHooks();
+}
+
+void SqliteDatabase::installWalHooks() {
+  sqlite3* db = &KJ_UNWRAP_OR(maybeDb, return);
+
+  if (walHooks == kj::none) {
+    // sqlite3_wal_autocheckpoint() reinstalls SQLite's own WAL hook, with the default threshold.
+    sqlite3_wal_autocheckpoint(db, 1000);
+    return;
+  }
+
+  sqlite3_wal_hook(
+      db, [](void* userdata, sqlite3*, const char* dbName, int walFrames) noexcept -> int {
+    auto& self = *static_cast<SqliteDatabase*>(userdata);
+    if (strcmp(dbName, "main") != 0) return SQLITE_OK;
+    KJ_IF_SOME(hooks, self.walHooks) {
+      // The commit has already happened, so there's nothing useful to report to SQLite.
+      KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+        hooks->afterWalCommit(self, walFrames);
+      })) {
+        KJ_LOG(ERROR, "WAL commit hook failed", exception);
+      }
+    }
+    return SQLITE_OK;
+  }, this);
+}
+
+kj::Maybe<SqliteDatabase::WalCheckpointResult> SqliteDatabase::checkpointWal() {
+  sqlite3* db = *this;
+  auto memoryScope = enterMemoryScope();
+
+  int walFrames = 0;
+  int checkpointedFrames = 0;
+  int err = sqlite3_wal_checkpoint_v2(
+      db, nullptr, SQLITE_CHECKPOINT_PASSIVE, &walFrames, &checkpointedFrames);
+  if (err == SQLITE_BUSY) {
+    return kj::none;
+  }
+  KJ_REQUIRE(err == SQLITE_OK, dbErrorMessage(err, db));
+
+  // Both are -1 if the database isn't in WAL mode.
+  return WalCheckpointResult{
+    .walFrames = static_cast<uint>(kj::max(walFrames, 0)),
+    .checkpointedFrames = static_cast<uint>(kj::max(checkpointedFrames, 0)),
+  };
+}
+
+SqliteDatabase::PageCacheStats SqliteDatabase::getPageCacheStats() {
+  sqlite3* db = *this;
+
+  auto status = [&](int op) -> uint64_t {
+    int current = 0;
+    int highwater = 0;
+    int err = sqlite3_db_status(db, op, &current, &highwater, false);
+    KJ_REQUIRE(err == SQLITE_OK, dbErrorMessage(err, db));
+    return kj::max(current, 0);
+  };
+
+  return PageCacheStats{
+    .hits = status(SQLITE_DBSTATUS_CACHE_HIT),
+    .misses = status(SQLITE_DBSTATUS_CACHE_MISS),
+    .usedBytes = status(SQLITE_DBSTATUS_CACHE_USED),
+  };
 }
 
 SqliteDatabase::~SqliteDatabase() noexcept(false) {
@@ -912,6 +983,17 @@ SqliteDatabase::StatementAndEffect SqliteDatabase::prepareSql(StaticRegulator re
                   0, kj::min(RA_MAX_METRICS_QUERY_SIZE, errorDescription.size())));
             }
 
+            KJ_IF_SOME(stats, statementStats) {
+              stats->record(sqlite3_sql(result),
+                  {
+                    .time = queryLatency,
+                    .rowsRead = static_cast<uint64_t>(rowsRead),
+                    .rowsWritten = static_cast<uint64_t>(rowsWritten),
+                    .internal = !regulator->shouldAddQueryStats(),
+                    .cacheHit = false,
+                  });
+            }
+
             // Report queryEvent for this statement
             sqliteObserver.reportQueryEvent(kj::mv(queryStatement), rowsRead, rowsWritten,
                 queryLatency, dbWalBytesWritten, err, extendedCode,
@@ -1011,6 +1093,9 @@ void SqliteDatabase::reset() {
     for (auto& listener: resetListeners) {
       listener.beforeSqliteReset();
     }
+    KJ_IF_SOME(hooks, walHooks) {
+      hooks->beforeReset();
+    }
 
     auto err = sqlite3_close(&db);
     KJ_REQUIRE(err == SQLITE_OK, "can't reset() database because dependent objects still exist",
@@ -1521,6 +1606,16 @@ void SqliteDatabase::Query::destroy() {
 
   try {
     kj::StringPtr statement = sqlite3_sql(getStatementAndEffect().statement);
+    KJ_IF_SOME(stats, db.statementStats) {
+      stats->record(statement,
+          {
+            .time = stepTime,
+            .rowsRead = rowsRead,
+            .rowsWritten = rowsWritten,
+            .internal = !regulator->shouldAddQueryStats(),
+            .cacheHit = statementCacheHit,
+          });
+    }
     queryEvent.setQueryStatement(
         kj::heapString(statement.slice(0, kj::min(statement.size(), RA_MAX_METRICS_QUERY_SIZE))));
   } catch (kj::Exception& e) {
@@ -1662,7 +1757,17 @@ void SqliteDatabase::Query::nextRow(bool first) {
 
   auto memoryScope = db.enterMemoryScope();
   SQLITE_CALL_SCOPE {
+    kj::Maybe<kj::TimePoint> stepStart;
+    if (db.statementStats != kj::none) {
+      stepStart = db.sqliteObserver.now();
+    }
+
     int err = sqlite3_step(statement);
+
+    KJ_IF_SOME(start, stepStart) {
+      stepTime += db.sqliteObserver.now() - start;
+    }
+
     queryEvent.setQueryResult(err);
 
     int extendedCode = sqlite3_extended_errcode(db);
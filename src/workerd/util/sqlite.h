@@ -6,6 +6,7 @@
 
 #include <workerd/util/account-limits.h>
 #include <workerd/util/sqlite-metering.h>
+#include <workerd/util/sqlite-stats.h>
 
 #include <kj/filesystem.h>
 #include <kj/function.h>
@@ -345,11 +346,68 @@ class SqliteDatabase {
     }
   }
 
+  // Callbacks used to take over WAL checkpointing from SQLite. See setWalHooks().
+  class WalHooks {
+   public:
+    virtual ~WalHooks() noexcept(false) = default;
+
+    // Called after each transaction commits to the WAL, with the number of frames now in it.
+    virtual void afterWalCommit(SqliteDatabase& db, uint walFrames) = 0;
+
+    // Called at the start of reset(), before the database file is deleted. Anything else that
+    // has the file open must be done with it by the time this returns.
+    virtual void beforeReset() = 0;
+  };
+
+  // Replaces SQLite's automatic checkpointing (which runs on the committing thread once the WAL
+  // reaches 1000 pages) with `hooks`. The hooks stay installed across reset(). Passing kj::none
+  // restores automatic checkpointing. Only meaningful for databases in WAL mode.
+  void setWalHooks(kj::Maybe<kj::Own<WalHooks>> hooks);
+
+  struct WalCheckpointResult {
+    // Frames in the WAL, and how many of those have been copied back into the database file.
+    uint walFrames;
+    uint checkpointedFrames;
+  };
+
+  // Runs a PASSIVE checkpoint, copying as many WAL frames into the database file as possible
+  // without waiting for readers or writers. Returns kj::none if another connection was already
+  // checkpointing.
+  kj::Maybe<WalCheckpointResult> checkpointWal();
+
+  struct PageCacheStats {
+    // Page lookups that hit and missed this connection's page cache.
+    uint64_t hits;
+    uint64_t misses;
+
+    // Approximate memory used by this connection's page cache.
+    size_t usedBytes;
+  };
+
+  // Returns page cache statistics for this connection. When the shared page cache is installed
+  // (see sqlite-pcache.h), this is the database's share of it.
+  PageCacheStats getPageCacheStats();
+
+  // Starts aggregating statistics about the statements executed on this database. This costs a
+  // clock read per step and a hash lookup per query, so it is off by default.
+  void enableStatementStats() {
+    if (statementStats == kj::none) {
+      statementStats = kj::heap<SqliteStatementStats>();
+    }
+  }
+
+  // Returns the statement statistics, or none if enableStatementStats() hasn't been called.
+  kj::Maybe<SqliteStatementStats&> getStatementStats() {
+    return statementStats.map(
+        [](kj::Own<SqliteStatementStats>& stats) -> SqliteStatementStats& { return *stats; });
+  }
+
  private:
   const Vfs& vfs;
   kj::Path path;
   bool readOnly;
   SqliteObserver& sqliteObserver;
+  kj::Maybe<kj::Own<SqliteStatementStats>> statementStats;
 
   // The amount of memory in bytes used by this database for use by sqlite3_mem_methods.
   size_t sqliteMemoryBytes = 0;
@@ -386,6 +444,7 @@ class SqliteDatabase {
   kj::Maybe<kj::Function<void(kj::StringPtr errorMessage, kj::Maybe<kj::Exception> maybeException)>>
       onCriticalErrorCallback;
   kj::Maybe<kj::Function<void(SqliteDatabase&)>> afterResetCallback;
+  kj::Maybe<kj::Own<WalHooks>> walHooks;
 
   kj::List<ResetListener, &ResetListener::link> resetListeners;
 
@@ -407,6 +466,9 @@ class SqliteDatabase {
 
   void init(kj::Maybe<kj::WriteMode> maybeMode);
 
+  // Installs `walHooks` on the connection, or restores automatic checkpointing if there are none.
+  void installWalHooks();
+
   // Describes various kinds of interesting state changes which a statement might apply, which we
   // need to track to implement the SqliteDatabse interface. In particular, we must track
   // transactions to implement the onRollback() method.
@@ -559,6 +621,12 @@ class SqliteDatabase::Query final: private ResetListener {
   // Row IO counter.
   uint64_t getRowsWritten();
 
+  // Notes that the statement being run came from the caller's prepared statement cache, for
+  // SqliteStatementStats.
+  void setStatementCacheHit() {
+    statementCacheHit = true;
+  }
+
   // If true, there are no more rows. (When true, the methods below must not be called.)
   bool isDone() {
     return done;
@@ -712,6 +780,10 @@ class SqliteDatabase::Query final: private ResetListener {
   // Whether this query allows unconfirmed writes.
   bool allowUnconfirmed = false;
 
+  // Accumulated only when the database has statement stats enabled.
+  kj::Duration stepTime = 0 * kj::NANOSECONDS;
+  bool statementCacheHit = false;
+
   friend class SqliteDatabase;
 
   Query(SqliteDatabase& db,
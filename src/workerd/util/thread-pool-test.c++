@@ -0,0 +1,135 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "thread-pool.h"
+
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+KJ_TEST("ThreadPool runs work on another thread") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  ThreadPool pool;
+
+  static thread_local int marker;
+  auto callerMarker = &marker;
+  auto result = KJ_ASSERT_NONNULL(pool.tryRun<kj::String>([&]() {
+    KJ_ASSERT(&marker != callerMarker);
+    // Spin a little so there's some CPU time to report.
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < 1'000'000; i++) {
+      sum += i * i;
+    }
+    return kj::str("done ", sum > 0);
+  })).wait(ws);
+
+  KJ_EXPECT(result.value == "done true");
+  KJ_EXPECT(result.cpuTime >= 0 * kj::NANOSECONDS);
+}
+
+KJ_TEST("ThreadPool propagates exceptions") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  ThreadPool pool;
+
+  auto promise = KJ_ASSERT_NONNULL(pool.tryRun<int>([]() -> int { KJ_FAIL_REQUIRE("oops"); }));
+  KJ_EXPECT_THROW_MESSAGE("oops", promise.wait(ws));
+}
+
+KJ_TEST("ThreadPool refuses work once the queue is full") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  ThreadPool pool({.threadCount = 1, .maxQueued = 2});
+
+  kj::MutexGuarded<bool> release(false);
+  auto block = [&]() {
+    release.when([](bool released) { return released; }, [](bool) {});
+    return 0;
+  };
+
+  // The first task occupies the only thread, so the next two fill the queue. Wait for the thread
+  // to take the first one off the queue before filling it.
+  kj::MutexGuarded<bool> started(false);
+  auto first = KJ_ASSERT_NONNULL(pool.tryRun<int>([&]() {
+    *started.lockExclusive() = true;
+    return block();
+  }));
+  started.when([](bool s) { return s; }, [](bool) {});
+  auto second = KJ_ASSERT_NONNULL(pool.tryRun<int>(block));
+  auto third = KJ_ASSERT_NONNULL(pool.tryRun<int>(block));
+  KJ_EXPECT(pool.tryRun<int>(block) == kj::none);
+
+  *release.lockExclusive() = true;
+  first.wait(ws);
+  second.wait(ws);
+  third.wait(ws);
+
+  KJ_EXPECT(pool.tryRun<int>([]() { return 1; }) != kj::none);
+}
+
+KJ_TEST("ThreadPool skips work whose promise was dropped") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+  ThreadPool pool({.threadCount = 1});
+
+  kj::MutexGuarded<bool> release(false);
+  auto first = KJ_ASSERT_NONNULL(pool.tryRun<int>([&]() {
+    release.when([](bool released) { return released; }, [](bool) {});
+    return 0;
+  }));
+
+  bool ran = false;
+  {
+    auto dropped = pool.tryRun<int>([&]() {
+      ran = true;
+      return 1;
+    });
+    KJ_ASSERT(dropped != kj::none);
+  }
+
+  *release.lockExclusive() = true;
+  first.wait(ws);
+
+  // Tasks run in order on the one thread, so this one runs only after the dropped one was
+  // dequeued.
+  KJ_ASSERT_NONNULL(pool.tryRun<int>([]() { return 2; })).wait(ws);
+  KJ_EXPECT(!ran);
+}
+
+KJ_TEST("ThreadPool runs detached work after its delay") {
+  kj::MutexGuarded<kj::Vector<int>> order;
+  ThreadPool pool({.threadCount = 1});
+  auto& clock = kj::systemPreciseMonotonicClock();
+
+  auto start = clock.now();
+  pool.runDetached([&]() { order.lockExclusive()->add(2); }, 20 * kj::MILLISECONDS);
+  pool.runDetached([&]() { order.lockExclusive()->add(1); }, 5 * kj::MILLISECONDS);
+  pool.runDetached([&]() { KJ_FAIL_REQUIRE("logged, not fatal"); });
+
+  order.when([](const kj::Vector<int>& v) { return v.size() == 2; }, [](auto&) {});
+  KJ_EXPECT(clock.now() - start >= 20 * kj::MILLISECONDS);
+  auto lock = order.lockExclusive();
+  KJ_EXPECT((*lock)[0] == 1);
+  KJ_EXPECT((*lock)[1] == 2);
+}
+
+KJ_TEST("ThreadPool finishes due work and drops pending delayed work on destruction") {
+  bool ranDue = false;
+  bool ranDelayed = false;
+  kj::MutexGuarded<bool> release(false);
+  {
+    ThreadPool pool({.threadCount = 1});
+    pool.runDetached([&]() { release.when([](bool released) { return released; }, [](bool) {}); });
+    pool.runDetached([&]() { ranDue = true; });
+    pool.runDetached([&]() { ranDelayed = true; }, 1 * kj::HOURS);
+    *release.lockExclusive() = true;
+  }
+  KJ_EXPECT(ranDue);
+  KJ_EXPECT(!ranDelayed);
+}
+
+}  // namespace
+}  // namespace workerd
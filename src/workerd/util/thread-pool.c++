@@ -0,0 +1,104 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "thread-pool.h"
+
+#include <kj/debug.h>
+
+#if _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace workerd {
+
+ThreadPool::ThreadPool(Options options): options(options) {
+  KJ_REQUIRE(options.threadCount > 0);
+  threads.reserve(options.threadCount);
+  for (uint i = 0; i < options.threadCount; i++) {
+    threads.add(kj::heap<kj::Thread>([this]() { run(); }));
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept(false) {
+  state.lockExclusive()->shuttingDown = true;
+  // `threads` are joined when they are destroyed, which happens first since they are declared
+  // last. They finish whatever is queued before exiting; tryRun() tasks whose promise is gone
+  // skip themselves. Delayed tasks that aren't due yet are dropped along with `state`.
+}
+
+void ThreadPool::runDetached(kj::Function<void()>&& work, kj::Duration delay) const {
+  kj::Function<void()> task = [work = kj::mv(work)]() mutable {
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { work(); })) {
+      KJ_LOG(ERROR, "background task failed", exception);
+    }
+  };
+
+  auto lock = state.lockExclusive();
+  if (lock->shuttingDown) return;
+  if (delay <= 0 * kj::SECONDS) {
+    lock->queue.push_back(kj::mv(task));
+  } else {
+    auto due = kj::systemPreciseMonotonicClock().now() + delay;
+    lock->delayed.add(Delayed{.due = due, .work = kj::mv(task)});
+    ++lock->delayedAdded;
+  }
+}
+
+void ThreadPool::run() {
+  auto& clock = kj::systemPreciseMonotonicClock();
+  for (;;) {
+    kj::Maybe<kj::Function<void()>> task;
+    {
+      auto lock = state.lockExclusive();
+      for (;;) {
+        // Move delayed work that has come due onto the queue, and find the next deadline.
+        auto now = clock.now();
+        kj::Maybe<kj::TimePoint> nextDue;
+        auto& delayed = lock->delayed;
+        for (size_t i = 0; i < delayed.size();) {
+          if (delayed[i].due <= now) {
+            lock->queue.push_back(kj::mv(delayed[i].work));
+            if (i + 1 < delayed.size()) delayed[i] = kj::mv(delayed.back());
+            delayed.removeLast();
+          } else {
+            auto due = delayed[i].due;
+            nextDue = kj::min(nextDue.orDefault(due), due);
+            i++;
+          }
+        }
+
+        if (!lock->queue.empty()) break;
+        if (lock->shuttingDown) return;
+
+        auto seen = lock->delayedAdded;
+        lock.wait([seen](const State& s) {
+          return !s.queue.empty() || s.shuttingDown || s.delayedAdded != seen;
+        }, nextDue.map([now](kj::TimePoint due) { return due - now; }));
+      }
+      task = kj::mv(lock->queue.front());
+      lock->queue.pop_front();
+    }
+    KJ_ASSERT_NONNULL(task)();
+  }
+}
+
+kj::Duration ThreadPool::threadCpuTime() {
+#if _WIN32
+  FILETIME creation, exit, kernel, user;
+  KJ_ASSERT(GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user));
+  // FILETIMEs count 100ns intervals.
+  auto toDuration = [](FILETIME time) {
+    return ((uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100 * kj::NANOSECONDS;
+  };
+  return toDuration(kernel) + toDuration(user);
+#else
+  struct timespec ts;
+  KJ_SYSCALL(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts));
+  return ts.tv_sec * kj::SECONDS + ts.tv_nsec * kj::NANOSECONDS;
+#endif
+}
+
+}  // namespace workerd
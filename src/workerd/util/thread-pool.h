@@ -0,0 +1,119 @@
+// Copyright (c) 2026 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/util/ring-buffer.h>
+
+#include <kj/async.h>
+#include <kj/function.h>
+#include <kj/mutex.h>
+#include <kj/thread.h>
+#include <kj/time.h>
+#include <kj/vector.h>
+
+namespace workerd {
+
+// Runs blocking, CPU-bound work on a fixed set of background threads, so that it doesn't hold up
+// the event loop of the thread that wants it done. Both the number of threads and the number of
+// tasks waiting for one are bounded; once the queue is full, tryRun() refuses new work and the
+// caller is expected to do it itself.
+//
+// A pool with a single thread also serves as a background worker for housekeeping that nobody
+// waits on, such as periodic checks or writing files out; see runDetached().
+class ThreadPool {
+ public:
+  struct Options {
+    uint threadCount = 2;
+
+    // Tasks that may wait for a free thread before tryRun() starts refusing more.
+    uint maxQueued = 64;
+  };
+
+  explicit ThreadPool(Options options);
+  ThreadPool(): ThreadPool(Options{}) {}
+  ~ThreadPool() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  template <typename T>
+  struct Result {
+    T value;
+
+    // CPU time the pool thread spent running the work.
+    kj::Duration cpuTime;
+  };
+
+  // Queues `work` to run on a pool thread and returns a promise for its result, which must be
+  // awaited on the calling thread's event loop. If the queue is full, returns none and leaves
+  // `work` untouched, so that the caller can run it some other way. `work` must not touch
+  // anything owned by the calling thread. If it throws, the promise rejects with the exception.
+  // If the promise is dropped before a thread picks `work` up, `work` never runs.
+  template <typename T>
+  kj::Maybe<kj::Promise<Result<T>>> tryRun(kj::Function<T()>&& work) const;
+
+  // Queues `work` to run on a pool thread once `delay` has passed, without reporting back. This
+  // never refuses work, so it's meant for the pool's owner rather than for request-driven tasks.
+  // Exceptions thrown by `work` are logged. When the pool is destroyed, work that is already due
+  // still runs before the destructor returns, while delayed work that isn't due yet is dropped,
+  // as is anything queued from then on; a periodic task can simply reschedule itself.
+  void runDetached(
+      kj::Function<void()>&& work, kj::Duration delay = 0 * kj::SECONDS) const;
+
+  // CPU time consumed so far by the calling thread.
+  static kj::Duration threadCpuTime();
+
+ private:
+  struct Delayed {
+    kj::TimePoint due;
+    kj::Function<void()> work;
+  };
+
+  struct State {
+    RingBuffer<kj::Function<void()>> queue;
+
+    // Work from runDetached() that isn't due yet, in no particular order. Owners schedule only a
+    // handful of these, so a linear scan is fine.
+    kj::Vector<Delayed> delayed;
+
+    // Bumped whenever `delayed` gains an entry, so that threads waiting for a later deadline
+    // wake up and recompute it.
+    uint64_t delayedAdded = 0;
+
+    bool shuttingDown = false;
+  };
+
+  Options options;
+  kj::MutexGuarded<State> state;
+
+  // Declared last so that they are joined before the rest of the object is torn down.
+  kj::Vector<kj::Own<kj::Thread>> threads;
+
+  void run();
+};
+
+template <typename T>
+kj::Maybe<kj::Promise<ThreadPool::Result<T>>> ThreadPool::tryRun(
+    kj::Function<T()>&& work) const {
+  auto lock = state.lockExclusive();
+  if (lock->shuttingDown || lock->queue.size() >= options.maxQueued) return kj::none;
+
+  auto paf = kj::newPromiseAndCrossThreadFulfiller<Result<T>>();
+  lock->queue.push_back([work = kj::mv(work), fulfiller = kj::mv(paf.fulfiller)]() mutable {
+    if (!fulfiller->isWaiting()) return;
+
+    auto start = threadCpuTime();
+    kj::Maybe<T> value;
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() { value = work(); })) {
+      fulfiller->reject(kj::mv(exception));
+    } else {
+      fulfiller->fulfill(Result<T>{
+        .value = kj::mv(KJ_ASSERT_NONNULL(value)),
+        .cpuTime = threadCpuTime() - start,
+      });
+    }
+  });
+  return kj::mv(paf.promise);
+}
+
+}  // namespace workerd